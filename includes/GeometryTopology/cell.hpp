@@ -3,10 +3,19 @@
 
 #include <iostream>
 #include "coordinate.hpp"
-#include "grid.hpp"
+
+namespace MolecularModeling
+{
+    class Atom;
+}
 
 namespace GeometryTopology
 {
+    class Grid;
+    /*! \class
+      * A box shaped cell of a grid. The corners and the center of the cell are stored in the cell itself,
+      * so that the cells of a grid can be kept in one dense array.
+      */
     class Cell
     {
         public:
@@ -43,9 +52,24 @@ namespace GeometryTopology
             //////////////////////////////////////////////////////////+
             //                         FUNCTIONS                    //
             //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to access to the center of the cell
+              * @return Pointer to the center that is stored in the cell, it is updated when a corner changes
+              */
             GeometryTopology::Coordinate* GetCellCenter();
             void CalculateCellCharge();
             void CalculateCellPotentialEnergy(double ion_radius);
+            /*! \fn
+              * A function in order to add the contribution of one more atom to the potential energy of the cell
+              * The result is the same as recalculating the potential energy with the atom appended to the atoms of the assembly
+              * @param atom The atom that has been added to the assembly of the grid
+              * @param ion_radius Radius of the ion that is going to be placed in the cell
+              * @param cutoff The atom is left out if it is farther than this from the center of the cell, 0 for no cutoff
+              * @param screening_length Debye length of the screened term of the atom, 0 for no screening
+              * @param minimum_distance The cell gets INFINITY if it is closer than this to the atom as well
+              */
+            void UpdateCellPotentialEnergy(MolecularModeling::Atom* atom, double ion_radius, double cutoff = 0.0, double screening_length = 0.0,
+                                           double minimum_distance = 0.0);
             void CalculateBoxCharge();
             void CalculateBoxPotentialEnergy();
 
@@ -60,11 +84,17 @@ namespace GeometryTopology
             void Print(std::ostream& out = std::cout);
 
     private:
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            void UpdateCellCenter();
+
             //////////////////////////////////////////////////////////
             //                         ATTRIBUTES                   //
             //////////////////////////////////////////////////////////
-            GeometryTopology::Coordinate* min_corner_;
-            GeometryTopology::Coordinate* max_corner_;
+            GeometryTopology::Coordinate min_corner_;
+            GeometryTopology::Coordinate max_corner_;
+            GeometryTopology::Coordinate cell_center_;
             double cell_charge_;
             double cell_potential_energy_;
             Grid* grid_;
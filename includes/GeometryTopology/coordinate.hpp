@@ -76,6 +76,11 @@ namespace GeometryTopology
               * @param z A double value on Z axis for the origin of translation
               */
             void Translate(double x, double y, double z);
+            /*! \fn
+              * Apply a 3x4 transformation (rotation in the first three columns, translation in the last one) to the current coordinate
+              * @param matrix The transformation matrix, e.g. one filled by gmml::GenerateRotationMatrix
+              */
+            void Transform(const double matrix[3][4]);
 
             /*! \fn
               * Compare current object with the given coordinate and return true if they are the same
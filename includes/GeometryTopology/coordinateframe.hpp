@@ -0,0 +1,96 @@
+#ifndef COORDINATEFRAME_HPP
+#define COORDINATEFRAME_HPP
+
+#include <vector>
+#include <iostream>
+
+#include "coordinate.hpp"
+
+namespace GeometryTopology
+{
+    class CoordinateFrame
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<Coordinate*> CoordinateVector;
+
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor
+              * @param block_size Number of coordinates stored contiguously in each block of the frame
+              */
+            CoordinateFrame(int block_size = 4096);
+            /*! \fn
+              * Destructor, releases all blocks and so all coordinates that have been allocated in the frame
+              */
+            ~CoordinateFrame();
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * An accessor function in order to access to the number of coordinates allocated in the frame
+              * @return size_ attribute of the current object of this class
+              */
+            int GetNumberOfCoordinates();
+            /*! \fn
+              * An accessor function in order to access to a coordinate of the frame by its allocation order
+              * @param index Index of the coordinate in the frame
+              * @return Pointer to the coordinate which remains valid as long as the frame exists
+              */
+            Coordinate* GetCoordinate(int index);
+            /*! \fn
+              * An accessor function in order to access to all coordinates of the frame in allocation order
+              * @return List of pointers to the coordinates of the frame
+              */
+            CoordinateVector GetCoordinates();
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to allocate a new coordinate right after the previously allocated one
+              * Blocks are never moved, so the returned pointer stays valid as long as the frame exists
+              * @param coordinate The values of the new coordinate
+              * @return Pointer to the newly allocated coordinate
+              */
+            Coordinate* AddCoordinate(const Coordinate& coordinate);
+            /*! \fn
+              * A function in order to allocate a new coordinate right after the previously allocated one
+              * @param x A double value on X axis in cartesian coordinate
+              * @param y A double value on Y axis in cartesian coordinate
+              * @param z A double value on Z axis in cartesian coordinate
+              * @return Pointer to the newly allocated coordinate
+              */
+            Coordinate* AddCoordinate(double x, double y, double z);
+
+            //////////////////////////////////////////////////////////
+            //                     DISPLAY FUNCTIONS                //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function to print out the frame dimensions
+              * @param out An output stream, the print result will be written in the given output stream
+              */
+            void Print(std::ostream& out = std::cout);
+
+        private:
+            /*! \fn
+              * Frames own their blocks and can not be copied
+              */
+            CoordinateFrame(const CoordinateFrame& frame);
+            CoordinateFrame& operator=(const CoordinateFrame& frame);
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            int block_size_;                    /*!< Number of coordinates in each block >*/
+            int size_;                          /*!< Number of coordinates allocated in the frame >*/
+            CoordinateVector blocks_;           /*!< Contiguous arrays of block_size_ coordinates >*/
+    };
+}
+
+#endif // COORDINATEFRAME_HPP
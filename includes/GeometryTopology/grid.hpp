@@ -2,12 +2,19 @@
 #define GRID_HPP
 
 #include <vector>
+#include <set>
 #include "../MolecularModeling/assembly.hpp"
+#include "cell.hpp"
 
 namespace GeometryTopology
 {
     class Coordinate;
-    class Cell;
+    class NeighborGrid;
+    /*! \class
+      * A rectangular grid of cells over a region of space, used to find good positions for ions around an assembly
+      * The cells are stored by value in one dense array, x major and z minor, and are described by the start and end of
+      * each cell along the three axes. The cells that take part in the calculations are listed in cells_.
+      */
     class Grid
     {
         public:
@@ -15,6 +22,9 @@ namespace GeometryTopology
             //                    TYPE DEFINITION                   //
             //////////////////////////////////////////////////////////
             typedef std::vector<Cell*> CellVector;
+            typedef std::vector<Cell> CellArray;
+            typedef std::vector<double> DoubleVector;
+            typedef std::set<std::pair<double, int> > CellRanking;
 
             //////////////////////////////////////////////////////////
             //                       Constructor                    //
@@ -30,6 +40,14 @@ namespace GeometryTopology
             Coordinate* GetMaxCorner();
             CellVector GetCells();
             MolecularModeling::Assembly* GetAssembly();
+            /*! \fn
+              * An accessor function in order to access to a cell of the dense array of the grid by its position
+              * @param x_index Position of the cell along the x axis
+              * @param y_index Position of the cell along the y axis
+              * @param z_index Position of the cell along the z axis
+              * @return Pointer to the cell, NULL if the position is outside of the grid
+              */
+            Cell* GetCell(int x_index, int y_index, int z_index);
 
             //////////////////////////////////////////////////////////
             //                           MUTATOR                    //
@@ -44,8 +62,81 @@ namespace GeometryTopology
             //////////////////////////////////////////////////////////
             void UpdateGrid(double lenght, double width, double height);
             void UpdateGrid(double ion_charge);
+            /*! \fn
+              * A function in order to calculate the total charge of the atoms inside each cell
+              * The atoms of the assembly are binned into the cells of the dense array in one pass
+              */
             void CalculateCellsCharge();
-            void CalculateCellsPotentialEnergy(double ion_radius);
+            /*! \fn
+              * A function in order to calculate the electrostatic potential energy at the center of each cell
+              * Cells that are closer to an atom than the radius of the atom plus the radius of the ion plus GRID_OFFSET get INFINITY.
+              * The atoms are packed into plain arrays once and the cells are divided between the threads.
+              * By default every atom is counted with an unscreened q / r term, in the order of the atoms of the assembly.
+              * @param ion_radius Radius of the ion that is going to be placed
+              * @param number_of_threads Number of threads that share the cells
+              * @param cutoff Atoms farther than this from the center of a cell are left out of its sum, 0 for no cutoff
+              * @param screening_length Debye length of the q * exp(-r / screening_length) / r screened term, 0 for no screening
+              * @param minimum_distance Cells closer than this to any atom get INFINITY as well
+              */
+            void CalculateCellsPotentialEnergy(double ion_radius, int number_of_threads = 1, double cutoff = 0.0, double screening_length = 0.0,
+                                               double minimum_distance = 0.0);
+            /*! \fn
+              * A function in order to calculate the electrostatic potential energy at a list of points, e.g. the centers of the cells of a grid
+              * The atoms are packed into plain arrays once and the points are divided between the threads. A point gets INFINITY if it is
+              * closer to an atom than the overlap distance of the atom. Without a cutoff every atom is counted in the order of the list.
+              * @param centers The points to calculate the potential energy at
+              * @param atom_coordinates Coordinates of the atoms
+              * @param charges Charges of the atoms
+              * @param overlap_distances Distance from each atom within which a point gets INFINITY
+              * @param number_of_threads Number of threads that share the points
+              * @param cutoff Atoms farther than this from a point are left out of its sum, 0 for no cutoff
+              * @param screening_length Debye length of the q * exp(-r / screening_length) / r screened term, 0 for no screening
+              * @param potential_energies The potential energy at each point, in the order of the points
+              */
+            static void CalculatePotentialEnergies(std::vector<Coordinate*>& centers, std::vector<Coordinate*>& atom_coordinates, DoubleVector& charges,
+                                                   DoubleVector& overlap_distances, int number_of_threads, double cutoff, double screening_length,
+                                                   DoubleVector& potential_energies);
+            /*! \fn
+              * A function in order to update the potential energy of the cells after an atom (e.g. an ion) has been added to the assembly
+              * Only the contribution of the new atom is added, so the grid can be reused for placing several ions.
+              * The cutoff and screening of the last CalculateCellsPotentialEnergy are used. With a cutoff and ranked cells (see RankCells)
+              * only the cells within reach of the atom are visited and re-ranked; otherwise all cells are updated and ranked again.
+              * @param atom The atom that has been added to the assembly of the grid
+              * @param ion_radius Radius of the ion that is going to be placed
+              * @param minimum_distance Cells closer than this to the atom get INFINITY as well
+              */
+            void UpdateCellsPotentialEnergy(MolecularModeling::Atom* atom, double ion_radius, double minimum_distance = 0.0);
+            /*! \fn
+              * A function in order to remove the cells whose centers are inside the current boundary of the assembly
+              * This keeps the grid the same as a new grid of the assembly after its boundary has grown
+              */
+            void RemoveCellsInsideAssembly();
+            /*! \fn
+              * A function in order to remove the cells whose centers are inside the boundary of the assembly after an atom has been added to it
+              * With ranked cells the boundary is extended by the atom instead of being recalculated from all atoms of the assembly.
+              * @param added_atom The atom that has been added to the assembly of the grid
+              */
+            void RemoveCellsInsideAssembly(MolecularModeling::Atom* added_atom);
+            /*! \fn
+              * A function in order to rank the cells by their potential energy for placing ions of the given charge
+              * The stored cells with a finite potential energy are kept in an ordered set with the best cell first, so the best cells are found
+              * without scanning the grid. The ranking follows UpdateCellsPotentialEnergy and RemoveCellsInsideAssembly, and is dropped when the
+              * potential energy of all cells is calculated again or the cells are replaced.
+              * @param ion_charge Charge of the ions that are going to be placed, the lowest potential energy is the best for positive ions
+              */
+            void RankCells(double ion_charge);
+            /*! \fn
+              * A function in order to access to the best ranked cells, all cells within THRESHOLD of the best potential energy
+              * @return The best cells in the order of the dense array, the same cells whose centers GetBestPositions gives
+              */
+            CellVector GetBestRankedCells();
+            /*! \fn
+              * A function in order to access to the best ranked cells for an ion of either charge
+              * The cells are ranked once in order of potential energy, so the best cells for the other charge are at the back of the ranking
+              * @param ion_charge Charge of the ion that is going to be placed
+              * @return The cells within THRESHOLD of the best potential energy for the ion, in the order of the dense array
+              */
+            CellVector GetBestRankedCells(double ion_charge);
             void CalculateBoxCharge();
             void CalculateBoxPotentialEnergy();
             Cell* GetBestBox(Grid* grid, double ion_charge);
@@ -62,14 +153,135 @@ namespace GeometryTopology
             void Print(std::ostream& out = std::cout);
 
     private:
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Copying is not allowed, the cells of a grid point back to it
+              */
+            Grid(const Grid& grid);
+            Grid& operator=(const Grid& grid);
+            /*! \fn
+              * A function that divides the region min ... max of an axis into cells of the given size, the last cell is cut at max
+              * @param min Start of the region
+              * @param max End of the region
+              * @param size Size of the cells
+              * @param starts The starts of the cells
+              * @param ends The ends of the cells
+              */
+            void DivideAxis(double min, double max, double size, DoubleVector& starts, DoubleVector& ends);
+            /*! \fn
+              * A function that finds the cell along an axis that holds a value, cells hold the values start < value <= end
+              * @param value The value to look up
+              * @param starts The starts of the cells of the axis
+              * @param ends The ends of the cells of the axis
+              * @return Position of the cell along the axis, -1 if the value is outside of all cells
+              */
+            int CellIndexAlongAxis(double value, DoubleVector& starts, DoubleVector& ends);
+            /*! \fn
+              * A function that (re)creates the dense array of cells from the starts and ends of the cells along the axes
+              * All cells are listed in cells_
+              */
+            void BuildCells();
+            /*! \fn
+              * A function that builds the cells of the region min ... max for placing an ion
+              * Cells whose centers are inside the boundary of the assembly are left out. A region that is larger than the default box is
+              * divided into eight boxes and the box with the best potential energy is divided further.
+              * @param min Lower corner of the region
+              * @param max Upper corner of the region
+              * @param ion_charge Charge of the ion that is going to be placed
+              */
+            void PartitionRegion(Coordinate min, Coordinate max, double ion_charge);
+            /*! \fn
+              * A function that checks whether a cell belongs to the dense array of the grid
+              * @param cell The cell to check
+              * @return True if the cell is one of the stored cells of the grid
+              */
+            bool IsStoredCell(Cell* cell);
+            /*! \fn
+              * A function that finds the cells along an axis whose centers are strictly between two values
+              * @param axis 0, 1 or 2 for the x, y or z axis
+              * @param min Lower value
+              * @param max Upper value
+              * @param first Position of the first cell along the axis
+              * @param last Position of the last cell along the axis, less than first if there is no such cell
+              */
+            void CellRangeAlongAxis(int axis, double min, double max, int& first, int& last);
+            /*! \fn
+              * A function that (re)fills the ranking with the stored cells of cells_ that have a finite potential energy
+              */
+            void FillRanking();
+
             //////////////////////////////////////////////////////////
             //                         ATTRIBUTES                   //
             //////////////////////////////////////////////////////////
-            Coordinate* min_corner_;
-            Coordinate* max_corner_;
-            CellVector cells_;
+            Coordinate min_corner_;
+            Coordinate max_corner_;
+            DoubleVector x_starts_;                 /*!< Start of each cell along the x axis >*/
+            DoubleVector x_ends_;                   /*!< End of each cell along the x axis >*/
+            DoubleVector y_starts_;
+            DoubleVector y_ends_;
+            DoubleVector z_starts_;
+            DoubleVector z_ends_;
+            CellArray cell_array_;                  /*!< All cells of the grid, the cell at (x, y, z) is at (x * ny + y) * nz + z >*/
+            CellVector cells_;                      /*!< Cells that take part in the calculations, in the order of the dense array >*/
             MolecularModeling::Assembly* assembly_;
+            double cutoff_;                         /*!< Cutoff of the potential energy of the cells, 0 for no cutoff >*/
+            double screening_length_;               /*!< Debye length of the screened potential energy of the cells, 0 for no screening >*/
+            CellRanking ranking_;                   /*!< Ranked cells as (sign * potential energy, position in the dense array) >*/
+            bool ranked_;                           /*!< Whether ranking_ is in use >*/
+            double ranking_sign_;                   /*!< 1 if the lowest potential energy is the best, -1 if the highest is >*/
+            Coordinate boundary_min_;               /*!< Boundary of the assembly while the cells are ranked >*/
+            Coordinate boundary_max_;
+
+    };
+
+    struct CellPotentialThreadArgument{
+            int thread_index;
+            int number_of_threads;
+            double cutoff;
+            double screening_length;
+            std::vector<Coordinate*>* centers;
+            std::vector<double>* potential_energies;
+            std::vector<double>* x;
+            std::vector<double>* y;
+            std::vector<double>* z;
+            std::vector<double>* charges;
+            std::vector<double>* overlap_distances;
+            NeighborGrid* atom_grid;
+
+            CellPotentialThreadArgument()
+            {
+                thread_index = 0;
+                number_of_threads = 1;
+                cutoff = 0.0;
+                screening_length = 0.0;
+                centers = NULL;
+                potential_energies = NULL;
+                x = NULL;
+                y = NULL;
+                z = NULL;
+                charges = NULL;
+                overlap_distances = NULL;
+                atom_grid = NULL;
+            }
 
+            CellPotentialThreadArgument(int ti, int tn, double c, double sl, std::vector<Coordinate*>* cs, std::vector<double>* pes, std::vector<double>* xs,
+                                        std::vector<double>* ys, std::vector<double>* zs, std::vector<double>* qs, std::vector<double>* ods, NeighborGrid* g)
+            {
+                thread_index = ti;
+                number_of_threads = tn;
+                cutoff = c;
+                screening_length = sl;
+                centers = cs;
+                potential_energies = pes;
+                x = xs;
+                y = ys;
+                z = zs;
+                charges = qs;
+                overlap_distances = ods;
+                atom_grid = g;
+            }
     };
 }
 
@@ -0,0 +1,109 @@
+#ifndef NEIGHBORGRID_HPP
+#define NEIGHBORGRID_HPP
+
+#include <vector>
+#include <iostream>
+
+#include "coordinate.hpp"
+
+namespace GeometryTopology
+{
+    class NeighborGrid
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<Coordinate*> CoordinateVector;
+            typedef std::vector<int> IndexVector;
+
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor
+              */
+            NeighborGrid();
+            /*! \fn
+              * Constructor to bin the given set of coordinates into a uniform grid (cell list)
+              * @param coordinates The coordinates to be indexed; the position of each coordinate in this list is its index in the grid
+              * @param cell_size Minimum edge length of each cell. Use the search cutoff so that every neighbor lies in one of the 27 surrounding cells
+              * A cell size that is not positive throws std::invalid_argument
+              */
+            NeighborGrid(CoordinateVector coordinates, double cell_size);
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * An accessor function in order to access to the cell size
+              * @return cell_size_ attribute of the current object of this class
+              */
+            double GetCellSize();
+            /*! \fn
+              * An accessor function in order to access to the number of indexed coordinates
+              * @return Number of coordinates that have been binned into the grid
+              */
+            int GetNumberOfPoints();
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to (re)bin a set of coordinates into the grid in one pass
+              * The grid is left unchanged if the cell size is not positive, std::invalid_argument is thrown instead
+              * @param coordinates The coordinates to be indexed
+              * @param cell_size Minimum edge length of each cell
+              */
+            void Build(CoordinateVector coordinates, double cell_size);
+            /*! \fn
+              * A function in order to collect the indices of all coordinates located in the cell of the given point and its 26 surrounding cells
+              * Indices are appended to the given list in the order of the cells; within a cell they are ascending
+              * @param x X of the query point
+              * @param y Y of the query point
+              * @param z Z of the query point
+              * @param indices The list that the candidate indices will be appended to
+              */
+            void GetCandidateIndices(double x, double y, double z, IndexVector& indices);
+            /*! \fn
+              * A function in order to collect the indices of all coordinates within the given distance of a point, the distance itself included
+              * The distance has to be less than or equal to the cell size of the grid
+              * @param point The query point
+              * @param cutoff Distance threshold
+              * @param indices The list that the indices of the close coordinates will be appended to
+              * @param candidates Scratch list owned by the caller; it is cleared and filled with the candidate indices, so repeated queries reuse its storage
+              */
+            void GetIndicesWithinDistance(Coordinate* point, double cutoff, IndexVector& indices, IndexVector& candidates);
+
+            //////////////////////////////////////////////////////////
+            //                     DISPLAY FUNCTIONS                //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function to print out the grid dimensions
+              * @param out An output stream, the print result will be written in the given output stream
+              */
+            void Print(std::ostream& out = std::cout);
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            int CellIndexAlongAxis(double value, double min, int number_of_cells);
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            double cell_size_;                  /*!< Edge length of each (cubic) cell >*/
+            double min_x_;                      /*!< Lower corner of the indexed region >*/
+            double min_y_;
+            double min_z_;
+            int number_of_cells_x_;             /*!< Number of cells along each axis >*/
+            int number_of_cells_y_;
+            int number_of_cells_z_;
+            IndexVector cell_offsets_;          /*!< Start of each cell's entries in cell_points_, one extra entry at the end >*/
+            IndexVector cell_points_;           /*!< Coordinate indices sorted by cell, ascending within each cell >*/
+            CoordinateVector points_;           /*!< The indexed coordinates >*/
+    };
+}
+
+#endif // NEIGHBORGRID_HPP
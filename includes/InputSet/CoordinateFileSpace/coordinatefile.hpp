@@ -61,6 +61,12 @@ namespace CoordinateFileSpace
               * @return coordinates_ attribute of the current object of this class
               */
             const std::vector<GeometryTopology::Coordinate*> GetCoordinates() const;
+            /*! \fn
+              * An accessor function in order to access to the periodic box of the current object
+              * The attribute is set by the last line of the given file, if it has a box line
+              * @return box_dimensions_ attribute of the current object of this class, the three box lengths followed by the three angles
+              */
+            const std::vector<double> GetBoxDimensions() const;
 
             //////////////////////////////////////////////////////////
             //                           MUTATOR                    //
@@ -97,6 +103,12 @@ namespace CoordinateFileSpace
               * @param title A string defines the title of the coordinate file which is extracted from the contents of the file
               */
             void AddCoordinate(GeometryTopology::Coordinate* coordinate);
+            /*! \fn
+              * A mutator function in order to set the periodic box of the current object
+              * Set the box_dimensions_ attribute of the current object; the box line is only written if six values are given
+              * @param box_dimensions The three box lengths followed by the three box angles
+              */
+            void SetBoxDimensions(std::vector<double> box_dimensions);
 
             //////////////////////////////////////////////////////////
             //                         FUNCTIONS                    //
@@ -137,6 +149,7 @@ namespace CoordinateFileSpace
             int number_of_coordinates_;                         /*!< Number of coordinates containing in the file; set by the second line of a coordinate file */
             std::vector<GeometryTopology::Coordinate*> coordinates_;    /*!< List of coordinates in a coordinate file; from the 3rd line of a coordinate file to
                                                                         the end of the file, lines are including coordinates */
+            std::vector<double> box_dimensions_;                /*!< Box lengths and angles; set by the last line of a coordinate file of a periodic system */
             /*! \file
               * An example of a coordinate file:
               *     ROH
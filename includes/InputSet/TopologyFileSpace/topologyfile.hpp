@@ -245,6 +245,21 @@ namespace TopologyFileSpace
             TopologyAssembly* GetAssembly();
 
             RadiusSet GetRadiusSet();
+            /*! \fn
+              * An accessor function in order to access to the solvent pointers (IPTRES, NSPM, NSPSOL)
+              * @return solvent_pointers_ attribute of the current object of this class
+              */
+            std::vector<int> GetSolventPointers();
+            /*! \fn
+              * An accessor function in order to access to the number of atoms in each molecule
+              * @return atoms_per_molecule_ attribute of the current object of this class
+              */
+            std::vector<int> GetAtomsPerMolecule();
+            /*! \fn
+              * An accessor function in order to access to the periodic box dimensions (BETA, BOX(1), BOX(2), BOX(3))
+              * @return box_dimensions_ attribute of the current object of this class
+              */
+            std::vector<double> GetBoxDimensions();
             /*! \fn
               * An accessor function in order to access to the bonds
               * @return bonds_ attribute of the current object of this class
@@ -510,6 +525,24 @@ namespace TopologyFileSpace
               * @param residue_set Residue set
               */
             void SetRadiusSet(RadiusSet radius_set);
+            /*! \fn
+              * A mutator function in order to set the solvent pointers of the current object
+              * Set the solvent_pointers_ attribute of the current topology file
+              * @param solvent_pointers Last solute residue, number of molecules and first solvent molecule
+              */
+            void SetSolventPointers(std::vector<int> solvent_pointers);
+            /*! \fn
+              * A mutator function in order to set the number of atoms in each molecule of the current object
+              * Set the atoms_per_molecule_ attribute of the current topology file
+              * @param atoms_per_molecule Number of atoms in each molecule
+              */
+            void SetAtomsPerMolecule(std::vector<int> atoms_per_molecule);
+            /*! \fn
+              * A mutator function in order to set the periodic box dimensions of the current object
+              * Set the box_dimensions_ attribute of the current topology file
+              * @param box_dimensions Box angle followed by the three box lengths
+              */
+            void SetBoxDimensions(std::vector<double> box_dimensions);
             /*! \fn
               * A mutator function in order to set the bonds of the current object
               * Set the bonds_ attribute of the current topology file
@@ -841,6 +874,21 @@ namespace TopologyFileSpace
               * @param out Intermediate output stream in order to write title section
               */
             void ResolveIRotatSection(std::ofstream& out);
+            /*! \fn
+              * A function to write back solvent pointers section of the topology file into an output stream
+              * @param out Intermediate output stream in order to write solvent pointers section
+              */
+            void ResolveSolventPointersSection(std::ofstream& out);
+            /*! \fn
+              * A function to write back atoms per molecule section of the topology file into an output stream
+              * @param out Intermediate output stream in order to write atoms per molecule section
+              */
+            void ResolveAtomsPerMoleculeSection(std::ofstream& out);
+            /*! \fn
+              * A function to write back box dimensions section of the topology file into an output stream
+              * @param out Intermediate output stream in order to write box dimensions section
+              */
+            void ResolveBoxDimensionsSection(std::ofstream& out);
             /*! \fn
               * A function to write back residue set section of the topology file into an output stream
               * @param out Intermediate output stream in order to write residue set section
@@ -911,6 +959,9 @@ namespace TopologyFileSpace
             TopologyDihedralTypeMap dihedral_types_;
             TopologyAssembly* assembly_;
             RadiusSet radius_set_;
+            std::vector<int> solvent_pointers_;             /*!< Last solute residue, number of molecules and first solvent molecule >*/
+            std::vector<int> atoms_per_molecule_;           /*!< Number of atoms in each molecule >*/
+            std::vector<double> box_dimensions_;            /*!< Box angle and the three box lengths >*/
             TopologyBondMap bonds_;
             TopologyAngleMap angles_;
             TopologyDihedralMap dihedrals_;
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <vector>
 #include <queue>
+#include <set>
+#include <boost/unordered_map.hpp>
 
 #include "../GeometryTopology/coordinate.hpp"
 #include "../GeometryTopology/plane.hpp"
@@ -29,11 +31,23 @@
 #include "../Glycan/oligosaccharide.hpp"
 #include "../Glycan/note.hpp"
 #include "../InputSet/CondensedSequenceSpace/condensedsequence.hpp"
+#include "assemblystorage.hpp"
+#include "identity.hpp"
+#include "bondgraph.hpp"
+#include "solventblock.hpp"
+
+namespace GeometryTopology
+{
+    class NeighborGrid;
+    class CoordinateFrame;
+}
 
 namespace MolecularModeling
 {
     class Residue;
     class Atom;    
+    class AtomNode;
+    struct PathGraph;
     class Assembly
     {
         public:
@@ -44,8 +58,11 @@ namespace MolecularModeling
             typedef std::vector<Residue*> ResidueVector;
             typedef std::vector<Atom*> AtomVector;
             typedef std::vector<GeometryTopology::Coordinate*> CoordinateVector;
+            typedef std::vector<GeometryTopology::CoordinateFrame*> CoordinateFrameVector;
             typedef std::map<std::string, gmml::GraphSearchNodeStatus> AtomStatusMap;
             typedef std::map<std::string, Atom*> AtomIdAtomMap;
+            typedef boost::unordered_map<AtomIdentityKey, Atom*> AtomHashMap;
+            typedef boost::unordered_map<AtomIdentityKey, std::vector<int> > AtomIndexHashMap;
 //            typedef std::vector<AtomVector> AtomVectorVector;
             typedef std::map<std::string, AtomVector> CycleMap;
             typedef std::map<std::string, std::map<std::string, std::vector<std::string> > > SelectPatternMap;
@@ -79,6 +96,12 @@ namespace MolecularModeling
               */
             Assembly(std::vector<std::vector<std::string> > file_paths, std::vector<gmml::InputFileType> types);
             Assembly(Assembly* assembly);
+            /*! \fn
+              * Destructor, gives up the references of the current assembly to its storage and to the storages it shares
+              * Atoms, atom nodes, residues and coordinates are released once no other assembly shares their storage or has added
+              * one of its residues (see AddResidue)
+              */
+            ~Assembly();
 
             //////////////////////////////////////////////////////////
             //                       ACCESSOR                       //
@@ -129,6 +152,27 @@ namespace MolecularModeling
               * @return model_index_ attribute of the current object of this class
               */
             int GetModelIndex();
+            /*! \fn
+              * An accessor function in order to access to the length (along x) of the periodic box of the assembly
+              * For a truncated octahedron it is the length of the lattice vectors
+              * @return box_length_ attribute of the current object of this class, gmml::dNotSet if the assembly is not in a periodic box
+              */
+            double GetBoxLength();
+            /*! \fn
+              * An accessor function in order to access to the width (along y) of the periodic box of the assembly
+              * @return box_width_ attribute of the current object of this class
+              */
+            double GetBoxWidth();
+            /*! \fn
+              * An accessor function in order to access to the height (along z) of the periodic box of the assembly
+              * @return box_height_ attribute of the current object of this class
+              */
+            double GetBoxHeight();
+            /*! \fn
+              * An accessor function in order to access to the angle between the lattice vectors of the periodic box of the assembly
+              * @return box_angle_ attribute of the current object of this class, 90 for a rectangular box and about 109.47 for a truncated octahedron
+              */
+            double GetBoxAngle();
             /*! \fn
               * A functions that extracts all atoms of an assembly
               * @return Vector of all atoms in the current object of assembly
@@ -149,6 +193,49 @@ namespace MolecularModeling
               * @return List of all coordinates of all atoms in all residues and assemblies of an assembly
               */
             CoordinateVector GetAllCoordinates();
+            /*! \fn
+              * A function that returns the flattened list of all atoms of an assembly without copying it
+              * The list is owned by the assembly and is rebuilt only after the structure has changed
+              * @return Reference to the list of all atoms in the current object of assembly
+              */
+            const AtomVector& GetAllAtomsOfAssemblyView();
+            /*! \fn
+              * A function that returns the flattened list of all residues of an assembly without copying it
+              * The list is owned by the assembly and is rebuilt only after the structure has changed
+              * @return Reference to the list of all residues in the current object of assembly
+              */
+            const ResidueVector& GetAllResiduesOfAssemblyView();
+            /*! \fn
+              * A function that returns the bond graph of all atoms of an assembly in compressed sparse row form
+              * Atoms are indexed by their position in GetAllAtomsOfAssemblyView. The graph is owned by the assembly
+              * and is rebuilt only after atoms have been added or removed or a bond of any atom has changed
+              * @return Pointer to the bond graph of the current object of assembly
+              */
+            BondGraph* GetBondGraph();
+            /*! \fn
+              * A function that returns the coordinates of all atoms of an assembly without copying them
+              * The list is owned by the assembly and is rebuilt only after the structure or the model index has changed
+              * @return Reference to the list of all coordinates in the current object of assembly, empty if any atom has no coordinate
+              */
+            const CoordinateVector& GetAllCoordinatesView();
+            /*! \fn
+              * An accessor function in order to access to the contiguous coordinate storage of a model
+              * @param model_index Index of the model
+              * @return The frame that holds the coordinates of the given model allocated by this assembly, NULL if there is none
+              */
+            GeometryTopology::CoordinateFrame* GetCoordinateFrame(int model_index);
+            /*! \fn
+              * An accessor function in order to access to the number of coordinate frames (models) of the storage of the assembly
+              * @return Number of frames that the assembly has allocated coordinates in
+              */
+            int GetNumberOfCoordinateFrames();
+            /*! \fn
+              * An accessor function in order to access to the compact solvent of the assembly
+              * Solvent added by AddSolvent is kept in the block until the residues or atoms of the assembly are asked for;
+              * the PDB, topology and coordinate builders write it from the block directly
+              * @return Pointer to the solvent block of the current object of this class
+              */
+            SolventBlock* GetSolventBlock();
             /*! \fn
               * A function to return all issues/notes within an assembly
               * @return List of all notes of an assembly
@@ -180,12 +267,15 @@ namespace MolecularModeling
             /*! \fn
               * A mutator function in order to set the residues of the current object
               * Set the residues_ attribute of the current assembly
+              * The current assembly retains the storages of the given residues, as AddResidue does
               * @param residues The residues attribute of the current object
               */
             void SetResidues(ResidueVector residues);
             /*! \fn
               * A function in order to add the residue to the current object
               * Set the residues_ attribute of the current assembly
+              * If the residue was created by another assembly, the current assembly takes a reference to that assembly's storage,
+              * so the residue, its atoms and their coordinates stay alive after the other assembly is cleared or destroyed
               * @param residue The residue of the current object
               */
             void AddResidue(Residue* residue);
@@ -226,6 +316,15 @@ namespace MolecularModeling
               * @param model_index The target model index attribute of the current object
               */
             void SetModelIndex(int model_index);
+            /*! \fn
+              * A mutator function in order to set the dimensions of the periodic box of the current object
+              * Set the box_length_, box_width_, box_height_ and box_angle_ attributes of the current assembly
+              * @param box_length The length of the box (gmml::dNotSet to remove the box)
+              * @param box_width The width of the box
+              * @param box_height The height of the box
+              * @param box_angle The angle between the lattice vectors of the box
+              */
+            void SetBoxDimensions(double box_length, double box_width, double box_height, double box_angle);
             /*! \fn
               * A mutator function in order to set the list of notes of the current object
               * Set the notes_ attribute of the current assembly
@@ -262,6 +361,15 @@ namespace MolecularModeling
             void SetOmegaDerivativeTorsion(Residue* residue, Residue* parent_residue, int branch_index, double torsion);
             void SetDihedral(Atom* atom1, Atom* atom2, Atom* atom3, Atom* atom4, double torsion);
             void SetAngle(Atom* atom1, Atom* atom2, Atom* atom3, double angle);
+            /*! \fn
+              * A function to find the atoms that move when the bond, angle or torsion between a fixed atom and a moving atom is changed
+              * The moving set is looked up in the bond graph of the assembly, where it is cached per bond until the bonds change.
+              * Atoms that are not part of the assembly fall back to Atom::FindConnectedAtoms.
+              * @param fixed_atom The atom that stays in place
+              * @param moving_atom The atom on the moving side
+              * @return All atoms that can be reached from moving_atom without passing through fixed_atom, starting with moving_atom
+              */
+            AtomVector GetMovingAtoms(Atom* fixed_atom, Atom* moving_atom);
             /*! \fn
               * A function to build a structure from a single pdb file
               * Imports data from pdb file data structure into central data structure
@@ -508,6 +616,8 @@ namespace MolecularModeling
             void BuildStructure(gmml::BuildingStructureOption building_option, std::vector<std::string> options, std::vector<std::string> file_paths);
             /*! \fn
               * A function to build a graph structure for the current object of central data structure based on the distance between the atoms of the structure
+              * Atoms are binned into a cell list with the size of the cutoff, so each atom is only compared with the atoms of its surrounding cells
+              * @param number_of_threads Number of threads that share the atoms of the assembly
               * @param cutoff Threshold of closeness of the atoms to be considered as bonded
               * @param model_index In the case that the structure has multiple model (multiple coordinates for atoms, such as pdb) this arguments indicates the desired model index
               */
@@ -531,6 +641,12 @@ namespace MolecularModeling
               * the original file in the case that the original file is a lib file
               */
             void BuildStructureByLIBFileInformation();
+            /*! \fn
+              * A function to build a graph structure for the current object of central data structure based on the bonding information provided in
+              * a lib file that has already been read
+              * @param library_file Library file object
+              */
+            void BuildStructureByLIBFileInformation(LibraryFileSpace::LibraryFile* library_file);
             /*! \fn
               * A function to build a graph structure for the current object of central data structure based on the bonding information provided in
               * the original file in the case that the original file is a prep file
@@ -656,7 +772,68 @@ namespace MolecularModeling
             SelectPatternMap ParsePatternString(std::string pattern);
             void GetHierarchicalMapOfAssembly(HierarchicalContainmentMap& hierarchical_map, std::stringstream& index);
 
+            /*! \fn
+              * A function to remove all residues and sub-assemblies from the current assembly
+              * The references to its storages are given up as well and a new storage is started for the objects created afterwards.
+              * Residues, atoms and coordinates that the assembly created are released with the last reference to its storage, so pointers
+              * taken from e.g. GetResidues or GetAllAtomsOfAssembly are only valid afterwards if the objects were added to another assembly.
+              * Every Build* function of the assembly starts with this function.
+              */
             void ClearAssembly();
+            /*! \fn
+              * A function to take a reference to the storages of another assembly
+              * It has to be called by an assembly that keeps residues, atoms, atom nodes or coordinates created by the other one,
+              * so that they are not released when the other assembly is cleared or destroyed
+              * @param assembly The assembly that created the shared objects
+              */
+            void ShareStorage(Assembly* assembly);
+            /*! \fn
+              * A function to mark the flattened atom, residue and coordinate lists of the assembly and of the assemblies that contain it as out of date
+              * It is called by the mutators of the assembly whenever residues or assemblies are added or removed. Residue::SetAtoms, AddAtom and
+              * RemoveAtom and Atom::SetCoordinates and AddCoordinate mark the storage of the residue instead (see AssemblyStorage), so only
+              * changes to residues that were not created by an assembly have to be reported here
+              */
+            void NotifyStructureChanged();
+            /*! \fn
+              * A function to mark the bond graph of the assembly and of the assemblies that contain it as out of date
+              * It is called by the functions of the assembly that build or change bonds, once all of their threads have finished.
+              * AtomNode::SetNodeNeighbors, AddNodeNeighbor and RemoveNodeNeighbor and Atom::SetNode mark the storage of the residue of
+              * the atom instead (see AssemblyStorage), so only bond changes of atoms whose residue was not created by an assembly have to be reported here
+              */
+            void NotifyBondsChanged();
+            /*! \fn
+              * A function to allocate a coordinate of an atom in the contiguous storage (frame) of the given model
+              * Coordinates of the same model are packed next to each other in allocation order instead of being scattered on the heap
+              * @param coordinate The values of the new coordinate
+              * @param model_index Index of the model that the coordinate belongs to
+              * @return Pointer to the new coordinate, owned by the storage of the current assembly
+              */
+            GeometryTopology::Coordinate* CreateCoordinate(const GeometryTopology::Coordinate& coordinate, int model_index = 0);
+            /*! \fn
+              * A function to allocate a new atom in the storage of the current assembly
+              * The atom is owned by the storage and is released when ClearAssembly or the destructor gives up the last reference to it,
+              * so it must not be deleted by the caller; assemblies that keep it have to share the storage (see ShareStorage)
+              * @return Pointer to the new atom
+              */
+            Atom* CreateAtom();
+            /*! \fn
+              * A function to allocate a new residue in the storage of the current assembly
+              * The residue is owned by the storage, in the same way as the atoms of CreateAtom
+              * @return Pointer to the new residue
+              */
+            Residue* CreateResidue();
+            /*! \fn
+              * A function to allocate a new atom node in the storage of the current assembly
+              * The node is owned by the storage, in the same way as the atoms of CreateAtom
+              * @return Pointer to the new atom node
+              */
+            AtomNode* CreateAtomNode();
+            /*! \fn
+              * A function to turn the molecules of the solvent block into full residues, atoms and atom nodes of the current assembly
+              * The residues are appended after the other residues of the assembly and the block is emptied. The accessors and mutators
+              * of residues and atoms call it, so the solvent is only expanded when a caller needs its atoms.
+              */
+            void ExpandSolventBlock();
 
 //            void CycleDetection();
 //            std::vector<std::vector<std::string> > CreateAllCyclePermutations(std::string id1, std::string id2, std::string id3, std::string id4, std::string id5, std::string id6);
@@ -700,9 +877,12 @@ namespace MolecularModeling
             * @param amino_lib_files The list of paths to amino library files, used for identifying terminal residues
             * @param gyprobity_report A flag to prompt information for glyprobity report
             * @param populate_ontology A flag to prompt ontology population
+            * @param number_of_threads Number of threads that share the analysis of the rings (side groups, chemical code, derivatives, names).
+            *        The results and the printed report are merged in the order of the rings, so they do not depend on the number of threads.
             * @return oligosaccharides A list of extarcted oligosaccharide structures
             */
-            OligosaccharideVector ExtractSugars(std::vector<std::string> amino_lib_files, bool glyporbity_report = false, bool populate_ontology = false);
+            OligosaccharideVector ExtractSugars(std::vector<std::string> amino_lib_files, bool glyporbity_report = false, bool populate_ontology = false,
+                                                int number_of_threads = 1);
             /*! \fn
             * A function in order to detec the shape of the ring using the external BFMP program
             * This function creates a pdb file and a configuration file for input arguments of the external detect_shape program.
@@ -1072,55 +1252,73 @@ namespace MolecularModeling
             /*! \fn
               * A function in order to detect cycles in the molecular graph using the exhaustive ring perception algorithm
               * The algorithm is derived from http://pubs.acs.org/doi/pdf/10.1021/ci960322f
+              * The search can be bounded, walks that are longer than the largest ring are dropped while the path graph is reduced and ring
+              * systems without any of the required elements are pruned before the search
+              * @param maximum_ring_size Largest number of atoms of a reported ring, 0 for the default of rings up to six atoms without pruning
+              * @param required_elements Ring systems (connected parts of the pruned graph) that have none of these elements are not searched
               * @return cycles A map between the string version of atoms of cycles and the list of cycle atom objects
               */
-            CycleMap DetectCyclesByExhaustiveRingPerception();
+            CycleMap DetectCyclesByExhaustiveRingPerception(int maximum_ring_size = 0, std::vector<std::string> required_elements = std::vector<std::string>());
             /*! \fn
               * A function in order to prune the graph (recursively removing nodes with zero or 1 neighbors)
-              * @param all_atoms The list of atoms of the graph which is going to be updated by the function
+              * Atoms are peeled off one at a time by their number of neighbors within the graph, on integer indices of a BondGraph
+              * @param all_atoms The list of atoms of the graph which is going to be updated by the function, the remaining atoms keep their order
               */
             void PruneGraph(AtomVector& all_atoms);
+            /*! \fn
+              * A function in order to prune the ring systems (connected parts of a pruned graph) that have none of the given elements
+              * The element of an atom is its element symbol, or the first letter of its name if the symbol is not set
+              * @param atoms The list of atoms of the graph which is going to be updated by the function, the remaining atoms keep their order
+              * @param required_elements The elements of which a ring system needs at least one atom
+              */
+            void PruneRingSystems(AtomVector& atoms, std::vector<std::string> required_elements);
             /*! \fn
               * A function in order to convert the graph into a path graph (creating list of edges between the nodes and a list of labels for those edges )
-              * @param path_graph_edges The list of edges between the nodes to be filled by the function
-              * @param path_graph_labels The list of edge labels to be filled by the function
+              * The nodes of the path graph are the positions of the atoms in the given list
+              * @param path_graph The path graph to be filled by the function
               * @param atoms The list of atoms of the graph
               */
-            void ConvertIntoPathGraph(std::vector<std::string>& path_graph_edges, std::vector<std::string>& path_graph_labels, AtomVector atoms);
+            void ConvertIntoPathGraph(PathGraph& path_graph, AtomVector atoms);
             /*! \fn
               * A function in order to reduce the path graph such that if there is a path/walk a-b-c in the graph converting it to a-c and creating a new label
                     for the new edge and checking if the new edge makes a cycle
-              * @param path_graph_edges The list of edges between the nodes
-              * @param path_graph_labels The list of edge labels
-              * @param reduced_path_graph_edges The list of edges of the (reduced) path graph
-              * @param reduced_path_graph_labels The list of edge labels of the (reduced) path graph
-              * @param common_atom The atom that needs to be checked if it is involved in a walk (a path like a-b-c)
-              * @param cycles The list of cycles to be filled by the function
-              */
-            void ReducePathGraph(std::vector<std::string> path_graph_edges, std::vector<std::string> path_graph_labels,
-                                 std::vector<std::string>& reduced_path_graph_edges, std::vector<std::string>& reduced_path_graph_labels, std::string common_atom, std::vector<std::string>& cycles);
+              * The walks are formed from the edges of the common atom only, which are found through its list of incident edges
+              * New edges whose label has more atoms than the maximum ring size of the path graph are dropped
+              * @param path_graph The path graph to be reduced
+              * @param common_atom Index of the atom that needs to be checked if it is involved in a walk (a path like a-b-c)
+              * @param cycles The list of cycles (labels of edges a,a) to be filled by the function
+              */
+            void ReducePathGraph(PathGraph& path_graph, int common_atom, std::vector<std::vector<int> >& cycles);
 
             /*! \fn
               * A function in order to detect cycles in the molecular graph using depth first search algorithm
+              * The search runs over the integer indices of a BondGraph of the atoms, bonds to atoms that are not heterogens are not followed
               * @return cycles A map between the string version of atoms of cycles and the list of cycle atom objects
               */
             CycleMap DetectCyclesByDFS();
             /*! \fn
-              * A function of depth first search algorithm in order to traverse the graph
-              * @param path_graph_edges The list of edges between the nodes to be filled by the function
-              * @param path_graph_labels The list of edge labels to be filled by the function
-              * @param atoms The list of atoms of the graph
-              */
-            void DFSVisit(AtomVector atoms, AtomStatusMap& atom_status_map, AtomIdAtomMap& atom_parent_map, Atom* atom, int& counter, AtomIdAtomMap& dest_srd_map);
-            /*! \fn
-              * A recursive function in order to back track a path from current atom to a source atom to return the atom objects using the information extracted by the DFS algorithm
-              * @param src_id The identifier of the source atom
-              * @param current_atom The current atom that the function has been called on
-              * @param atom_parent_map A map between atom identifier and its parent atom object
+              * A function of depth first search algorithm in order to traverse the graph from a root atom
+              * The search is iterative with an explicit stack, so it does not depend on the depth of the graph
+              * @param graph The bond graph of the atoms
+              * @param atom_statuses The search status of each atom of the graph
+              * @param atom_parents The index of the atom from which each atom has been reached, -1 for the roots
+              * @param root Index of the atom to start from
+              * @param counter The number of back edges (cycles) found so far
+              * @param back_edges The back edges found so far as (source, destination), the source is an ancestor of the destination
+              */
+            void DFSVisit(BondGraph& graph, std::vector<gmml::GraphSearchNodeStatus>& atom_statuses, std::vector<int>& atom_parents, int root, int& counter,
+                          std::vector<std::pair<int, int> >& back_edges);
+            /*! \fn
+              * A function in order to back track a path from current atom to a source atom to return the atom objects using the information extracted by the DFS algorithm
+              * @param src_index Index of the source atom
+              * @param current_index Index of the atom to start from, the destination of the back edge
+              * @param atom_parents The index of the atom from which each atom has been reached
+              * @param atoms The atoms of the graph
               * @param cycle The list of atom objects involved in a cycle
-              * @param cycle_stream The cycle path that has been back traversed so far
+              * @param cycle_stream The cycle path that has been back traversed
               */
-            void ReturnCycleAtoms(std::string src_id, Atom* current_atom, AtomIdAtomMap& atom_parent_map, AtomVector& cycle, std::stringstream& cycle_stream);
+            void ReturnCycleAtoms(int src_index, int current_index, std::vector<int>& atom_parents, const AtomVector& atoms, AtomVector& cycle,
+                                  std::stringstream& cycle_stream);
             /*! \fn
               * A function in order to discard rings/cycles that are only made from carbons atoms
               * @param cycles A map between the string version of atoms of cycles and the list of cycle atom objects
@@ -1351,8 +1549,64 @@ namespace MolecularModeling
               */
             std::string CheckxCOO(Atom* target, std::string cycle_atoms_str, AtomVector& pattern_atoms);
 
-            void AddIon(std::string ion_name, std::string lib_file, std::string parameter_file, int ion_count = 0);
-            void AddSolvent(double extension, double closeness, std::string lib_file);
+            /*! \fn
+              * A function in order to place ions of one kind around the current assembly at the positions with the best electrostatic potential energy
+              * The grid of candidate positions is built once and only the contribution of each placed ion is added to it afterwards.
+              * The cells of the grid are ranked by potential energy, so the best positions are taken from the front of the ranking; with a
+              * cutoff only the cells around each placed ion are re-ranked. Ties within THRESHOLD are broken at random.
+              * @param ion_name Name of the ion residue in the lib file
+              * @param lib_file Path to a lib file that contains the ion
+              * @param parameter_file Path to a parameter file with the radius of the ion
+              * @param ion_count Number of ions to place, 0 to neutralize the assembly
+              * @param number_of_threads Number of threads that share the cells of the grid
+              * @param cutoff Atoms farther than this from a cell are left out of its potential energy, 0 for no cutoff
+              * @param screening_length Debye length of a screened q * exp(-r / screening_length) / r potential, 0 for no screening
+              * @param minimum_solute_distance Minimum distance between an ion and the atoms that were in the assembly before the call
+              * @param minimum_ion_distance Minimum distance between the ions that are placed by the call
+              * @param seed Seed of the random choice between equally good positions, a negative seed uses rand()
+              */
+            void AddIon(std::string ion_name, std::string lib_file, std::string parameter_file, int ion_count = 0, int number_of_threads = 1,
+                        double cutoff = 0.0, double screening_length = 0.0, double minimum_solute_distance = 0.0, double minimum_ion_distance = 0.0,
+                        int seed = -1);
+            /*! \fn
+              * A function in order to fill a cube, a truncated octahedron or a shell around the current assembly with copies of a solvent box
+              * The solvent box is read and bonded once; its coordinates are used as a template that is translated into each copy.
+              * Solvent molecules that are outside the shape or within closeness of a solute atom are left out; the solute atoms are
+              * binned into a grid with cells as large as closeness, so each solvent atom is only compared to the solute atoms nearby.
+              * The dimensions of the resulting periodic box are recorded in the assembly (see GetBoxLength); a shell is not periodic.
+              * The kept molecules are stored in the solvent block of the assembly (see GetSolventBlock) and get atoms only when they are needed.
+              * All molecules of the solvent box must have the atoms of its first molecule, otherwise an error is reported and nothing is added.
+              * @param extension Distance between the solute and the faces of the box, or the thickness of the shell
+              * @param closeness Minimum distance between solvent and solute atoms
+              * @param lib_file Path to a lib file with the solvent box as its first residue
+              * @param number_of_threads Number of threads that share the copies of the solvent box
+              * @param shape Shape of the solvent around the solute
+              */
+            void AddSolvent(double extension, double closeness, std::string lib_file, int number_of_threads = 1,
+                            gmml::SolventShape shape = gmml::SOLVENT_BOX);
+            /*! \fn
+              * A function in order to add a salt of a cation and an anion at a molar concentration and set the net charge of the assembly
+              * The number of formula units is concentration / WATER_MOLARITY times the number of molecules of the solvent block, or the
+              * concentration times the volume of the periodic box if there is no solvent block; the ions for the net charge come on top.
+              * Both kinds of ions are placed from one ranked grid (see AddIon), the cations at the lowest and the anions at the highest
+              * potential energy; or the solvent molecules with the best potential energy from the solute and the placed ions are replaced.
+              * @param cation_name Name of the cation residue in the lib file
+              * @param anion_name Name of the anion residue in the lib file
+              * @param lib_file Path to a lib file that contains the ions
+              * @param parameter_file Path to a parameter file with the radii of the ions
+              * @param concentration Concentration of the salt in mol/L
+              * @param net_charge Total charge of the assembly after the ions have been added
+              * @param replace_solvent Put the ions at the first sites of solvent molecules of the solvent block and remove those molecules
+              * @param number_of_threads Number of threads that share the cells of the grid
+              * @param cutoff Atoms farther than this from a site are left out of its potential energy, 0 for no cutoff
+              * @param screening_length Debye length of a screened q * exp(-r / screening_length) / r potential, 0 for no screening
+              * @param minimum_solute_distance Minimum distance between an ion and the atoms that were in the assembly before the call
+              * @param minimum_ion_distance Minimum distance between the ions that are placed by the call
+              * @param seed Seed of the random choice between equally good sites, a negative seed uses rand()
+              */
+            void AddSalt(std::string cation_name, std::string anion_name, std::string lib_file, std::string parameter_file, double concentration,
+                         double net_charge = 0.0, bool replace_solvent = false, int number_of_threads = 1, double cutoff = 0.0,
+                         double screening_length = 0.0, double minimum_solute_distance = 0.0, double minimum_ion_distance = 0.0, int seed = -1);
             void SplitSolvent(Assembly* solvent, Assembly* solute);
             void SplitIons(Assembly* assembly, ResidueVector ions);
 
@@ -1364,10 +1618,13 @@ namespace MolecularModeling
             void GetBoundary(GeometryTopology::Coordinate* lower_left_back_corner, GeometryTopology::Coordinate* upper_right_front_corner);
             /*! \fn
               * A function in order to calculate the surface area of overlap between atoms of two assemblies
+              * The atoms of the larger assembly are binned into a grid, so each atom of the smaller one is only compared to the atoms nearby
               * @param assemblyB is the second assembly. Overlaps between atoms of the same assembly are not counted
+              * @param number_of_threads Number of threads that share the atoms of the smaller assembly
+              * @param model_index Index of the model (coordinate set) of both assemblies that is used
               * @return Total overlap between assemblies, relative to the surface area of a buried C atom.
               */
-            double CalculateAtomicOverlaps(Assembly *assemblyB);
+            double CalculateAtomicOverlaps(Assembly *assemblyB, int number_of_threads = 1, int model_index = 0);
 
 
             //////////////////////////////////////////////////////////
@@ -1402,6 +1659,103 @@ namespace MolecularModeling
             gmml::InputFileType source_file_type_;          /*!< Type of the file that the current assembly has been built upon >*/
             int model_index_;                               /*!< In case that there are more than one models for an assembly, this attribute indicated which model is the target model >*/
             NoteVector notes_;                              /*!< A list of note instances from the Note struct in Glycan name space which is used for representing the potential issues within a structure >*/
+            double box_length_;                             /*!< Length of the periodic box of the assembly, e.g. after solvation; gmml::dNotSet if there is no box >*/
+            double box_width_;                              /*!< Width of the periodic box of the assembly >*/
+            double box_height_;                             /*!< Height of the periodic box of the assembly >*/
+            double box_angle_;                              /*!< Angle between the lattice vectors of the periodic box of the assembly >*/
+
+            /*! \fn
+              * A function that returns the latest revision of the assembly, its storages and its sub-assemblies
+              * @return The largest structure_revision_ of the assembly, of the storages it holds and of its sub-assemblies
+              */
+            unsigned long GetStructureRevision();
+            /*! \fn
+              * A function that returns the latest bond revision of the assembly, its storages and its sub-assemblies
+              * @return The largest bond_revision_ of the assembly, of the storages it holds and of its sub-assemblies
+              */
+            unsigned long GetBondRevision();
+            /*! \fn
+              * A function that rebuilds the flattened atom and residue lists if the structure has changed since they were built
+              * It rewrites all_atoms_ and all_residues_ without a lock, so it must not run while other threads read them. Functions that
+              * start threads build the views first, and their workers must not change residues, atoms or coordinates of the assembly.
+              */
+            void UpdateViews();
+            /*! \fn
+              * A function that rebuilds the bond graph from the flattened atom list if atoms or bonds have changed since it was built
+              * Unlike GetBondGraph it does not expand the solvent block
+              */
+            void UpdateBondGraph();
+            /*! \fn
+              * A function that rebuilds the flattened coordinate list if the structure or the model index has changed since it was built
+              * Unlike GetAllCoordinatesView it does not expand the solvent block
+              */
+            void UpdateCoordinatesView();
+            /*! \fn
+              * A function that counts something in all molecules of the solvent block by counting it in one of them
+              * @param count_function The counting function of an assembly, e.g. &Assembly::CountNumberOfBondsIncludingHydrogen
+              * @param parameter_file_path Path to the parameter file that is passed on to the counting function
+              * @return The count of one solvent molecule times the number of molecules of the block
+              */
+            int CountNumberInSolventBlock(int (Assembly::*count_function)(std::string), std::string parameter_file_path);
+            /*! \fn
+              * A function that returns the atoms of the assembly without expanding the solvent block, followed by the atoms of one
+              * molecule of the block if there is any; every atom type (and bond, angle or dihedral type) of the assembly occurs in this list
+              * @param solvent_molecule Empty assembly that the molecule of the block is built into
+              * @return List of atoms
+              */
+            AtomVector GetAllAtomsOfAssemblyWithSolventMolecule(Assembly* solvent_molecule);
+            /*! \fn
+              * A function that adds an ion of a library file to the assembly as a new residue with one atom
+              * The ion is added with AddResidue, which expands the solvent block first, so the ions come after the water residues
+              * @param lib_ion_residue The residue of the ion in the library file
+              * @param ion_name Name of the atom of the ion
+              * @param ion_mass Mass of the ion
+              * @param ion_radius Radius of the ion
+              * @param position Position of the ion
+              * @param ion_index Number of ions of this kind that have been placed before it in the same call; it gives the ids
+              * @return The atom of the new ion
+              */
+            Atom* AddIonResidue(LibraryFileSpace::LibraryFileResidue* lib_ion_residue, std::string ion_name, double ion_mass, double ion_radius,
+                                GeometryTopology::Coordinate position, int ion_index);
+
+            unsigned long structure_revision_;              /*!< Revision of the last change of the residues or sub-assemblies of this assembly >*/
+            unsigned long views_revision_;                  /*!< Value of GetStructureRevision() when all_atoms_ and all_residues_ were built >*/
+            unsigned long coordinates_revision_;            /*!< Value of GetStructureRevision() when all_coordinates_ was built >*/
+            int coordinates_model_index_;                   /*!< Model index that all_coordinates_ has been built for >*/
+            AtomVector all_atoms_;                          /*!< Flattened list of all atoms of the assembly and its sub-assemblies >*/
+            ResidueVector all_residues_;                    /*!< Flattened list of all residues of the assembly and its sub-assemblies >*/
+            CoordinateVector all_coordinates_;              /*!< Flattened list of all coordinates of the assembly and its sub-assemblies >*/
+            BondGraph bond_graph_;                          /*!< Bond graph of all atoms of the assembly and its sub-assemblies >*/
+            unsigned long bond_graph_structure_revision_;   /*!< Value of GetStructureRevision() when bond_graph_ was built >*/
+            unsigned long bond_revision_;                   /*!< Revision of the last change of the bonds of the atoms of this assembly >*/
+            unsigned long bond_graph_bond_revision_;        /*!< Value of GetBondRevision() when bond_graph_ was built >*/
+            AssemblyStorage* storage_;                      /*!< Storage of the atoms, residues, atom nodes and coordinates created by this assembly >*/
+            std::vector<AssemblyStorage*> shared_storages_; /*!< Storages of other assemblies whose objects this assembly keeps >*/
+            SolventBlock solvent_block_;                    /*!< Solvent molecules that have not been expanded into atoms yet >*/
+
+            /*! \fn
+              * A function that gives up the references of the current assembly to its own and its shared storages
+              */
+            void ReleaseStorages();
+            /*! \fn
+              * A function that takes a reference to a storage whose objects the current assembly keeps, unless it already holds one
+              * @param storage The storage to retain; NULL (objects that were not created by an assembly) is ignored
+              */
+            void RetainStorage(AssemblyStorage* storage);
+            /*! \fn
+              * Assemblies hold references to their storages and can not be copied; use Assembly(Assembly*) for a copy
+              */
+            Assembly(const Assembly& assembly);
+            Assembly& operator=(const Assembly& assembly);
+            /*! \fn
+              * A function that applies a 3x4 transformation to the coordinates (of the current model) of the atoms that move
+              * together with moving_atom when the bond between fixed_atom and moving_atom is changed
+              * The moving set comes from the cache of the bond graph, so no memory is allocated for atoms of the assembly
+              * @param fixed_atom The atom that stays in place
+              * @param moving_atom The atom on the moving side
+              * @param matrix The transformation matrix, e.g. one filled by gmml::GenerateRotationMatrix
+              */
+            void TransformMovingAtoms(Atom* fixed_atom, Atom* moving_atom, const double matrix[3][4]);
     };
 
     struct DistanceCalculationThreadArgument{
@@ -1410,6 +1764,9 @@ namespace MolecularModeling
             int model_index;
             double cutoff;
             Assembly* a;
+            std::vector<Atom*>* atoms;
+            GeometryTopology::NeighborGrid* grid;
+            std::vector<std::pair<int, int> >* edges;
             DistanceCalculationThreadArgument()
             {
                 thread_index = 0;
@@ -1417,6 +1774,9 @@ namespace MolecularModeling
                 model_index = 0;
                 cutoff = gmml::dCutOff;
                 a = NULL;
+                atoms = NULL;
+                grid = NULL;
+                edges = NULL;
             }
 
             DistanceCalculationThreadArgument(int ti, int tn, int mi, double c, Assembly* assembly)
@@ -1426,6 +1786,22 @@ namespace MolecularModeling
                 model_index = mi;
                 cutoff = c;
                 a = assembly;
+                atoms = NULL;
+                grid = NULL;
+                edges = NULL;
+            }
+
+            DistanceCalculationThreadArgument(int ti, int tn, int mi, double c, Assembly* assembly, std::vector<Atom*>* as, GeometryTopology::NeighborGrid* g,
+                                              std::vector<std::pair<int, int> >* e)
+            {
+                thread_index = ti;
+                number_of_threads = tn;
+                model_index = mi;
+                cutoff = c;
+                a = assembly;
+                atoms = as;
+                grid = g;
+                edges = e;
             }
     };
 
@@ -1455,6 +1831,203 @@ namespace MolecularModeling
             }
     };
 
+    struct OverlapCalculationThreadArgument{
+            int thread_index;
+            int number_of_threads;
+            bool query_is_first;
+            std::vector<GeometryTopology::Coordinate*>* query_coordinates;
+            std::vector<double>* query_radii;
+            std::vector<GeometryTopology::Coordinate*>* grid_coordinates;
+            std::vector<double>* grid_radii;
+            GeometryTopology::NeighborGrid* grid;
+            double overlap;
+
+            OverlapCalculationThreadArgument()
+            {
+                thread_index = 0;
+                number_of_threads = 1;
+                query_is_first = true;
+                query_coordinates = NULL;
+                query_radii = NULL;
+                grid_coordinates = NULL;
+                grid_radii = NULL;
+                grid = NULL;
+                overlap = 0.0;
+            }
+
+            OverlapCalculationThreadArgument(int ti, int tn, bool qf, std::vector<GeometryTopology::Coordinate*>* qc, std::vector<double>* qr,
+                                             std::vector<GeometryTopology::Coordinate*>* gc, std::vector<double>* gr, GeometryTopology::NeighborGrid* g)
+            {
+                thread_index = ti;
+                number_of_threads = tn;
+                query_is_first = qf;
+                query_coordinates = qc;
+                query_radii = qr;
+                grid_coordinates = gc;
+                grid_radii = gr;
+                grid = g;
+                overlap = 0.0;
+            }
+    };
+
+    struct SolventBoxThreadArgument{
+            int thread_index;
+            int number_of_threads;
+            double closeness;
+            std::vector<std::vector<int> >* solvent_molecules;
+            std::vector<GeometryTopology::Coordinate>* solvent_coordinates;
+            std::vector<GeometryTopology::Coordinate>* box_shifts;
+            GeometryTopology::NeighborGrid* solute_grid;
+            GeometryTopology::Coordinate* solvent_box_max_boundary;
+            std::vector<std::vector<bool> >* removed_molecules;
+            gmml::SolventShape shape;
+            GeometryTopology::Coordinate* center;
+            double octahedron_limit;
+            GeometryTopology::NeighborGrid* shell_grid;
+            double shell_distance;
+
+            SolventBoxThreadArgument()
+            {
+                thread_index = 0;
+                number_of_threads = 1;
+                closeness = 0.0;
+                solvent_molecules = NULL;
+                solvent_coordinates = NULL;
+                box_shifts = NULL;
+                solute_grid = NULL;
+                solvent_box_max_boundary = NULL;
+                removed_molecules = NULL;
+                shape = gmml::SOLVENT_BOX;
+                center = NULL;
+                octahedron_limit = 0.0;
+                shell_grid = NULL;
+                shell_distance = 0.0;
+            }
+
+            SolventBoxThreadArgument(int ti, int tn, double c, std::vector<std::vector<int> >* sm, std::vector<GeometryTopology::Coordinate>* sc,
+                                     std::vector<GeometryTopology::Coordinate>* bs, GeometryTopology::NeighborGrid* sg, GeometryTopology::Coordinate* sbmax,
+                                     std::vector<std::vector<bool> >* rm, gmml::SolventShape s, GeometryTopology::Coordinate* ce, double ol,
+                                     GeometryTopology::NeighborGrid* shg, double sd)
+            {
+                thread_index = ti;
+                number_of_threads = tn;
+                closeness = c;
+                solvent_molecules = sm;
+                solvent_coordinates = sc;
+                box_shifts = bs;
+                solute_grid = sg;
+                solvent_box_max_boundary = sbmax;
+                removed_molecules = rm;
+                shape = s;
+                center = ce;
+                octahedron_limit = ol;
+                shell_grid = shg;
+                shell_distance = sd;
+            }
+    };
+
+    struct MonosaccharideThreadArgument{
+            int thread_index;
+            int number_of_threads;
+            Assembly* assembly;
+            std::vector<Glycan::Monosaccharide*>* monos;
+            std::vector<std::string>* ring_reports;
+            std::vector<Assembly::AtomVector>* plus_sides;
+            std::vector<std::string>* derivative_reports;
+            std::vector<std::string>* complex_reports;
+
+            MonosaccharideThreadArgument()
+            {
+                thread_index = 0;
+                number_of_threads = 1;
+                assembly = NULL;
+                monos = NULL;
+                ring_reports = NULL;
+                plus_sides = NULL;
+                derivative_reports = NULL;
+                complex_reports = NULL;
+            }
+
+            MonosaccharideThreadArgument(int ti, int tn, Assembly* a, std::vector<Glycan::Monosaccharide*>* ms, std::vector<std::string>* rr,
+                                         std::vector<Assembly::AtomVector>* ps, std::vector<std::string>* dr, std::vector<std::string>* cr)
+            {
+                thread_index = ti;
+                number_of_threads = tn;
+                assembly = a;
+                monos = ms;
+                ring_reports = rr;
+                plus_sides = ps;
+                derivative_reports = dr;
+                complex_reports = cr;
+            }
+    };
+
+    /*! \struct
+      * The path graph of the exhaustive ring perception on integer atom indices
+      * Edges are never moved once they are created, so an edge is known by its position. Removed edges are only marked as not alive.
+      */
+    struct PathGraph
+    {
+        public:
+            PathGraph()
+            {
+                number_of_alive_edges = 0;
+                maximum_ring_size = 0;
+            }
+
+            PathGraph(int number_of_atoms, int max_ring_size = 0)
+            {
+                number_of_alive_edges = 0;
+                maximum_ring_size = max_ring_size;
+                incident_edges = std::vector<std::vector<int> >(number_of_atoms);
+                degrees = std::vector<int>(number_of_atoms, 0);
+            }
+
+            /*! \fn
+              * A function in order to add an edge to the path graph
+              * @param source Index of the first atom of the edge
+              * @param target Index of the last atom of the edge
+              * @param label The atoms of the walk from source to target
+              */
+            void AddEdge(int source, int target, std::vector<int> label)
+            {
+                int edge = edges.size();
+                edges.push_back(std::make_pair(source, target));
+                labels.push_back(label);
+                alive.push_back(true);
+                alive_labels.insert(label);
+                incident_edges.at(source).push_back(edge);
+                incident_edges.at(target).push_back(edge);
+                degrees.at(source)++;
+                degrees.at(target)++;
+                number_of_alive_edges++;
+            }
+
+            /*! \fn
+              * A function in order to remove an edge from the path graph
+              * @param edge Position of the edge
+              */
+            void RemoveEdge(int edge)
+            {
+                if(!alive.at(edge))
+                    return;
+                alive.at(edge) = false;
+                alive_labels.erase(labels.at(edge));
+                degrees.at(edges.at(edge).first)--;
+                degrees.at(edges.at(edge).second)--;
+                number_of_alive_edges--;
+            }
+
+            std::vector<std::pair<int, int> > edges;            /*!< Source and target atom of each edge >*/
+            std::vector<std::vector<int> > labels;              /*!< Atoms of the walk of each edge, from source to target >*/
+            std::vector<bool> alive;                            /*!< Whether each edge is still in the graph >*/
+            std::set<std::vector<int> > alive_labels;           /*!< Labels of the edges that are still in the graph >*/
+            std::vector<std::vector<int> > incident_edges;      /*!< Edges of each atom in the order they were created, including removed ones >*/
+            std::vector<int> degrees;                           /*!< Number of edges of each atom that are still in the graph >*/
+            int number_of_alive_edges;
+            int maximum_ring_size;                              /*!< Edges and cycles with more atoms than this are dropped, 0 for no limit >*/
+    };
+
     struct BacktrackingElements
     {
         public:
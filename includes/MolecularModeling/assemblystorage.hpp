@@ -0,0 +1,144 @@
+#ifndef ASSEMBLYSTORAGE_HPP
+#define ASSEMBLYSTORAGE_HPP
+
+#include <vector>
+#include "objectpool.hpp"
+
+namespace GeometryTopology
+{
+    class Coordinate;
+    class CoordinateFrame;
+}
+
+namespace MolecularModeling
+{
+    class Atom;
+    class Residue;
+    class AtomNode;
+    /*! \class
+      * Reference counted storage of the atoms, residues, atom nodes and coordinates created by an assembly
+      * The assembly that creates the storage holds the first reference. Assemblies that keep objects of another assembly
+      * take a reference to its storage, either implicitly when a residue of the storage is added to them (Assembly::AddResidue)
+      * or explicitly by Assembly::ShareStorage, so the objects are released when the last of these assemblies is cleared or destroyed and not before.
+      * Retain and Release are not synchronized; assemblies are created, shared and destroyed outside of threaded sections.
+      * The storage also keeps the revisions of the last change of its residues and atoms and of the last change of their bonds.
+      * Residue, Atom and AtomNode mutators bump them, so every assembly that holds the storage sees the change, however many
+      * assemblies the residue has been added to.
+      */
+    class AssemblyStorage
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<GeometryTopology::CoordinateFrame*> CoordinateFrameVector;
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor, an empty storage with one reference held by the caller
+              */
+            AssemblyStorage();
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * An accessor function in order to access to the contiguous coordinate storage of a model
+              * @param model_index Index of the model
+              * @return The frame that holds the coordinates of the given model, NULL if there is none
+              */
+            GeometryTopology::CoordinateFrame* GetCoordinateFrame(int model_index);
+            /*! \fn
+              * An accessor function in order to access to the number of coordinate frames (models) of the storage
+              * @return Size of the coordinate_frames_ attribute of the current object of this class
+              */
+            int GetNumberOfCoordinateFrames();
+            /*! \fn
+              * An accessor function in order to access to the revision of the last change of the atoms of a residue or the coordinates of an atom of the storage
+              * @return structure_revision_ attribute of the current object of this class, 0 if nothing has changed since the storage was created
+              */
+            unsigned long GetStructureRevision();
+            /*! \fn
+              * An accessor function in order to access to the revision of the last change of the bonds of the atoms of the storage
+              * @return bond_revision_ attribute of the current object of this class, 0 if no bond has changed since the storage was created
+              */
+            unsigned long GetBondRevision();
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to take one more reference to the storage
+              */
+            void Retain();
+            /*! \fn
+              * A function in order to give up a reference to the storage
+              * The storage and all objects in it are released when the last reference is given up
+              */
+            void Release();
+            /*! \fn
+              * A function that returns a new revision, larger than all revisions handed out before
+              * Revisions of all assemblies and storages come from this one counter; it can be called from any thread
+              * @return The new revision
+              */
+            static unsigned long NextRevision();
+            /*! \fn
+              * A function to mark the atoms of the residues or the coordinates of the atoms of the storage as changed
+              * It is called by the Residue and Atom mutators and can be called from any thread
+              */
+            void NotifyStructureChanged();
+            /*! \fn
+              * A function to mark the bonds of the atoms of the storage as changed
+              * It is called by the AtomNode mutators and Atom::SetNode and can be called from any thread
+              */
+            void NotifyBondsChanged();
+            /*! \fn
+              * A function to allocate a coordinate in the frame of the given model, right after the previous coordinate of the model
+              * @param coordinate The values of the new coordinate
+              * @param model_index Index of the model that the coordinate belongs to
+              * @return Pointer to the new coordinate
+              */
+            GeometryTopology::Coordinate* CreateCoordinate(const GeometryTopology::Coordinate& coordinate, int model_index);
+            /*! \fn
+              * A function to allocate a new atom in the atom pool
+              * @return Pointer to the new atom
+              */
+            Atom* CreateAtom();
+            /*! \fn
+              * A function to allocate a new residue in the residue pool
+              * @return Pointer to the new residue
+              */
+            Residue* CreateResidue();
+            /*! \fn
+              * A function to allocate a new atom node in the node pool
+              * @return Pointer to the new atom node
+              */
+            AtomNode* CreateAtomNode();
+
+        private:
+            /*! \fn
+              * Destructor, releases all objects of the storage; it is only called by Release
+              */
+            ~AssemblyStorage();
+            /*! \fn
+              * Storages are shared by reference and can not be copied
+              */
+            AssemblyStorage(const AssemblyStorage& storage);
+            AssemblyStorage& operator=(const AssemblyStorage& storage);
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            int reference_count_;                           /*!< Number of assemblies that hold the storage >*/
+            unsigned long structure_revision_;              /*!< Revision of the last change of the atoms of a residue or the coordinates of an atom of the storage >*/
+            unsigned long bond_revision_;                   /*!< Revision of the last change of the bonds of the atoms of the storage >*/
+            CoordinateFrameVector coordinate_frames_;       /*!< Contiguous coordinate storage, one frame per model >*/
+            ObjectPool<Atom> atom_pool_;                    /*!< Storage of the atoms >*/
+            ObjectPool<Residue> residue_pool_;              /*!< Storage of the residues >*/
+            ObjectPool<AtomNode> atom_node_pool_;           /*!< Storage of the atom nodes >*/
+    };
+}
+
+#endif // ASSEMBLYSTORAGE_HPP
@@ -7,6 +7,8 @@
 
 #include "../GeometryTopology/coordinate.hpp"
 #include "moleculardynamicatom.hpp"
+#include "symboltable.hpp"
+#include "identity.hpp"
 #include "quantommechanicatom.hpp"
 #include "dockingatom.hpp"
 
@@ -49,26 +51,52 @@ namespace MolecularModeling
               * @return name_ attribute of the current object of this class
               */
             std::string GetName();
+            /*! \fn
+              * An accessor function in order to access to the interned name
+              * @return Symbol of the name_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetNameSymbol();
             /*! \fn
               * An accessor function in order to access to the coordinates
               * @return coordinates_ attribute of the current object of this class
               */
             CoordinateVector GetCoordinates();
+            /*! \fn
+              * An accessor function in order to access to the coordinate of one model without copying the list of coordinates
+              * @param model_index Index of the model
+              * @return The coordinate of the atom in the given model
+              */
+            GeometryTopology::Coordinate* GetCoordinate(int model_index);
             /*! \fn
               * An accessor function in order to access to the chemical_type
               * @return chemical_type_ attribute of the current object of this class
               */
             std::string GetChemicalType();
+            /*! \fn
+              * An accessor function in order to access to the interned chemical type
+              * @return Symbol of the chemical_type_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetChemicalTypeSymbol();
             /*! \fn
               * An accessor function in order to access to the description
               * @return description_ attribute of the current object of this class
               */
             std::string GetDescription();
+            /*! \fn
+              * An accessor function in order to access to the interned description
+              * @return Symbol of the description_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetDescriptionSymbol();
             /*! \fn
               * An accessor function in order to access to the element symbol
               * @return element_symbol_ attribute of the current object of this class
               */
             std::string GetElementSymbol();
+            /*! \fn
+              * An accessor function in order to access to the interned element symbol
+              * @return Symbol of the element_symbol_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetElementSymbolSymbol();
             /*! \fn
               * An accessor function in order to access to the node
               * @return node_ attribute of the current object of this class
@@ -79,6 +107,16 @@ namespace MolecularModeling
               * @return id_ attribute of the current object of this class
               */
             std::string GetId();
+            /*! \fn
+              * An accessor function in order to access to the structured identity
+              * @return identity_ attribute of the current object of this class
+              */
+            AtomIdentity GetIdentity();
+            /*! \fn
+              * An accessor function in order to access to the serial number of the atom in the input file
+              * @return Serial number of the identity_ attribute of the current object of this class
+              */
+            int GetSerialNumber();
             /*! \fn
               * An accessor function in order to access to the is_ring_ attribute of the current object
               * @return is_ring_ attribute of the current object of this class
@@ -94,6 +132,12 @@ namespace MolecularModeling
             //                       FUNCTIONS                      //
             //////////////////////////////////////////////////////////
             void FindConnectedAtoms(AtomVector &visitedAtoms);
+            /*! \fn
+              * A function in order to check if the atom has been read as a heterogen atom (its description contains "Het;")
+              * The flag is worked out when the description is set, so no string is searched here
+              * @return True if the description of the atom marks it as a heterogen atom
+              */
+            bool IsHeterogen();
             double GetDistanceToAtom(Atom *otherAtom);
             unsigned long long generateAtomIndex();
 
@@ -154,6 +198,14 @@ namespace MolecularModeling
               * @param id The identification of the current object
               */
             void SetId(std::string id);
+            /*! \fn
+              * A mutator function in order to set the structured identity of the current object
+              * The id of the atom is formatted from the identity, it stays empty while the serial number is not set
+              * @param name The atom name that appears in the id
+              * @param serial_number The serial number of the atom
+              * @param residue_identity The identity of the residue that the atom has been read in
+              */
+            void SetIdentity(std::string name, int serial_number, ResidueIdentity residue_identity);
             /*! \fn
               * A mutator function in order to set the is_ring_ attribute of the current object
               * Set the is_ring_ attribute of the current atom
@@ -176,16 +228,23 @@ namespace MolecularModeling
             //                       ATTRIBUTES                     //
             //////////////////////////////////////////////////////////
             Residue* residue_;                      /*!< A pointer back to the residue that this atom belongs to >*/
-            std::string name_;                      /*!< Name of the atom >*/
+            SymbolTable::Symbol name_;              /*!< Name of the atom, interned in the symbol table >*/
             CoordinateVector coordinates_;          /*!< Position of the atom >*/
-            std::string chemical_type_;             /*!< A descriptor to determines the chemical type of the atom >*/
-            std::string description_;               /*!< Short description of the atom >*/
-            std::string element_symbol_;            /*!< Element symbol of the atom >*/
+            SymbolTable::Symbol chemical_type_;     /*!< A descriptor to determines the chemical type of the atom, interned in the symbol table >*/
+            SymbolTable::Symbol description_;       /*!< Short description of the atom, interned in the symbol table >*/
+            bool is_heterogen_;                     /*!< Whether the description contains "Het;", set together with the description >*/
+            SymbolTable::Symbol element_symbol_;    /*!< Element symbol of the atom, interned in the symbol table >*/
             AtomNode* node_;                        /*!< A Pointer to a node of the graph structure that indicates this atom >*/
             std::string id_;                        /*!< An identifier for an atom which is generated based on the type of the input file from which the structure has to be built
-                                                      Mostly it is like "residue_name:atom_name" >*/
+                                                      Mostly it is like "residue_name:atom_name". Atoms with a structured identity get it formatted from identity_ by SetIdentity >*/
+            AtomIdentity identity_;                 /*!< Structured identity of the atom; it is set by SetIdentity or parsed from the id given to SetId >*/
             bool is_ring_;                          /*!< A boolean value which represents if an atom is involved in a sugar ring or not. This attribute is set during the Sugar ID process >*/
             unsigned long long index_;              /*!< A unqiue index for each atom in an assembly >*/
+
+            /*! \fn
+              * A function that marks the storage of the residue of the atom as changed, so the assemblies that hold it rebuild their views
+              */
+            void NotifyStructureChanged();
     };
 }
 
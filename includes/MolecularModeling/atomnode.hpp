@@ -110,6 +110,10 @@ namespace MolecularModeling
             char chirality_label_;
             AtomVector intra_node_neighbors_;
 
+            /*! \fn
+              * A function that marks the bonds of the storage of the residue of the atom as changed, so the assemblies that hold it rebuild their bond graphs
+              */
+            void NotifyBondsChanged();
     };
 }
 
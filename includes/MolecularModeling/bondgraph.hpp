@@ -0,0 +1,122 @@
+#ifndef BONDGRAPH_HPP
+#define BONDGRAPH_HPP
+
+#include <vector>
+#include <utility>
+#include <boost/unordered_map.hpp>
+
+namespace MolecularModeling
+{
+    class Atom;
+    /*! \class
+      * Compressed sparse row (CSR) snapshot of the bond graph of a list of atoms
+      * Atoms are numbered by their position in the list. The neighbors of atom i are the indices
+      * neighbors_[offsets_[i]] ... neighbors_[offsets_[i + 1] - 1], in the order of the neighbors of its atom node.
+      * Bonds to atoms that are not in the list are left out.
+      * The snapshot is not updated when bonds change; use Assembly::GetBondGraph to get an up to date graph.
+      */
+    class BondGraph
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<Atom*> AtomVector;
+            typedef std::vector<int> IndexVector;
+            typedef boost::unordered_map<Atom*, int> AtomIndexMap;
+            typedef boost::unordered_map<std::pair<int, int>, IndexVector> MovingAtomsMap;
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor, an empty graph
+              */
+            BondGraph();
+            /*! \fn
+              * Constructor that builds the graph of the given atoms from their atom nodes
+              * @param atoms List of the atoms of the graph
+              */
+            BondGraph(AtomVector atoms);
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * An accessor function in order to access to the number of atoms of the graph
+              * @return Number of atoms in the graph
+              */
+            int GetNumberOfAtoms();
+            /*! \fn
+              * An accessor function in order to access to the number of neighbor entries of the graph
+              * Every bond is counted once from each side, so this is twice the number of bonds
+              * @return Size of the neighbor array
+              */
+            int GetNumberOfNeighborEntries();
+            /*! \fn
+              * An accessor function in order to access to the atom of an index
+              * @param index Index of the atom in the graph
+              * @return The atom of the given index
+              */
+            Atom* GetAtom(int index);
+            /*! \fn
+              * An accessor function in order to access to the index of an atom
+              * @param atom The atom to look up
+              * @return Index of the atom in the graph, -1 if the atom is not in the graph
+              */
+            int GetIndex(Atom* atom);
+            /*! \fn
+              * An accessor function in order to access to the number of neighbors of an atom
+              * @param index Index of the atom in the graph
+              * @return Number of neighbors of the atom
+              */
+            int GetDegree(int index);
+            /*! \fn
+              * An accessor function in order to access to the atoms of the graph
+              * @return atoms_ attribute of the current object of this class
+              */
+            const AtomVector& GetAtoms();
+            /*! \fn
+              * An accessor function in order to access to the offsets of the neighbor lists
+              * @return offsets_ attribute of the current object of this class, one entry per atom plus one
+              */
+            const IndexVector& GetOffsets();
+            /*! \fn
+              * An accessor function in order to access to the concatenated neighbor lists
+              * @return neighbors_ attribute of the current object of this class
+              */
+            const IndexVector& GetNeighbors();
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to rebuild the graph of the given atoms from their atom nodes
+              * @param atoms List of the atoms of the graph
+              */
+            void Build(AtomVector atoms);
+            /*! \fn
+              * A function in order to find the atoms that move together with an atom when the bond (or angle) at a fixed atom is changed
+              * These are all atoms that can be reached from the moving atom without passing through the fixed atom. The search is iterative
+              * with a visited bitmap and a stack that are kept between queries, and its result is cached per pair of atoms until the graph is rebuilt.
+              * @param fixed_index Index of the atom that stays in place
+              * @param moving_index Index of the atom on the moving side
+              * @return Indices of the moving atoms in depth first order, starting with moving_index
+              */
+            const IndexVector& GetMovingAtoms(int fixed_index, int moving_index);
+
+        private:
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            AtomVector atoms_;                  /*!< Atoms of the graph, indexed by their position >*/
+            IndexVector offsets_;               /*!< Start of the neighbor list of each atom in neighbors_, followed by the total size >*/
+            IndexVector neighbors_;             /*!< Indices of the neighbors of all atoms, concatenated >*/
+            AtomIndexMap indices_;              /*!< Index of each atom of the graph >*/
+            MovingAtomsMap moving_atoms_;       /*!< Moving atom sets that have been found so far, keyed by (fixed index, moving index) >*/
+            std::vector<bool> visited_;         /*!< Visited bitmap of GetMovingAtoms, one entry per atom; all entries are false between queries >*/
+            IndexVector stack_;                 /*!< Search stack of GetMovingAtoms, kept to reuse its memory >*/
+    };
+}
+
+#endif // BONDGRAPH_HPP
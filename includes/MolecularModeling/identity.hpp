@@ -0,0 +1,42 @@
+#ifndef IDENTITY_HPP
+#define IDENTITY_HPP
+
+#include <utility>
+
+#include "symboltable.hpp"
+
+namespace MolecularModeling
+{
+    /*! \struct
+      * Structured identity of a residue as it has been read from the input file
+      * It holds the fields of composite residue ids like "NAG_A_1521_?_?_1" (name_chain_sequence_insertion_alternate_model)
+      */
+    struct ResidueIdentity
+    {
+            SymbolTable::Symbol name_;          /*!< Name of the residue at the time it has been identified >*/
+            char chain_id_;                     /*!< Chain identifier >*/
+            int sequence_number_;               /*!< Residue sequence number, gmml::iNotSet if the residue has no identity >*/
+            char insertion_code_;               /*!< Insertion code >*/
+            char alternate_location_;           /*!< Alternate location indicator >*/
+            SymbolTable::Symbol model_;         /*!< Id of the assembly (model) that the residue has been read in >*/
+    };
+
+    /*! \struct
+      * Structured identity of an atom as it has been read from the input file
+      * It holds the fields of composite atom ids like "C1_3810_NAG_A_1521_?_?_1" (name_serial_followed by the residue identity)
+      */
+    struct AtomIdentity
+    {
+            SymbolTable::Symbol name_;          /*!< Name of the atom at the time it has been identified >*/
+            int serial_number_;                 /*!< Serial number of the atom, gmml::iNotSet if the atom has no identity >*/
+            ResidueIdentity residue_;           /*!< Identity of the residue that the atom has been read in >*/
+    };
+
+    /*! \typedef
+      * Key of an atom in hash based lookups: (residue name, residue sequence number) and (atom name, serial number)
+      * Parts that a lookup does not use are set to gmml::iNotSet, or 0 for the names
+      */
+    typedef std::pair<std::pair<SymbolTable::Symbol, int>, std::pair<SymbolTable::Symbol, int> > AtomIdentityKey;
+}
+
+#endif // IDENTITY_HPP
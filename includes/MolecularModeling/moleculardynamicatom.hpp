@@ -4,6 +4,8 @@
 #include <string>
 #include <iostream>
 
+#include "symboltable.hpp"
+
 namespace MolecularModeling
 {
     class MolecularDynamicAtom
@@ -25,6 +27,11 @@ namespace MolecularModeling
               * @return atom_type_ attribute of the current object of this class
               */
             std::string GetAtomType();
+            /*! \fn
+              * An accessor function in order to access to the interned atom type
+              * @return Symbol of the atom_type_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetAtomTypeSymbol();
             /*! \fn
               * An accessor function in order to access to the charge
               * @return charge_ attribute of the current object of this class
@@ -85,7 +92,7 @@ namespace MolecularModeling
             //////////////////////////////////////////////////////////
             //                       ATTRIBUTES                     //
             //////////////////////////////////////////////////////////
-            std::string atom_type_;             /*!< Atom type >*/
+            SymbolTable::Symbol atom_type_;     /*!< Atom type, interned in the symbol table >*/
             double charge_;                     /*!< Charge of the atom >*/
             double mass_;                       /*!< Mass of the atom >*/
             double radius_;                     /*!< Radius of the atom >*/
@@ -0,0 +1,126 @@
+#ifndef OBJECTPOOL_HPP
+#define OBJECTPOOL_HPP
+
+#include <vector>
+#include <new>
+#include <cstddef>
+
+namespace MolecularModeling
+{
+    /*! \class
+      * A pool that allocates objects of type T contiguously in fixed size blocks and owns them.
+      * Objects are never moved or released individually; all of them are destroyed at once by Clear or the destructor.
+      * Heap objects that were created elsewhere can be handed over to the pool by Adopt, so they are released together with the pooled ones.
+      * The template argument may be an incomplete type as long as Create, Adopt and Clear are instantiated where the type is complete.
+      */
+    template <class T>
+    class ObjectPool
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<T*> ObjectVector;
+
+            //////////////////////////////////////////////////////////
+            //                       Constructor                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor
+              * @param block_size Number of objects stored contiguously in each block of the pool
+              */
+            ObjectPool(int block_size = 256) : block_size_(block_size), used_in_last_block_(0)
+            {
+                if(block_size_ < 1)
+                    block_size_ = 1;
+                used_in_last_block_ = block_size_;
+            }
+            /*! \fn
+              * Destructor, destroys all objects of the pool and releases their storage
+              */
+            ~ObjectPool()
+            {
+                Clear();
+            }
+
+            //////////////////////////////////////////////////////////
+            //                           ACCESSOR                   //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * An accessor function in order to access to the number of objects owned by the pool
+              * @return Number of pooled and adopted objects
+              */
+            int GetNumberOfObjects()
+            {
+                int pooled = 0;
+                if(!blocks_.empty())
+                    pooled = (blocks_.size() - 1) * block_size_ + used_in_last_block_;
+                return pooled + adopted_.size();
+            }
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to default construct a new object right after the previously created one
+              * @return Pointer to the new object which remains valid until the pool is cleared or destroyed
+              */
+            T* Create()
+            {
+                if(used_in_last_block_ == block_size_)
+                {
+                    blocks_.push_back(static_cast<T*>(::operator new(sizeof(T) * block_size_)));
+                    used_in_last_block_ = 0;
+                }
+                T* object = new (blocks_.back() + used_in_last_block_) T();
+                used_in_last_block_++;
+                return object;
+            }
+            /*! \fn
+              * A function in order to take over the ownership of an object that has been allocated by new
+              * @param object The object that is going to be deleted when the pool is cleared or destroyed
+              * @return The given object
+              */
+            T* Adopt(T* object)
+            {
+                if(object != NULL)
+                    adopted_.push_back(object);
+                return object;
+            }
+            /*! \fn
+              * A function in order to destroy all objects of the pool and release their storage
+              */
+            void Clear()
+            {
+                for(unsigned int i = 0; i < blocks_.size(); i++)
+                {
+                    int used = (i == blocks_.size() - 1) ? used_in_last_block_ : block_size_;
+                    for(int j = 0; j < used; j++)
+                        (blocks_.at(i) + j)->~T();
+                    ::operator delete(blocks_.at(i));
+                }
+                blocks_.clear();
+                used_in_last_block_ = block_size_;
+                for(typename ObjectVector::iterator it = adopted_.begin(); it != adopted_.end(); it++)
+                    delete *it;
+                adopted_.clear();
+            }
+
+        private:
+            /*! \fn
+              * Pools own their objects and can not be copied
+              */
+            ObjectPool(const ObjectPool& pool);
+            ObjectPool& operator=(const ObjectPool& pool);
+
+            //////////////////////////////////////////////////////////
+            //                         ATTRIBUTES                   //
+            //////////////////////////////////////////////////////////
+            int block_size_;                    /*!< Number of objects in each block >*/
+            int used_in_last_block_;            /*!< Number of objects constructed in the last block >*/
+            ObjectVector blocks_;               /*!< Contiguous raw storage for block_size_ objects each >*/
+            ObjectVector adopted_;              /*!< Objects allocated elsewhere whose ownership has been handed over to the pool >*/
+    };
+}
+
+#endif // OBJECTPOOL_HPP
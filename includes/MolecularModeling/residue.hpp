@@ -6,10 +6,13 @@
 #include <fstream>
 #include <vector>
 
+#include "symboltable.hpp"
+#include "identity.hpp"
 
 namespace MolecularModeling
 {
     class Assembly;
+    class AssemblyStorage;
     class Atom;
     class Residue
     {
@@ -37,11 +40,21 @@ namespace MolecularModeling
               * @return assembly_ attribute of the current object of this class
               */
             Assembly* GetAssembly();
+            /*! \fn
+              * An accessor function in order to access to the storage that owns the residue
+              * @return storage_ attribute of the current object of this class, NULL if the residue was not created by an assembly storage
+              */
+            AssemblyStorage* GetStorage();
             /*! \fn
               * An accessor function in order to access to the name
               * @return name_ attribute of the current object of this class
               */
             std::string GetName();
+            /*! \fn
+              * An accessor function in order to access to the interned name
+              * @return Symbol of the name_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetNameSymbol();
             /*! \fn
               * An accessor function in order to access to the atoms
               * @return atoms_ attribute of the current object of this class
@@ -62,16 +75,36 @@ namespace MolecularModeling
               * @return chemical_residue_ attribute of the current object of this class
               */
             std::string GetChemicalType();
+            /*! \fn
+              * An accessor function in order to access to the interned chemical type
+              * @return Symbol of the chemical_type_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetChemicalTypeSymbol();
             /*! \fn
               * An accessor function in order to access to the description
               * @return description_ attribute of the current object of this class
               */
-            std::string GetDescription();            
+            std::string GetDescription();
+            /*! \fn
+              * An accessor function in order to access to the interned description
+              * @return Symbol of the description_ attribute of the current object of this class
+              */
+            SymbolTable::Symbol GetDescriptionSymbol();            
             /*! \fn
               * An accessor function in order to access to the id
               * @return id_ attribute of the current object of this class
               */
             std::string GetId();
+            /*! \fn
+              * An accessor function in order to access to the structured identity
+              * @return identity_ attribute of the current object of this class
+              */
+            ResidueIdentity GetIdentity();
+            /*! \fn
+              * An accessor function in order to access to the sequence number of the residue in the input file
+              * @return Sequence number of the identity_ attribute of the current object of this class
+              */
+            int GetSequenceNumber();
 
             //////////////////////////////////////////////////////////
             //                       MUTATOR                        //
@@ -82,6 +115,12 @@ namespace MolecularModeling
               * @param assembly The assembly attribute of the current object
               */
             void SetAssembly(Assembly* assembly);
+            /*! \fn
+              * A mutator function in order to set the storage that owns the current object
+              * It is set by AssemblyStorage::CreateResidue; assemblies that keep the residue retain this storage (see Assembly::AddResidue)
+              * @param storage The storage that owns the residue
+              */
+            void SetStorage(AssemblyStorage* storage);
             /*! \fn
               * A mutator function in order to set the name of the current object
               * Set the name_ attribute of the current residue
@@ -148,10 +187,35 @@ namespace MolecularModeling
               * @param id The identification attribute of the current object
               */
             void SetId(std::string id);
+            /*! \fn
+              * A mutator function in order to set the structured identity of the current object
+              * The id of the residue is formatted from the identity, it stays empty while the sequence number is not set
+              * @param name The residue name that appears in the id
+              * @param chain_id The chain identifier of the residue
+              * @param sequence_number The sequence number of the residue
+              * @param insertion_code The insertion code of the residue
+              * @param alternate_location The alternate location indicator of the residue
+              * @param model The id of the assembly that the residue has been read in
+              */
+            void SetIdentity(std::string name, char chain_id, int sequence_number, char insertion_code, char alternate_location, std::string model);
 
             //////////////////////////////////////////////////////////
             //                       FUNCTIONS                      //
             //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to format a residue identity the way residue ids are written (name_chain_sequence_insertion_alternate_model)
+              * @param identity The residue identity to be formatted
+              * @return String version of the given identity
+              */
+            static std::string FormatIdentity(ResidueIdentity identity);
+            /*! \fn
+              * A function in order to extract a residue identity from the tokens of a residue or atom id
+              * Missing or malformed tokens are left unset
+              * @param tokens The id split by "_"
+              * @param first_token Index of the token that holds the residue name
+              * @return Residue identity read from the tokens
+              */
+            static ResidueIdentity ParseIdentity(std::vector<std::string> tokens, int first_token);
             /// Check if all atoms in the residue have their element symbols --> Label directly (1st priority)
             bool CheckSymbolBasedElementLabeling();
             /// Check if all atoms in the residue have their atom type --> Element symbols come from parameter file (2nd priority)
@@ -184,13 +248,16 @@ namespace MolecularModeling
             //                       ATTRIBUTES                     //
             //////////////////////////////////////////////////////////
             Assembly* assembly_;                /*!< Pointer back to the assembly that the current residue belongs to >*/
-            std::string name_;                  /*!< Name of residue >*/
+            AssemblyStorage* storage_;          /*!< Storage that owns the residue, NULL if it was allocated elsewhere >*/
+            SymbolTable::Symbol name_;          /*!< Name of residue, interned in the symbol table >*/
             AtomVector atoms_;                  /*!< List of atoms building the residue >*/
             AtomVector head_atoms_;             /*!< List of head atoms in the residue >*/
             AtomVector tail_atoms_;             /*!< List of tail atoms in the residue >*/
-            std::string chemical_type_;         /*!< A descriptor in order to describe chemical type of the residue >*/
-            std::string description_;           /*!< A short description of the residue >*/
-            std::string id_;                    /*!< An identifier for a residue that is generated based on the type of the given file from which the structure has to be built >*/
+            SymbolTable::Symbol chemical_type_; /*!< A descriptor in order to describe chemical type of the residue, interned in the symbol table >*/
+            SymbolTable::Symbol description_;   /*!< A short description of the residue, interned in the symbol table >*/
+            std::string id_;                    /*!< An identifier for a residue that is generated based on the type of the given file from which the structure has to be built
+                                                      Residues with a structured identity get it formatted from identity_ by SetIdentity >*/
+            ResidueIdentity identity_;          /*!< Structured identity of the residue; it is set by SetIdentity or parsed from the id given to SetId >*/
 
     };
  }
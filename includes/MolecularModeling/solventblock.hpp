@@ -0,0 +1,259 @@
+#ifndef SOLVENTBLOCK_HPP
+#define SOLVENTBLOCK_HPP
+
+#include <string>
+#include <vector>
+
+#include "../GeometryTopology/coordinate.hpp"
+
+namespace MolecularModeling
+{
+    class Assembly;
+    class Atom;
+    class Residue;
+    /*! \class
+      * Compact storage of the rigid solvent molecules (e.g. TIP3P or TIP5P water) that have been added to an assembly
+      * All molecules share one template that holds the names, types, charges, masses, radii and bonds of their sites, so a molecule is
+      * only its site coordinates, packed one after the other. Molecules are grouped into residues in the same way as the full atoms
+      * would be; residue i holds the molecules residue_offsets_[i] ... residue_offsets_[i + 1] - 1 and may be empty.
+      * Residues and atoms are numbered on from the first sequence and serial numbers in the order of the molecules and their sites.
+      * Real residues, atoms and atom nodes are only created when a residue is expanded into an assembly.
+      */
+    class SolventBlock
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            typedef std::vector<Atom*> AtomVector;
+            typedef std::vector<int> IndexVector;
+            typedef std::vector<double> DoubleVector;
+            typedef std::vector<std::string> StringVector;
+            typedef std::vector<GeometryTopology::Coordinate> CoordinateVector;
+
+            //////////////////////////////////////////////////////////
+            //                       CONSTRUCTOR                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * Default constructor, an empty block without a template
+              */
+            SolventBlock();
+
+            //////////////////////////////////////////////////////////
+            //                       ACCESSOR                       //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * An accessor function in order to check whether the block has any residue (empty residues included)
+              * @return True if nothing has been added to the block since it has been cleared
+              */
+            bool IsEmpty();
+            /*! \fn
+              * An accessor function in order to access to the number of sites (atoms) of each molecule
+              * @return Number of atoms of the template molecule
+              */
+            int GetNumberOfSites();
+            /*! \fn
+              * An accessor function in order to access to the number of molecules of the block
+              * @return Number of molecules in all residues of the block
+              */
+            int GetNumberOfMolecules();
+            /*! \fn
+              * An accessor function in order to access to the number of atoms of the block
+              * @return Number of molecules times the number of sites
+              */
+            int GetNumberOfAtoms();
+            /*! \fn
+              * An accessor function in order to access to the number of residues of the block
+              * @return Number of residues of the block, empty ones included
+              */
+            int GetNumberOfResidues();
+            /*! \fn
+              * An accessor function in order to access to the first molecule of a residue
+              * @param residue_index Index of the residue in the block
+              * @return Index of the first molecule of the residue
+              */
+            int GetFirstMoleculeOfResidue(int residue_index);
+            /*! \fn
+              * An accessor function in order to access to the number of molecules of a residue
+              * @param residue_index Index of the residue in the block
+              * @return Number of molecules of the residue
+              */
+            int GetNumberOfMoleculesOfResidue(int residue_index);
+            /*! \fn
+              * An accessor function in order to access to the residue of a molecule
+              * @param molecule_index Index of the molecule in the block
+              * @return Index of the residue that the molecule belongs to
+              */
+            int GetResidueOfMolecule(int molecule_index);
+            /*! \fn
+              * An accessor function in order to access to the coordinate of a site of a molecule
+              * @param molecule_index Index of the molecule in the block
+              * @param site_index Index of the site in the template molecule
+              * @return Reference to the packed coordinate, valid until the block is changed
+              */
+            GeometryTopology::Coordinate& GetSiteCoordinate(int molecule_index, int site_index);
+            /*! \fn
+              * An accessor function in order to access to the sequence number of a residue
+              * @param residue_index Index of the residue in the block
+              * @return Sequence number of the residue
+              */
+            int GetSequenceNumber(int residue_index);
+            /*! \fn
+              * An accessor function in order to access to the serial number of a site of a molecule
+              * @param molecule_index Index of the molecule in the block
+              * @param site_index Index of the site in the template molecule
+              * @return Serial number of the atom
+              */
+            int GetSerialNumber(int molecule_index, int site_index);
+            /*! \fn
+              * An accessor function in order to access to the name of the residues of the block
+              * @return residue_name_ attribute of the current object of this class
+              */
+            std::string GetResidueName();
+            /*! \fn
+              * An accessor function in order to access to the residue name that the ids of residues and atoms of the block start with
+              * @return id_prefix_ attribute of the current object of this class
+              */
+            std::string GetIdPrefix();
+            /*! \fn
+              * An accessor function in order to access to the name of a site of the template
+              * @param site_index Index of the site in the template molecule
+              * @return Name of the site
+              */
+            std::string GetSiteName(int site_index);
+            /*! \fn
+              * An accessor function in order to access to the atom type of a site of the template
+              * @param site_index Index of the site in the template molecule
+              * @return Atom type of the site
+              */
+            std::string GetSiteAtomType(int site_index);
+            /*! \fn
+              * An accessor function in order to access to the charge of a site of the template
+              * @param site_index Index of the site in the template molecule
+              * @return Charge of the site
+              */
+            double GetSiteCharge(int site_index);
+            /*! \fn
+              * An accessor function in order to access to the radius of a site of the template
+              * @param site_index Index of the site in the template molecule
+              * @return Radius of the site
+              */
+            double GetSiteRadius(int site_index);
+            /*! \fn
+              * An accessor function in order to access to the offsets of the bonds of the sites of the template
+              * @return site_offsets_ attribute of the current object of this class, one entry per site plus one
+              */
+            const IndexVector& GetSiteOffsets();
+            /*! \fn
+              * An accessor function in order to access to the bonded sites of the sites of the template
+              * The bonded sites of site i are site_neighbors_[site_offsets_[i]] ... site_neighbors_[site_offsets_[i + 1] - 1]
+              * @return site_neighbors_ attribute of the current object of this class
+              */
+            const IndexVector& GetSiteNeighbors();
+
+            //////////////////////////////////////////////////////////
+            //                       MUTATOR                        //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A mutator function in order to set the template molecule of the block
+              * The sites keep the order of the given atoms and only the bonds between them are kept
+              * @param molecule_atoms Atoms of one molecule of the solvent
+              * @param residue_name Name of the residues of the block
+              * @param id_prefix Residue name that the ids of residues and atoms of the block start with
+              */
+            void SetTemplate(AtomVector molecule_atoms, std::string residue_name, std::string id_prefix);
+            /*! \fn
+              * A mutator function in order to set the numbers that the residues and atoms of the block are numbered from
+              * @param first_sequence_number Sequence number of the first residue of the block
+              * @param first_serial_number Serial number of the first atom of the block
+              */
+            void SetFirstNumbers(int first_sequence_number, int first_serial_number);
+
+            //////////////////////////////////////////////////////////
+            //                       FUNCTIONS                      //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to start a new (empty) residue at the end of the block
+              */
+            void AddResidue();
+            /*! \fn
+              * A function in order to add a molecule to the last residue of the block
+              * @param site_coordinates Coordinates of the sites of the molecule, in the order of the template
+              */
+            void AddMolecule(const GeometryTopology::Coordinate* site_coordinates);
+            /*! \fn
+              * A function in order to remove all residues and molecules of the block; the template is kept
+              */
+            void Clear();
+            /*! \fn
+              * A function in order to remove molecules from the block; the residues are kept, and may become empty
+              * The atoms of the molecules after a removed one are numbered on without a gap
+              * @param molecule_indices Indices of the molecules to remove, in any order
+              */
+            void RemoveMolecules(IndexVector molecule_indices);
+            /*! \fn
+              * A function in order to build the full residue, atoms and atom nodes of a residue of the block
+              * The objects are created by (and owned by) the given assembly, the residue is not added to it
+              * @param residue_index Index of the residue in the block
+              * @param assembly Assembly that creates the objects
+              * @param assembly_id Id of the assembly that the solvent belongs to, the last field of the residue and atom ids
+              * @return The new residue
+              */
+            Residue* ExpandResidue(int residue_index, Assembly* assembly, std::string assembly_id);
+            /*! \fn
+              * A function in order to build a residue that only holds one molecule of the block
+              * @param molecule_index Index of the molecule in the block
+              * @param assembly Assembly that creates the objects
+              * @param assembly_id Id of the assembly that the solvent belongs to, the last field of the residue and atom ids
+              * @return The new residue
+              */
+            Residue* ExpandMolecule(int molecule_index, Assembly* assembly, std::string assembly_id);
+            /*! \fn
+              * A function in order to give a residue that has been expanded from the block the ids of another residue of the block
+              * The residues must hold the same number of molecules, so an expanded residue can be reused instead of expanding each residue
+              * @param residue_index Index of the residue in the block whose sequence and serial numbers are taken
+              * @param residue Residue that has been built by ExpandResidue
+              * @param assembly_id Id of the assembly that the solvent belongs to, the last field of the residue and atom ids
+              */
+            void RenumberResidue(int residue_index, Residue* residue, std::string assembly_id);
+
+        private:
+            /*! \fn
+              * A function that builds a residue of the given molecules of the block
+              * @param residue_index Index of the residue in the block that gives the numbering
+              * @param first_molecule Index of the first molecule
+              * @param last_molecule Index after the last molecule
+              * @param assembly Assembly that creates the objects
+              * @param assembly_id Id of the assembly that the solvent belongs to
+              * @return The new residue
+              */
+            Residue* ExpandMolecules(int residue_index, int first_molecule, int last_molecule, Assembly* assembly, std::string assembly_id);
+            /*! \fn
+              * A function that formats the id of a residue of the block
+              * @param residue_index Index of the residue in the block
+              * @param assembly_id Id of the assembly that the solvent belongs to
+              * @return Id of the residue, the atom ids are made of the site name, the serial number and this id
+              */
+            std::string FormatResidueId(int residue_index, std::string assembly_id);
+
+            //////////////////////////////////////////////////////////
+            //                       ATTRIBUTES                     //
+            //////////////////////////////////////////////////////////
+            std::string residue_name_;              /*!< Name of the residues of the block >*/
+            std::string id_prefix_;                 /*!< Residue name that the ids of residues and atoms of the block start with >*/
+            StringVector site_names_;               /*!< Atom name of each site of the template >*/
+            StringVector site_atom_types_;          /*!< Atom type of each site of the template >*/
+            DoubleVector site_charges_;             /*!< Charge of each site of the template >*/
+            DoubleVector site_masses_;              /*!< Mass of each site of the template >*/
+            DoubleVector site_radii_;               /*!< Radius of each site of the template >*/
+            IndexVector site_node_ids_;             /*!< Atom node id of each site of the template >*/
+            IndexVector site_offsets_;              /*!< Start of the bonded sites of each site in site_neighbors_, followed by the total size >*/
+            IndexVector site_neighbors_;            /*!< Bonded sites of all sites of the template, concatenated >*/
+            CoordinateVector coordinates_;          /*!< Coordinates of the sites of all molecules, molecule after molecule >*/
+            IndexVector residue_offsets_;           /*!< First molecule of each residue, followed by the number of molecules >*/
+            int first_sequence_number_;             /*!< Sequence number of the first residue >*/
+            int first_serial_number_;               /*!< Serial number of the first atom >*/
+    };
+}
+
+#endif // SOLVENTBLOCK_HPP
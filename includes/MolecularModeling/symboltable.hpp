@@ -0,0 +1,55 @@
+#ifndef SYMBOLTABLE_HPP
+#define SYMBOLTABLE_HPP
+
+#include <string>
+
+namespace MolecularModeling
+{
+    /*! \class
+      * A process wide table of interned strings
+      * Every distinct string is stored once and is represented by a small integer symbol, so two interned strings are equal exactly when their symbols are equal.
+      * Symbol 0 always stands for the empty string.
+      * Interning and reading the text of a symbol are thread safe, and reading takes no lock; the text of a symbol stays valid until the process exits.
+      */
+    class SymbolTable
+    {
+        public:
+            //////////////////////////////////////////////////////////
+            //                    TYPE DEFINITION                   //
+            //////////////////////////////////////////////////////////
+            /*! \typedef
+              * Handle of an interned string
+              */
+            typedef unsigned int Symbol;
+
+            //////////////////////////////////////////////////////////
+            //                         FUNCTIONS                    //
+            //////////////////////////////////////////////////////////
+            /*! \fn
+              * A function in order to look up the symbol of a string, adding the string to the table if it has not been seen before
+              * std::length_error is thrown if a new string does not fit into the table any more
+              * @param text The string to be interned
+              * @return Symbol representing the given string
+              */
+            static Symbol Intern(const std::string& text);
+            /*! \fn
+              * A function in order to access to the text of an interned string
+              * @param symbol A symbol returned by Intern
+              * @return The string that the symbol represents
+              */
+            static const std::string& GetString(Symbol symbol);
+            /*! \fn
+              * A function in order to access to the number of distinct strings that have been interned
+              * @return Number of symbols in the table including the empty string
+              */
+            static unsigned int GetNumberOfSymbols();
+
+        private:
+            /*! \fn
+              * The table only has static members and can not be instantiated
+              */
+            SymbolTable();
+    };
+}
+
+#endif // SYMBOLTABLE_HPP
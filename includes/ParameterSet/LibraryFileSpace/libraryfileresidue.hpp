@@ -45,6 +45,10 @@ namespace LibraryFileSpace
               */
             LibraryFileResidue(std::string& name, int listing_index, std::vector<LibraryFileAtom*>& atoms, int head_atom_index, int tail_atom_index, double box_angle = 0,
                                double box_length = 0, double box_width = 0, double box_height = 0);
+            /*! \fn
+              * Destructor; releases the atoms belonging to the residue
+              */
+            ~LibraryFileResidue();
 
             //////////////////////////////////////////////////////////
             //                           ACCESSOR                   //
@@ -45,6 +45,10 @@ namespace ParameterFileSpace
               * @param param_file An existing library file path to be read
               */
             ParameterFile(std::string param_file, int type = gmml::MAIN);
+            /*! \fn
+              * Destructor; releases the atom types, bonds, angles and dihedrals read from the file
+              */
+            ~ParameterFile();
 
             //////////////////////////////////////////////////////////
             //                           ACCESSOR                   //
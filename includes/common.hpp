@@ -59,6 +59,9 @@ namespace gmml
     const int MAX_PDB_ATOM = 99999;
     const double CHARGE_DIVIDER = 18.2223;
     const double CARBON_SURFACE_AREA = 36.31681103;
+    const double OVERLAP_CUTOFF = 3.6;
+    const double OVERLAP_TOLERANCE = 0.6;
+    const double TRUNCATED_OCTAHEDRON_ANGLE = 109.4712206;
 
     // Ionizing
     const double DEFAULT_GRID_LENGTH = 2;//0.5;
@@ -73,6 +76,9 @@ namespace gmml
     const double GRID_OFFSET = 1.0;
     const double MARGIN = 0.0;//10.0;
     const double CRITICAL_RADIOUS = 1.0;        
+    const double WATER_MOLARITY = 55.5;                         // Molecules of water per liter, in mol/L
+    const double MOLAR_TO_PER_CUBIC_ANGSTROM = 6.02214076e-4;   // Particles per cubic angstrom at 1 mol/L
+    const int MAXIMUM_SUGAR_RING_SIZE = 6;                      // Largest ring (furanose, pyranose) that is searched for in sugar detection
 
     const double EXTERNAL28LINKAGEROTAMERS[][6] = {
         {-66.0, 0.0, -66.0, 80.0, -167.0},
@@ -818,6 +824,16 @@ namespace gmml
         DATABASE
     };
 
+    /*! \enum
+      * Enumerator to the possible shapes of the solvent that is added around a solute
+      */
+    enum SolventShape
+    {
+        SOLVENT_BOX = 0,                    /*!< Periodic rectangular box around the boundary of the solute >*/
+        SOLVENT_TRUNCATED_OCTAHEDRON = 1,   /*!< Periodic truncated octahedron around the solute >*/
+        SOLVENT_SHELL = 2                   /*!< Non periodic shell of solvent within a given distance of the solute atoms >*/
+    };
+
     /*! \enum
       * Enumerator to parameter file type
       */
@@ -86,6 +86,8 @@
 #include "GeometryTopology/plane.hpp"
 #include "GeometryTopology/cell.hpp"
 #include "GeometryTopology/grid.hpp"
+#include "GeometryTopology/neighborgrid.hpp"
+#include "GeometryTopology/coordinateframe.hpp"
 #include "GeometryTopology/InternalCoordinate/angle.hpp"
 #include "GeometryTopology/InternalCoordinate/dihedral.hpp"
 #include "GeometryTopology/InternalCoordinate/distance.hpp"
@@ -101,8 +103,13 @@
 #include "MolecularModeling/dockingatom.hpp"
 #include "MolecularModeling/element.hpp"
 #include "MolecularModeling/moleculardynamicatom.hpp"
+#include "MolecularModeling/objectpool.hpp"
+#include "MolecularModeling/assemblystorage.hpp"
 #include "MolecularModeling/quantommechanicatom.hpp"
 #include "MolecularModeling/residue.hpp"
+#include "MolecularModeling/symboltable.hpp"
+#include "MolecularModeling/identity.hpp"
+#include "MolecularModeling/bondgraph.hpp"
 #include "ParameterSet/LibraryFileSpace/libraryfile.hpp"
 #include "ParameterSet/LibraryFileSpace/libraryfileatom.hpp"
 #include "ParameterSet/LibraryFileSpace/libraryfileprocessingexception.hpp"
@@ -9,8 +9,10 @@
 #include <vector>
 #include <iomanip>
 #include <math.h>
+#include <bitset>
 #include "boost/tokenizer.hpp"
 #include "boost/foreach.hpp"
+#include "boost/unordered_map.hpp"
 #include "common.hpp"
 #include "GeometryTopology/coordinate.hpp"
 
@@ -415,79 +417,132 @@ namespace gmml
         }
     }
 
+    typedef boost::unordered_map<std::string, int> SugarNameIndexMap;
+
+    /*! \fn
+      * A function in order to index the rows of a sugar name lookup table by their chemical code structures
+      * If a chemical code appears in several rows the first row is kept
+      * @param table The sugar name lookup table
+      * @param table_size Number of rows of the table
+      * @return Mapping between the string chemical code structures and the positions of the rows in the table
+      */
+    inline SugarNameIndexMap IndexSugarNameLookup(const Glycan::SugarName* table, int table_size)
+    {
+        SugarNameIndexMap index = SugarNameIndexMap();
+        for(int i = 0; i < table_size; i++)
+            index.insert(std::make_pair(table[i].chemical_code_string_, i));
+        return index;
+    }
+
     /*! \fn
       * A function in order to look up the stereochemistry name of the sugar structure based on the given string version of the chemical code structure
+      * The lookup table is indexed by chemical code once, on the first call
       * @param code The string chemical code structure
       * @return SUGARNAMELOOKUP The matched row of the lookup table with the given code
       */
     inline Glycan::SugarName SugarStereoChemistryNameLookup(std::string code)
     {
-        for(int i = 0; i < SUGARNAMELOOKUPSIZE; i++)
+        static const SugarNameIndexMap index = IndexSugarNameLookup(SUGARNAMELOOKUP, SUGARNAMELOOKUPSIZE);
+        SugarNameIndexMap::const_iterator it = index.find(code);
+        if(it != index.end())
+            return SUGARNAMELOOKUP[it->second];
+        return SUGARNAMELOOKUP[0];
+    }
+
+    /*! \fn
+      * A function in order to encode the stereo positions of a chemical code structure into bits, for finding the closest match of a chemical code
+      * For each of the 2, 3, 4, a, +1, +2, +3 and -1 positions (the first occurrence in the code) one bit of each byte tells:
+      * byte 0 whether the code has the position, byte 1 whether it is preceded by '^', byte 2 whether it is preceded by '_',
+      * byte 3 whether it is followed by 'd' and byte 4 whether it is not at the end of the code.
+      * Bits 40 and 41 tell whether the code has a P or an F (pyranose or furanose).
+      * @param code The string chemical code structure
+      * @return The bit encoding of the code
+      */
+    inline unsigned long long EncodeSugarStereoChemistryCode(const std::string& code)
+    {
+        const std::string vocab[] = {"2", "3", "4", "a", "+1", "+2", "+3", "-1"};
+        const int vocab_size = (sizeof(vocab)/sizeof(vocab[0]));
+        unsigned long long bits = 0;
+        for(int j = 0; j < vocab_size; j++)
         {
-            if(code.compare(SUGARNAMELOOKUP[i].chemical_code_string_) == 0)
-                return SUGARNAMELOOKUP[i];
+            size_t index = code.find(vocab[j]);
+            if(index == std::string::npos)
+                continue;
+            bits |= 1ULL << j;
+            if(index > 0 && code[index-1] == '^')
+                bits |= 1ULL << (8 + j);
+            if(index > 0 && code[index-1] == '_')
+                bits |= 1ULL << (16 + j);
+            if(index != code.size()-1)
+            {
+                if(code[index+1] == 'd')
+                    bits |= 1ULL << (24 + j);
+                bits |= 1ULL << (32 + j);
+            }
         }
-        return SUGARNAMELOOKUP[0];
+        if(code.find("P") != std::string::npos)
+            bits |= 1ULL << 40;
+        if(code.find("F") != std::string::npos)
+            bits |= 1ULL << 41;
+        return bits;
+    }
+
+    /*! \fn
+      * A function in order to score the difference between two chemical code structures encoded by EncodeSugarStereoChemistryCode
+      * A position costs one if only one of the codes has it, one more if both have it but it is preceded by different orientations
+      * and one more if it is followed by 'd' in only one of the codes (unless it ends one of them). The costs are gathered into one word and counted
+      * @param code_bits The bit encoding of the first code
+      * @param target_bits The bit encoding of the second code
+      * @return The number of differences between the codes
+      */
+    inline int SugarStereoChemistryCodeDifference(unsigned long long code_bits, unsigned long long target_bits)
+    {
+        unsigned long long diff = code_bits ^ target_bits;
+        unsigned long long both = code_bits & target_bits & 0xFFULL;
+        unsigned long long costs = (diff & 0xFFULL) |
+                (((diff >> 8) | (diff >> 16)) & both) << 8 |
+                ((diff >> 24) & (code_bits >> 32) & (target_bits >> 32) & 0xFFULL) << 16;
+        return std::bitset<64>(costs).count();
+    }
+
+    /*! \fn
+      * A function in order to encode the chemical code structures of the rows of the stereochemistry lookup table
+      * @return The bit encodings of the codes of SUGARNAMELOOKUP, in the order of the table
+      */
+    inline std::vector<unsigned long long> EncodeSugarNameLookup()
+    {
+        std::vector<unsigned long long> lookup_bits = std::vector<unsigned long long>();
+        for(int i = 0; i < SUGARNAMELOOKUPSIZE; i++)
+            lookup_bits.push_back(EncodeSugarStereoChemistryCode(SUGARNAMELOOKUP[i].chemical_code_string_));
+        return lookup_bits;
     }
 
     /*! \fn
       * A function in order to search the stereochemistry lookup table and identify the closest match for the sugar structure based on the given string version of the chemical code structure
+      * The codes of the lookup table are encoded once, on the first call, and compared to the given code by SugarStereoChemistryCodeDifference
       * @param code The string chemical code structure
       * @return SUGARNAMELOOKUP The closest row of the lookup table which matches th emost with the given code
       */
     inline Glycan::SugarName ClosestMatchSugarStereoChemistryNameLookup(std::string code, std::vector<Glycan::SugarName>& closest_matches)
     {
-        std::string vocab[] = {"2", "3", "4", "a", "+1", "+2", "+3", "-1"};
-        int vocab_size = (sizeof(vocab)/sizeof(vocab[0]));
-        std::string pos = "^_";
-        std::string stat = "d";
+        static const std::vector<unsigned long long> lookup_bits = EncodeSugarNameLookup();
+        unsigned long long code_bits = EncodeSugarStereoChemistryCode(code);
         int min_diff_score = -1000;
-        std::map<int, std::vector<Glycan::SugarName> > score_map = std::map<int, std::vector<Glycan::SugarName> >();
+        closest_matches = std::vector<Glycan::SugarName>();
         for(int i = 0; i < SUGARNAMELOOKUPSIZE; i++)
         {
-            int diff_score = 0;
-            std::string target_code = SUGARNAMELOOKUP[i].chemical_code_string_;
-            if((target_code.find("P") != std::string::npos && code.find("P") != std::string::npos) ||
-                    (target_code.find("F") != std::string::npos && code.find("F") != std::string::npos))
+            ///Only codes of the same ring type (P/F) are compared
+            if(((code_bits & lookup_bits[i]) >> 40) == 0)
+                continue;
+            int diff_score = -SugarStereoChemistryCodeDifference(code_bits, lookup_bits[i]);
+            if(diff_score > min_diff_score)
             {
-                for(int j = 0; j < vocab_size; j++)
-                {
-                    int target_index = target_code.find(vocab[j]);
-                    int code_index = code.find(vocab[j]);
-                    if(target_index != std::string::npos)
-                    {
-                        //target code and the key code both contain the vocab[j]
-                        if(code_index != std::string::npos)
-                        {
-                            if(pos.find(code[code_index-1]) != std::string::npos || pos.find(target_code[target_index-1]) != std::string::npos)
-                                if(code[code_index-1] != target_code[target_index-1])
-                                    diff_score--;
-                            if(code_index != code.size()-1 && target_index != target_code.size()-1)
-                                if(stat.find(code[code_index+1]) != std::string::npos || stat.find(target_code[target_index+1]) != std::string::npos)
-                                    if(code[code_index+1] != target_code[target_index+1])
-                                        diff_score--;
-                        }
-                        //target code contains the vocab[j] but the key code does not
-                        else
-                            diff_score--;
-                    }
-                    else
-                    {
-                        //the key code contains the vocab[j] but the target code does not
-                        if(code_index != std::string::npos)
-                            diff_score--;
-                        //target code and the key code both do not contain the vocab[j]
-                        else
-                        {
-                        }
-                    }
-                }
-                if(diff_score > min_diff_score)
-                    min_diff_score = diff_score;
-                score_map[diff_score].push_back(SUGARNAMELOOKUP[i]);
+                min_diff_score = diff_score;
+                closest_matches.clear();
             }
+            if(diff_score == min_diff_score)
+                closest_matches.push_back(SUGARNAMELOOKUP[i]);
         }
-        closest_matches = score_map[min_diff_score];
         ///SELECTING ONE MATCH FROM CLOSEST MATCHES
         ///RULE1: choose D over L isomer in closest matches
         ///RULE2: if the input chemical code has 'd's and the matches don't have corresponding 'd's. for D sugars choose the match that has '^' instead of 'd' for that index and '_' for L sugars
@@ -564,16 +619,16 @@ namespace gmml
 
     /*! \fn
       * A function in order to look up the complex name of the sugar structure based on the given string version of the chemical code structure
+      * The lookup table is indexed by chemical code once, on the first call
       * @param code The string complex chemical code structure
       * @return COMPLEXSUGARNAMELOOKUP The matched row of the lookup table with the given code
       */
     inline Glycan::SugarName ComplexSugarNameLookup(std::string code)
     {
-        for(int i = 0; i < COMPLEXSUGARNAMELOOKUPSIZE; i++)
-        {
-            if(code.compare(COMPLEXSUGARNAMELOOKUP[i].chemical_code_string_) == 0)
-                return COMPLEXSUGARNAMELOOKUP[i];
-        }
+        static const SugarNameIndexMap index = IndexSugarNameLookup(COMPLEXSUGARNAMELOOKUP, COMPLEXSUGARNAMELOOKUPSIZE);
+        SugarNameIndexMap::const_iterator it = index.find(code);
+        if(it != index.end())
+            return COMPLEXSUGARNAMELOOKUP[it->second];
         return COMPLEXSUGARNAMELOOKUP[0];
     }    
 
@@ -683,12 +738,16 @@ namespace gmml
 //        file.close();
     }
 
-    inline double** GenerateRotationMatrix(GeometryTopology::Coordinate* direction, GeometryTopology::Coordinate* parent, double angle)
+    /*! \fn
+      * A function in order to build the 3x4 matrix of a rotation around an axis without allocating memory
+      * The first three columns hold the rotation and the last one the translation that keeps the axis in place
+      * @param direction Direction of the rotation axis, it is normalized in place
+      * @param parent A point on the rotation axis
+      * @param angle Rotation angle in radian
+      * @param rotation_matrix The 3x4 matrix (usually on the stack) that is going to be filled
+      */
+    inline void GenerateRotationMatrix(GeometryTopology::Coordinate* direction, GeometryTopology::Coordinate* parent, double angle, double rotation_matrix[3][4])
     {
-        double** rotation_matrix = new double*[3];
-        for(int i = 0; i < 3; i++)
-            rotation_matrix[i] = new double[4];
-
         direction->Normalize();
         double u = direction->GetX();
         double v = direction->GetY();
@@ -719,9 +778,38 @@ namespace gmml
         rotation_matrix[2][0] = u * w * (1 - cos_rotation_angle) - v * sin_rotation_angle;
         rotation_matrix[2][1] = v * w * (1 - cos_rotation_angle) + u * sin_rotation_angle;
         rotation_matrix[2][2] = w2 + (u2 + v2) * cos_rotation_angle;
-
+    }
+    /*! \fn
+      * A function in order to build the 3x4 matrix of a rotation around an axis on the heap
+      * Prefer the overload that fills a caller provided matrix; this one has to be released by DeleteRotationMatrix
+      * @param direction Direction of the rotation axis, it is normalized in place
+      * @param parent A point on the rotation axis
+      * @param angle Rotation angle in radian
+      * @return The 3x4 rotation matrix
+      */
+    inline double** GenerateRotationMatrix(GeometryTopology::Coordinate* direction, GeometryTopology::Coordinate* parent, double angle)
+    {
+        double matrix[3][4];
+        GenerateRotationMatrix(direction, parent, angle, matrix);
+        double** rotation_matrix = new double*[3];
+        for(int i = 0; i < 3; i++)
+        {
+            rotation_matrix[i] = new double[4];
+            for(int j = 0; j < 4; j++)
+                rotation_matrix[i][j] = matrix[i][j];
+        }
         return rotation_matrix;
     }
+    /*! \fn
+      * A function in order to release a rotation matrix created by GenerateRotationMatrix
+      * @param rotation_matrix The 3x4 matrix that is going to be deleted
+      */
+    inline void DeleteRotationMatrix(double** rotation_matrix)
+    {
+        for(int i = 0; i < 3; i++)
+            delete[] rotation_matrix[i];
+        delete[] rotation_matrix;
+    }
     /*! \fn
       * A function in order to replace all occurrences of a sub-string with another sub-string in a string
       * @param str The string that is going to be manipulated
@@ -1,5 +1,6 @@
 #include "../../includes/common.hpp"
 #include "../../includes/GeometryTopology/cell.hpp"
+#include "../../includes/GeometryTopology/grid.hpp"
 #include "../../includes/GeometryTopology/coordinate.hpp"
 #include "../../includes/MolecularModeling/assembly.hpp"
 
@@ -11,8 +12,9 @@ using namespace MolecularModeling;
 //////////////////////////////////////////////////////////
 Cell::Cell()
 {
-    min_corner_ = new Coordinate();
-    max_corner_ = new Coordinate();
+    min_corner_ = Coordinate();
+    max_corner_ = Coordinate();
+    this->UpdateCellCenter();
     cell_charge_ = 0.0;
     cell_potential_energy_ = 0.0;
     grid_ = NULL;
@@ -20,8 +22,9 @@ Cell::Cell()
 
 Cell::Cell(Coordinate* min, Coordinate* max)
 {
-    min_corner_ = new Coordinate(min->GetX(), min->GetY(), min->GetZ());
-    max_corner_ = new Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    min_corner_ = Coordinate(min->GetX(), min->GetY(), min->GetZ());
+    max_corner_ = Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    this->UpdateCellCenter();
     cell_charge_ = 0.0;
     cell_potential_energy_ = 0.0;
     grid_ = NULL;
@@ -29,8 +32,9 @@ Cell::Cell(Coordinate* min, Coordinate* max)
 
 Cell::Cell(Grid *grid, Coordinate *min, Coordinate *max)
 {
-    min_corner_ = new Coordinate(min->GetX(), min->GetY(), min->GetZ());
-    max_corner_ = new Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    min_corner_ = Coordinate(min->GetX(), min->GetY(), min->GetZ());
+    max_corner_ = Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    this->UpdateCellCenter();
     cell_charge_ = 0.0;
     cell_potential_energy_ = 0.0;
     grid_ = grid;
@@ -38,8 +42,9 @@ Cell::Cell(Grid *grid, Coordinate *min, Coordinate *max)
 
 Cell::Cell(Coordinate* min, Coordinate* max, double charge, double potential_energy)
 {
-    min_corner_ = new Coordinate(min->GetX(), min->GetY(), min->GetZ());
-    max_corner_ = new Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    min_corner_ = Coordinate(min->GetX(), min->GetY(), min->GetZ());
+    max_corner_ = Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    this->UpdateCellCenter();
     cell_charge_ = charge;
     cell_potential_energy_ = potential_energy;
     grid_ = NULL;
@@ -47,8 +52,9 @@ Cell::Cell(Coordinate* min, Coordinate* max, double charge, double potential_ene
 
 Cell::Cell(Grid *grid, Coordinate *min, Coordinate *max, double charge, double potential_energy)
 {
-    min_corner_ = new Coordinate(min->GetX(), min->GetY(), min->GetZ());
-    max_corner_ = new Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    min_corner_ = Coordinate(min->GetX(), min->GetY(), min->GetZ());
+    max_corner_ = Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    this->UpdateCellCenter();
     cell_charge_ = charge;
     cell_potential_energy_ = potential_energy;
     grid_ = grid;
@@ -59,12 +65,12 @@ Cell::Cell(Grid *grid, Coordinate *min, Coordinate *max, double charge, double p
 //////////////////////////////////////////////////////////
 GeometryTopology::Coordinate* Cell::GetMinCorner()
 {
-    return min_corner_;
+    return &min_corner_;
 }
 
 GeometryTopology::Coordinate* Cell::GetMaxCorner()
 {
-    return max_corner_;
+    return &max_corner_;
 }
 
 double Cell::GetCellCharge()
@@ -79,17 +85,17 @@ double Cell::GetCellPotentialEnergy()
 
 double Cell::GetCellLength()
 {
-    return max_corner_->GetX() - min_corner_->GetX();
+    return max_corner_.GetX() - min_corner_.GetX();
 }
 
 double Cell::GetCellWidth()
 {
-    max_corner_->GetY() - min_corner_->GetY();
+    return max_corner_.GetY() - min_corner_.GetY();
 }
 
 double Cell::GetCellHeight()
 {
-    max_corner_->GetZ() - min_corner_->GetZ();
+    return max_corner_.GetZ() - min_corner_.GetZ();
 }
 
 Grid* Cell::GetGrid()
@@ -102,16 +108,18 @@ Grid* Cell::GetGrid()
 //////////////////////////////////////////////////////////
 void Cell::SetMinCorner(GeometryTopology::Coordinate* min)
 {
-    min_corner_->SetX(min->GetX());
-    min_corner_->SetY(min->GetY());
-    min_corner_->SetZ(min->GetZ());
+    min_corner_.SetX(min->GetX());
+    min_corner_.SetY(min->GetY());
+    min_corner_.SetZ(min->GetZ());
+    this->UpdateCellCenter();
 }
 
 void Cell::SetMaxCorner(GeometryTopology::Coordinate* max)
 {
-    max_corner_->SetX(max->GetX());
-    max_corner_->SetY(max->GetY());
-    max_corner_->SetZ(max->GetZ());
+    max_corner_.SetX(max->GetX());
+    max_corner_.SetY(max->GetY());
+    max_corner_.SetZ(max->GetZ());
+    this->UpdateCellCenter();
 }
 
 void Cell::SetCellCharge(double charge)
@@ -134,16 +142,14 @@ void Cell::SetGrid(Grid *grid)
 //////////////////////////////////////////////////////////
 GeometryTopology::Coordinate* Cell::GetCellCenter()
 {
-    return new Coordinate(min_corner_->GetX() + (max_corner_->GetX() - min_corner_->GetX()) / 2,
-                          min_corner_->GetY() + (max_corner_->GetY() - min_corner_->GetY()) / 2,
-                          min_corner_->GetZ() + (max_corner_->GetZ() - min_corner_->GetZ()) / 2);
+    return &cell_center_;
 }
 
 void Cell::CalculateCellCharge()
 {
     double charge = 0.0;
-    Assembly::AtomVector all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssembly();
-    for(Assembly::AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    const Assembly::AtomVector& all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssemblyView();
+    for(Assembly::AtomVector::const_iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = *it;
         if(atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX() <= this->GetMaxCorner()->GetX() &&
@@ -160,9 +166,9 @@ void Cell::CalculateCellCharge()
 void Cell::CalculateCellPotentialEnergy(double ion_radius)
 {
     double potential_energy = 0.0;
-    Assembly::AtomVector all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssembly();
+    const Assembly::AtomVector& all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssemblyView();
     Coordinate* center_of_cell = this->GetCellCenter();
-    for(Assembly::AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    for(Assembly::AtomVector::const_iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = *it;
         double dist = sqrt((center_of_cell->GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) *
@@ -186,11 +192,33 @@ void Cell::CalculateCellPotentialEnergy(double ion_radius)
     cell_potential_energy_ = potential_energy;
 }
 
+void Cell::UpdateCellPotentialEnergy(Atom* atom, double ion_radius, double cutoff, double screening_length, double minimum_distance)
+{
+    if(cell_potential_energy_ == INFINITY)
+        return;
+    Coordinate* center_of_cell = this->GetCellCenter();
+    Coordinate* atom_coordinate = atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex());
+    double dist = sqrt((center_of_cell->GetX() - atom_coordinate->GetX()) * (center_of_cell->GetX() - atom_coordinate->GetX()) +
+                       (center_of_cell->GetY() - atom_coordinate->GetY()) * (center_of_cell->GetY() - atom_coordinate->GetY()) +
+                       (center_of_cell->GetZ() - atom_coordinate->GetZ()) * (center_of_cell->GetZ() - atom_coordinate->GetZ()));
+
+    double radius = (atom->MolecularDynamicAtom::GetRadius() != dNotSet) ? atom->MolecularDynamicAtom::GetRadius() : MINIMUM_RADIUS;
+    if(dist < radius + GRID_OFFSET + ion_radius || dist < minimum_distance)
+        cell_potential_energy_ = INFINITY;
+    else if(cutoff > 0.0 && dist >= cutoff)
+        return;
+    else if(screening_length > 0.0)
+        cell_potential_energy_ += ((atom->MolecularDynamicAtom::GetCharge() != dNotSet) ?
+                                       atom->MolecularDynamicAtom::GetCharge() * exp(-dist / screening_length) / dist : 0.0);
+    else
+        cell_potential_energy_ += ((atom->MolecularDynamicAtom::GetCharge() != dNotSet) ? atom->MolecularDynamicAtom::GetCharge() / dist : 0.0);
+}
+
 void Cell::CalculateBoxCharge()
 {
     double charge = 0.0;
-    Assembly::AtomVector all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssembly();
-    for(Assembly::AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    const Assembly::AtomVector& all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssemblyView();
+    for(Assembly::AtomVector::const_iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = *it;
         if(atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX() <= this->GetMaxCorner()->GetX() &&
@@ -207,9 +235,9 @@ void Cell::CalculateBoxCharge()
 void Cell::CalculateBoxPotentialEnergy()
 {
     double potential_energy = 0.0;
-    Assembly::AtomVector all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssembly();
+    const Assembly::AtomVector& all_atoms = this->grid_->GetAssembly()->GetAllAtomsOfAssemblyView();
     Coordinate* center_of_cell = this->GetCellCenter();
-    for(Assembly::AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    for(Assembly::AtomVector::const_iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = *it;
         double dist = sqrt((center_of_cell->GetX() - atom->GetCoordinates().at(this->grid_->GetAssembly()->GetModelIndex())->GetX()) *
@@ -226,6 +254,13 @@ void Cell::CalculateBoxPotentialEnergy()
     cell_potential_energy_ = potential_energy;
 }
 
+void Cell::UpdateCellCenter()
+{
+    cell_center_ = Coordinate(min_corner_.GetX() + (max_corner_.GetX() - min_corner_.GetX()) / 2,
+                              min_corner_.GetY() + (max_corner_.GetY() - min_corner_.GetY()) / 2,
+                              min_corner_.GetZ() + (max_corner_.GetZ() - min_corner_.GetZ()) / 2);
+}
+
 //////////////////////////////////////////////////////////
 //                     DISPLAY FUNCTIONS                //
 //////////////////////////////////////////////////////////
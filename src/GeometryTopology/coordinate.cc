@@ -64,6 +64,16 @@ void Coordinate::Translate(double x, double y, double z)
     z_ += z;
 }
 
+void Coordinate::Transform(const double matrix[3][4])
+{
+    double x = x_;
+    double y = y_;
+    double z = z_;
+    x_ = matrix[0][0] * x + matrix[0][1] * y + matrix[0][2] * z + matrix[0][3];
+    y_ = matrix[1][0] * x + matrix[1][1] * y + matrix[1][2] * z + matrix[1][3];
+    z_ = matrix[2][0] * x + matrix[2][1] * y + matrix[2][2] * z + matrix[2][3];
+}
+
 bool Coordinate::CompareTo(Coordinate coordinate)
 {
     if(x_ == coordinate.x_ && y_ == coordinate.y_ && z_ == coordinate.z_)
@@ -146,18 +156,18 @@ void Coordinate::TranslateAll(CoordinateVector coordinate_set, double margin, in
 {
     if(coordinate_set.size() == 0)
         return;
-    Coordinate* direction;
+    Coordinate direction;
     if(pos == 1)
-        direction  = new Coordinate(coordinate_set.at(0));
+        direction = Coordinate(coordinate_set.at(0));
     if(pos == -1)
-        direction  = new Coordinate(coordinate_set.at(coordinate_set.size()-1));
-    direction->operator -(this);
-    Coordinate* offset = new Coordinate(direction);
-    offset->Normalize();
-    offset->operator *(margin);
-    offset->operator -(direction);
+        direction = Coordinate(coordinate_set.at(coordinate_set.size()-1));
+    direction.operator -(this);
+    Coordinate offset = Coordinate(direction);
+    offset.Normalize();
+    offset.operator *(margin);
+    offset.operator -(direction);
     for(CoordinateVector::iterator it = coordinate_set.begin(); it != coordinate_set.end(); it++)
-        (*it)->Translate(offset->GetX(), offset->GetY(), offset->GetZ());
+        (*it)->Translate(offset.GetX(), offset.GetY(), offset.GetZ());
 }
 
 void Coordinate::RotateAngularAll(CoordinateVector coordinate_set, double angle, int pos){
@@ -165,64 +175,43 @@ void Coordinate::RotateAngularAll(CoordinateVector coordinate_set, double angle,
         return;
     double current_angle = 0.0;
     Coordinate* a1 = this;
-    Coordinate* a2;
-    Coordinate* a3;
+    Coordinate a2;
+    Coordinate a3;
     if(pos == 1){
-        a2 = new Coordinate(coordinate_set.at(0));
-        a3 = new Coordinate(coordinate_set.at(1));
+        a2 = Coordinate(coordinate_set.at(0));
+        a3 = Coordinate(coordinate_set.at(1));
     }
     if(pos == -1){
-        a2 = new Coordinate(coordinate_set.at(coordinate_set.size()-1));
-        a3 = new Coordinate(coordinate_set.at(coordinate_set.size()-2));
+        a2 = Coordinate(coordinate_set.at(coordinate_set.size()-1));
+        a3 = Coordinate(coordinate_set.at(coordinate_set.size()-2));
     }
 
-    Coordinate* b1 = new Coordinate(*a1);
-    b1->operator -(*a2);
-    Coordinate* b2 = new Coordinate(*a3);
-    b2->operator -(*a2);
+    Coordinate b1 = Coordinate(*a1);
+    b1.operator -(a2);
+    Coordinate b2 = Coordinate(a3);
+    b2.operator -(a2);
 
-    current_angle = acos((b1->DotProduct(*b2)) / (b1->length() * b2->length() + DIST_EPSILON));
+    current_angle = acos((b1.DotProduct(b2)) / (b1.length() * b2.length() + DIST_EPSILON));
     double rotation_angle = ConvertDegree2Radian(angle) - current_angle;
 
-    Coordinate* direction = new Coordinate(*b1);
-    direction->CrossProduct(*b2);
-    direction->Normalize();
-    double** rotation_matrix = GenerateRotationMatrix(direction, a2, rotation_angle);
+    Coordinate direction = Coordinate(b1);
+    direction.CrossProduct(b2);
+    direction.Normalize();
+    double rotation_matrix[3][4];
+    GenerateRotationMatrix(&direction, &a2, rotation_angle, rotation_matrix);
 
     if(pos == 1)
     {
         for(CoordinateVector::iterator it = coordinate_set.begin() + 1; it != coordinate_set.end(); it++)
         {
-            Coordinate* coordinate = (*it);
-            Coordinate* result = new Coordinate();
-            result->SetX(rotation_matrix[0][0] * coordinate->GetX() + rotation_matrix[0][1] * coordinate->GetY() +
-                    rotation_matrix[0][2] * coordinate->GetZ() + rotation_matrix[0][3]);
-            result->SetY(rotation_matrix[1][0] * coordinate->GetX() + rotation_matrix[1][1] * coordinate->GetY() +
-                    rotation_matrix[1][2] * coordinate->GetZ() + rotation_matrix[1][3]);
-            result->SetZ(rotation_matrix[2][0] * coordinate->GetX() + rotation_matrix[2][1] * coordinate->GetY() +
-                    rotation_matrix[2][2] * coordinate->GetZ() + rotation_matrix[2][3]);
-
-            (*it)->SetX(result->GetX());
-            (*it)->SetY(result->GetY());
-            (*it)->SetZ(result->GetZ());
+            (*it)->Transform(rotation_matrix);
         }
     }
     if(pos == -1)
     {
         for(CoordinateVector::iterator it = coordinate_set.begin(); it != coordinate_set.end() - 1; it++)
         {
-            Coordinate* coordinate = (*it);
-            Coordinate* result = new Coordinate();
-            result->SetX(rotation_matrix[0][0] * coordinate->GetX() + rotation_matrix[0][1] * coordinate->GetY() +
-                    rotation_matrix[0][2] * coordinate->GetZ() + rotation_matrix[0][3]);
-            result->SetY(rotation_matrix[1][0] * coordinate->GetX() + rotation_matrix[1][1] * coordinate->GetY() +
-                    rotation_matrix[1][2] * coordinate->GetZ() + rotation_matrix[1][3]);
-            result->SetZ(rotation_matrix[2][0] * coordinate->GetX() + rotation_matrix[2][1] * coordinate->GetY() +
-                    rotation_matrix[2][2] * coordinate->GetZ() + rotation_matrix[2][3]);
-
-            (*it)->SetX(result->GetX());
-            (*it)->SetY(result->GetY());
-            (*it)->SetZ(result->GetZ());
+            (*it)->Transform(rotation_matrix);
         }
     }
 }
@@ -233,79 +222,58 @@ void Coordinate::RotateTorsionalAll(CoordinateVector coordinate_set, double tors
         return;
     double current_dihedral = 0.0;
     Coordinate* a1 = this;
-    Coordinate* a2;
-    Coordinate* a3;
-    Coordinate* a4;
+    Coordinate a2;
+    Coordinate a3;
+    Coordinate a4;
     if(pos == 1)
     {
-        a2 = new Coordinate(coordinate_set.at(0));
-        a3 = new Coordinate(coordinate_set.at(1));
-        a4 = new Coordinate(coordinate_set.at(2));
+        a2 = Coordinate(coordinate_set.at(0));
+        a3 = Coordinate(coordinate_set.at(1));
+        a4 = Coordinate(coordinate_set.at(2));
     }
     if(pos == -1)
     {
-        a2 = new Coordinate(coordinate_set.at(coordinate_set.size()-1));
-        a3 = new Coordinate(coordinate_set.at(coordinate_set.size()-2));
-        a4 = new Coordinate(coordinate_set.at(coordinate_set.size()-3));
+        a2 = Coordinate(coordinate_set.at(coordinate_set.size()-1));
+        a3 = Coordinate(coordinate_set.at(coordinate_set.size()-2));
+        a4 = Coordinate(coordinate_set.at(coordinate_set.size()-3));
     }
 
-    Coordinate* b1 = new Coordinate(*a2);
-    b1->operator -(*a1);
-    Coordinate* b2 = new Coordinate(*a3);
-    b2->operator -(*a2);
-    Coordinate* b3 = new Coordinate(*a4);
-    b3->operator -(*a3);
-    Coordinate* b4 = new Coordinate(*b2);
-    b4->operator *(-1);
+    Coordinate b1 = Coordinate(a2);
+    b1.operator -(*a1);
+    Coordinate b2 = Coordinate(a3);
+    b2.operator -(a2);
+    Coordinate b3 = Coordinate(a4);
+    b3.operator -(a3);
+    Coordinate b4 = Coordinate(b2);
+    b4.operator *(-1);
 
-    Coordinate* b2xb3 = new Coordinate(*b2);
-    b2xb3->CrossProduct(*b3);
+    Coordinate b2xb3 = Coordinate(b2);
+    b2xb3.CrossProduct(b3);
 
-    Coordinate* b1_m_b2n = new Coordinate(*b1);
-    b1_m_b2n->operator *(b2->length());
+    Coordinate b1_m_b2n = Coordinate(b1);
+    b1_m_b2n.operator *(b2.length());
 
-    Coordinate* b1xb2 = new Coordinate(*b1);
-    b1xb2->CrossProduct(*b2);
+    Coordinate b1xb2 = Coordinate(b1);
+    b1xb2.CrossProduct(b2);
 
-    current_dihedral = atan2(b1_m_b2n->DotProduct(*b2xb3), b1xb2->DotProduct(*b2xb3));
+    current_dihedral = atan2(b1_m_b2n.DotProduct(b2xb3), b1xb2.DotProduct(b2xb3));
 
-    double** torsion_matrix = GenerateRotationMatrix(b4, a2, current_dihedral - ConvertDegree2Radian(torsion));
+    double torsion_matrix[3][4];
+    GenerateRotationMatrix(&b4, &a2, current_dihedral - ConvertDegree2Radian(torsion), torsion_matrix);
 
 
     if(pos == 1)
     {
         for(CoordinateVector::iterator it = coordinate_set.begin() + 2; it != coordinate_set.end(); it++)
         {
-            Coordinate* coordinate = (*it);
-            Coordinate* result = new Coordinate();
-            result->SetX(torsion_matrix[0][0] * coordinate->GetX() + torsion_matrix[0][1] * coordinate->GetY() +
-                    torsion_matrix[0][2] * coordinate->GetZ() + torsion_matrix[0][3]);
-            result->SetY(torsion_matrix[1][0] * coordinate->GetX() + torsion_matrix[1][1] * coordinate->GetY() +
-                    torsion_matrix[1][2] * coordinate->GetZ() + torsion_matrix[1][3]);
-            result->SetZ(torsion_matrix[2][0] * coordinate->GetX() + torsion_matrix[2][1] * coordinate->GetY() +
-                    torsion_matrix[2][2] * coordinate->GetZ() + torsion_matrix[2][3]);
-
-            (*it)->SetX(result->GetX());
-            (*it)->SetY(result->GetY());
-            (*it)->SetZ(result->GetZ());
+            (*it)->Transform(torsion_matrix);
         }
     }
     if(pos == -1)
     {
         for(CoordinateVector::iterator it = coordinate_set.begin(); it != coordinate_set.end() - 2; it++)
         {
-            Coordinate* coordinate = (*it);
-            Coordinate* result = new Coordinate();
-            result->SetX(torsion_matrix[0][0] * coordinate->GetX() + torsion_matrix[0][1] * coordinate->GetY() +
-                    torsion_matrix[0][2] * coordinate->GetZ() + torsion_matrix[0][3]);
-            result->SetY(torsion_matrix[1][0] * coordinate->GetX() + torsion_matrix[1][1] * coordinate->GetY() +
-                    torsion_matrix[1][2] * coordinate->GetZ() + torsion_matrix[1][3]);
-            result->SetZ(torsion_matrix[2][0] * coordinate->GetX() + torsion_matrix[2][1] * coordinate->GetY() +
-                    torsion_matrix[2][2] * coordinate->GetZ() + torsion_matrix[2][3]);
-
-            (*it)->SetX(result->GetX());
-            (*it)->SetY(result->GetY());
-            (*it)->SetZ(result->GetZ());
+            (*it)->Transform(torsion_matrix);
         }
     }
 }
@@ -0,0 +1,72 @@
+#include "../../includes/GeometryTopology/coordinateframe.hpp"
+#include "../../includes/GeometryTopology/coordinate.hpp"
+
+using namespace std;
+using namespace GeometryTopology;
+
+//////////////////////////////////////////////////////////
+//                       Constructor                    //
+//////////////////////////////////////////////////////////
+CoordinateFrame::CoordinateFrame(int block_size) : block_size_(block_size), size_(0)
+{
+    if(block_size_ < 1)
+        block_size_ = 1;
+    blocks_ = CoordinateVector();
+}
+
+CoordinateFrame::~CoordinateFrame()
+{
+    for(CoordinateVector::iterator it = blocks_.begin(); it != blocks_.end(); it++)
+        delete[] *it;
+}
+
+//////////////////////////////////////////////////////////
+//                           ACCESSOR                   //
+//////////////////////////////////////////////////////////
+int CoordinateFrame::GetNumberOfCoordinates()
+{
+    return size_;
+}
+
+Coordinate* CoordinateFrame::GetCoordinate(int index)
+{
+    if(index < 0 || index >= size_)
+        return NULL;
+    return blocks_.at(index / block_size_) + (index % block_size_);
+}
+
+CoordinateFrame::CoordinateVector CoordinateFrame::GetCoordinates()
+{
+    CoordinateVector coordinates = CoordinateVector();
+    coordinates.reserve(size_);
+    for(int i = 0; i < size_; i++)
+        coordinates.push_back(blocks_.at(i / block_size_) + (i % block_size_));
+    return coordinates;
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+Coordinate* CoordinateFrame::AddCoordinate(const Coordinate& coordinate)
+{
+    ///Coordinates are handed out from fixed size blocks that are never reallocated, so the pointers held by the atoms stay valid
+    if(size_ == (int)blocks_.size() * block_size_)
+        blocks_.push_back(new Coordinate[block_size_]);
+    Coordinate* new_coordinate = blocks_.back() + (size_ % block_size_);
+    *new_coordinate = coordinate;
+    size_++;
+    return new_coordinate;
+}
+
+Coordinate* CoordinateFrame::AddCoordinate(double x, double y, double z)
+{
+    return this->AddCoordinate(Coordinate(x, y, z));
+}
+
+//////////////////////////////////////////////////////////
+//                     DISPLAY FUNCTIONS                //
+//////////////////////////////////////////////////////////
+void CoordinateFrame::Print(ostream &out)
+{
+    out << "Coordinates: " << size_ << " in " << blocks_.size() << " block(s) of " << block_size_ << endl;
+}
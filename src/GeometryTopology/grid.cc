@@ -1,6 +1,9 @@
+#include <algorithm>
+
 #include "../../includes/GeometryTopology/coordinate.hpp"
 #include "../../includes/GeometryTopology/cell.hpp"
 #include "../../includes/GeometryTopology/grid.hpp"
+#include "../../includes/GeometryTopology/neighborgrid.hpp"
 #include "../../includes/common.hpp"
 
 using namespace std;
@@ -12,27 +15,39 @@ using namespace gmml;
 //////////////////////////////////////////////////////////
 Grid::Grid()
 {
-    min_corner_ = new Coordinate();
-    max_corner_ = new Coordinate();
+    min_corner_ = Coordinate();
+    max_corner_ = Coordinate();
     cells_ = CellVector();
     assembly_ = NULL;
+    cutoff_ = 0.0;
+    screening_length_ = 0.0;
+    ranked_ = false;
+    ranking_sign_ = 1.0;
 }
 
 Grid::Grid(Assembly *assembly, Coordinate *min, Coordinate *max, double ion_radius, double ion_charge)
 {
-    min_corner_ = new Coordinate(min->GetX(), min->GetY(), min->GetZ());
-    max_corner_ = new Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    min_corner_ = Coordinate(min->GetX(), min->GetY(), min->GetZ());
+    max_corner_ = Coordinate(max->GetX(), max->GetY(), max->GetZ());
     cells_ = CellVector();
     assembly_ = assembly;
+    cutoff_ = 0.0;
+    screening_length_ = 0.0;
+    ranked_ = false;
+    ranking_sign_ = 1.0;
     this->UpdateGrid(ion_charge);
 }
 
 Grid::Grid(Assembly *assembly, Coordinate *min, Coordinate *max, double cell_length, double cell_width, double cell_height)
 {
-    min_corner_ = new Coordinate(min->GetX(), min->GetY(), min->GetZ());
-    max_corner_ = new Coordinate(max->GetX(), max->GetY(), max->GetZ());
+    min_corner_ = Coordinate(min->GetX(), min->GetY(), min->GetZ());
+    max_corner_ = Coordinate(max->GetX(), max->GetY(), max->GetZ());
     cells_ = CellVector();
     assembly_ = assembly;
+    cutoff_ = 0.0;
+    screening_length_ = 0.0;
+    ranked_ = false;
+    ranking_sign_ = 1.0;
     this->UpdateGrid(cell_length, cell_width, cell_height);
 }
 //////////////////////////////////////////////////////////
@@ -40,12 +55,12 @@ Grid::Grid(Assembly *assembly, Coordinate *min, Coordinate *max, double cell_len
 //////////////////////////////////////////////////////////
 Coordinate* Grid::GetMinCorner()
 {
-    return min_corner_;
+    return &min_corner_;
 }
 
 Coordinate* Grid::GetMaxCorner()
 {
-    return max_corner_;
+    return &max_corner_;
 }
 
 Grid::CellVector Grid::GetCells()
@@ -58,21 +73,32 @@ Assembly* Grid::GetAssembly()
     return assembly_;
 }
 
+Cell* Grid::GetCell(int x_index, int y_index, int z_index)
+{
+    int number_of_cells_y = y_starts_.size();
+    int number_of_cells_z = z_starts_.size();
+    if(x_index < 0 || x_index >= (int)x_starts_.size() || y_index < 0 || y_index >= number_of_cells_y || z_index < 0 || z_index >= number_of_cells_z)
+        return NULL;
+    return &cell_array_.at((x_index * number_of_cells_y + y_index) * number_of_cells_z + z_index);
+}
+
 //////////////////////////////////////////////////////////
 //                           MUTATOR                    //
 //////////////////////////////////////////////////////////
 void Grid::SetMinCorner(Coordinate *min)
 {
-    min_corner_ = min;
+    min_corner_ = Coordinate(min->GetX(), min->GetY(), min->GetZ());
 }
 
 void Grid::SetMaxCorner(Coordinate *max)
 {
-    max_corner_ = max;
+    max_corner_ = Coordinate(max->GetX(), max->GetY(), max->GetZ());
 }
 
 void Grid::SetCells(CellVector cells)
 {
+    ranking_.clear();
+    ranked_ = false;
     cells_.clear();
     for(CellVector::iterator it = cells.begin(); it != cells.end(); it++)
     {
@@ -90,358 +116,378 @@ void Grid::SetAssembly(Assembly *assembly)
 //////////////////////////////////////////////////////////
 void Grid::UpdateGrid(double length, double width, double height)
 {
-    double min_x = this->GetMinCorner()->GetX();
-    double min_y = this->GetMinCorner()->GetY();
-    double min_z = this->GetMinCorner()->GetZ();
-    double max_x = this->GetMaxCorner()->GetX();
-    double max_y = this->GetMaxCorner()->GetY();
-    double max_z = this->GetMaxCorner()->GetZ();
+    this->DivideAxis(min_corner_.GetX(), max_corner_.GetX(), length, x_starts_, x_ends_);
+    this->DivideAxis(min_corner_.GetY(), max_corner_.GetY(), width, y_starts_, y_ends_);
+    this->DivideAxis(min_corner_.GetZ(), max_corner_.GetZ(), height, z_starts_, z_ends_);
+    this->BuildCells();
+}
 
-    Grid::CellVector grid_cells = Grid::CellVector();
-    for(double i = min_x; i <= max_x; i += length)
+void Grid::UpdateGrid(double ion_charge)
+{
+    this->PartitionRegion(min_corner_, max_corner_, ion_charge);
+}
+
+void Grid::CalculateCellsCharge()
+{
+    for(CellArray::iterator it = cell_array_.begin(); it != cell_array_.end(); it++)
+        it->SetCellCharge(0.0);
+    if(!cell_array_.empty())
     {
-        for(double j = min_y; j <= max_y; j += width)
+        int model_index = assembly_->GetModelIndex();
+        const Assembly::AtomVector& all_atoms = assembly_->GetAllAtomsOfAssemblyView();
+        for(Assembly::AtomVector::const_iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
         {
-            for(double k = min_z; k <= max_z; k += height)
+            Atom* atom = *it;
+            Coordinate* coordinate = atom->GetCoordinates().at(model_index);
+            int x_index = this->CellIndexAlongAxis(coordinate->GetX(), x_starts_, x_ends_);
+            int y_index = this->CellIndexAlongAxis(coordinate->GetY(), y_starts_, y_ends_);
+            int z_index = this->CellIndexAlongAxis(coordinate->GetZ(), z_starts_, z_ends_);
+            if(x_index == -1 || y_index == -1 || z_index == -1)
+                continue;
+            Cell* cell = this->GetCell(x_index, y_index, z_index);
+            cell->SetCellCharge(cell->GetCellCharge() +
+                                ((atom->MolecularDynamicAtom::GetCharge() != dNotSet) ? atom->MolecularDynamicAtom::GetCharge() : 0.0));
+        }
+    }
+    /// Cells that have been given to the grid from outside are not in the dense array and are calculated one by one
+    for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
+    {
+        if(!this->IsStoredCell(*it))
+            (*it)->CalculateCellCharge();
+    }
+}
+
+void* CalculateCellsPotentialEnergyThread(void* args)
+{
+    CellPotentialThreadArgument* arg = (CellPotentialThreadArgument*)args;
+    vector<Coordinate*>& centers = *(arg->centers);
+    vector<double>& potential_energies = *(arg->potential_energies);
+    int size = centers.size();
+    int begin_index = (int)(((long long)arg->thread_index * size) / arg->number_of_threads);
+    int end_index = (int)(((long long)(arg->thread_index + 1) * size) / arg->number_of_threads);
+    int number_of_atoms = arg->x->size();
+    if(number_of_atoms == 0)
+    {
+        for(int index = begin_index; index < end_index; index++)
+            potential_energies[index] = 0.0;
+        pthread_exit(NULL);
+    }
+    const double* x = &(*arg->x)[0];
+    const double* y = &(*arg->y)[0];
+    const double* z = &(*arg->z)[0];
+    const double* charges = &(*arg->charges)[0];
+    const double* overlap_distances = &(*arg->overlap_distances)[0];
+    double screening_length = arg->screening_length;
+
+    vector<double> terms = vector<double>(number_of_atoms, 0.0);
+    vector<int> candidates = vector<int>();
+    for(int index = begin_index; index < end_index; index++)
+    {
+        Coordinate* center_of_cell = centers[index];
+        double center_x = center_of_cell->GetX();
+        double center_y = center_of_cell->GetY();
+        double center_z = center_of_cell->GetZ();
+        double potential_energy = 0.0;
+        if(arg->atom_grid == NULL)
+        {
+            ///The terms of all atoms are computed without branches and summed afterwards in the order of the atoms,
+            ///so the result is the same as the one of Cell::CalculateCellPotentialEnergy
+            int overlap = 0;
+            if(screening_length > 0.0)
             {
-                if(i + length <= max_x)
+                for(int i = 0; i < number_of_atoms; i++)
                 {
-                    if(j + width <= max_y)
-                    {
-                        if(k + height <= max_z)
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k),
-                                                      new Coordinate(i + length, j + width, k + height));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-                        }
-                        else
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + length, j + width, max_z));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-                        }
-                    }
-                    else
-                    {
-                        if(k + height <= max_z)
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + length, max_y, k + height));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-                        }
-                        else
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + length, max_y, max_z));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-                        }
-                    }
+                    double dist = sqrt((center_x - x[i]) * (center_x - x[i]) + (center_y - y[i]) * (center_y - y[i]) + (center_z - z[i]) * (center_z - z[i]));
+                    overlap |= (dist < overlap_distances[i]);
+                    terms[i] = charges[i] * exp(-dist / screening_length) / dist;
                 }
-                else
+            }
+            else
+            {
+                for(int i = 0; i < number_of_atoms; i++)
                 {
-                    if(j + width <= max_y)
-                    {
-                        if(k + height <= max_z)
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, j + width, k + height));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-                        }
-                        else
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, j + width, max_z));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-                        }
-                    }
-                    else
-                    {
-                        if(k + height <= max_z)
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, max_y, k + height));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-
-                        }
-                        else
-                        {
-                            Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, max_y, max_z));
-                            new_cell->SetGrid(this);
-                            grid_cells.push_back(new_cell);
-
-                        }
-                    }
+                    double dist = sqrt((center_x - x[i]) * (center_x - x[i]) + (center_y - y[i]) * (center_y - y[i]) + (center_z - z[i]) * (center_z - z[i]));
+                    overlap |= (dist < overlap_distances[i]);
+                    terms[i] = charges[i] / dist;
                 }
             }
+            if(overlap)
+                potential_energy = INFINITY;
+            else
+                for(int i = 0; i < number_of_atoms; i++)
+                    potential_energy += terms[i];
         }
+        else
+        {
+            ///Only the atoms in the surrounding cells of the atom grid can be closer than the cutoff or overlap with the ion
+            candidates.clear();
+            arg->atom_grid->GetCandidateIndices(center_x, center_y, center_z, candidates);
+            for(vector<int>::iterator it = candidates.begin(); it != candidates.end(); it++)
+            {
+                int i = *it;
+                double dist = sqrt((center_x - x[i]) * (center_x - x[i]) + (center_y - y[i]) * (center_y - y[i]) + (center_z - z[i]) * (center_z - z[i]));
+                if(dist < overlap_distances[i])
+                {
+                    potential_energy = INFINITY;
+                    break;
+                }
+                if(dist >= arg->cutoff)
+                    continue;
+                if(screening_length > 0.0)
+                    potential_energy += charges[i] * exp(-dist / screening_length) / dist;
+                else
+                    potential_energy += charges[i] / dist;
+            }
+        }
+        potential_energies[index] = potential_energy;
     }
-    this->SetCells(grid_cells);
-    return;
+    pthread_exit(NULL);
+}
 
+void Grid::CalculateCellsPotentialEnergy(double ion_radius, int number_of_threads, double cutoff, double screening_length, double minimum_distance)
+{
+    ranking_.clear();
+    ranked_ = false;
+    cutoff_ = (cutoff > 0.0) ? cutoff : 0.0;
+    screening_length_ = (screening_length > 0.0) ? screening_length : 0.0;
+
+    ///Coordinates, charges and overlap distances are looked up once per atom instead of once per cell and atom
+    const Assembly::AtomVector& all_atoms = assembly_->GetAllAtomsOfAssemblyView();
+    int model_index = assembly_->GetModelIndex();
+    vector<Coordinate*> coordinates = vector<Coordinate*>();
+    vector<double> charges = vector<double>();
+    vector<double> overlap_distances = vector<double>();
+    coordinates.reserve(all_atoms.size());
+    charges.reserve(all_atoms.size());
+    overlap_distances.reserve(all_atoms.size());
+    for(Assembly::AtomVector::const_iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    {
+        Atom* atom = *it;
+        coordinates.push_back(atom->GetCoordinates().at(model_index));
+        charges.push_back((atom->MolecularDynamicAtom::GetCharge() != dNotSet) ? atom->MolecularDynamicAtom::GetCharge() : 0.0);
+        double radius = (atom->MolecularDynamicAtom::GetRadius() != dNotSet) ? atom->MolecularDynamicAtom::GetRadius() : MINIMUM_RADIUS;
+        overlap_distances.push_back((radius + GRID_OFFSET + ion_radius > minimum_distance) ? radius + GRID_OFFSET + ion_radius : minimum_distance);
+    }
+    vector<Coordinate*> centers = vector<Coordinate*>();
+    centers.reserve(cells_.size());
+    for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
+        centers.push_back((*it)->GetCellCenter());
+    vector<double> potential_energies = vector<double>();
+    Grid::CalculatePotentialEnergies(centers, coordinates, charges, overlap_distances, number_of_threads, cutoff_, screening_length_, potential_energies);
+    for(unsigned int i = 0; i < cells_.size(); i++)
+        cells_.at(i)->SetCellPotentialEnergy(potential_energies.at(i));
 }
 
-void Grid::UpdateGrid(double ion_charge)
+void Grid::CalculatePotentialEnergies(vector<Coordinate*>& centers, vector<Coordinate*>& atom_coordinates, DoubleVector& charges,
+                                      DoubleVector& overlap_distances, int number_of_threads, double cutoff, double screening_length,
+                                      DoubleVector& potential_energies)
 {
-    double min_x = this->GetMinCorner()->GetX();
-    double min_y = this->GetMinCorner()->GetY();
-    double min_z = this->GetMinCorner()->GetZ();
-    double max_x = this->GetMaxCorner()->GetX();
-    double max_y = this->GetMaxCorner()->GetY();
-    double max_z = this->GetMaxCorner()->GetZ();
+    if(number_of_threads < 1)
+        number_of_threads = 1;
+    potential_energies.assign(centers.size(), 0.0);
+    vector<double> x = vector<double>();
+    vector<double> y = vector<double>();
+    vector<double> z = vector<double>();
+    x.reserve(atom_coordinates.size());
+    y.reserve(atom_coordinates.size());
+    z.reserve(atom_coordinates.size());
+    double maximum_overlap_distance = 0.0;
+    for(unsigned int i = 0; i < atom_coordinates.size(); i++)
+    {
+        x.push_back(atom_coordinates.at(i)->GetX());
+        y.push_back(atom_coordinates.at(i)->GetY());
+        z.push_back(atom_coordinates.at(i)->GetZ());
+        if(overlap_distances.at(i) > maximum_overlap_distance)
+            maximum_overlap_distance = overlap_distances.at(i);
+    }
 
-    Coordinate* min_boundary = new Coordinate();
-    Coordinate* max_boundary = new Coordinate();
-    this->assembly_->GetBoundary(min_boundary, max_boundary);
+    ///With a cutoff the atoms are binned into cells that are large enough for both the cutoff and the overlap check
+    NeighborGrid* atom_grid = NULL;
+    if(cutoff > 0.0 && !atom_coordinates.empty())
+        atom_grid = new NeighborGrid(atom_coordinates, (cutoff > maximum_overlap_distance) ? cutoff : maximum_overlap_distance);
 
-    if(max_x - min_x <= DEFAULT_BOX_LENGTH && max_y - min_y <= DEFAULT_BOX_WIDTH && max_z - min_z <= DEFAULT_BOX_HEIGHT)
+    pthread_t threads[number_of_threads];
+    CellPotentialThreadArgument arg[number_of_threads];
+    for(int i = 0; i < number_of_threads; i++)
     {
-        Grid::CellVector grid_cells = Grid::CellVector();
-        for(double i = min_x; i <= max_x; i += DEFAULT_GRID_LENGTH)
-        {
-            for(double j = min_y; j <= max_y; j += DEFAULT_GRID_WIDTH)
-            {
-                for(double k = min_z; k <= max_z; k += DEFAULT_GRID_HEIGHT)
-                {
-                    if(i + DEFAULT_GRID_LENGTH <= max_x)
-                    {
-                        if(j + DEFAULT_GRID_WIDTH <= max_y)
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k),
-                                                          new Coordinate(i + DEFAULT_GRID_LENGTH, j + DEFAULT_GRID_WIDTH, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + DEFAULT_GRID_LENGTH, j + DEFAULT_GRID_WIDTH, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                        }
-                        else
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + DEFAULT_GRID_LENGTH, max_y, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(i + DEFAULT_GRID_LENGTH, max_y, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                        }
-                    }
-                    else
-                    {
-                        if(j + DEFAULT_GRID_WIDTH <= max_y)
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, j + DEFAULT_GRID_WIDTH, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, j + DEFAULT_GRID_WIDTH, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-                            }
-                        }
-                        else
-                        {
-                            if(k + DEFAULT_GRID_HEIGHT <= max_z)
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, max_y, k + DEFAULT_GRID_HEIGHT));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-
-                            }
-                            else
-                            {
-                                Cell* new_cell = new Cell(new Coordinate(i, j, k), new Coordinate(max_x, max_y, max_z));
-                                if(!(new_cell->GetCellCenter()->GetX() > min_boundary->GetX() && new_cell->GetCellCenter()->GetX() < max_boundary->GetX() &&
-                                     new_cell->GetCellCenter()->GetY() > min_boundary->GetY() && new_cell->GetCellCenter()->GetY() < max_boundary->GetY() &&
-                                     new_cell->GetCellCenter()->GetZ() > min_boundary->GetZ() && new_cell->GetCellCenter()->GetZ() < max_boundary->GetZ()))
-                                {
-                                    new_cell->SetGrid(this);
-                                    grid_cells.push_back(new_cell);
-                                }
-
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        this->SetCells(grid_cells);
-        return;
+        arg[i] = CellPotentialThreadArgument(i, number_of_threads, cutoff, screening_length, &centers, &potential_energies, &x, &y, &z, &charges,
+                                             &overlap_distances, atom_grid);
+        pthread_create(&threads[i], NULL, &CalculateCellsPotentialEnergyThread, &arg[i]);
     }
-    else
+    for(int i = 0; i < number_of_threads; i++)
     {
-        Grid* temp_grid = new Grid();
-        temp_grid->SetMaxCorner(this->GetMaxCorner());
-        temp_grid->SetMinCorner(this->GetMinCorner());
-        double min_x = temp_grid->GetMinCorner()->GetX();
-        double min_y = temp_grid->GetMinCorner()->GetY();
-        double min_z = temp_grid->GetMinCorner()->GetZ();
-        double max_x = temp_grid->GetMaxCorner()->GetX();
-        double max_y = temp_grid->GetMaxCorner()->GetY();
-        double max_z = temp_grid->GetMaxCorner()->GetZ();
-        Grid::CellVector grid_cells = Grid::CellVector();
-        grid_cells.push_back(new Cell(temp_grid,
-                                      temp_grid->GetMinCorner(),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                      new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
-                                                     temp_grid->GetMinCorner()->GetY(),
-                                                     temp_grid->GetMinCorner()->GetZ()),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_x),
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                      new Coordinate(temp_grid->GetMinCorner()->GetX(),
-                                                     temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                                     temp_grid->GetMinCorner()->GetZ()),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                      new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
-                                                     temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                                     temp_grid->GetMinCorner()->GetZ()),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2)));
-        grid_cells.push_back(new Cell(temp_grid,
-                                      new Coordinate(temp_grid->GetMinCorner()->GetX(),
-                                                     temp_grid->GetMinCorner()->GetY(),
-                                                     temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_y) / 2,
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
-        grid_cells.push_back(new Cell(temp_grid,
-                                      new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
-                                                     temp_grid->GetMinCorner()->GetY(),
-                                                     temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
-        grid_cells.push_back(new Cell(temp_grid,
-                                      new Coordinate(temp_grid->GetMinCorner()->GetX(),
-                                                     temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                                     temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
-        grid_cells.push_back(new Cell(temp_grid,
-                                      new Coordinate(temp_grid->GetMinCorner()->GetX() + (max_x - min_x) / 2,
-                                                     temp_grid->GetMinCorner()->GetY() + (max_y - min_y) / 2,
-                                                     temp_grid->GetMinCorner()->GetZ() + (max_z - min_z) / 2),
-                                      new Coordinate(
-                                          temp_grid->GetMinCorner()->GetX() + (max_x - min_y),
-                                          temp_grid->GetMinCorner()->GetY() + (max_y - min_y),
-                                          temp_grid->GetMinCorner()->GetZ() + (max_z - min_z))));
-
-
-
-        temp_grid->SetCells(grid_cells);
+        pthread_join(threads[i], NULL);
+    }
+    delete atom_grid;
+}
 
-        temp_grid->CalculateBoxCharge();
-        temp_grid->CalculateBoxPotentialEnergy();
-        Cell* best_box = temp_grid->GetBestBox(temp_grid, ion_charge);
-        if(best_box != NULL)
+void Grid::UpdateCellsPotentialEnergy(Atom* atom, double ion_radius, double minimum_distance)
+{
+    if(!ranked_ || cutoff_ <= 0.0)
+    {
+        for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
         {
-            Grid* new_grid = new Grid();
-            new_grid->SetAssembly(this->assembly_);
-            new_grid->SetMaxCorner(best_box->GetMaxCorner());
-            new_grid->SetMinCorner(best_box->GetMinCorner());
-            new_grid->UpdateGrid(ion_charge);
-            this->SetCells(new_grid->GetCells());
-            return;
+            (*it)->UpdateCellPotentialEnergy(atom, ion_radius, cutoff_, screening_length_, minimum_distance);
         }
-        else
+        if(ranked_)
+            this->FillRanking();
+        return;
+    }
+
+    ///Only the cells within the cutoff or the overlap distance of the atom can change; the ranked cells are exactly the cells of cells_
+    ///with a finite potential energy, so a cell that is not found in the ranking is left alone
+    Coordinate* atom_coordinate = atom->GetCoordinates().at(assembly_->GetModelIndex());
+    double radius = (atom->MolecularDynamicAtom::GetRadius() != dNotSet) ? atom->MolecularDynamicAtom::GetRadius() : MINIMUM_RADIUS;
+    double reach = cutoff_;
+    if(radius + GRID_OFFSET + ion_radius > reach)
+        reach = radius + GRID_OFFSET + ion_radius;
+    if(minimum_distance > reach)
+        reach = minimum_distance;
+    int first_x = 0, last_x = -1, first_y = 0, last_y = -1, first_z = 0, last_z = -1;
+    this->CellRangeAlongAxis(0, atom_coordinate->GetX() - reach, atom_coordinate->GetX() + reach, first_x, last_x);
+    this->CellRangeAlongAxis(1, atom_coordinate->GetY() - reach, atom_coordinate->GetY() + reach, first_y, last_y);
+    this->CellRangeAlongAxis(2, atom_coordinate->GetZ() - reach, atom_coordinate->GetZ() + reach, first_z, last_z);
+    for(int i = first_x; i <= last_x; i++)
+    {
+        for(int j = first_y; j <= last_y; j++)
         {
-            cout << "Can't create an appropriate grid!" << endl;
-            return;
+            for(int k = first_z; k <= last_z; k++)
+            {
+                Cell* cell = this->GetCell(i, j, k);
+                if(cell->GetCellPotentialEnergy() == INFINITY)
+                    continue;
+                int index = cell - &cell_array_.front();
+                if(ranking_.erase(make_pair(ranking_sign_ * cell->GetCellPotentialEnergy(), index)) == 0)
+                    continue;
+                cell->UpdateCellPotentialEnergy(atom, ion_radius, cutoff_, screening_length_, minimum_distance);
+                if(cell->GetCellPotentialEnergy() != INFINITY)
+                    ranking_.insert(make_pair(ranking_sign_ * cell->GetCellPotentialEnergy(), index));
+            }
         }
-
-
     }
 }
 
-void Grid::CalculateCellsCharge()
+void Grid::RemoveCellsInsideAssembly()
 {
+    Coordinate* min_boundary = new Coordinate();
+    Coordinate* max_boundary = new Coordinate();
+    this->assembly_->GetBoundary(min_boundary, max_boundary);
+    CellVector remaining_cells = CellVector();
     for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
     {
-        (*it)->CalculateCellCharge();
+        Cell* cell = *it;
+        Coordinate* center_of_cell = cell->GetCellCenter();
+        if(!(center_of_cell->GetX() > min_boundary->GetX() && center_of_cell->GetX() < max_boundary->GetX() &&
+             center_of_cell->GetY() > min_boundary->GetY() && center_of_cell->GetY() < max_boundary->GetY() &&
+             center_of_cell->GetZ() > min_boundary->GetZ() && center_of_cell->GetZ() < max_boundary->GetZ()))
+            remaining_cells.push_back(cell);
     }
+    if(ranked_)
+    {
+        for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
+        {
+            Cell* cell = *it;
+            Coordinate* center_of_cell = cell->GetCellCenter();
+            if(IsStoredCell(cell) && cell->GetCellPotentialEnergy() != INFINITY &&
+                    center_of_cell->GetX() > min_boundary->GetX() && center_of_cell->GetX() < max_boundary->GetX() &&
+                    center_of_cell->GetY() > min_boundary->GetY() && center_of_cell->GetY() < max_boundary->GetY() &&
+                    center_of_cell->GetZ() > min_boundary->GetZ() && center_of_cell->GetZ() < max_boundary->GetZ())
+                ranking_.erase(make_pair(ranking_sign_ * cell->GetCellPotentialEnergy(), (int)(cell - &cell_array_.front())));
+        }
+        boundary_min_ = *min_boundary;
+        boundary_max_ = *max_boundary;
+    }
+    delete min_boundary;
+    delete max_boundary;
+    cells_ = remaining_cells;
 }
 
-void Grid::CalculateCellsPotentialEnergy(double ion_radius)
+void Grid::RemoveCellsInsideAssembly(Atom* added_atom)
 {
+    if(!ranked_)
+    {
+        this->RemoveCellsInsideAssembly();
+        return;
+    }
+    ///The same extension of the boundary as in Assembly::GetBoundary
+    Coordinate* atom_coordinate = added_atom->GetCoordinates().at(assembly_->GetModelIndex());
+    double radius = (added_atom->MolecularDynamicAtom::GetRadius() != dNotSet) ? added_atom->MolecularDynamicAtom::GetRadius() : DEFAULT_RADIUS;
+    Coordinate min_boundary = boundary_min_;
+    Coordinate max_boundary = boundary_max_;
+    if(atom_coordinate->GetX() - radius < min_boundary.GetX())
+        min_boundary.SetX(atom_coordinate->GetX() - radius);
+    if(atom_coordinate->GetY() - radius < min_boundary.GetY())
+        min_boundary.SetY(atom_coordinate->GetY() - radius);
+    if(atom_coordinate->GetZ() - radius < min_boundary.GetZ())
+        min_boundary.SetZ(atom_coordinate->GetZ() - radius);
+    if(atom_coordinate->GetX() + radius > max_boundary.GetX())
+        max_boundary.SetX(atom_coordinate->GetX() + radius);
+    if(atom_coordinate->GetY() + radius > max_boundary.GetY())
+        max_boundary.SetY(atom_coordinate->GetY() + radius);
+    if(atom_coordinate->GetZ() + radius > max_boundary.GetZ())
+        max_boundary.SetZ(atom_coordinate->GetZ() + radius);
+    if(min_boundary.GetX() == boundary_min_.GetX() && min_boundary.GetY() == boundary_min_.GetY() && min_boundary.GetZ() == boundary_min_.GetZ() &&
+            max_boundary.GetX() == boundary_max_.GetX() && max_boundary.GetY() == boundary_max_.GetY() && max_boundary.GetZ() == boundary_max_.GetZ())
+        return;
+    boundary_min_ = min_boundary;
+    boundary_max_ = max_boundary;
+
+    CellVector remaining_cells = CellVector();
     for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
     {
-        (*it)->CalculateCellPotentialEnergy(ion_radius);
+        Cell* cell = *it;
+        Coordinate* center_of_cell = cell->GetCellCenter();
+        if(!(center_of_cell->GetX() > min_boundary.GetX() && center_of_cell->GetX() < max_boundary.GetX() &&
+             center_of_cell->GetY() > min_boundary.GetY() && center_of_cell->GetY() < max_boundary.GetY() &&
+             center_of_cell->GetZ() > min_boundary.GetZ() && center_of_cell->GetZ() < max_boundary.GetZ()))
+            remaining_cells.push_back(cell);
+        else if(IsStoredCell(cell) && cell->GetCellPotentialEnergy() != INFINITY)
+            ranking_.erase(make_pair(ranking_sign_ * cell->GetCellPotentialEnergy(), (int)(cell - &cell_array_.front())));
     }
+    cells_ = remaining_cells;
 }
 
-void Grid::CalculateBoxCharge()
+void Grid::RankCells(double ion_charge)
 {
-    for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
+    ranking_sign_ = (ion_charge < 0) ? -1.0 : 1.0;
+    this->FillRanking();
+    assembly_->GetBoundary(&boundary_min_, &boundary_max_);
+    ranked_ = true;
+}
+
+Grid::CellVector Grid::GetBestRankedCells()
+{
+    return this->GetBestRankedCells(ranking_sign_);
+}
+
+Grid::CellVector Grid::GetBestRankedCells(double ion_charge)
+{
+    CellVector best_cells = CellVector();
+    if(!ranked_ || ranking_.empty())
+        return best_cells;
+    ///The ties are taken from the front (or back) of the ranking and put back in the order of the dense array, the order GetBestPositions gives them in
+    vector<int> indices = vector<int>();
+    if((ion_charge < 0) == (ranking_sign_ < 0))
+    {
+        double best_value = ranking_.begin()->first;
+        for(CellRanking::iterator it = ranking_.begin(); it != ranking_.end() && it->first - best_value < THRESHOLD; it++)
+            indices.push_back(it->second);
+    }
+    else
     {
-        (*it)->CalculateBoxCharge();
+        double best_value = ranking_.rbegin()->first;
+        for(CellRanking::reverse_iterator it = ranking_.rbegin(); it != ranking_.rend() && best_value - it->first < THRESHOLD; it++)
+            indices.push_back(it->second);
     }
+    sort(indices.begin(), indices.end());
+    for(vector<int>::iterator it = indices.begin(); it != indices.end(); it++)
+        best_cells.push_back(&cell_array_.at(*it));
+    return best_cells;
+}
+
+void Grid::CalculateBoxCharge()
+{
+    this->CalculateCellsCharge();
 }
 
 void Grid::CalculateBoxPotentialEnergy()
@@ -454,55 +500,56 @@ void Grid::CalculateBoxPotentialEnergy()
 
 Cell* Grid::GetBestBox(Grid *grid, double ion_charge)
 {
+    CellVector cells = grid->GetCells();
     if(ion_charge > 0)
     {
         double min_value = INFINITY;
-        for(unsigned int i = 0; i < grid->GetCells().size(); i++)
+        for(unsigned int i = 0; i < cells.size(); i++)
         {
-            if(grid->GetCells().at(i)->GetCellPotentialEnergy() == INFINITY)
+            if(cells.at(i)->GetCellPotentialEnergy() == INFINITY)
             {
                 continue;
             }
-            if(min_value > grid->GetCells().at(i)->GetCellPotentialEnergy())
+            if(min_value > cells.at(i)->GetCellPotentialEnergy())
             {
-                min_value = grid->GetCells().at(i)->GetCellPotentialEnergy();
+                min_value = cells.at(i)->GetCellPotentialEnergy();
             }
         }
-        for(unsigned int i = 0; i < grid->GetCells().size(); i++)
+        for(unsigned int i = 0; i < cells.size(); i++)
         {
-            if(grid->GetCells().at(i)->GetCellPotentialEnergy() == INFINITY)
+            if(cells.at(i)->GetCellPotentialEnergy() == INFINITY)
             {
                 continue;
             }
-            if(fabs(min_value - grid->GetCells().at(i)->GetCellPotentialEnergy()) < THRESHOLD_PARTITIONING)
+            if(fabs(min_value - cells.at(i)->GetCellPotentialEnergy()) < THRESHOLD_PARTITIONING)
             {
-                return grid->GetCells().at(i);
+                return cells.at(i);
             }
         }
     }
     else if(ion_charge < 0)
     {
         double max_value = -INFINITY;
-        for(unsigned int i = 0; i < grid->GetCells().size(); i++)
+        for(unsigned int i = 0; i < cells.size(); i++)
         {
-            if(grid->GetCells().at(i)->GetCellPotentialEnergy() == INFINITY)
+            if(cells.at(i)->GetCellPotentialEnergy() == INFINITY)
             {
                 continue;
             }
-            if(max_value < grid->GetCells().at(i)->GetCellPotentialEnergy())
+            if(max_value < cells.at(i)->GetCellPotentialEnergy())
             {
-                max_value = grid->GetCells().at(i)->GetCellPotentialEnergy();
+                max_value = cells.at(i)->GetCellPotentialEnergy();
             }
         }
-        for(unsigned int i = 0; i < grid->GetCells().size(); i++)
+        for(unsigned int i = 0; i < cells.size(); i++)
         {
-            if(grid->GetCells().at(i)->GetCellPotentialEnergy() == INFINITY)
+            if(cells.at(i)->GetCellPotentialEnergy() == INFINITY)
             {
                 continue;
             }
-            if(fabs(max_value - grid->GetCells().at(i)->GetCellPotentialEnergy()) < THRESHOLD_PARTITIONING)
+            if(fabs(max_value - cells.at(i)->GetCellPotentialEnergy()) < THRESHOLD_PARTITIONING)
             {
-                return grid->GetCells().at(i);
+                return cells.at(i);
             }
         }
     }
@@ -552,6 +599,186 @@ vector<Coordinate*> Grid::GetBestPositions(double ion_charge)
     return best_coordinates;
 }
 
+void Grid::DivideAxis(double min, double max, double size, DoubleVector& starts, DoubleVector& ends)
+{
+    starts.clear();
+    ends.clear();
+    for(double i = min; i <= max; i += size)
+    {
+        starts.push_back(i);
+        ends.push_back((i + size <= max) ? i + size : max);
+    }
+}
+
+int Grid::CellIndexAlongAxis(double value, DoubleVector& starts, DoubleVector& ends)
+{
+    int number_of_cells = starts.size();
+    if(number_of_cells == 0 || !(value > starts.front() && value <= ends.back()))
+        return -1;
+    /// The cells have the same size except the last one, so the estimate is at most one cell off because of rounding
+    double size = ends.front() - starts.front();
+    int index = (size > 0.0) ? (int)floor((value - starts.front()) / size) : 0;
+    if(index < 0)
+        index = 0;
+    if(index >= number_of_cells)
+        index = number_of_cells - 1;
+    while(index > 0 && !(value > starts.at(index)))
+        index--;
+    while(index < number_of_cells - 1 && value > ends.at(index))
+        index++;
+    if(value > starts.at(index) && value <= ends.at(index))
+        return index;
+    return -1;
+}
+
+void Grid::BuildCells()
+{
+    int number_of_cells_x = x_starts_.size();
+    int number_of_cells_y = y_starts_.size();
+    int number_of_cells_z = z_starts_.size();
+    ranking_.clear();
+    ranked_ = false;
+    cells_.clear();
+    cell_array_.clear();
+    cell_array_.reserve(number_of_cells_x * number_of_cells_y * number_of_cells_z);
+    for(int i = 0; i < number_of_cells_x; i++)
+    {
+        for(int j = 0; j < number_of_cells_y; j++)
+        {
+            for(int k = 0; k < number_of_cells_z; k++)
+            {
+                Coordinate min = Coordinate(x_starts_.at(i), y_starts_.at(j), z_starts_.at(k));
+                Coordinate max = Coordinate(x_ends_.at(i), y_ends_.at(j), z_ends_.at(k));
+                cell_array_.push_back(Cell(this, &min, &max));
+            }
+        }
+    }
+    /// The array is not resized after this point, so the pointers to its cells stay valid
+    for(CellArray::iterator it = cell_array_.begin(); it != cell_array_.end(); it++)
+        cells_.push_back(&(*it));
+}
+
+void Grid::PartitionRegion(Coordinate min, Coordinate max, double ion_charge)
+{
+    double min_x = min.GetX();
+    double min_y = min.GetY();
+    double min_z = min.GetZ();
+    double max_x = max.GetX();
+    double max_y = max.GetY();
+    double max_z = max.GetZ();
+
+    if(max_x - min_x <= DEFAULT_BOX_LENGTH && max_y - min_y <= DEFAULT_BOX_WIDTH && max_z - min_z <= DEFAULT_BOX_HEIGHT)
+    {
+        Coordinate min_boundary = Coordinate();
+        Coordinate max_boundary = Coordinate();
+        this->assembly_->GetBoundary(&min_boundary, &max_boundary);
+
+        this->DivideAxis(min_x, max_x, DEFAULT_GRID_LENGTH, x_starts_, x_ends_);
+        this->DivideAxis(min_y, max_y, DEFAULT_GRID_WIDTH, y_starts_, y_ends_);
+        this->DivideAxis(min_z, max_z, DEFAULT_GRID_HEIGHT, z_starts_, z_ends_);
+        this->BuildCells();
+        CellVector grid_cells = CellVector();
+        for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
+        {
+            Coordinate* center_of_cell = (*it)->GetCellCenter();
+            if(!(center_of_cell->GetX() > min_boundary.GetX() && center_of_cell->GetX() < max_boundary.GetX() &&
+                 center_of_cell->GetY() > min_boundary.GetY() && center_of_cell->GetY() < max_boundary.GetY() &&
+                 center_of_cell->GetZ() > min_boundary.GetZ() && center_of_cell->GetZ() < max_boundary.GetZ()))
+                grid_cells.push_back(*it);
+        }
+        cells_ = grid_cells;
+        return;
+    }
+    else
+    {
+        /// The eight boxes are the halves of the region along each axis; bit 0, 1 and 2 of the box index select the upper half along x, y and z
+        Grid* temp_grid = new Grid();
+        temp_grid->SetAssembly(this->assembly_);
+        temp_grid->SetMinCorner(&min);
+        temp_grid->SetMaxCorner(&max);
+        double mid_x = min_x + (max_x - min_x) / 2;
+        double mid_y = min_y + (max_y - min_y) / 2;
+        double mid_z = min_z + (max_z - min_z) / 2;
+        temp_grid->x_starts_ = DoubleVector(1, min_x);
+        temp_grid->x_starts_.push_back(mid_x);
+        temp_grid->x_ends_ = DoubleVector(1, mid_x);
+        temp_grid->x_ends_.push_back(max_x);
+        temp_grid->y_starts_ = DoubleVector(1, min_y);
+        temp_grid->y_starts_.push_back(mid_y);
+        temp_grid->y_ends_ = DoubleVector(1, mid_y);
+        temp_grid->y_ends_.push_back(max_y);
+        temp_grid->z_starts_ = DoubleVector(1, min_z);
+        temp_grid->z_starts_.push_back(mid_z);
+        temp_grid->z_ends_ = DoubleVector(1, mid_z);
+        temp_grid->z_ends_.push_back(max_z);
+        temp_grid->BuildCells();
+        CellVector boxes = CellVector();
+        for(int box = 0; box < 8; box++)
+            boxes.push_back(temp_grid->GetCell(box & 1, (box >> 1) & 1, (box >> 2) & 1));
+        temp_grid->SetCells(boxes);
+
+        temp_grid->CalculateBoxCharge();
+        temp_grid->CalculateBoxPotentialEnergy();
+        Cell* best_box = temp_grid->GetBestBox(temp_grid, ion_charge);
+        if(best_box != NULL)
+        {
+            Coordinate best_box_min = Coordinate(best_box->GetMinCorner()->GetX(), best_box->GetMinCorner()->GetY(), best_box->GetMinCorner()->GetZ());
+            Coordinate best_box_max = Coordinate(best_box->GetMaxCorner()->GetX(), best_box->GetMaxCorner()->GetY(), best_box->GetMaxCorner()->GetZ());
+            delete temp_grid;
+            this->PartitionRegion(best_box_min, best_box_max, ion_charge);
+            return;
+        }
+        else
+        {
+            delete temp_grid;
+            cout << "Can't create an appropriate grid!" << endl;
+            return;
+        }
+    }
+}
+
+bool Grid::IsStoredCell(Cell* cell)
+{
+    if(cell_array_.empty())
+        return false;
+    return cell >= &cell_array_.front() && cell <= &cell_array_.back();
+}
+
+void Grid::CellRangeAlongAxis(int axis, double min, double max, int& first, int& last)
+{
+    DoubleVector& starts = (axis == 0) ? x_starts_ : ((axis == 1) ? y_starts_ : z_starts_);
+    int number_of_cells = starts.size();
+    first = 0;
+    last = -1;
+    if(cell_array_.empty())
+        return;
+    for(int index = 0; index < number_of_cells; index++)
+    {
+        Cell* cell = (axis == 0) ? this->GetCell(index, 0, 0) : ((axis == 1) ? this->GetCell(0, index, 0) : this->GetCell(0, 0, index));
+        double center = (axis == 0) ? cell->GetCellCenter()->GetX() : ((axis == 1) ? cell->GetCellCenter()->GetY() : cell->GetCellCenter()->GetZ());
+        if(center <= min)
+            first = index + 1;
+        else if(center < max)
+            last = index;
+        else
+            break;
+    }
+}
+
+void Grid::FillRanking()
+{
+    vector<pair<double, int> > entries = vector<pair<double, int> >();
+    for(CellVector::iterator it = cells_.begin(); it != cells_.end(); it++)
+    {
+        Cell* cell = *it;
+        if(IsStoredCell(cell) && cell->GetCellPotentialEnergy() != INFINITY)
+            entries.push_back(make_pair(ranking_sign_ * cell->GetCellPotentialEnergy(), (int)(cell - &cell_array_.front())));
+    }
+    ///Sorted input is inserted in linear time
+    sort(entries.begin(), entries.end());
+    ranking_ = CellRanking(entries.begin(), entries.end());
+}
+
 //////////////////////////////////////////////////////////
 //                     DISPLAY FUNCTIONS                //
 //////////////////////////////////////////////////////////
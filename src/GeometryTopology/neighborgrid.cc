@@ -0,0 +1,164 @@
+#include <math.h>
+#include <stdexcept>
+
+#include "../../includes/GeometryTopology/neighborgrid.hpp"
+#include "../../includes/GeometryTopology/coordinate.hpp"
+
+using namespace std;
+using namespace GeometryTopology;
+
+//////////////////////////////////////////////////////////
+//                       Constructor                    //
+//////////////////////////////////////////////////////////
+NeighborGrid::NeighborGrid() : cell_size_(0.0), min_x_(0.0), min_y_(0.0), min_z_(0.0),
+    number_of_cells_x_(0), number_of_cells_y_(0), number_of_cells_z_(0)
+{
+    cell_offsets_ = IndexVector();
+    cell_points_ = IndexVector();
+    points_ = CoordinateVector();
+}
+
+NeighborGrid::NeighborGrid(CoordinateVector coordinates, double cell_size)
+{
+    this->Build(coordinates, cell_size);
+}
+
+//////////////////////////////////////////////////////////
+//                           ACCESSOR                   //
+//////////////////////////////////////////////////////////
+double NeighborGrid::GetCellSize()
+{
+    return cell_size_;
+}
+
+int NeighborGrid::GetNumberOfPoints()
+{
+    return points_.size();
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+void NeighborGrid::Build(CoordinateVector coordinates, double cell_size)
+{
+    /// The cells are found by dividing by the cell size, so it has to be positive
+    if(cell_size <= 0.0)
+        throw std::invalid_argument("NeighborGrid: the cell size has to be positive");
+    points_ = coordinates;
+    cell_size_ = cell_size;
+    int number_of_points = points_.size();
+    if(number_of_points == 0)
+    {
+        min_x_ = min_y_ = min_z_ = 0.0;
+        number_of_cells_x_ = number_of_cells_y_ = number_of_cells_z_ = 0;
+        cell_offsets_ = IndexVector(1, 0);
+        cell_points_ = IndexVector();
+        return;
+    }
+
+    double max_x = points_.at(0)->GetX();
+    double max_y = points_.at(0)->GetY();
+    double max_z = points_.at(0)->GetZ();
+    min_x_ = max_x;
+    min_y_ = max_y;
+    min_z_ = max_z;
+    for(CoordinateVector::iterator it = points_.begin(); it != points_.end(); it++)
+    {
+        Coordinate* coordinate = (*it);
+        if(coordinate->GetX() < min_x_) min_x_ = coordinate->GetX();
+        if(coordinate->GetY() < min_y_) min_y_ = coordinate->GetY();
+        if(coordinate->GetZ() < min_z_) min_z_ = coordinate->GetZ();
+        if(coordinate->GetX() > max_x) max_x = coordinate->GetX();
+        if(coordinate->GetY() > max_y) max_y = coordinate->GetY();
+        if(coordinate->GetZ() > max_z) max_z = coordinate->GetZ();
+    }
+
+    /// Sparse structures (e.g. far apart fragments) would otherwise allocate a huge mostly empty grid.
+    /// Enlarging the cells keeps the grid size proportional to the number of points, and any cell size above the cutoff stays correct.
+    double maximum_number_of_cells = 8.0 * number_of_points + 27.0;
+    while(((floor((max_x - min_x_) / cell_size_) + 1) * (floor((max_y - min_y_) / cell_size_) + 1) *
+           (floor((max_z - min_z_) / cell_size_) + 1)) > maximum_number_of_cells)
+        cell_size_ *= 2.0;
+
+    number_of_cells_x_ = (int)floor((max_x - min_x_) / cell_size_) + 1;
+    number_of_cells_y_ = (int)floor((max_y - min_y_) / cell_size_) + 1;
+    number_of_cells_z_ = (int)floor((max_z - min_z_) / cell_size_) + 1;
+    int number_of_cells = number_of_cells_x_ * number_of_cells_y_ * number_of_cells_z_;
+
+    /// Counting sort of the points by cell, keeps the points of each cell in ascending index order
+    IndexVector point_cells = IndexVector(number_of_points);
+    cell_offsets_ = IndexVector(number_of_cells + 1, 0);
+    for(int i = 0; i < number_of_points; i++)
+    {
+        Coordinate* coordinate = points_.at(i);
+        int cell_x = CellIndexAlongAxis(coordinate->GetX(), min_x_, number_of_cells_x_);
+        int cell_y = CellIndexAlongAxis(coordinate->GetY(), min_y_, number_of_cells_y_);
+        int cell_z = CellIndexAlongAxis(coordinate->GetZ(), min_z_, number_of_cells_z_);
+        point_cells.at(i) = (cell_x * number_of_cells_y_ + cell_y) * number_of_cells_z_ + cell_z;
+        cell_offsets_.at(point_cells.at(i) + 1)++;
+    }
+    for(int i = 0; i < number_of_cells; i++)
+        cell_offsets_.at(i + 1) += cell_offsets_.at(i);
+    cell_points_ = IndexVector(number_of_points);
+    IndexVector insert_positions = IndexVector(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    for(int i = 0; i < number_of_points; i++)
+        cell_points_.at(insert_positions.at(point_cells.at(i))++) = i;
+}
+
+void NeighborGrid::GetCandidateIndices(double x, double y, double z, IndexVector& indices)
+{
+    if(points_.empty())
+        return;
+    int cell_x = CellIndexAlongAxis(x, min_x_, number_of_cells_x_);
+    int cell_y = CellIndexAlongAxis(y, min_y_, number_of_cells_y_);
+    int cell_z = CellIndexAlongAxis(z, min_z_, number_of_cells_z_);
+    /// A query point outside of the indexed region may still be within the cutoff of the boundary cells
+    if(x < min_x_ - cell_size_ || y < min_y_ - cell_size_ || z < min_z_ - cell_size_ ||
+            x >= min_x_ + (number_of_cells_x_ + 1) * cell_size_ ||
+            y >= min_y_ + (number_of_cells_y_ + 1) * cell_size_ ||
+            z >= min_z_ + (number_of_cells_z_ + 1) * cell_size_)
+        return;
+    for(int i = max(cell_x - 1, 0); i <= min(cell_x + 1, number_of_cells_x_ - 1); i++)
+    {
+        for(int j = max(cell_y - 1, 0); j <= min(cell_y + 1, number_of_cells_y_ - 1); j++)
+        {
+            for(int k = max(cell_z - 1, 0); k <= min(cell_z + 1, number_of_cells_z_ - 1); k++)
+            {
+                int cell = (i * number_of_cells_y_ + j) * number_of_cells_z_ + k;
+                for(int l = cell_offsets_[cell]; l < cell_offsets_[cell + 1]; l++)
+                    indices.push_back(cell_points_[l]);
+            }
+        }
+    }
+}
+
+void NeighborGrid::GetIndicesWithinDistance(Coordinate* point, double cutoff, IndexVector& indices, IndexVector& candidates)
+{
+    candidates.clear();
+    this->GetCandidateIndices(point->GetX(), point->GetY(), point->GetZ(), candidates);
+    for(IndexVector::iterator it = candidates.begin(); it != candidates.end(); it++)
+    {
+        if(point->Distance(*(points_[*it])) <= cutoff)
+            indices.push_back(*it);
+    }
+}
+
+int NeighborGrid::CellIndexAlongAxis(double value, double min, int number_of_cells)
+{
+    int index = (int)floor((value - min) / cell_size_);
+    if(index < 0)
+        return 0;
+    if(index >= number_of_cells)
+        return number_of_cells - 1;
+    return index;
+}
+
+//////////////////////////////////////////////////////////
+//                     DISPLAY FUNCTIONS                //
+//////////////////////////////////////////////////////////
+void NeighborGrid::Print(ostream &out)
+{
+    out << "Neighbor grid: " << number_of_cells_x_ << "x" << number_of_cells_y_ << "x" << number_of_cells_z_
+        << " cells of " << cell_size_ << " starting at (" << min_x_ << ", " << min_y_ << ", " << min_z_ << "), "
+        << points_.size() << " points" << endl;
+}
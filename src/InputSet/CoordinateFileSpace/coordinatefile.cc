@@ -71,6 +71,12 @@ const std::vector<GeometryTopology::Coordinate*> CoordinateFile::GetCoordinates(
     return coordinates_;
 }
 
+/// Return the box lengths and angles of the coordinate file, empty if the file has no box
+const std::vector<double> CoordinateFile::GetBoxDimensions() const
+{
+    return box_dimensions_;
+}
+
 //////////////////////////////////////////////////////////
 //                           MUTATOR                    //
 //////////////////////////////////////////////////////////
@@ -102,6 +108,12 @@ void CoordinateFile::SetCoordinates(std::vector<Coordinate*> coordinates)
     }
 }
 
+/// Set the box lengths and angles of the coordinate file
+void CoordinateFile::SetBoxDimensions(std::vector<double> box_dimensions)
+{
+    box_dimensions_ = box_dimensions;
+}
+
 /// Add a new coordinate to the list of the coordinates
 void CoordinateFile::AddCoordinate(GeometryTopology::Coordinate* coordinate)
 {
@@ -131,32 +143,34 @@ void CoordinateFile::Read(std::ifstream& in_file)
     ss >> number_of_coordinates;
     number_of_coordinates_ = number_of_coordinates; /// Set the number of coordinates attribute
 
-    getline(in_file, line);                         /// Read the next line
-    while(!Trim(line).empty())                      /// Read until the end of the file
+    /// Values are read as a flat list, since the coordinates may be followed by velocities and a periodic box line
+    vector<double> values = vector<double>();
+    while(getline(in_file, line) && !Trim(line).empty())
     {
         // Tokenizing the read line
         boost::char_separator<char> separator(" ");
         boost::tokenizer< boost::char_separator<char> > tokens(line, separator);
-        vector<string> vectorTokens = vector<string>();
-        vectorTokens.assign(tokens.begin(), tokens.end());
-        switch(vectorTokens.size())
+        BOOST_FOREACH(const string& token, tokens)
         {
-            /// One coordinate in the read line
-            case 3:
-                coordinates_.push_back(new Coordinate(ConvertString<double>(vectorTokens.at(0)), ConvertString<double>(vectorTokens.at(1)),
-                                                      ConvertString<double>(vectorTokens.at(2))));
-                break;
-            /// Two coordinates in the read line
-            case 6:
-                coordinates_.push_back(new Coordinate(ConvertString<double>(vectorTokens.at(0)), ConvertString<double>(vectorTokens.at(1)),
-                                                      ConvertString<double>(vectorTokens.at(2))));
-                coordinates_.push_back(new Coordinate(ConvertString<double>(vectorTokens.at(3)), ConvertString<double>(vectorTokens.at(4)),
-                                                      ConvertString<double>(vectorTokens.at(5))));
-                break;
+            values.push_back(ConvertString<double>(token));
         }
-        getline(in_file, line);
     }
-    if((int)coordinates_.size() != number_of_coordinates_)
+    int number_of_values = 3 * number_of_coordinates_;
+    if((int)values.size() < number_of_values)
+    {
+        throw CoordinateFileProcessingException(__LINE__, "Corrupted file");
+    }
+    for(int i = 0; i < number_of_values; i += 3)
+    {
+        coordinates_.push_back(new Coordinate(values.at(i), values.at(i + 1), values.at(i + 2)));
+    }
+    /// The last six values are the box lengths and angles, with or without velocities in between
+    int number_of_remaining_values = values.size() - number_of_values;
+    if(number_of_remaining_values == 6 || number_of_remaining_values == number_of_values + 6)
+    {
+        box_dimensions_.assign(values.end() - 6, values.end());
+    }
+    else if(number_of_remaining_values != 0 && number_of_remaining_values != number_of_values)
     {
         throw CoordinateFileProcessingException(__LINE__, "Corrupted file");
     }
@@ -194,6 +208,14 @@ void CoordinateFile::BuildCoordinateFile(ofstream &stream)
             stream << endl;
     }
     stream << endl;
+    if(box_dimensions_.size() == 6)
+    {
+        for(unsigned int i = 0; i < box_dimensions_.size(); i++)
+        {
+            stream << right << setw(12) << fixed << setprecision(7) << box_dimensions_.at(i);
+        }
+        stream << endl;
+    }
 }
 
 //////////////////////////////////////////////////////////
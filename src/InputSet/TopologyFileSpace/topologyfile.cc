@@ -68,6 +68,9 @@ TopologyFile::TopologyFile()
     dihedral_types_ = TopologyDihedralTypeMap();
     assembly_ = new TopologyAssembly();
     radius_set_ = RadiusSet();
+    solvent_pointers_ = vector<int>();
+    atoms_per_molecule_ = vector<int>();
+    box_dimensions_ = vector<double>();
     bonds_ = TopologyBondMap();
     angles_ = TopologyAngleMap();
     dihedrals_ = TopologyDihedralMap();
@@ -251,6 +254,18 @@ TopologyFile::RadiusSet TopologyFile::GetRadiusSet()
 {
     return radius_set_;
 }
+vector<int> TopologyFile::GetSolventPointers()
+{
+    return solvent_pointers_;
+}
+vector<int> TopologyFile::GetAtomsPerMolecule()
+{
+    return atoms_per_molecule_;
+}
+vector<double> TopologyFile::GetBoxDimensions()
+{
+    return box_dimensions_;
+}
 TopologyFile::TopologyBondMap TopologyFile::GetBonds()
 {
     return bonds_;
@@ -479,6 +494,18 @@ void TopologyFile::SetRadiusSet(RadiusSet radius_set)
         radius_set_.push_back(*it);
     }
 }
+void TopologyFile::SetSolventPointers(vector<int> solvent_pointers)
+{
+    solvent_pointers_ = solvent_pointers;
+}
+void TopologyFile::SetAtomsPerMolecule(vector<int> atoms_per_molecule)
+{
+    atoms_per_molecule_ = atoms_per_molecule;
+}
+void TopologyFile::SetBoxDimensions(vector<double> box_dimensions)
+{
+    box_dimensions_ = box_dimensions;
+}
 void TopologyFile::SetBonds(TopologyBondMap bonds)
 {
     bonds_.clear();
@@ -820,12 +847,15 @@ void TopologyFile::ParseSections(ifstream &in_stream)
             }
             else if(in_line.find("%FLAG SOLVENT_POINTERS") != string::npos)
             {
+                solvent_pointers_ = ParsePartition<int>(section);
             }
             else if(in_line.find("%FLAG ATOMS_PER_MOLECULE") != string::npos)
             {
+                atoms_per_molecule_ = ParsePartition<int>(section);
             }
             else if(in_line.find("%FLAG BOX_DIMENSIONS") != string::npos)
             {
+                box_dimensions_ = ParsePartition<double>(section);
             }
             else if(in_line.find("%FLAG CAP_INFO") != string::npos)
             {
@@ -1714,6 +1744,18 @@ vector<T> TopologyFile::PartitionLine(string line, string format)
 
         return items;
     }
+    if(format.compare("3I8") == 0)
+    {
+        int number_of_items = 3;
+        int item_length = 8;
+        for(int i = 0; i < number_of_items && item_length * (i+1) <= (int)line.length(); i++)
+        {
+            string token = line.substr(i*item_length, item_length);
+            token = Trim(token);
+            items.push_back(ConvertString<T>(token));
+        }
+        return items;
+    }
     if(format.compare("1I8") == 0)
     {
         int number_of_items = 1;
@@ -1791,6 +1833,12 @@ void TopologyFile::ResolveSections(ofstream &out_stream)
     this->ResolveTreeChainClassificationSection(out_stream);
     this->ResolveJoinArraySection(out_stream);
     this->ResolveIRotatSection(out_stream);
+    if(standard_periodic_box_option_ != iNotSet && standard_periodic_box_option_ > 0)
+    {
+        this->ResolveSolventPointersSection(out_stream);
+        this->ResolveAtomsPerMoleculeSection(out_stream);
+        this->ResolveBoxDimensionsSection(out_stream);
+    }
     this->ResolveRadiusSetSection(out_stream);
     this->ResolveRadiiSection(out_stream);
     this->ResolveScreenSection(out_stream);
@@ -3267,6 +3315,62 @@ void TopologyFile::ResolveIRotatSection(ofstream& out)
 
 }
 
+void TopologyFile::ResolveSolventPointersSection(ofstream& out)
+{
+    out << "%FLAG SOLVENT_POINTERS" << endl
+        << "%FORMAT(3I8)" << endl;
+    for(unsigned int i = 0; i < 3; i++)
+    {
+        if(i < solvent_pointers_.size())
+            out << setw(8) << right << solvent_pointers_.at(i);
+        else
+            out << setw(8) << right << 0;
+    }
+    out << endl;
+}
+
+void TopologyFile::ResolveAtomsPerMoleculeSection(ofstream& out)
+{
+    out << "%FLAG ATOMS_PER_MOLECULE" << endl
+        << "%FORMAT(10I8)" << endl;
+    int count = 0;
+    const int MAX_IN_LINE = 10;
+    const int ITEM_LENGTH = 8;
+    for(vector<int>::iterator it = atoms_per_molecule_.begin(); it != atoms_per_molecule_.end(); it++)
+    {
+        out << setw(ITEM_LENGTH) << right << *it;
+        count++;
+        if(count == MAX_IN_LINE)
+        {
+            count = 0;
+            out << endl;
+        }
+    }
+    if(count < MAX_IN_LINE && count != 0)
+        out << endl;
+    if(atoms_per_molecule_.empty())
+        out << endl;
+}
+
+void TopologyFile::ResolveBoxDimensionsSection(ofstream& out)
+{
+    out << "%FLAG BOX_DIMENSIONS" << endl
+        << "%FORMAT(5E16.8)" << endl;
+    const int ITEM_LENGTH = 16;
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        stringstream ss;
+        if(i < box_dimensions_.size())
+            ss << setw(ITEM_LENGTH) << right << scientific << setprecision(8) << box_dimensions_.at(i);
+        else
+            ss << setw(ITEM_LENGTH) << right << scientific << setprecision(8) << 0.0;
+        string sss = ss.str();
+        std::transform(sss.begin(), sss.end(), sss.begin(), ::toupper);
+        out << sss;
+    }
+    out << endl;
+}
+
 void TopologyFile::ResolveRadiusSetSection(ofstream& out)
 {
     if(radius_set_.size() != 0)
@@ -89,12 +89,32 @@ CoordinateFile* Assembly::BuildCoordinateFileStructureFromAssembly()
 {
     cout << "Creating coordinate file ..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Creating coordinate file ...");
-    vector<Coordinate*> coordinates = this->GetAllCoordinates();
+    /// The coordinates of the solvent block are taken from the block directly, after the coordinates of all atoms (if none are missing)
+    this->UpdateViews();
+    this->UpdateCoordinatesView();
+    vector<Coordinate*> coordinates = all_coordinates_;
+    if(coordinates.size() == all_atoms_.size())
+    {
+        for(int i = 0; i < solvent_block_.GetNumberOfMolecules(); i++)
+            for(int j = 0; j < solvent_block_.GetNumberOfSites(); j++)
+                coordinates.push_back(&solvent_block_.GetSiteCoordinate(i, j));
+    }
     CoordinateFile* coordinate_file = new CoordinateFile();
     coordinate_file->SetCoordinates(coordinates);
     coordinate_file->SetNumberOfCoordinates(coordinates.size());
     string title = "Generated by GMML";
     coordinate_file->SetTitle(title);
+    if(box_length_ != dNotSet)
+    {
+        vector<double> box_dimensions = vector<double>();
+        box_dimensions.push_back(box_length_);
+        box_dimensions.push_back(box_width_);
+        box_dimensions.push_back(box_height_);
+        box_dimensions.push_back(box_angle_);
+        box_dimensions.push_back(box_angle_);
+        box_dimensions.push_back(box_angle_);
+        coordinate_file->SetBoxDimensions(box_dimensions);
+    }
     return coordinate_file;
 }
 
@@ -164,12 +164,12 @@ void Assembly::ExtractPdbModelCardFromAssembly(PdbModelResidueSet* residue_set,
                     residue_name = "HOH";
                 PdbAtom* pdb_atom = new PdbAtom(serial_number, atom->GetName(), ' ', residue_name, ' ', sequence_number, ' ',
                                                 *((atom->GetCoordinates()).at(model_number)), dNotSet, dNotSet, atom->GetElementSymbol(), "");//ss.str());
-                vector<string> atom_id_tokens = Split(atom->GetId(), "_");
-                pdb_atom->SetAtomChainId(ConvertString<char>(atom_id_tokens.at(3)));
-                pdb_atom->SetAtomInsertionCode(ConvertString<char>(atom_id_tokens.at(5)));
-                pdb_atom->SetAtomAlternateLocation(ConvertString<char>(atom_id_tokens.at(6)));
-                assembly_to_pdb_sequence_number_map[gmml::ConvertString<int>(atom_id_tokens.at(4))] = sequence_number;
-                assembly_to_pdb_serial_number_map[ConvertString<int>(atom_id_tokens.at(1))] = serial_number;
+                AtomIdentity atom_identity = atom->GetIdentity();
+                pdb_atom->SetAtomChainId(atom_identity.residue_.chain_id_);
+                pdb_atom->SetAtomInsertionCode(atom_identity.residue_.insertion_code_);
+                pdb_atom->SetAtomAlternateLocation(atom_identity.residue_.alternate_location_);
+                assembly_to_pdb_sequence_number_map[atom_identity.residue_.sequence_number_] = sequence_number;
+                assembly_to_pdb_serial_number_map[atom_identity.serial_number_] = serial_number;
 
                 if(find(dscr.begin(), dscr.end(), "Atom") != dscr.end())
                 {
@@ -220,12 +220,12 @@ void Assembly::ExtractPdbModelCardFromAssembly(PdbModelResidueSet* residue_set,
                 residue_name = "HOH";
             PdbAtom* pdb_atom = new PdbAtom(serial_number, atom->GetName(), ' ', residue_name, ' ', sequence_number, ' ',
                                             *((atom->GetCoordinates()).at(model_number)), dNotSet, dNotSet, atom->GetElementSymbol(), "");//ss.str());
-            vector<string> atom_id_tokens = Split(atom->GetId(), "_");
-            pdb_atom->SetAtomChainId(ConvertString<char>(atom_id_tokens.at(3)));
-            pdb_atom->SetAtomInsertionCode(ConvertString<char>(atom_id_tokens.at(5)));
-            pdb_atom->SetAtomAlternateLocation(ConvertString<char>(atom_id_tokens.at(6)));
-            assembly_to_pdb_sequence_number_map[gmml::ConvertString<int>(atom_id_tokens.at(4))] = sequence_number;
-            assembly_to_pdb_serial_number_map[ConvertString<int>(atom_id_tokens.at(1))] = serial_number;
+            AtomIdentity atom_identity = atom->GetIdentity();
+            pdb_atom->SetAtomChainId(atom_identity.residue_.chain_id_);
+            pdb_atom->SetAtomInsertionCode(atom_identity.residue_.insertion_code_);
+            pdb_atom->SetAtomAlternateLocation(atom_identity.residue_.alternate_location_);
+            assembly_to_pdb_sequence_number_map[atom_identity.residue_.sequence_number_] = sequence_number;
+            assembly_to_pdb_serial_number_map[atom_identity.serial_number_] = serial_number;
 
             if(find(dscr.begin(), dscr.end(), "Atom") != dscr.end())
             {
@@ -249,6 +249,27 @@ void Assembly::ExtractPdbModelCardFromAssembly(PdbModelResidueSet* residue_set,
         }
         sequence_number++;
     }
+    /// The molecules of the solvent block are written from the template and their packed coordinates, as the heterogen atoms they expand into
+    for(int i = 0; i < solvent_block_.GetNumberOfResidues(); i++)
+    {
+        for(int j = solvent_block_.GetFirstMoleculeOfResidue(i); j < solvent_block_.GetFirstMoleculeOfResidue(i + 1); j++)
+        {
+            for(int k = 0; k < solvent_block_.GetNumberOfSites(); k++)
+            {
+                PdbAtom* pdb_atom = new PdbAtom(serial_number, solvent_block_.GetSiteName(k), ' ', solvent_block_.GetResidueName(), ' ', sequence_number, ' ',
+                                                solvent_block_.GetSiteCoordinate(j, k), dNotSet, dNotSet, "", "");
+                pdb_atom->SetAtomChainId(BLANK_SPACE);
+                pdb_atom->SetAtomInsertionCode(BLANK_SPACE);
+                pdb_atom->SetAtomAlternateLocation(BLANK_SPACE);
+                assembly_to_pdb_sequence_number_map[solvent_block_.GetSequenceNumber(i)] = sequence_number;
+                assembly_to_pdb_serial_number_map[solvent_block_.GetSerialNumber(j, k)] = serial_number;
+                het_atom_map[serial_number] = pdb_atom;
+                het_atom_vector.push_back(pdb_atom);
+                serial_number++;
+            }
+        }
+        sequence_number++;
+    }
     atom_card->SetAtoms(atom_map);
     atom_card->SetOrderedAtoms(atom_vector);
     het_atom_card->SetHeterogenAtoms(het_atom_map);
@@ -262,7 +283,9 @@ void Assembly::ExtractPdbLinkCardFromAssembly(PdbLinkCard* link_card, int model_
 {
     PdbLinkCard::LinkVector link_vector = PdbLinkCard::LinkVector();
     vector<string> visited_links = vector<string>();
-    AtomVector all_atoms = GetAllAtomsOfAssembly();
+    /// Molecules of the solvent block are only bonded within their residue, so they have no links and are not expanded
+    this->UpdateViews();
+    AtomVector all_atoms = all_atoms_;
     for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = (*it);
@@ -288,20 +311,20 @@ void Assembly::ExtractPdbLinkCardFromAssembly(PdbLinkCard* link_card, int model_
                             visited_links.push_back(atom->GetId());
                             visited_links.push_back(neighbor->GetId());
                             PdbLinkResidue* link_residue1 = new PdbLinkResidue();
-                            vector<string> atom_id_tokens = Split(atom->GetId(), "_");
+                            ResidueIdentity atom_residue_identity = atom->GetIdentity().residue_;
                             link_residue1->SetAtomName(atom->GetName());
-                            link_residue1->SetResidueChainId(ConvertString<char>(atom_id_tokens.at(3)));
-                            link_residue1->SetResidueSequenceNumber(assembly_to_pdb_sequence_number[ConvertString<int>(atom_id_tokens.at(4))]);
-                            link_residue1->SetResidueInsertionCode(ConvertString<char>(atom_id_tokens.at(5)));
-                            link_residue1->SetAlternateLocationIndicator(ConvertString<char>(atom_id_tokens.at(6)));
+                            link_residue1->SetResidueChainId(atom_residue_identity.chain_id_);
+                            link_residue1->SetResidueSequenceNumber(assembly_to_pdb_sequence_number[atom_residue_identity.sequence_number_]);
+                            link_residue1->SetResidueInsertionCode(atom_residue_identity.insertion_code_);
+                            link_residue1->SetAlternateLocationIndicator(atom_residue_identity.alternate_location_);
                             link_residue1->SetResidueName(residue->GetName());
                             PdbLinkResidue* link_residue2 = new PdbLinkResidue();
-                            vector<string> neighbor_id_tokens = Split(neighbor->GetId(), "_");
+                            ResidueIdentity neighbor_residue_identity = neighbor->GetIdentity().residue_;
                             link_residue2->SetAtomName(neighbor->GetName());
-                            link_residue2->SetResidueChainId(ConvertString<char>(neighbor_id_tokens.at(3)));
-                            link_residue2->SetResidueSequenceNumber(assembly_to_pdb_sequence_number[ConvertString<int>(neighbor_id_tokens.at(4))]);
-                            link_residue2->SetResidueInsertionCode(ConvertString<char>(neighbor_id_tokens.at(5)));
-                            link_residue2->SetAlternateLocationIndicator(ConvertString<char>(neighbor_id_tokens.at(6)));
+                            link_residue2->SetResidueChainId(neighbor_residue_identity.chain_id_);
+                            link_residue2->SetResidueSequenceNumber(assembly_to_pdb_sequence_number[neighbor_residue_identity.sequence_number_]);
+                            link_residue2->SetResidueInsertionCode(neighbor_residue_identity.insertion_code_);
+                            link_residue2->SetAlternateLocationIndicator(neighbor_residue_identity.alternate_location_);
                             link_residue2->SetResidueName(neighbor_residue->GetName());
 
                             PdbLink* pdb_link = new PdbLink();
@@ -323,7 +346,8 @@ void Assembly::ExtractPdbLinkCardFromAssembly(PdbLinkCard* link_card, int model_
 void Assembly::ExtractPdbConnectCardFromAssembly(PdbConnectCard *connect_card, AssemblytoPdbSerialNumberMap assembly_to_pdb_serial_number)
 {
     PdbConnectCard::BondedAtomsSerialNumbersMap bonded_atoms_serial_number_map = PdbConnectCard::BondedAtomsSerialNumbersMap();
-    AtomVector all_atoms = this->GetAllAtomsOfAssembly();
+    this->UpdateViews();
+    AtomVector all_atoms = all_atoms_;
     for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
     {
         Atom* atom = *it;
@@ -331,16 +355,27 @@ void Assembly::ExtractPdbConnectCardFromAssembly(PdbConnectCard *connect_card, A
         if(node != NULL)
         {
             AtomVector neighbors = node->GetNodeNeighbors();
-            vector<string> atom_id_tokens = Split(atom->GetId(), "_");
-            int atom_serial_number = assembly_to_pdb_serial_number[ConvertString<int>(atom_id_tokens.at(1))];
+            int atom_serial_number = assembly_to_pdb_serial_number[atom->GetSerialNumber()];
             bonded_atoms_serial_number_map[atom_serial_number] = vector<int>();
             for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
             {
                 Atom* neighbor = *it1;
-                vector<string> neighbor_id_tokens = Split(neighbor->GetId(), "_");
-                bonded_atoms_serial_number_map[atom_serial_number].push_back(assembly_to_pdb_serial_number[ConvertString<int>(neighbor_id_tokens.at(1))]);
+                bonded_atoms_serial_number_map[atom_serial_number].push_back(assembly_to_pdb_serial_number[neighbor->GetSerialNumber()]);
             }
         }
     }
+    /// The bonds of the molecules of the solvent block are the bonds of the template
+    const SolventBlock::IndexVector& site_offsets = solvent_block_.GetSiteOffsets();
+    const SolventBlock::IndexVector& site_neighbors = solvent_block_.GetSiteNeighbors();
+    for(int i = 0; i < solvent_block_.GetNumberOfMolecules(); i++)
+    {
+        for(int j = 0; j < solvent_block_.GetNumberOfSites(); j++)
+        {
+            int atom_serial_number = assembly_to_pdb_serial_number[solvent_block_.GetSerialNumber(i, j)];
+            bonded_atoms_serial_number_map[atom_serial_number] = vector<int>();
+            for(int k = site_offsets.at(j); k < site_offsets.at(j + 1); k++)
+                bonded_atoms_serial_number_map[atom_serial_number].push_back(assembly_to_pdb_serial_number[solvent_block_.GetSerialNumber(i, site_neighbors.at(k))]);
+        }
+    }
     connect_card->SetBondedAtomsSerialNumbers(bonded_atoms_serial_number_map);
 }
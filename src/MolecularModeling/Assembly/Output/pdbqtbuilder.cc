@@ -162,7 +162,9 @@ void Assembly::ExtractPdbqtModelCardFromAssembly(PdbqtModelResidueSet* residue_s
             sequence_number++;
         }
     }
-    for(ResidueVector::iterator it1 = residues_.begin(); it1 != residues_.end(); it1++)
+    ///GetResidues also expands the solvent block, so that its molecules are written too
+    ResidueVector residues = this->GetResidues();
+    for(ResidueVector::iterator it1 = residues.begin(); it1 != residues.end(); it1++)
     {
         Residue* residue = (*it1);
         AtomVector atoms = residue->GetAtoms();
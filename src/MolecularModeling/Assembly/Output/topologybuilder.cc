@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <set>
+#include <map>
 #include <queue>
 #include <stack>
 
@@ -85,6 +86,16 @@ using namespace CondensedSequenceSpace;
 //////////////////////////////////////////////////////////
 //                       FUNCTIONS                      //
 //////////////////////////////////////////////////////////
+/// Excluded atoms are written as "RESIDUE(sequence_number):ATOM(serial_number)" using the names the atom has been identified with
+string FormatExcludedAtomKey(Atom* atom)
+{
+    AtomIdentity identity = atom->GetIdentity();
+    stringstream ss;
+    ss << SymbolTable::GetString(identity.residue_.name_) << "(" << identity.residue_.sequence_number_ << "):"
+       << SymbolTable::GetString(identity.name_) << "(" << identity.serial_number_ << ")";
+    return ss.str();
+}
+
 TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_file_path, string ion_parameter_file_path)
 {
     cout << "Creating topology file ..." << endl;
@@ -92,7 +103,10 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
     TopologyFile* topology_file = new TopologyFile();
 
     TopologyAssembly* topology_assembly = new TopologyAssembly();
-    ResidueVector assembly_residues = this->GetAllResiduesOfAssembly();
+    /// The solvent block is not expanded; its residues are built one at a time after the other residues (see below)
+    this->UpdateViews();
+    ResidueVector assembly_residues = all_residues_;
+    int number_of_residues = assembly_residues.size() + solvent_block_.GetNumberOfResidues();
     int number_of_excluded_atoms = 0;
     int residue_counter = 0;
     int atom_counter = 1;
@@ -109,7 +123,21 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
     TopologyFile::TopologyAtomPairMap pairs = TopologyFile::TopologyAtomPairMap();
     int pair_count = 1;
     vector<string> inserted_pairs = vector<string>();
-    vector<string> excluded_atom_list = vector<string>();
+    /// Bonds, angles and dihedrals are enumerated by walking the bond graph of the assembly; excluded pairs are kept as ordered atom indices of the graph
+    this->UpdateBondGraph();
+    BondGraph* bond_graph = &bond_graph_;
+    set<pair<int, int> > excluded_atom_pairs = set<pair<int, int> >();
+    /// The residues of the solvent block are written from scratch residues instead of being expanded one by one. One residue is built into
+    /// a scratch assembly for each number of molecules, along with its bond graph, and it is renumbered to each residue of the block that it stands for.
+    /// Its molecules are only bonded within the residue, so its bonds, angles, dihedrals and excluded pairs are looked up in lists of their own
+    /// instead of the lists of the whole assembly
+    Assembly solvent_residue_assembly;
+    map<int, Residue*> solvent_residues = map<int, Residue*>();
+    map<int, BondGraph> solvent_residue_graphs = map<int, BondGraph>();
+    set<pair<int, int> > solvent_excluded_atom_pairs = set<pair<int, int> >();
+    vector<vector<string> > solvent_inserted_bonds = vector<vector<string> >();
+    vector<vector<string> > solvent_inserted_angles = vector<vector<string> >();
+    vector<vector<string> > solvent_inserted_dihedrals = vector<vector<string> >();
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
     ParameterFileSpace::ParameterFile::BondMap bonds = parameter_file->GetBonds();
     ParameterFileSpace::ParameterFile::AngleMap angles = parameter_file->GetAngles();
@@ -122,9 +150,44 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
         ion_parameter_file = new ParameterFile(ion_parameter_file_path, gmml::IONICMOD);
         ion_atom_types_map = ion_parameter_file->GetAtomTypes();
     }
-    for(ResidueVector::iterator it = assembly_residues.begin(); it != assembly_residues.end(); it++)
+    for(int residue_index = 0; residue_index < number_of_residues; residue_index++)
     {
-        Residue* assembly_residue = *it;
+        Residue* assembly_residue = NULL;
+        BondGraph* residue_graph = bond_graph;
+        set<pair<int, int> >* residue_excluded_atom_pairs = &excluded_atom_pairs;
+        vector<vector<string> >* residue_inserted_bonds = &inserted_bonds;
+        vector<vector<string> >* residue_inserted_angles = &inserted_angles;
+        vector<vector<string> >* residue_inserted_dihedrals = &inserted_dihedrals;
+        if(residue_index < (int)assembly_residues.size())
+            assembly_residue = assembly_residues.at(residue_index);
+        else
+        {
+            int solvent_residue_index = residue_index - assembly_residues.size();
+            int number_of_molecules = solvent_block_.GetNumberOfMoleculesOfResidue(solvent_residue_index);
+            map<int, Residue*>::iterator solvent_residue = solvent_residues.find(number_of_molecules);
+            if(solvent_residue == solvent_residues.end())
+            {
+                assembly_residue = solvent_block_.ExpandResidue(solvent_residue_index, &solvent_residue_assembly, id_);
+                solvent_residues[number_of_molecules] = assembly_residue;
+                solvent_residue_graphs[number_of_molecules].Build(assembly_residue->GetAtoms());
+            }
+            else
+            {
+                assembly_residue = solvent_residue->second;
+                solvent_block_.RenumberResidue(solvent_residue_index, assembly_residue, id_);
+            }
+            residue_graph = &solvent_residue_graphs[number_of_molecules];
+            solvent_excluded_atom_pairs.clear();
+            solvent_inserted_bonds.clear();
+            solvent_inserted_angles.clear();
+            solvent_inserted_dihedrals.clear();
+            residue_excluded_atom_pairs = &solvent_excluded_atom_pairs;
+            residue_inserted_bonds = &solvent_inserted_bonds;
+            residue_inserted_angles = &solvent_inserted_angles;
+            residue_inserted_dihedrals = &solvent_inserted_dihedrals;
+        }
+        const BondGraph::IndexVector& offsets = residue_graph->GetOffsets();
+        const BondGraph::IndexVector& graph_neighbors = residue_graph->GetNeighbors();
         TopologyResidue* topology_residue = new TopologyResidue();
         residue_counter++;
         topology_residue->SetIndex(residue_counter);
@@ -134,7 +197,7 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
         if(residue_name.compare("TIP5") == 0 || residue_name.compare("TIP5PBOX") == 0)
             residue_name = "TP5";
         topology_residue->SetResidueName(residue_name);
-        if(distance(assembly_residues.begin(), it) == (int)assembly_residues.size()-1)
+        if(residue_index == number_of_residues - 1)
             ss << assembly_residue->GetName();
         else
             ss << assembly_residue->GetName() << "-";
@@ -149,8 +212,6 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
         for(AtomVector::iterator it1 = assembly_atoms.begin(); it1 != assembly_atoms.end(); it1++)
         {
             Atom* assembly_atom = (*it1);
-            stringstream key1;
-            key1 << assembly_atom->GetId();
             TopologyAtom* topology_atom = new TopologyAtom();
             topology_atom->SetAtomName(assembly_atom->GetName());
             topology_atom->SetAtomCharge(assembly_atom->MolecularDynamicAtom::GetCharge() * CHARGE_DIVIDER);
@@ -169,88 +230,75 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
             atom_counter++;
             atom_index++;
             ///Bond Types, Bonds
+            ///Bonds to atoms that are not in the bond graph (e.g. atoms of another assembly) are left out of the topology and reported
+            int atom_graph_index = residue_graph->GetIndex(assembly_atom);
+            int number_of_graph_neighbors = (atom_graph_index == -1) ? 0 : residue_graph->GetDegree(atom_graph_index);
             AtomNode* atom_node = assembly_atom->GetNode();
-            if(atom_node != NULL)
+            if(atom_graph_index == -1 || (atom_node != NULL && (int)atom_node->GetNodeNeighbors().size() != number_of_graph_neighbors))
             {
-                AtomVector neighbors = atom_node->GetNodeNeighbors();
-                for(AtomVector::iterator it2 = neighbors.begin(); it2 != neighbors.end(); it2++)
+                AtomVector node_neighbors = (atom_node != NULL) ? atom_node->GetNodeNeighbors() : AtomVector();
+                if(atom_graph_index == -1)
                 {
-                    Atom* neighbor = (*it2);
-                    stringstream key2;
-                    key2 << neighbor->GetId();
-                    ExtractTopologyBondTypesFromAssembly(inserted_bond_types, assembly_atom, neighbor, bonds, bond_type_counter, topology_file);
-                    ExtractTopologyBondsFromAssembly(inserted_bonds, inserted_bond_types, assembly_atom, neighbor, topology_file);
-
-                    ///Excluded Atoms
-                    stringstream first_order_interaction;
-                    stringstream reverse_first_order_interaction;
-                    first_order_interaction << key1.str() << "-" << key2.str();
-                    reverse_first_order_interaction << key2.str() << "-" << key1.str();
-                    if(find(excluded_atom_list.begin(), excluded_atom_list.end(), first_order_interaction.str()) == excluded_atom_list.end() &&
-                            find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_first_order_interaction.str()) == excluded_atom_list.end())
+                    stringstream warning;
+                    warning << "Atom " << assembly_atom->GetId() << " is not in the bond graph of the assembly, its bonds are skipped";
+                    gmml::log(__LINE__, __FILE__, gmml::WAR, warning.str());
+                    cout << warning.str() << endl;
+                }
+                for(AtomVector::iterator it2 = node_neighbors.begin(); it2 != node_neighbors.end(); it2++)
+                {
+                    if(atom_graph_index == -1 || residue_graph->GetIndex(*it2) == -1)
                     {
-                        excluded_atom_list.push_back(first_order_interaction.str());
-                        vector<string> key_tokens = Split(key2.str(),"_");
-                        topology_atom->AddExcludedAtom(key_tokens.at(2) + "(" + key_tokens.at(4) + "):" + key_tokens.at(0) + "(" + key_tokens.at(1) +")");
+                        stringstream warning;
+                        warning << "Bond " << assembly_atom->GetId() << " - " << (*it2)->GetId() << " is not in the bond graph of the assembly and is skipped";
+                        gmml::log(__LINE__, __FILE__, gmml::WAR, warning.str());
+                        cout << warning.str() << endl;
                     }
+                }
+            }
+            int first_neighbor = (atom_graph_index == -1) ? 0 : offsets.at(atom_graph_index);
+            for(int i = first_neighbor; i < first_neighbor + number_of_graph_neighbors; i++)
+            {
+                int neighbor_graph_index = graph_neighbors.at(i);
+                Atom* neighbor = residue_graph->GetAtom(neighbor_graph_index);
+                ExtractTopologyBondTypesFromAssembly(inserted_bond_types, assembly_atom, neighbor, bonds, bond_type_counter, topology_file);
+                ExtractTopologyBondsFromAssembly(*residue_inserted_bonds, inserted_bond_types, assembly_atom, neighbor, topology_file);
 
-                    ///Angle Types, Angle
-                    AtomNode* neighbor_node = neighbor->GetNode();
-                    AtomVector neighbors_of_neighbor = neighbor_node->GetNodeNeighbors();
+                ///Excluded Atoms
+                if(residue_excluded_atom_pairs->insert(make_pair(min(atom_graph_index, neighbor_graph_index), max(atom_graph_index, neighbor_graph_index))).second)
+                    topology_atom->AddExcludedAtom(FormatExcludedAtomKey(neighbor));
 
-                    for(AtomVector::iterator it3 = neighbors_of_neighbor.begin(); it3 != neighbors_of_neighbor.end(); it3++)
+                ///Angle Types, Angle
+                for(int j = offsets.at(neighbor_graph_index); j < offsets.at(neighbor_graph_index + 1); j++)
+                {
+                    int neighbor_of_neighbor_graph_index = graph_neighbors.at(j);
+                    if(neighbor_of_neighbor_graph_index != atom_graph_index)
                     {
-                        Atom* neighbor_of_neighbor = (*it3);
-                        stringstream key3;
-                        key3 << neighbor_of_neighbor->GetId();
-                        if(key1.str().compare(key3.str()) != 0)
+                        Atom* neighbor_of_neighbor = residue_graph->GetAtom(neighbor_of_neighbor_graph_index);
+                        ExtractTopologyAngleTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, inserted_angle_types, angle_type_counter,
+                                                              topology_file, angles);
+                        ExtractTopologyAnglesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, *residue_inserted_angles, inserted_angle_types, topology_file);
+
+                        ///Excluded Atoms
+                        if(residue_excluded_atom_pairs->insert(make_pair(min(atom_graph_index, neighbor_of_neighbor_graph_index),
+                                                                max(atom_graph_index, neighbor_of_neighbor_graph_index))).second)
+                            topology_atom->AddExcludedAtom(FormatExcludedAtomKey(neighbor_of_neighbor));
+
+                        //Dihedral Types, Dihedrals
+                        for(int k = offsets.at(neighbor_of_neighbor_graph_index); k < offsets.at(neighbor_of_neighbor_graph_index + 1); k++)
                         {
-                            ExtractTopologyAngleTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, inserted_angle_types, angle_type_counter,
-                                                                  topology_file, angles);
-                            ExtractTopologyAnglesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, inserted_angles, inserted_angle_types, topology_file);
-
-                            ///Excluded Atoms
-                            stringstream second_order_interaction;
-                            stringstream reverse_second_order_interaction;
-                            second_order_interaction << key1.str() << "-" << key3.str();
-                            reverse_second_order_interaction << key3.str() << "-" << key1.str();
-                            if(find(excluded_atom_list.begin(), excluded_atom_list.end(), second_order_interaction.str()) == excluded_atom_list.end() &&
-                                    find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_second_order_interaction.str()) == excluded_atom_list.end())
+                            int neighbor_of_neighbor_of_neighbor_graph_index = graph_neighbors.at(k);
+                            if(neighbor_of_neighbor_of_neighbor_graph_index != neighbor_graph_index)
                             {
-                                excluded_atom_list.push_back(second_order_interaction.str());
-                                vector<string> key_tokens = Split(key3.str(),"_");
-                                topology_atom->AddExcludedAtom(key_tokens.at(2) + "(" + key_tokens.at(4) + "):" + key_tokens.at(0) + "(" + key_tokens.at(1) +")");
-                            }
-
-
-                            //Dihedral Types, Dihedrals
-                            AtomNode* neighbor_of_neighbor_node = neighbor_of_neighbor->GetNode();
-                            AtomVector neighbors_of_neighbor_neighbor = neighbor_of_neighbor_node->GetNodeNeighbors();
-                            for(AtomVector::iterator it4 =  neighbors_of_neighbor_neighbor.begin(); it4 != neighbors_of_neighbor_neighbor.end(); it4++)
-                            {
-                                Atom* neighbor_of_neighbor_of_neighbor = (*it4);
-                                stringstream key4;
-                                key4 << neighbor_of_neighbor_of_neighbor->GetId();
-                                if(key2.str().compare(key4.str()) != 0)
-                                {
-                                    ExtractTopologyDihedralTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
-                                                                             inserted_dihedral_types, dihedral_type_counter, topology_file, dihedrals);
-                                    ExtractTopologyDihedralsFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
-                                                                         inserted_dihedrals, inserted_dihedral_types, dihedrals, topology_file);
-
-                                    ///Excluded Atoms
-                                    stringstream third_order_interaction;
-                                    stringstream reverse_third_order_interaction;
-                                    third_order_interaction << key1.str() << "-" << key4.str();
-                                    reverse_third_order_interaction << key4.str() << "-" << key1.str();
-                                    if(find(excluded_atom_list.begin(), excluded_atom_list.end(), third_order_interaction.str()) == excluded_atom_list.end() &&
-                                            find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_third_order_interaction.str()) == excluded_atom_list.end())
-                                    {
-                                        excluded_atom_list.push_back(third_order_interaction.str());
-                                        vector<string> key_tokens = Split(key4.str(),"_");
-                                        topology_atom->AddExcludedAtom(key_tokens.at(2) + "(" + key_tokens.at(4) + "):" + key_tokens.at(0) + "(" + key_tokens.at(1) +")");
-                                    }
-                                }
+                                Atom* neighbor_of_neighbor_of_neighbor = residue_graph->GetAtom(neighbor_of_neighbor_of_neighbor_graph_index);
+                                ExtractTopologyDihedralTypesFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
+                                                                         inserted_dihedral_types, dihedral_type_counter, topology_file, dihedrals);
+                                ExtractTopologyDihedralsFromAssembly(assembly_atom, neighbor, neighbor_of_neighbor, neighbor_of_neighbor_of_neighbor,
+                                                                     *residue_inserted_dihedrals, inserted_dihedral_types, dihedrals, topology_file);
+
+                                ///Excluded Atoms
+                                if(residue_excluded_atom_pairs->insert(make_pair(min(atom_graph_index, neighbor_of_neighbor_of_neighbor_graph_index),
+                                                                        max(atom_graph_index, neighbor_of_neighbor_of_neighbor_graph_index))).second)
+                                    topology_atom->AddExcludedAtom(FormatExcludedAtomKey(neighbor_of_neighbor_of_neighbor));
                             }
                         }
                     }
@@ -262,16 +310,26 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
         topology_assembly->AddResidue(topology_residue);
     }
 
-    AtomVector all_atoms = this->GetAllAtomsOfAssembly();
-    for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    /// A pair of atom types is looked up at its first occurrence, so it is enough to pair the atom types in the order they first occur
+    vector<string> all_atom_types = vector<string>();
+    for(AtomVector::iterator it = all_atoms_.begin(); it != all_atoms_.end(); it++)
+    {
+        string atom_type = (*it)->GetAtomType();
+        if(find(all_atom_types.begin(), all_atom_types.end(), atom_type) == all_atom_types.end())
+            all_atom_types.push_back(atom_type);
+    }
+    for(int i = 0; i < solvent_block_.GetNumberOfSites() && solvent_block_.GetNumberOfMolecules() > 0; i++)
+    {
+        if(find(all_atom_types.begin(), all_atom_types.end(), solvent_block_.GetSiteAtomType(i)) == all_atom_types.end())
+            all_atom_types.push_back(solvent_block_.GetSiteAtomType(i));
+    }
+    for(vector<string>::iterator it = all_atom_types.begin(); it != all_atom_types.end(); it++)
     {
-        Atom* assembly_atom = *it;
         ///Pairs
-        for(AtomVector::iterator it2 = all_atoms.begin(); it2 != all_atoms.end(); it2++)
+        for(vector<string>::iterator it2 = all_atom_types.begin(); it2 != all_atom_types.end(); it2++)
         {
-            Atom* pair_assembly_atom = (*it2);
-            string atom_type1 = assembly_atom->GetAtomType();
-            string atom_type2 = pair_assembly_atom->GetAtomType();
+            string atom_type1 = *it;
+            string atom_type2 = *it2;
             vector<string> pair_vector = vector<string>();
             pair_vector.push_back(atom_type1);
             pair_vector.push_back(atom_type2);
@@ -377,6 +435,93 @@ TopologyFile* Assembly::BuildTopologyFileStructureFromAssembly(string parameter_
     topology_file->SetNumberOfDihedralTypes(this->CountNumberOfDihedralTypes(parameter_file_path));
     topology_file->SetNumberOfAtomsInLargestResidue(this->CountMaxNumberOfAtomsInLargestResidue());
 
+    // Periodic box
+    if(box_length_ != dNotSet)
+    {
+        topology_file->SetStandardPeriodicBoxOption((fabs(box_angle_ - 90.0) < 0.0001) ? 1 : 2);
+        vector<double> box_dimensions = vector<double>();
+        box_dimensions.push_back(box_angle_);
+        box_dimensions.push_back(box_length_);
+        box_dimensions.push_back(box_width_);
+        box_dimensions.push_back(box_height_);
+        topology_file->SetBoxDimensions(box_dimensions);
+
+        /// Molecules are the connected components of the bond graph, numbered in the order of their first atom
+        const BondGraph::IndexVector& offsets = bond_graph->GetOffsets();
+        const BondGraph::IndexVector& graph_neighbors = bond_graph->GetNeighbors();
+        vector<int> molecule_of_atom = vector<int>(bond_graph->GetNumberOfAtoms(), -1);
+        vector<int> atoms_per_molecule = vector<int>();
+        int last_solute_residue = 0;
+        int first_solvent_molecule = iNotSet;
+        residue_counter = 0;
+        const char* solvent_residue_names[] = {"HOH", "WAT", "TP3", "TIP3", "TIP3PBOX", "TP5", "TIP5", "TIP5PBOX"};
+        set<SymbolTable::Symbol> solvent_names = set<SymbolTable::Symbol>();
+        for(unsigned int i = 0; i < sizeof(solvent_residue_names) / sizeof(solvent_residue_names[0]); i++)
+            solvent_names.insert(SymbolTable::Intern(solvent_residue_names[i]));
+        for(ResidueVector::iterator it = assembly_residues.begin(); it != assembly_residues.end(); it++)
+        {
+            residue_counter++;
+            bool is_solvent = (solvent_names.find((*it)->GetNameSymbol()) != solvent_names.end());
+            AtomVector residue_atoms = (*it)->GetAtoms();
+            for(AtomVector::iterator it1 = residue_atoms.begin(); it1 != residue_atoms.end(); it1++)
+            {
+                int atom_graph_index = bond_graph->GetIndex(*it1);
+                ///An atom that is not in the bond graph had its bonds skipped above, so it is a molecule of its own
+                if(atom_graph_index == -1)
+                {
+                    atoms_per_molecule.push_back(1);
+                    if(is_solvent && first_solvent_molecule == iNotSet)
+                        first_solvent_molecule = atoms_per_molecule.size();
+                    continue;
+                }
+                if(molecule_of_atom.at(atom_graph_index) == -1)
+                {
+                    int molecule = atoms_per_molecule.size();
+                    atoms_per_molecule.push_back(0);
+                    vector<int> stack = vector<int>(1, atom_graph_index);
+                    molecule_of_atom.at(atom_graph_index) = molecule;
+                    while(!stack.empty())
+                    {
+                        int index = stack.back();
+                        stack.pop_back();
+                        atoms_per_molecule.at(molecule)++;
+                        for(int i = offsets.at(index); i < offsets.at(index + 1); i++)
+                        {
+                            if(molecule_of_atom.at(graph_neighbors.at(i)) == -1)
+                            {
+                                molecule_of_atom.at(graph_neighbors.at(i)) = molecule;
+                                stack.push_back(graph_neighbors.at(i));
+                            }
+                        }
+                    }
+                }
+                if(is_solvent && first_solvent_molecule == iNotSet)
+                    first_solvent_molecule = molecule_of_atom.at(atom_graph_index) + 1;
+            }
+            if(!is_solvent && first_solvent_molecule == iNotSet)
+                last_solute_residue = residue_counter;
+        }
+        /// Each molecule of the solvent block is a molecule of its own; an empty residue of the block has no name and counts as solute
+        for(int i = 0; i < solvent_block_.GetNumberOfResidues(); i++)
+        {
+            residue_counter++;
+            int number_of_molecules = solvent_block_.GetNumberOfMoleculesOfResidue(i);
+            if(number_of_molecules > 0 && first_solvent_molecule == iNotSet)
+                first_solvent_molecule = atoms_per_molecule.size() + 1;
+            atoms_per_molecule.insert(atoms_per_molecule.end(), number_of_molecules, solvent_block_.GetNumberOfSites());
+            if(number_of_molecules == 0 && first_solvent_molecule == iNotSet)
+                last_solute_residue = residue_counter;
+        }
+        if(first_solvent_molecule == iNotSet)
+            first_solvent_molecule = atoms_per_molecule.size() + 1;
+        vector<int> solvent_pointers = vector<int>();
+        solvent_pointers.push_back(last_solute_residue);
+        solvent_pointers.push_back(atoms_per_molecule.size());
+        solvent_pointers.push_back(first_solvent_molecule);
+        topology_file->SetSolventPointers(solvent_pointers);
+        topology_file->SetAtomsPerMolecule(atoms_per_molecule);
+    }
+
     return topology_file;
 }
 
@@ -437,16 +582,16 @@ void Assembly::ExtractTopologyBondsFromAssembly(vector<vector<string> > &inserte
 
     vector<string> atom_pair_name = vector<string>();;
     vector<string> reverse_atom_pair_name = vector<string>();;
-    atom_pair_name.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-    atom_pair_name.push_back(neighbor->GetName() + "(" + Split(neighbor->GetId(),"_").at(1) + ")");
-    reverse_atom_pair_name.push_back(neighbor->GetName() + "(" + Split(neighbor->GetId(),"_").at(1) + ")");
-    reverse_atom_pair_name.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
+    atom_pair_name.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+    atom_pair_name.push_back(neighbor->GetName() + "(" + ConvertT<int>(neighbor->GetSerialNumber()) + ")");
+    reverse_atom_pair_name.push_back(neighbor->GetName() + "(" + ConvertT<int>(neighbor->GetSerialNumber()) + ")");
+    reverse_atom_pair_name.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
     vector<string> residue_names = vector<string>();;
     vector<string> reverse_residue_names = vector<string>();;
-    residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-    residue_names.push_back(neighbor->GetResidue()->GetName()+"("+Split(neighbor->GetResidue()->GetId(),"_").at(2)+")");
-    reverse_residue_names.push_back(neighbor->GetResidue()->GetName()+"("+Split(neighbor->GetResidue()->GetId(),"_").at(2)+")");
-    reverse_residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
+    residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+    residue_names.push_back(neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor->GetResidue()->GetSequenceNumber())+")");
+    reverse_residue_names.push_back(neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor->GetResidue()->GetSequenceNumber())+")");
+    reverse_residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
     vector<string> bond = vector<string>();
     vector<string> reverse_bond = vector<string>();
     stringstream ss;
@@ -559,21 +704,21 @@ void Assembly::ExtractTopologyAnglesFromAssembly(Atom* assembly_atom, Atom* neig
 
     vector<string> angle_atom_names = vector<string>();
     vector<string> reverse_angle_atom_names = vector<string>();
-    angle_atom_names.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-    angle_atom_names.push_back(neighbor->GetName() + "(" + Split(neighbor->GetId(),"_").at(1) + ")");
-    angle_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + Split(neighbor_of_neighbor->GetId(),"_").at(1) + ")");
-    reverse_angle_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + Split(neighbor_of_neighbor->GetId(),"_").at(1) + ")");
-    reverse_angle_atom_names.push_back(neighbor->GetName() + "(" + Split(neighbor->GetId(),"_").at(1) + ")");
-    reverse_angle_atom_names.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
+    angle_atom_names.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+    angle_atom_names.push_back(neighbor->GetName() + "(" + ConvertT<int>(neighbor->GetSerialNumber()) + ")");
+    angle_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + ConvertT<int>(neighbor_of_neighbor->GetSerialNumber()) + ")");
+    reverse_angle_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + ConvertT<int>(neighbor_of_neighbor->GetSerialNumber()) + ")");
+    reverse_angle_atom_names.push_back(neighbor->GetName() + "(" + ConvertT<int>(neighbor->GetSerialNumber()) + ")");
+    reverse_angle_atom_names.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
 
     vector<string> residue_names = vector<string>();
     vector<string> reverse_residue_names = vector<string>();
-    residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-    residue_names.push_back(neighbor->GetResidue()->GetName()+"("+Split(neighbor->GetResidue()->GetId(),"_").at(2)+")");
-    residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+Split(neighbor_of_neighbor->GetResidue()->GetId(),"_").at(2)+")");
-    reverse_residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+Split(neighbor_of_neighbor->GetResidue()->GetId(),"_").at(2)+")");
-    reverse_residue_names.push_back(neighbor->GetResidue()->GetName()+"("+Split(neighbor->GetResidue()->GetId(),"_").at(2)+")");
-    reverse_residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
+    residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+    residue_names.push_back(neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor->GetResidue()->GetSequenceNumber())+")");
+    residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor_of_neighbor->GetResidue()->GetSequenceNumber())+")");
+    reverse_residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor_of_neighbor->GetResidue()->GetSequenceNumber())+")");
+    reverse_residue_names.push_back(neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor->GetResidue()->GetSequenceNumber())+")");
+    reverse_residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
     vector<string> angle = vector<string>();
     vector<string> reverse_angle = vector<string>();
     stringstream ss;
@@ -744,25 +889,25 @@ void Assembly::ExtractTopologyDihedralsFromAssembly(Atom *assembly_atom, Atom *n
         {
             vector<string> dihedral_atom_names = vector<string>();
             vector<string> reverse_dihedral_atom_names = vector<string>();
-            dihedral_atom_names.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-            dihedral_atom_names.push_back(neighbor->GetName() + "(" + Split(neighbor->GetId(),"_").at(1) + ")");
-            dihedral_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + Split(neighbor_of_neighbor->GetId(),"_").at(1) + ")");
-            dihedral_atom_names.push_back(neighbor_of_neighbor_of_neighbor->GetName() + "(" + Split(neighbor_of_neighbor_of_neighbor->GetId(),"_").at(1) + ")");
-            reverse_dihedral_atom_names.push_back(neighbor_of_neighbor_of_neighbor->GetName() + "(" + Split(neighbor_of_neighbor_of_neighbor->GetId(),"_").at(1) + ")");
-            reverse_dihedral_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + Split(neighbor_of_neighbor->GetId(),"_").at(1) + ")");
-            reverse_dihedral_atom_names.push_back(neighbor->GetName() + "(" + Split(neighbor->GetId(),"_").at(1) + ")");
-            reverse_dihedral_atom_names.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
+            dihedral_atom_names.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+            dihedral_atom_names.push_back(neighbor->GetName() + "(" + ConvertT<int>(neighbor->GetSerialNumber()) + ")");
+            dihedral_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + ConvertT<int>(neighbor_of_neighbor->GetSerialNumber()) + ")");
+            dihedral_atom_names.push_back(neighbor_of_neighbor_of_neighbor->GetName() + "(" + ConvertT<int>(neighbor_of_neighbor_of_neighbor->GetSerialNumber()) + ")");
+            reverse_dihedral_atom_names.push_back(neighbor_of_neighbor_of_neighbor->GetName() + "(" + ConvertT<int>(neighbor_of_neighbor_of_neighbor->GetSerialNumber()) + ")");
+            reverse_dihedral_atom_names.push_back(neighbor_of_neighbor->GetName() + "(" + ConvertT<int>(neighbor_of_neighbor->GetSerialNumber()) + ")");
+            reverse_dihedral_atom_names.push_back(neighbor->GetName() + "(" + ConvertT<int>(neighbor->GetSerialNumber()) + ")");
+            reverse_dihedral_atom_names.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
 
             vector<string> residue_names = vector<string>();
             vector<string> reverse_residue_names = vector<string>();
-            residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-            residue_names.push_back(neighbor->GetResidue()->GetName()+"("+Split(neighbor->GetResidue()->GetId(),"_").at(2)+")");
-            residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+Split(neighbor_of_neighbor->GetResidue()->GetId(),"_").at(2)+")");
-            residue_names.push_back(neighbor_of_neighbor_of_neighbor->GetResidue()->GetName()+"("+Split(neighbor_of_neighbor_of_neighbor->GetResidue()->GetId(),"_").at(2)+")");
-            reverse_residue_names.push_back(neighbor_of_neighbor_of_neighbor->GetResidue()->GetName()+"("+Split(neighbor_of_neighbor_of_neighbor->GetResidue()->GetId(),"_").at(2)+")");
-            reverse_residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+Split(neighbor_of_neighbor->GetResidue()->GetId(),"_").at(2)+")");
-            reverse_residue_names.push_back(neighbor->GetResidue()->GetName()+"("+Split(neighbor->GetResidue()->GetId(),"_").at(2)+")");
-            reverse_residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
+            residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+            residue_names.push_back(neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor->GetResidue()->GetSequenceNumber())+")");
+            residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor_of_neighbor->GetResidue()->GetSequenceNumber())+")");
+            residue_names.push_back(neighbor_of_neighbor_of_neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor_of_neighbor_of_neighbor->GetResidue()->GetSequenceNumber())+")");
+            reverse_residue_names.push_back(neighbor_of_neighbor_of_neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor_of_neighbor_of_neighbor->GetResidue()->GetSequenceNumber())+")");
+            reverse_residue_names.push_back(neighbor_of_neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor_of_neighbor->GetResidue()->GetSequenceNumber())+")");
+            reverse_residue_names.push_back(neighbor->GetResidue()->GetName()+"("+ConvertT<int>(neighbor->GetResidue()->GetSequenceNumber())+")");
+            reverse_residue_names.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
 
             vector<string> dihedral = vector<string>();
             vector<string> reverse_dihedral = vector<string>();
@@ -857,68 +1002,68 @@ void Assembly::ExtractTopologyDihedralsFromAssembly(Atom *assembly_atom, Atom *n
             if(find(inserted_dihedral_types.begin(), inserted_dihedral_types.end(), sss.str()) != inserted_dihedral_types.end())
             {
                 vector<string> dihedral_atom_names1 = vector<string>();
-                dihedral_atom_names1.push_back(neighbor1->GetName() + "(" + Split(neighbor1->GetId(),"_").at(1) + ")");
-                dihedral_atom_names1.push_back(neighbor2->GetName() + "(" + Split(neighbor2->GetId(),"_").at(1) + ")");
-                dihedral_atom_names1.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-                dihedral_atom_names1.push_back(neighbor3->GetName() + "(" + Split(neighbor3->GetId(),"_").at(1) + ")");
+                dihedral_atom_names1.push_back(neighbor1->GetName() + "(" + ConvertT<int>(neighbor1->GetSerialNumber()) + ")");
+                dihedral_atom_names1.push_back(neighbor2->GetName() + "(" + ConvertT<int>(neighbor2->GetSerialNumber()) + ")");
+                dihedral_atom_names1.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+                dihedral_atom_names1.push_back(neighbor3->GetName() + "(" + ConvertT<int>(neighbor3->GetSerialNumber()) + ")");
                 //                vector<string> dihedral_atom_names2 = vector<string>();
-                //                dihedral_atom_names2.push_back(neighbor1->GetName() + "(" + Split(neighbor1->GetId(),"_").at(1) + ")");
-                //                dihedral_atom_names2.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-                //                dihedral_atom_names2.push_back(neighbor3->GetName() + "(" + Split(neighbor3->GetId(),"_").at(1) + ")");
-                //                dihedral_atom_names2.push_back(neighbor2->GetName() + "(" + Split(neighbor2->GetId(),"_").at(1) + ")");
+                //                dihedral_atom_names2.push_back(neighbor1->GetName() + "(" + ConvertT<int>(neighbor1->GetSerialNumber()) + ")");
+                //                dihedral_atom_names2.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+                //                dihedral_atom_names2.push_back(neighbor3->GetName() + "(" + ConvertT<int>(neighbor3->GetSerialNumber()) + ")");
+                //                dihedral_atom_names2.push_back(neighbor2->GetName() + "(" + ConvertT<int>(neighbor2->GetSerialNumber()) + ")");
                 vector<string> dihedral_atom_names3 = vector<string>();
-                dihedral_atom_names3.push_back(neighbor1->GetName() + "(" + Split(neighbor1->GetId(),"_").at(1) + ")");
-                dihedral_atom_names3.push_back(neighbor3->GetName() + "(" + Split(neighbor3->GetId(),"_").at(1) + ")");
-                dihedral_atom_names3.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-                dihedral_atom_names3.push_back(neighbor2->GetName() + "(" + Split(neighbor2->GetId(),"_").at(1) + ")");
+                dihedral_atom_names3.push_back(neighbor1->GetName() + "(" + ConvertT<int>(neighbor1->GetSerialNumber()) + ")");
+                dihedral_atom_names3.push_back(neighbor3->GetName() + "(" + ConvertT<int>(neighbor3->GetSerialNumber()) + ")");
+                dihedral_atom_names3.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+                dihedral_atom_names3.push_back(neighbor2->GetName() + "(" + ConvertT<int>(neighbor2->GetSerialNumber()) + ")");
 
                 //                vector<string> reverse_dihedral_atom_names1 = vector<string>();
-                //                reverse_dihedral_atom_names1.push_back(neighbor3->GetName() + "(" + Split(neighbor3->GetId(),"_").at(1) + ")");
-                //                reverse_dihedral_atom_names1.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-                //                reverse_dihedral_atom_names1.push_back(neighbor2->GetName() + "(" + Split(neighbor2->GetId(),"_").at(1) + ")");
-                //                reverse_dihedral_atom_names1.push_back(neighbor1->GetName() + "(" + Split(neighbor1->GetId(),"_").at(1) + ")");
+                //                reverse_dihedral_atom_names1.push_back(neighbor3->GetName() + "(" + ConvertT<int>(neighbor3->GetSerialNumber()) + ")");
+                //                reverse_dihedral_atom_names1.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+                //                reverse_dihedral_atom_names1.push_back(neighbor2->GetName() + "(" + ConvertT<int>(neighbor2->GetSerialNumber()) + ")");
+                //                reverse_dihedral_atom_names1.push_back(neighbor1->GetName() + "(" + ConvertT<int>(neighbor1->GetSerialNumber()) + ")");
                 vector<string> reverse_dihedral_atom_names2 = vector<string>();
-                reverse_dihedral_atom_names2.push_back(neighbor2->GetName() + "(" + Split(neighbor2->GetId(),"_").at(1) + ")");
-                reverse_dihedral_atom_names2.push_back(neighbor3->GetName() + "(" + Split(neighbor3->GetId(),"_").at(1) + ")");
-                reverse_dihedral_atom_names2.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-                reverse_dihedral_atom_names2.push_back(neighbor1->GetName() + "(" + Split(neighbor1->GetId(),"_").at(1) + ")");
+                reverse_dihedral_atom_names2.push_back(neighbor2->GetName() + "(" + ConvertT<int>(neighbor2->GetSerialNumber()) + ")");
+                reverse_dihedral_atom_names2.push_back(neighbor3->GetName() + "(" + ConvertT<int>(neighbor3->GetSerialNumber()) + ")");
+                reverse_dihedral_atom_names2.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+                reverse_dihedral_atom_names2.push_back(neighbor1->GetName() + "(" + ConvertT<int>(neighbor1->GetSerialNumber()) + ")");
                 //                vector<string> reverse_dihedral_atom_names3 = vector<string>();
-                //                reverse_dihedral_atom_names3.push_back(neighbor2->GetName() + "(" + Split(neighbor2->GetId(),"_").at(1) + ")");
-                //                reverse_dihedral_atom_names3.push_back(assembly_atom->GetName() + "(" + Split(assembly_atom->GetId(),"_").at(1) + ")");
-                //                reverse_dihedral_atom_names3.push_back(neighbor3->GetName() + "(" + Split(neighbor3->GetId(),"_").at(1) + ")");
-                //                reverse_dihedral_atom_names3.push_back(neighbor1->GetName() + "(" + Split(neighbor1->GetId(),"_").at(1) + ")");
+                //                reverse_dihedral_atom_names3.push_back(neighbor2->GetName() + "(" + ConvertT<int>(neighbor2->GetSerialNumber()) + ")");
+                //                reverse_dihedral_atom_names3.push_back(assembly_atom->GetName() + "(" + ConvertT<int>(assembly_atom->GetSerialNumber()) + ")");
+                //                reverse_dihedral_atom_names3.push_back(neighbor3->GetName() + "(" + ConvertT<int>(neighbor3->GetSerialNumber()) + ")");
+                //                reverse_dihedral_atom_names3.push_back(neighbor1->GetName() + "(" + ConvertT<int>(neighbor1->GetSerialNumber()) + ")");
 
                 vector<string> residue_names1 = vector<string>();
-                residue_names1.push_back(neighbor1->GetResidue()->GetName()+"("+Split(neighbor1->GetResidue()->GetId(),"_").at(2)+")");
-                residue_names1.push_back(neighbor2->GetResidue()->GetName()+"("+Split(neighbor2->GetResidue()->GetId(),"_").at(2)+")");
-                residue_names1.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-                residue_names1.push_back(neighbor3->GetResidue()->GetName()+"("+Split(neighbor3->GetResidue()->GetId(),"_").at(2)+")");
+                residue_names1.push_back(neighbor1->GetResidue()->GetName()+"("+ConvertT<int>(neighbor1->GetResidue()->GetSequenceNumber())+")");
+                residue_names1.push_back(neighbor2->GetResidue()->GetName()+"("+ConvertT<int>(neighbor2->GetResidue()->GetSequenceNumber())+")");
+                residue_names1.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+                residue_names1.push_back(neighbor3->GetResidue()->GetName()+"("+ConvertT<int>(neighbor3->GetResidue()->GetSequenceNumber())+")");
                 //                vector<string> residue_names2 = vector<string>();
-                //                residue_names2.push_back(neighbor1->GetName()+"("+Split(neighbor1->GetResidue()->GetId(),"_").at(2)+")");
-                //                residue_names2.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-                //                residue_names2.push_back(neighbor3->GetResidue()->GetName()+"("+Split(neighbor3->GetResidue()->GetId(),"_").at(2)+")");
-                //                residue_names2.push_back(neighbor2->GetResidue()->GetName()+"("+Split(neighbor2->GetResidue()->GetId(),"_").at(2)+")");
+                //                residue_names2.push_back(neighbor1->GetName()+"("+ConvertT<int>(neighbor1->GetResidue()->GetSequenceNumber())+")");
+                //                residue_names2.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+                //                residue_names2.push_back(neighbor3->GetResidue()->GetName()+"("+ConvertT<int>(neighbor3->GetResidue()->GetSequenceNumber())+")");
+                //                residue_names2.push_back(neighbor2->GetResidue()->GetName()+"("+ConvertT<int>(neighbor2->GetResidue()->GetSequenceNumber())+")");
                 vector<string> residue_names3 = vector<string>();
-                residue_names3.push_back(neighbor1->GetResidue()->GetName()+"("+Split(neighbor1->GetResidue()->GetId(),"_").at(2)+")");
-                residue_names3.push_back(neighbor3->GetResidue()->GetName()+"("+Split(neighbor3->GetResidue()->GetId(),"_").at(2)+")");
-                residue_names3.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-                residue_names3.push_back(neighbor2->GetResidue()->GetName()+"("+Split(neighbor2->GetResidue()->GetId(),"_").at(2)+")");
+                residue_names3.push_back(neighbor1->GetResidue()->GetName()+"("+ConvertT<int>(neighbor1->GetResidue()->GetSequenceNumber())+")");
+                residue_names3.push_back(neighbor3->GetResidue()->GetName()+"("+ConvertT<int>(neighbor3->GetResidue()->GetSequenceNumber())+")");
+                residue_names3.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+                residue_names3.push_back(neighbor2->GetResidue()->GetName()+"("+ConvertT<int>(neighbor2->GetResidue()->GetSequenceNumber())+")");
 
                 //                vector<string> reverse_residue_names1 = vector<string>();
-                //                reverse_residue_names1.push_back(neighbor3->GetResidue()->GetName()+"("+Split(neighbor3->GetResidue()->GetId(),"_").at(2)+")");
-                //                reverse_residue_names1.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-                //                reverse_residue_names1.push_back(neighbor2->GetResidue()->GetName()+"("+Split(neighbor2->GetResidue()->GetId(),"_").at(2)+")");
-                //                reverse_residue_names1.push_back(neighbor1->GetResidue()->GetName()+"("+Split(neighbor1->GetResidue()->GetId(),"_").at(2)+")");
+                //                reverse_residue_names1.push_back(neighbor3->GetResidue()->GetName()+"("+ConvertT<int>(neighbor3->GetResidue()->GetSequenceNumber())+")");
+                //                reverse_residue_names1.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+                //                reverse_residue_names1.push_back(neighbor2->GetResidue()->GetName()+"("+ConvertT<int>(neighbor2->GetResidue()->GetSequenceNumber())+")");
+                //                reverse_residue_names1.push_back(neighbor1->GetResidue()->GetName()+"("+ConvertT<int>(neighbor1->GetResidue()->GetSequenceNumber())+")");
                 vector<string> reverse_residue_names2 = vector<string>();
-                reverse_residue_names2.push_back(neighbor2->GetResidue()->GetName()+"("+Split(neighbor2->GetResidue()->GetId(),"_").at(2)+")");
-                reverse_residue_names2.push_back(neighbor3->GetResidue()->GetName()+"("+Split(neighbor3->GetResidue()->GetId(),"_").at(2)+")");
-                reverse_residue_names2.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-                reverse_residue_names2.push_back(neighbor1->GetName()+"("+Split(neighbor1->GetResidue()->GetId(),"_").at(2)+")");
+                reverse_residue_names2.push_back(neighbor2->GetResidue()->GetName()+"("+ConvertT<int>(neighbor2->GetResidue()->GetSequenceNumber())+")");
+                reverse_residue_names2.push_back(neighbor3->GetResidue()->GetName()+"("+ConvertT<int>(neighbor3->GetResidue()->GetSequenceNumber())+")");
+                reverse_residue_names2.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+                reverse_residue_names2.push_back(neighbor1->GetName()+"("+ConvertT<int>(neighbor1->GetResidue()->GetSequenceNumber())+")");
                 //                vector<string> reverse_residue_names3 = vector<string>();
-                //                reverse_residue_names3.push_back(neighbor2->GetResidue()->GetName()+"("+Split(neighbor2->GetResidue()->GetId(),"_").at(2)+")");
-                //                reverse_residue_names3.push_back(assembly_atom->GetResidue()->GetName()+"("+Split(assembly_atom->GetResidue()->GetId(),"_").at(2)+")");
-                //                reverse_residue_names3.push_back(neighbor3->GetResidue()->GetName()+"("+Split(neighbor3->GetResidue()->GetId(),"_").at(2)+")");
-                //                reverse_residue_names3.push_back(neighbor1->GetResidue()->GetName()+"("+Split(neighbor1->GetResidue()->GetId(),"_").at(2)+")");
+                //                reverse_residue_names3.push_back(neighbor2->GetResidue()->GetName()+"("+ConvertT<int>(neighbor2->GetResidue()->GetSequenceNumber())+")");
+                //                reverse_residue_names3.push_back(assembly_atom->GetResidue()->GetName()+"("+ConvertT<int>(assembly_atom->GetResidue()->GetSequenceNumber())+")");
+                //                reverse_residue_names3.push_back(neighbor3->GetResidue()->GetName()+"("+ConvertT<int>(neighbor3->GetResidue()->GetSequenceNumber())+")");
+                //                reverse_residue_names3.push_back(neighbor1->GetResidue()->GetName()+"("+ConvertT<int>(neighbor1->GetResidue()->GetSequenceNumber())+")");
 
                 vector<string> dihedral1 = vector<string>();
                 vector<string> dihedral2 = vector<string>();
@@ -1071,13 +1216,15 @@ int Assembly::CountNumberOfAtoms()
         Residue::AtomVector atoms = residue->GetAtoms();
         counter += atoms.size();
     }
+    counter += solvent_block_.GetNumberOfAtoms();
     return counter;
 }
 
 int Assembly::CountNumberOfAtomTypes()
 {
     vector<string> type_list = vector<string>();
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    Assembly solvent_molecule;
+    AtomVector atoms = this->GetAllAtomsOfAssemblyWithSolventMolecule(&solvent_molecule);
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
         Atom* atom = (*it);
@@ -1101,6 +1248,7 @@ int Assembly::CountNumberOfResidues()
         counter += assembly->CountNumberOfResidues();
     }
     counter += residues_.size();
+    counter += solvent_block_.GetNumberOfResidues();
     return counter;
 }
 
@@ -1108,7 +1256,8 @@ int Assembly::CountNumberOfBondsIncludingHydrogen(string parameter_file_path)
 {
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
     ParameterFileSpace::ParameterFile::BondMap bonds = parameter_file->GetBonds();
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    this->UpdateViews();
+    AtomVector atoms = all_atoms_;
     int counter = 0;
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
@@ -1146,14 +1295,15 @@ int Assembly::CountNumberOfBondsIncludingHydrogen(string parameter_file_path)
             //            }
         }
     }
-    return counter/2;
+    return counter/2 + this->CountNumberInSolventBlock(&Assembly::CountNumberOfBondsIncludingHydrogen, parameter_file_path);
 }
 
 int Assembly::CountNumberOfBondsExcludingHydrogen(string parameter_file_path)
 {
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
     ParameterFileSpace::ParameterFile::BondMap bonds = parameter_file->GetBonds();
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    this->UpdateViews();
+    AtomVector atoms = all_atoms_;
     int counter = 0;
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
@@ -1192,29 +1342,18 @@ int Assembly::CountNumberOfBondsExcludingHydrogen(string parameter_file_path)
             //            }
         }
     }
-    return counter/2;
+    return counter/2 + this->CountNumberInSolventBlock(&Assembly::CountNumberOfBondsExcludingHydrogen, parameter_file_path);
 }
 
 int Assembly::CountNumberOfBonds()
 {
-    AtomVector atoms = GetAllAtomsOfAssembly();
-    int counter = 0;
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        AtomNode* atom_node = atom->GetNode();
-        if(atom_node != NULL)
-        {
-            AtomVector node_neighbors = atom_node->GetNodeNeighbors();
-            counter += node_neighbors.size();
-        }
-    }
-    return counter/2;
+    return this->GetBondGraph()->GetNumberOfNeighborEntries()/2;
 }
 
 int Assembly::CountNumberOfBondTypes(string parameter_file_path)
 {
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    Assembly solvent_molecule;
+    AtomVector atoms = this->GetAllAtomsOfAssemblyWithSolventMolecule(&solvent_molecule);
     vector<string> type_list = vector<string>();
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
     ParameterFileSpace::ParameterFile::BondMap bonds = parameter_file->GetBonds();
@@ -1262,7 +1401,8 @@ int Assembly::CountNumberOfAnglesIncludingHydrogen(string parameter_file_path)
 {
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
     ParameterFileSpace::ParameterFile::AngleMap angles = parameter_file->GetAngles();
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    this->UpdateViews();
+    AtomVector atoms = all_atoms_;
     int counter = 0;
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
@@ -1308,14 +1448,15 @@ int Assembly::CountNumberOfAnglesIncludingHydrogen(string parameter_file_path)
             }
         }
     }
-    return counter/2;
+    return counter/2 + this->CountNumberInSolventBlock(&Assembly::CountNumberOfAnglesIncludingHydrogen, parameter_file_path);
 }
 
 int Assembly::CountNumberOfAnglesExcludingHydrogen(string parameter_file_path)
 {
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
     ParameterFileSpace::ParameterFile::AngleMap angles = parameter_file->GetAngles();
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    this->UpdateViews();
+    AtomVector atoms = all_atoms_;
     int counter = 0;
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
     {
@@ -1363,7 +1504,7 @@ int Assembly::CountNumberOfAnglesExcludingHydrogen(string parameter_file_path)
             }
         }
     }
-    return counter/2;
+    return counter/2 + this->CountNumberInSolventBlock(&Assembly::CountNumberOfAnglesExcludingHydrogen, parameter_file_path);
 }
 
 int Assembly::CountNumberOfAngles()
@@ -1404,7 +1545,8 @@ int Assembly::CountNumberOfAngleTypes(string parameter_file_path)
 {
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
     ParameterFileSpace::ParameterFile::AngleMap angles = parameter_file->GetAngles();
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    Assembly solvent_molecule;
+    AtomVector atoms = this->GetAllAtomsOfAssemblyWithSolventMolecule(&solvent_molecule);
 
     vector<string> type_list = vector<string>();
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
@@ -1462,7 +1604,8 @@ int Assembly::CountNumberOfAngleTypes(string parameter_file_path)
 int Assembly::CountNumberOfDihedralsIncludingHydrogen(string parameter_file_path)
 {
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    this->UpdateViews();
+    AtomVector atoms = all_atoms_;
     int counter = 0;
     int improper_counter = 0;
     //    int not_found_counter = 0;
@@ -1562,13 +1705,14 @@ int Assembly::CountNumberOfDihedralsIncludingHydrogen(string parameter_file_path
         }
     }
     //    cout << not_found_counter/2 << " dihedrals not found in parameter file" << endl;
-    return counter/2 + improper_counter;
+    return counter/2 + improper_counter + this->CountNumberInSolventBlock(&Assembly::CountNumberOfDihedralsIncludingHydrogen, parameter_file_path);
 }
 
 int Assembly::CountNumberOfDihedralsExcludingHydrogen(string parameter_file_path)
 {
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    this->UpdateViews();
+    AtomVector atoms = all_atoms_;
     int counter = 0;
     int improper_counter = 0;
     //    int not_found_counter = 0;
@@ -1674,7 +1818,7 @@ int Assembly::CountNumberOfDihedralsExcludingHydrogen(string parameter_file_path
         }
     }
     //    cout << not_found_counter/2 << " dihedrals not found in parameter file" << endl;
-    return counter/2 + improper_counter;
+    return counter/2 + improper_counter + this->CountNumberInSolventBlock(&Assembly::CountNumberOfDihedralsExcludingHydrogen, parameter_file_path);
 }
 
 int Assembly::CountNumberOfDihedrals(string parameter_file_path)
@@ -1770,7 +1914,8 @@ int Assembly::CountNumberOfDihedralTypes(string parameter_file_path)
 {
     vector<string> type_list = vector<string>();
     ParameterFile* parameter_file = new ParameterFile(parameter_file_path);
-    AtomVector atoms = GetAllAtomsOfAssembly();
+    Assembly solvent_molecule;
+    AtomVector atoms = this->GetAllAtomsOfAssemblyWithSolventMolecule(&solvent_molecule);
     int counter = 0;
     //    int not_found_counter = 0;
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
@@ -2198,97 +2343,52 @@ vector<vector<string> > Assembly::CreateAllAtomTypePermutationsforImproperDihedr
 
 Assembly::AtomVector Assembly::GetAllAtomsOfAssemblyWithAtLeastThreeNeighbors()
 {
-    AtomVector all_atoms = GetAllAtomsOfAssembly();
+    BondGraph* bond_graph = this->GetBondGraph();
     AtomVector atoms_with_at_least_three_neighbors = AtomVector();
-    for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    for(int i = 0; i < bond_graph->GetNumberOfAtoms(); i++)
     {
-        Atom* atom = (*it);
-        AtomNode* node = atom->GetNode();
-        AtomVector neighbors = node->GetNodeNeighbors();
-        if(neighbors.size() > 2)
-            atoms_with_at_least_three_neighbors.push_back(atom);
+        if(bond_graph->GetDegree(i) > 2)
+            atoms_with_at_least_three_neighbors.push_back(bond_graph->GetAtom(i));
     }
     return atoms_with_at_least_three_neighbors;
 }
 
 int Assembly::CountNumberOfExcludedAtoms()
 {
-    AtomVector atoms = GetAllAtomsOfAssembly();
-    vector<string> excluded_atom_list = vector<string>();
-    map<string, vector<string> > excluded_atom_list_map = map<string, vector<string> >();
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
+    BondGraph* bond_graph = this->GetBondGraph();
+    const BondGraph::IndexVector& offsets = bond_graph->GetOffsets();
+    const BondGraph::IndexVector& neighbors = bond_graph->GetNeighbors();
+    /// Every pair of atoms up to three bonds apart is excluded once, and is listed by the atom that reaches it first
+    set<pair<int, int> > excluded_atom_pairs = set<pair<int, int> >();
+    int number_of_excluded_atoms = 0;
+    for(int atom_index = 0; atom_index < bond_graph->GetNumberOfAtoms(); atom_index++)
     {
-        Atom* atom = (*it);
-        stringstream ss;
-        ss << atom->GetId();
-        AtomNode* node = atom->GetNode();
-        excluded_atom_list_map[atom->GetId()] = vector<string>();
-        if(node != NULL)
+        int number_of_excluded_atoms_of_atom = 0;
+        for(int i = offsets.at(atom_index); i < offsets.at(atom_index + 1); i++)
         {
-            AtomVector neighbors = node->GetNodeNeighbors();
-            for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
+            int neighbor_index = neighbors.at(i);
+            if(excluded_atom_pairs.insert(make_pair(min(atom_index, neighbor_index), max(atom_index, neighbor_index))).second)
+                number_of_excluded_atoms_of_atom++;
+            for(int j = offsets.at(neighbor_index); j < offsets.at(neighbor_index + 1); j++)
             {
-                Atom* neighbor = (*it1);
-                stringstream ss1;
-                ss1 << neighbor->GetId();
-                stringstream first_order_interaction;
-                stringstream reverse_first_order_interaction;
-                first_order_interaction << ss.str() << "-" << ss1.str();
-                reverse_first_order_interaction << ss1.str() << "-" << ss.str();
-                if(find(excluded_atom_list.begin(), excluded_atom_list.end(), first_order_interaction.str()) == excluded_atom_list.end() &&
-                        find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_first_order_interaction.str()) == excluded_atom_list.end())
+                int neighbor_of_neighbor_index = neighbors.at(j);
+                if(neighbor_of_neighbor_index != atom_index)
                 {
-                    excluded_atom_list.push_back(first_order_interaction.str());
-                    excluded_atom_list_map[atom->GetId()].push_back(neighbor->GetId());
-                }
-                AtomNode* neighbor_node = neighbor->GetNode();
-                AtomVector neighbor_of_neighbors = neighbor_node->GetNodeNeighbors();
-                for(AtomVector::iterator it2 = neighbor_of_neighbors.begin(); it2 != neighbor_of_neighbors.end(); it2++)
-                {
-                    Atom* neighbor_of_neighbor = (*it2);
-                    stringstream ss2;
-                    ss2 << neighbor_of_neighbor->GetId();
-                    if(ss.str().compare(ss2.str()) != 0)
+                    if(excluded_atom_pairs.insert(make_pair(min(atom_index, neighbor_of_neighbor_index), max(atom_index, neighbor_of_neighbor_index))).second)
+                        number_of_excluded_atoms_of_atom++;
+                    for(int k = offsets.at(neighbor_of_neighbor_index); k < offsets.at(neighbor_of_neighbor_index + 1); k++)
                     {
-                        stringstream second_order_interaction;
-                        stringstream reverse_second_order_interaction;
-                        second_order_interaction << ss.str() << "-" << ss2.str();
-                        reverse_second_order_interaction << ss2.str() << "-" << ss.str();
-                        if(find(excluded_atom_list.begin(), excluded_atom_list.end(), second_order_interaction.str()) == excluded_atom_list.end() &&
-                                find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_second_order_interaction.str()) == excluded_atom_list.end())
-                        {
-                            excluded_atom_list.push_back(second_order_interaction.str());
-                            excluded_atom_list_map[atom->GetId()].push_back(neighbor_of_neighbor->GetId());
-                        }
-                        AtomNode* neighbor_of_neighbor_node = neighbor_of_neighbor->GetNode();
-                        AtomVector neighbor_of_neighbor_of_neighbors = neighbor_of_neighbor_node->GetNodeNeighbors();
-                        for(AtomVector::iterator it3 = neighbor_of_neighbor_of_neighbors.begin(); it3 != neighbor_of_neighbor_of_neighbors.end(); it3++)
-                        {
-                            Atom* neighbor_of_neighbor_of_neighbor = (*it3);
-                            stringstream ss3;
-                            ss3 << neighbor_of_neighbor_of_neighbor->GetId();
-                            if(ss1.str().compare(ss3.str()) != 0)
-                            {
-                                stringstream third_order_interaction;
-                                stringstream reverse_third_order_interaction;
-                                third_order_interaction << ss.str() << "-" << ss3.str();
-                                reverse_third_order_interaction << ss3.str() << "-" << ss.str();
-                                if(find(excluded_atom_list.begin(), excluded_atom_list.end(), third_order_interaction.str()) == excluded_atom_list.end() &&
-                                        find(excluded_atom_list.begin(), excluded_atom_list.end(), reverse_third_order_interaction.str()) == excluded_atom_list.end())
-                                {
-                                    excluded_atom_list.push_back(third_order_interaction.str());
-                                    excluded_atom_list_map[atom->GetId()].push_back(neighbor_of_neighbor_of_neighbor->GetId());
-                                }
-                            }
-                        }
+                        int neighbor_of_neighbor_of_neighbor_index = neighbors.at(k);
+                        if(neighbor_of_neighbor_of_neighbor_index != neighbor_index &&
+                                excluded_atom_pairs.insert(make_pair(min(atom_index, neighbor_of_neighbor_of_neighbor_index),
+                                                                     max(atom_index, neighbor_of_neighbor_of_neighbor_index))).second)
+                            number_of_excluded_atoms_of_atom++;
                     }
                 }
             }
         }
+        number_of_excluded_atoms_of_atom == 0 ? number_of_excluded_atoms++ : number_of_excluded_atoms += number_of_excluded_atoms_of_atom;
     }
-    int number_of_excluded_atoms = 0;
-    for(map<string, vector<string> >::iterator it = excluded_atom_list_map.begin(); it != excluded_atom_list_map.end(); it++)
-        (*it).second.size() == 0 ? number_of_excluded_atoms++ : number_of_excluded_atoms += (*it).second.size();
     return number_of_excluded_atoms;
 }
 
@@ -2308,5 +2408,34 @@ int Assembly::CountMaxNumberOfAtomsInLargestResidue()
         if(max <= atoms.size())
             max = atoms.size();
     }
+    for(int i = 0; i < solvent_block_.GetNumberOfResidues(); i++)
+    {
+        if(max <= solvent_block_.GetNumberOfMoleculesOfResidue(i) * solvent_block_.GetNumberOfSites())
+            max = solvent_block_.GetNumberOfMoleculesOfResidue(i) * solvent_block_.GetNumberOfSites();
+    }
     return max;
 }
+
+int Assembly::CountNumberInSolventBlock(int (Assembly::*count_function)(string), string parameter_file_path)
+{
+    if(solvent_block_.GetNumberOfMolecules() == 0)
+        return 0;
+    /// All molecules of the block share the template, so they all have the count of the first one
+    Assembly solvent_molecule;
+    solvent_molecule.AddResidue(solvent_block_.ExpandMolecule(0, &solvent_molecule, id_));
+    return solvent_block_.GetNumberOfMolecules() * (solvent_molecule.*count_function)(parameter_file_path);
+}
+
+Assembly::AtomVector Assembly::GetAllAtomsOfAssemblyWithSolventMolecule(Assembly* solvent_molecule)
+{
+    this->UpdateViews();
+    AtomVector atoms = all_atoms_;
+    if(solvent_block_.GetNumberOfMolecules() > 0)
+    {
+        Residue* residue = solvent_block_.ExpandMolecule(0, solvent_molecule, id_);
+        solvent_molecule->AddResidue(residue);
+        AtomVector molecule_atoms = residue->GetAtoms();
+        atoms.insert(atoms.end(), molecule_atoms.begin(), molecule_atoms.end());
+    }
+    return atoms;
+}
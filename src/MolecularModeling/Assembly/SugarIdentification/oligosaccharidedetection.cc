@@ -116,6 +116,8 @@ void Assembly::DetectShape(AtomVector cycle, Monosaccharide* mono)
     ///Write a new PDB file from the new assembly
     PdbFile* pdb = detect_shape_assembly->BuildPdbFileStructureFromAssembly();
     pdb->Write("temp_gmml_pdb.pdb");
+    ///The assembly only refers to the residue of the ring, it does not own it
+    delete detect_shape_assembly;
 
     ///Converting the written PDB file to fomrat readable by detect_shape program
     string line = "";
@@ -176,132 +178,98 @@ void Assembly::DetectShape(AtomVector cycle, Monosaccharide* mono)
     remove("ring_conformations.txt");
 }
 
-vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files, bool glyprobity_report, bool populate_ontology)
+///The workers below share the rings of ExtractSugars. Each of them only reads the atoms of the assembly and writes to the monosaccharides and report
+///slots of its own rings. Nothing that writes state shared between the rings may be called from them: no notes, no logging and no Atom/Residue
+///GetId of an id that has not been formatted yet. ExtractSugars formats all ids before it starts the workers.
+void* BuildChemicalCodesThread(void* args)
 {
-    ResidueNameMap dataset_residue_names = GetAllResidueNamesFromMultipleLibFilesMap(amino_lib_files);
-
-    ///CYCLE DETECTION
-    CycleMap cycles = DetectCyclesByExhaustiveRingPerception();
-
-    //    CycleMap cycles = DetectCyclesByDFS();
-
-    ///PRINTING ALL DETECTED CYCLES
-    cout << endl << "All detected cycles" << endl;
-    for(CycleMap::iterator it = cycles.begin(); it != cycles.end(); it++)
-    {
-        string cycle_atoms_str = (*it).first;
-        cout << cycle_atoms_str << endl;
-    }
-
-    ///FILTERING OUT FUSED CYCLES. aka Cycles that are sharing an edge
-    RemoveFusedCycles(cycles);
-
-    ///FILTERING OUT OXYGENLESS CYCLES
-    FilterAllCarbonCycles(cycles);
-
-    ///ANOMERIC CARBON DETECTION and SORTING
-    cout << endl << "Cycles after discarding rings that are all-carbon" << endl;
-    vector<string> anomeric_carbons_status = vector<string>();
-    vector<Note*> anomeric_notes = vector<Note*>();
-    CycleMap sorted_cycles = CycleMap();
-    for(CycleMap::iterator it = cycles.begin(); it != cycles.end(); it++)
-    {
-        string cycle_atoms_str = (*it).first;
-        AtomVector cycle_atoms = (*it).second;
-
-        cout << cycle_atoms_str << endl; ///e.g. C1_3810_NAG_A_1521_?_?_1-O5_3821_NAG_A_1521_?_?_1-C5_3814_NAG_A_1521_?_?_1-C4_3813_NAG_A_1521_?_?_1-C3_3812_NAG_A_1521_?_?_1-C2_3811_NAG_A_1521_?_?_1
-
-        Note* anomeric_note = new Note();
-        Atom* anomeric = FindAnomericCarbon(anomeric_note, anomeric_carbons_status, cycle_atoms, cycle_atoms_str);
-        anomeric_notes.push_back(anomeric_note);
-        if(anomeric != NULL) ///Sorting the cycle atoms and adding it to the sorted_cycles map if an anomeric carbon identified, otherwise the structure can't be a sugar
-        {
-            AtomVector sorted_cycle_atoms = AtomVector();
-            stringstream sorted_cycle_stream;
-            sorted_cycle_atoms = SortCycle(cycle_atoms, anomeric, sorted_cycle_stream);
-            sorted_cycles[sorted_cycle_stream.str()] = sorted_cycle_atoms;
-        }
-    }
-    cycles = sorted_cycles;
+    MonosaccharideThreadArgument* arg = (MonosaccharideThreadArgument*)args;
+    Assembly* assembly = arg->assembly;
+    vector<Monosaccharide*>& monos = *(arg->monos);
+    int size = monos.size();
+    int begin_index = (int)(((long long)arg->thread_index * size) / arg->number_of_threads);
+    int end_index = (int)(((long long)(arg->thread_index + 1) * size) / arg->number_of_threads);
 
-    ///CREATING MONOSACCHARIDE STRUCTURE. Ring atoms, side atoms, chemical code (Glycode), modifications/derivatives, names
-    cout << endl << "Detailed information of sorted cycles after discarding fused or oxygenless rings: " << endl;
-    vector<Monosaccharide*> monos = vector<Monosaccharide*>();
-    int mono_id = 0;
-    for(CycleMap::iterator it = cycles.begin(); it != cycles.end(); it++)
+    for(int index = begin_index; index < end_index; index++)
     {
-        string cycle_atoms_str = (*it).first;
-        AtomVector cycle = (*it).second;
-
-        Monosaccharide* mono = new Monosaccharide();
-        int status_index = distance(cycles.begin(), it);
-        mono->anomeric_status_ = anomeric_carbons_status.at(status_index);
-
-        ///ASSIGNING RING ATOMS TO MONOSACCHARIDE OBJECT
-        cout << "Ring atoms: " << cycle_atoms_str << endl;
-        mono->cycle_atoms_str_ = cycle_atoms_str;
-        mono->cycle_atoms_ = cycle;
+        Monosaccharide* mono = monos.at(index);
+        stringstream ring_report;
+        ring_report << "Ring atoms: " << mono->cycle_atoms_str_ << endl;
 
         ///ASSIGNING SIDE ATOMS (EXCOCYCLIC ATOMS) TO MONOSACCHARIDE OBJECT
-        vector<string> orientations = GetSideGroupOrientations(mono, cycle_atoms_str);
+        vector<string> orientations = assembly->GetSideGroupOrientations(mono, mono->cycle_atoms_str_);
 
         ///PRINTING ASSIGNED SIDE ATOMS
-        cout << "Side group atoms: " << endl;
-        for(vector<AtomVector>::iterator it1 = mono->side_atoms_.begin(); it1 != mono->side_atoms_.end(); it1++)
+        ring_report << "Side group atoms: " << endl;
+        for(vector<Assembly::AtomVector>::iterator it1 = mono->side_atoms_.begin(); it1 != mono->side_atoms_.end(); it1++)
         {
-            AtomVector sides = (*it1);
+            Assembly::AtomVector sides = (*it1);
             if(it1 == mono->side_atoms_.begin())///side atoms of anomeric carbon
             {
                 if(sides.at(0) != NULL && sides.at(1) != NULL)
-                    cout << "[1] -> " << sides.at(0)->GetId() << ", " << sides.at(1)->GetId() << endl;
+                    ring_report << "[1] -> " << sides.at(0)->GetId() << ", " << sides.at(1)->GetId() << endl;
                 else if(sides.at(1) != NULL)
-                    cout << "[1] -> " << sides.at(1)->GetId() << endl;
+                    ring_report << "[1] -> " << sides.at(1)->GetId() << endl;
                 else if(sides.at(0) != NULL)
-                    cout << "[1] -> " << sides.at(0)->GetId() << endl;
+                    ring_report << "[1] -> " << sides.at(0)->GetId() << endl;
             }
             else if(it1 == mono->side_atoms_.end() - 1)//side atoms of last carbon of the ring
             {
-                cout << "[" << mono->cycle_atoms_.size() - 1 << "] -> ";
+                ring_report << "[" << mono->cycle_atoms_.size() - 1 << "] -> ";
                 if(sides.at(0) != NULL)
-                    cout << sides.at(0)->GetId() << endl;
+                    ring_report << sides.at(0)->GetId() << endl;
             }
             else if(sides.at(1) != NULL)
             {
                 int cycle_atom_index = distance(mono->side_atoms_.begin(), it1);
-                cout << "[" << cycle_atom_index + 1 << "] -> " << sides.at(1)->GetId() << endl;
+                ring_report << "[" << cycle_atom_index + 1 << "] -> " << sides.at(1)->GetId() << endl;
             }
         }
 
         ///PRINTING ANOMERIC STATUS
-        cout << mono->anomeric_status_ << mono->cycle_atoms_.at(0)->GetId() << endl;
+        ring_report << mono->anomeric_status_ << mono->cycle_atoms_.at(0)->GetId() << endl;
 
         ///CREATING CHEMICAL CODE (Glycode) OBJECT
-        ChemicalCode* code = BuildChemicalCode(orientations);
+        ChemicalCode* code = assembly->BuildChemicalCode(orientations);
+        ring_report << endl << "Stereo chemistry chemical code:"  << endl;
         if(code != NULL)
         {
             mono->chemical_code_ = code;
+            code->Print(ring_report);
         }
-        cout << endl << "Stereo chemistry chemical code:"  << endl;
-        code->Print(cout);
-        cout << endl;
+        ring_report << endl;
+        arg->ring_reports->at(index) = ring_report.str();
+    }
+    pthread_exit(NULL);
+}
 
-        ///DETECT SHAPE USING BFMP EXTERNAL PROGRAM. Currently, the program does not work for furanoses
-        if(cycle.size() > 5)
-        {
-            DetectShape(cycle, mono);
-            if(mono->bfmp_ring_conformation_.compare("") != 0)
-                cout << "BFMP ring conformation: " << mono->bfmp_ring_conformation_ << endl << endl; ///Part of Glyprobity report
-        }
+void* CharacterizeMonosaccharidesThread(void* args)
+{
+    MonosaccharideThreadArgument* arg = (MonosaccharideThreadArgument*)args;
+    Assembly* assembly = arg->assembly;
+    vector<Monosaccharide*>& monos = *(arg->monos);
+    int size = monos.size();
+    int begin_index = (int)(((long long)arg->thread_index * size) / arg->number_of_threads);
+    int end_index = (int)(((long long)(arg->thread_index + 1) * size) / arg->number_of_threads);
+
+    for(int index = begin_index; index < end_index; index++)
+    {
+        Monosaccharide* mono = monos.at(index);
+        ChemicalCode* code = mono->chemical_code_;
 
         ///CHECKING FOR +2 and +3 SIDE CARBONS
-        AtomVector plus_sides = ExtractAdditionalSideAtoms(mono);
+        Assembly::AtomVector plus_sides = assembly->ExtractAdditionalSideAtoms(mono);
+        arg->plus_sides->at(index) = plus_sides;
 
         ///FINDING CHEMICAL CODE IN NAME LOOKUP TABLE
         string code_str = code->toString();
         mono->sugar_name_ = SugarStereoChemistryNameLookup(code_str);
 
         ///DERIVATIVE/MODIFICATION PATTERN EXTRACTION
-        ExtractDerivatives(mono);
+        assembly->ExtractDerivatives(mono);
+
+        ///REPORTING DERIVATIVE/MODIFICATION PATTERNS. The report is taken before UpdateComplexSugarChemicalCode looks up (and so adds) empty patterns
+        stringstream derivative_report;
         bool minus_one = false;
         if(mono->derivatives_map_.find("-1") != mono->derivatives_map_.end())
             minus_one = true;
@@ -312,32 +280,28 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files,
             if(minus_one)
             {
                 if(key.compare("-1") == 0)
-                    cout << "Carbon at position 1 is attached to " << value << endl;
+                    derivative_report << "Carbon at position 1 is attached to " << value << endl;
                 else if(key.compare("a") == 0)
-                    cout << "Carbon at position 2 is attached to " << value << endl;
+                    derivative_report << "Carbon at position 2 is attached to " << value << endl;
                 else if(key.compare("+1") == 0 || key.compare("+2") == 0 || key.compare("+3") == 0)
-                    cout << "Carbon at position " << mono->cycle_atoms_.size() - 1 + ConvertString<int>(key) + 1 << " is attached to " << value << endl;
+                    derivative_report << "Carbon at position " << mono->cycle_atoms_.size() - 1 + ConvertString<int>(key) + 1 << " is attached to " << value << endl;
                 else
-                    cout << "Carbon at position " << (gmml::ConvertString<int>(key) + 1) << " is attached to " << value << endl;
+                    derivative_report << "Carbon at position " << (gmml::ConvertString<int>(key) + 1) << " is attached to " << value << endl;
             }
             else
             {
                 if(key.compare("a") == 0)
-                    cout << "Carbon at position 1 is attached to " << value << endl;
+                    derivative_report << "Carbon at position 1 is attached to " << value << endl;
                 else if(key.compare("+1") == 0 || key.compare("+2") == 0 || key.compare("+3") == 0)
-                    cout << "Carbon at position " << mono->cycle_atoms_.size() - 1 + ConvertString<int>(key) << " is attached to " << value << endl;
+                    derivative_report << "Carbon at position " << mono->cycle_atoms_.size() - 1 + ConvertString<int>(key) << " is attached to " << value << endl;
                 else
-                    cout << "Carbon at position " << key << " is attached to " << value << endl;
+                    derivative_report << "Carbon at position " << key << " is attached to " << value << endl;
             }
         }
+        arg->derivative_reports->at(index) = derivative_report.str();
 
-        ///GENERATING COMPLETE NAME
-        if(plus_sides.size() <= 1)
-        {
-            ///COMPLETE NAME GENERATION BASED ON DERIVATIVE MAP
-            GenerateCompleteSugarName(mono);
-        }
-        else///UPDATING SIDE ATOMS
+        ///UPDATING SIDE ATOMS
+        if(plus_sides.size() > 1)
         {
             vector<string>::iterator index_it;
             if((index_it = find(mono->chemical_code_->right_up_.begin(), mono->chemical_code_->right_up_.end(), "+1")) != mono->chemical_code_->right_up_.end()){}
@@ -345,27 +309,28 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files,
 
             ///CHECKING R or S
             stringstream plus_one;
-            string orientation = CalculateRSOrientations(mono->cycle_atoms_.at(mono->cycle_atoms_.size() - 2), plus_sides.at(0), plus_sides.at(1));
+            string orientation = assembly->CalculateRSOrientations(mono->cycle_atoms_.at(mono->cycle_atoms_.size() - 2), plus_sides.at(0), plus_sides.at(1));
             plus_one << "+1" << orientation;
             (*index_it) = plus_one.str();
             if(plus_sides.size() == 3)
             {
                 stringstream plus_two;
-                orientation = CalculateRSOrientations(plus_sides.at(0), plus_sides.at(1), plus_sides.at(2));
+                orientation = assembly->CalculateRSOrientations(plus_sides.at(0), plus_sides.at(1), plus_sides.at(2));
                 plus_two << "+2" << orientation;
                 mono->chemical_code_->right_up_.push_back(plus_two.str());
                 mono->chemical_code_->right_up_.push_back("+3");
             }
 
             ///UPDATING CHEMICAL CODE
-            UpdateComplexSugarChemicalCode(mono);
+            assembly->UpdateComplexSugarChemicalCode(mono);
 
             ///PRINTING SIDE ATOMS OF COMPLEX STRUCTURE
-            cout << "Complex structure side group atoms: " << endl;
-            for(vector<AtomVector>::iterator it1 = mono->side_atoms_.begin(); it1 != mono->side_atoms_.end(); it1++)
+            stringstream complex_report;
+            complex_report << "Complex structure side group atoms: " << endl;
+            for(vector<Assembly::AtomVector>::iterator it1 = mono->side_atoms_.begin(); it1 != mono->side_atoms_.end(); it1++)
             {
                 stringstream complex_structure_side;
-                AtomVector sides = (*it1);
+                Assembly::AtomVector sides = (*it1);
                 if(it1 == mono->side_atoms_.begin())///side atoms of anomeric carbon
                 {
                     if(sides.at(0) != NULL && sides.at(1) != NULL)
@@ -378,9 +343,9 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files,
                 else if(it1 == mono->side_atoms_.end() - 1)///side atoms of last carbon of the ring
                 {
                     complex_structure_side << "[" << mono->cycle_atoms_.size() - 1 << "]";
-                    for(int i = 0; i < plus_sides.size() ; i++)
+                    for(unsigned int i = 0; i < plus_sides.size() ; i++)
                         complex_structure_side << " -> " << sides.at(i)->GetId();
-                    cout << complex_structure_side.str() << endl;
+                    complex_report << complex_structure_side.str() << endl;
                 }
                 else if(sides.at(1) != NULL)
                 {
@@ -390,11 +355,160 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files,
             }
 
             ///PRINTING COMPLEX SUGAR CHEMICAL CODE
-            cout << endl << "Complex sugar chemical code:" << endl;
-            mono->chemical_code_->Print(cout);
+            complex_report << endl << "Complex sugar chemical code:" << endl;
+            mono->chemical_code_->Print(complex_report);
+            arg->complex_reports->at(index) = complex_report.str();
 
             ///FINDING COMPLEX CHEMICAL CODE IN COMPLEX SUGAR NAME LOOKUP TABLE
             mono->sugar_name_ = ComplexSugarNameLookup(mono->chemical_code_->toString());
+        }
+    }
+    pthread_exit(NULL);
+}
+
+vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files, bool glyprobity_report, bool populate_ontology, int number_of_threads)
+{
+    ResidueNameMap dataset_residue_names = GetAllResidueNamesFromMultipleLibFilesMap(amino_lib_files);
+
+    ///CYCLE DETECTION
+    ///Only furanose and pyranose rings with a ring oxygen are of interest, so larger rings and ring systems without oxygen are not searched
+    vector<string> ring_elements = vector<string>(1, "O");
+    CycleMap cycles = DetectCyclesByExhaustiveRingPerception(MAXIMUM_SUGAR_RING_SIZE, ring_elements);
+
+    //    CycleMap cycles = DetectCyclesByDFS();
+
+    ///PRINTING ALL DETECTED CYCLES
+    cout << endl << "All detected cycles" << endl;
+    for(CycleMap::iterator it = cycles.begin(); it != cycles.end(); it++)
+    {
+        string cycle_atoms_str = (*it).first;
+        cout << cycle_atoms_str << endl;
+    }
+
+    ///FILTERING OUT FUSED CYCLES. aka Cycles that are sharing an edge
+    RemoveFusedCycles(cycles);
+
+    ///FILTERING OUT OXYGENLESS CYCLES
+    FilterAllCarbonCycles(cycles);
+
+    ///ANOMERIC CARBON DETECTION and SORTING
+    cout << endl << "Cycles after discarding rings that are all-carbon" << endl;
+    vector<string> anomeric_carbons_status = vector<string>();
+    vector<Note*> anomeric_notes = vector<Note*>();
+    CycleMap sorted_cycles = CycleMap();
+    for(CycleMap::iterator it = cycles.begin(); it != cycles.end(); it++)
+    {
+        string cycle_atoms_str = (*it).first;
+        AtomVector cycle_atoms = (*it).second;
+
+        cout << cycle_atoms_str << endl; ///e.g. C1_3810_NAG_A_1521_?_?_1-O5_3821_NAG_A_1521_?_?_1-C5_3814_NAG_A_1521_?_?_1-C4_3813_NAG_A_1521_?_?_1-C3_3812_NAG_A_1521_?_?_1-C2_3811_NAG_A_1521_?_?_1
+
+        Note* anomeric_note = new Note();
+        Atom* anomeric = FindAnomericCarbon(anomeric_note, anomeric_carbons_status, cycle_atoms, cycle_atoms_str);
+        anomeric_notes.push_back(anomeric_note);
+        if(anomeric != NULL) ///Sorting the cycle atoms and adding it to the sorted_cycles map if an anomeric carbon identified, otherwise the structure can't be a sugar
+        {
+            AtomVector sorted_cycle_atoms = AtomVector();
+            stringstream sorted_cycle_stream;
+            sorted_cycle_atoms = SortCycle(cycle_atoms, anomeric, sorted_cycle_stream);
+            sorted_cycles[sorted_cycle_stream.str()] = sorted_cycle_atoms;
+        }
+    }
+    cycles = sorted_cycles;
+
+    ///CREATING MONOSACCHARIDE STRUCTURE. Ring atoms, side atoms, chemical code (Glycode), modifications/derivatives, names
+    cout << endl << "Detailed information of sorted cycles after discarding fused or oxygenless rings: " << endl;
+    vector<Monosaccharide*> monos = vector<Monosaccharide*>();
+    for(CycleMap::iterator it = cycles.begin(); it != cycles.end(); it++)
+    {
+        Monosaccharide* mono = new Monosaccharide();
+        int status_index = distance(cycles.begin(), it);
+        mono->anomeric_status_ = anomeric_carbons_status.at(status_index);
+
+        ///ASSIGNING RING ATOMS TO MONOSACCHARIDE OBJECT
+        mono->cycle_atoms_str_ = (*it).first;
+        mono->cycle_atoms_ = (*it).second;
+        monos.push_back(mono);
+    }
+
+    ///ANALYZING THE RINGS IN PARALLEL. Side atoms, chemical code, +2 and +3 side carbons, name lookup and derivatives of each ring only depend on the ring
+    ///The views of the assembly are built here, the workers must not rebuild them
+    this->GetAllAtomsOfAssemblyView();
+    vector<string> ring_reports = vector<string>(monos.size(), "");
+    vector<string> shape_reports = vector<string>(monos.size(), "");
+    vector<AtomVector> plus_sides_of_monos = vector<AtomVector>(monos.size(), AtomVector());
+    vector<string> derivative_reports = vector<string>(monos.size(), "");
+    vector<string> complex_reports = vector<string>(monos.size(), "");
+    if(number_of_threads < 1)
+        number_of_threads = 1;
+    pthread_t threads[number_of_threads];
+    MonosaccharideThreadArgument arg[number_of_threads];
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        arg[i] = MonosaccharideThreadArgument(i, number_of_threads, this, &monos, &ring_reports, &plus_sides_of_monos, &derivative_reports, &complex_reports);
+        pthread_create(&threads[i], NULL, &BuildChemicalCodesThread, &arg[i]);
+    }
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    ///DETECT SHAPE USING BFMP EXTERNAL PROGRAM. Currently, the program does not work for furanoses
+    ///The program runs on fixed temporary files and DetectShape renames the ring atoms, which the rest of the analysis sees, so it runs
+    ///here between the two parallel steps as it did between them for each ring. Its messages are kept for the report of the ring
+    for(vector<Monosaccharide*>::iterator it = monos.begin(); it != monos.end(); it++)
+    {
+        Monosaccharide* mono = (*it);
+        if(mono->cycle_atoms_.size() > 5)
+        {
+            stringstream shape_report;
+            streambuf* console = cout.rdbuf(shape_report.rdbuf());
+            DetectShape(mono->cycle_atoms_, mono);
+            cout.rdbuf(console);
+            if(mono->bfmp_ring_conformation_.compare("") != 0)
+                shape_report << "BFMP ring conformation: " << mono->bfmp_ring_conformation_ << endl << endl; ///Part of Glyprobity report
+            shape_reports.at(distance(monos.begin(), it)) = shape_report.str();
+        }
+    }
+    ///DetectShape replaces the atom list of the ring residues, so the views of the assembly are rebuilt here and not by a worker
+    this->UpdateViews();
+
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, &CharacterizeMonosaccharidesThread, &arg[i]);
+    }
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    ///MERGING THE RESULTS IN THE ORDER OF THE RINGS. Steps that print, add notes or run external programs are done here
+    int mono_id = 0;
+    for(vector<Monosaccharide*>::iterator it = monos.begin(); it != monos.end(); it++)
+    {
+        Monosaccharide* mono = (*it);
+        int status_index = distance(monos.begin(), it);
+        AtomVector plus_sides = plus_sides_of_monos.at(status_index);
+
+        ///PRINTING RING ATOMS, ASSIGNED SIDE ATOMS, ANOMERIC STATUS AND CHEMICAL CODE
+        cout << ring_reports.at(status_index);
+
+        ///PRINTING THE BFMP RING CONFORMATION
+        cout << shape_reports.at(status_index);
+
+        ///PRINTING DERIVATIVE/MODIFICATION PATTERNS
+        cout << derivative_reports.at(status_index);
+
+        ///GENERATING COMPLETE NAME
+        if(plus_sides.size() <= 1)
+        {
+            ///COMPLETE NAME GENERATION BASED ON DERIVATIVE MAP
+            GenerateCompleteSugarName(mono);
+        }
+        else
+        {
+            ///PRINTING SIDE ATOMS AND CHEMICAL CODE OF COMPLEX STRUCTURE
+            cout << complex_reports.at(status_index);
 
             if(plus_sides.size() == 2)
             {
@@ -503,7 +617,6 @@ vector<Oligosaccharide*> Assembly::ExtractSugars(vector<string> amino_lib_files,
 
         mono_id++;
         mono->mono_id = mono_id;
-        monos.push_back(mono);
     }
 
     ///CREATING TREE-LIKE STRUCTURE OF OLIGOSACCHARIDE
@@ -638,7 +751,7 @@ bool Assembly::MatchDisaccharide(queue<Oligosaccharide*> oligo_queue, double &ph
 
                         ///Preparing atoms for phi and psi angle
                         Atom* phi_atom1 = mono1_ring_atoms.at(mono1_ring_atoms.size() - 1); ///O5 or N5
-                        Atom* phi_atom2 = new Atom(); ///C1
+                        Atom* phi_atom2 = NULL; ///C1
                         phi_atom2 = corresponding_first_oligo->root_->cycle_atoms_.at(0); ///anomeric carbon
                         Atom* phi_atom3 = NULL;
                         AtomVector phi_atom2_neighbors = phi_atom2->GetNode()->GetNodeNeighbors();
@@ -703,7 +816,8 @@ bool Assembly::MatchDisaccharide(queue<Oligosaccharide*> oligo_queue, double &ph
 void Assembly::ExtractRingAtomsInformation()
 {
     ///CYCLE DETECTION
-    CycleMap cycles = DetectCyclesByExhaustiveRingPerception();
+    vector<string> ring_elements = vector<string>(1, "O");
+    CycleMap cycles = DetectCyclesByExhaustiveRingPerception(MAXIMUM_SUGAR_RING_SIZE, ring_elements);
     ///FILTERING OUT FUSED CYCLES
     RemoveFusedCycles(cycles);
     ///FILTERING OUT OXYGENLESS CYCLES
@@ -748,29 +862,30 @@ void Assembly::ExtractRingAtomsInformation()
         for(AtomVector::iterator it1 = cycle.begin(); it1 != cycle.end(); it1++)
         {
             Atom* atom = (*it1);
-            vector<string> atom_tokens = Split(atom->GetId(), "_");
+            string atom_name = SymbolTable::GetString(atom->GetIdentity().name_);
             if(it1 == cycle.end() - 1)
-                ring_atom_names << atom_tokens.at(0);
+                ring_atom_names << atom_name;
             else
-                ring_atom_names << atom_tokens.at(0) << ",";
+                ring_atom_names << atom_name << ",";
         }
         cout << ring_atom_names.str() << endl;
         gmml::log(__LINE__, __FILE__,  gmml::INF, ring_atom_names.str());
     }
 }
 
-void Assembly::ReturnCycleAtoms(string src_id, Atom *current_atom, AtomIdAtomMap &atom_parent_map, AtomVector &cycle, stringstream &cycle_stream)
+void Assembly::ReturnCycleAtoms(int src_index, int current_index, vector<int>& atom_parents, const AtomVector& atoms, AtomVector& cycle,
+                                stringstream& cycle_stream)
 {
-    cycle.push_back(current_atom);
-    cycle_stream << current_atom->GetId() << "-";
-    Atom* parent = atom_parent_map[current_atom->GetId()];
-    if(src_id.compare(parent->GetId()) == 0)
+    int atom_index = current_index;
+    while(atom_index != src_index)
     {
-        cycle.push_back(parent);
-        cycle_stream << parent->GetId();
-        return;
+        Atom* current_atom = atoms.at(atom_index);
+        cycle.push_back(current_atom);
+        cycle_stream << current_atom->GetId() << "-";
+        atom_index = atom_parents.at(atom_index);
     }
-    ReturnCycleAtoms(src_id, parent, atom_parent_map, cycle, cycle_stream);
+    cycle.push_back(atoms.at(src_index));
+    cycle_stream << atoms.at(src_index)->GetId();
 }
 
 void Assembly::FilterAllCarbonCycles(CycleMap &cycles)
@@ -822,8 +937,8 @@ void Assembly::RemoveFusedCycles(CycleMap &cycles)
                 {
                     stringstream mutual_edge;
                     stringstream mutual_edge_reverse;
-                    Atom* a1 = new Atom();
-                    Atom* a2 = new Atom();
+                    Atom* a1 = NULL;
+                    Atom* a2 = NULL;
                     if(i == cycle_i_atoms.size() - 1)
                     {
                         a1 = cycle_i_atoms.at(i);
@@ -860,7 +975,7 @@ void Assembly::RemoveFusedCycles(CycleMap &cycles)
 
 Atom* Assembly::FindAnomericCarbon(Note* anomeric_note, vector<string>& anomeric_carbons_status, AtomVector cycle, string cycle_atoms_str)
 {
-    Atom* anomeric_carbon = new Atom();
+    Atom* anomeric_carbon = NULL;
     for(AtomVector::iterator it = cycle.begin(); it != cycle.end(); it++)
     {
         Atom* cycle_atom = (*it);
@@ -1094,9 +1209,9 @@ vector<string> Assembly::GetSideGroupOrientations(Monosaccharide* mono, string c
         orientations.push_back("N");
         side_atoms.push_back(default_atom_vector);
         int index = distance(mono->cycle_atoms_.begin(), it);
-        Atom* prev_atom = new Atom();
+        Atom* prev_atom = NULL;
         Atom* current_atom = (*it);
-        Atom* next_atom = new Atom();
+        Atom* next_atom = NULL;
         if(index == 0)///if the current atom is the anomeric atom
             prev_atom = mono->cycle_atoms_.at(mono->cycle_atoms_.size() - 1); ///previous atom is the oxygen(last atom of the sorted cycle)
         else
@@ -2785,8 +2900,8 @@ vector<Oligosaccharide*> Assembly::ExtractOligosaccharides(vector<Monosaccharide
                         isRoot = true;
                         terminal_residue_name = CheckTerminals(anomeric_o, terminal_atoms);
                     }
-                    else if(o_neighbors.size() == 2 && (((o_neighbor_1->GetDescription().find("Het;") != string::npos) && (o_neighbor_2->GetDescription().find("Het;") == string::npos)) ||
-                                                        ((o_neighbor_2->GetDescription().find("Het;") != string::npos) && (o_neighbor_1->GetDescription().find("Het;") == string::npos))) )
+                    else if(o_neighbors.size() == 2 && (((o_neighbor_1->IsHeterogen()) && (!o_neighbor_2->IsHeterogen())) ||
+                                                        ((o_neighbor_2->IsHeterogen()) && (!o_neighbor_1->IsHeterogen()))) )
                     {
                         ///anomeric oxygen is attached to protein
                         isRoot = true;
@@ -2876,8 +2991,8 @@ vector<Oligosaccharide*> Assembly::ExtractOligosaccharides(vector<Monosaccharide
                             isRoot = true;
                             terminal_residue_name = CheckTerminals(anomeric_o, terminal_atoms);
                         }
-                        else if(o_neighbors.size() == 2 && (((o_neighbor_1->GetDescription().find("Het;") != string::npos) && (o_neighbor_2->GetDescription().find("Het;") == string::npos)) ||
-                                                            ((o_neighbor_2->GetDescription().find("Het;") != string::npos) && (o_neighbor_1->GetDescription().find("Het;") == string::npos))) )
+                        else if(o_neighbors.size() == 2 && (((o_neighbor_1->IsHeterogen()) && (!o_neighbor_2->IsHeterogen())) ||
+                                                            ((o_neighbor_2->IsHeterogen()) && (!o_neighbor_1->IsHeterogen()))) )
                         {
                             ///anomeric oxygen is attached to protein
                             isRoot = true;
@@ -3216,9 +3331,9 @@ string Assembly::CheckTerminals(Atom* target, AtomVector& terminal_atoms)
         else if(o_neighbors.size() == 2)
         {
             Atom* target_o_neighbor = NULL;
-            if(o_neighbors.at(0)->GetDescription().find("Het;") != string::npos && o_neighbors.at(1)->GetDescription().find("Het;") == string::npos)
+            if(o_neighbors.at(0)->IsHeterogen() && !o_neighbors.at(1)->IsHeterogen())
                 target_o_neighbor = o_neighbors.at(1);
-            else if(o_neighbors.at(0)->GetDescription().find("Het;") == string::npos && o_neighbors.at(1)->GetDescription().find("Het;") != string::npos)
+            else if(!o_neighbors.at(0)->IsHeterogen() && o_neighbors.at(1)->IsHeterogen())
                 target_o_neighbor = o_neighbors.at(0);
 
             if(target_o_neighbor != NULL)
@@ -85,341 +85,266 @@ using namespace CondensedSequenceSpace;
 //////////////////////////////////////////////////////////
 //                       FUNCTIONS                      //
 //////////////////////////////////////////////////////////
-Assembly::CycleMap Assembly::DetectCyclesByExhaustiveRingPerception()
+Assembly::CycleMap Assembly::DetectCyclesByExhaustiveRingPerception(int maximum_ring_size, vector<string> required_elements)
 {
     CycleMap cycles = CycleMap();
     AtomVector atoms = GetAllAtomsOfAssemblyExceptProteinWaterResiduesAtoms();
-    vector<string> path_graph_edges = vector<string> (); ///The list of edges in the molecular graph
-    vector<string> path_graph_labels = vector<string> (); ///The list of labels of edges in the molecular graph
-    vector<string> cycless = vector<string>();
+    vector<vector<int> > cycless = vector<vector<int> >();
 
-    ///Initializing the map
-    map<string, Atom*> IdAtom = map<string, Atom*>(); ///A map from atom ID to Assembly atom object
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        IdAtom[atom->GetId()] = atom;
-    }
     ///Pruning the graph (filter out atoms with less than 2 neighbors)
     PruneGraph(atoms);
 
-    ///Converting the molecular graph into a path graph
-    ConvertIntoPathGraph(path_graph_edges, path_graph_labels, atoms);
-    vector<string> reduced_path_graph_edges = path_graph_edges;
-    vector<string> reduced_path_graph_labels = path_graph_labels;
+    ///Pruning the ring systems that can not have a ring with the required elements
+    if(!required_elements.empty())
+        PruneRingSystems(atoms, required_elements);
+
+    ///Converting the molecular graph into a path graph, the nodes are the positions of the atoms in the pruned list
+    ///Without a bound all walks are kept, and only rings of up to six atoms are reported at the end
+    PathGraph path_graph = PathGraph(atoms.size(), maximum_ring_size);
+    ConvertIntoPathGraph(path_graph, atoms);
+
+    ///Atoms that have not been reduced yet, in the order of the pruned list
+    vector<int> remaining_atoms = vector<int>();
+    for(unsigned int i = 0; i < atoms.size(); i++)
+        remaining_atoms.push_back(i);
 
     int neighbor_counter = 2;
     ///Reducing the path graph
     ///Whenever a walk a-b-c is found it should be reduced to a-c and the label should be changed from [a-b], [b-c] to [a-b-c]
     /// the node with lowest number of edges to other nodes should be examined first
-    while(atoms.size() > 1 && path_graph_edges.size() != 0)
+    while(remaining_atoms.size() > 1 && path_graph.number_of_alive_edges != 0)
     {
-        AtomVector::iterator common_atom_it;
-        bool neighbor_counter_update = true;
-        for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
+        vector<int>::iterator common_atom_it = remaining_atoms.end();
+        for(vector<int>::iterator it = remaining_atoms.begin(); it != remaining_atoms.end(); it++)
         {
-            common_atom_it = it;
-            int counter = 0;
-            for(vector<string>::iterator it1 = path_graph_edges.begin(); it1 != path_graph_edges.end(); it1++)
+            if(path_graph.degrees.at(*it) <= neighbor_counter)
             {
-                string edge = (*it1);
-                if(edge.find((*common_atom_it)->GetId()) != string::npos)
-                    counter++;
-            }
-            if(counter <= neighbor_counter)
-            {
-                neighbor_counter_update = false;
+                common_atom_it = it;
                 break;
             }
         }
-        if(neighbor_counter_update)
+        if(common_atom_it == remaining_atoms.end())
         {
             neighbor_counter++;
             continue;
         }
 
-        ReducePathGraph(path_graph_edges, path_graph_labels, reduced_path_graph_edges, reduced_path_graph_labels, (*common_atom_it)->GetId(), cycless);
-
-        atoms.erase(common_atom_it);
+        ReducePathGraph(path_graph, (*common_atom_it), cycless);
 
-        path_graph_edges = reduced_path_graph_edges;
-        path_graph_labels = reduced_path_graph_labels;
+        remaining_atoms.erase(common_atom_it);
     }
 
-    for(vector<string>::iterator it = cycless.begin(); it != cycless.end(); it++)
+    for(vector<vector<int> >::iterator it = cycless.begin(); it != cycless.end(); it++)
     {
-        string cycle = (*it);
-        vector<string> splitted_cycle = Split(cycle, "-");
-        if(splitted_cycle.size() <= 7)
+        vector<int>& cycle = (*it);
+        ///The first atom of a cycle label is repeated at its end
+        if((maximum_ring_size == 0 && cycle.size() <= 7) || (maximum_ring_size != 0 && cycle.size() <= (unsigned int)maximum_ring_size + 1))
         {
             AtomVector atomvector = AtomVector();
             stringstream ss;
-            for(vector<string>::iterator it1 = splitted_cycle.begin(); it1 != splitted_cycle.end() - 1; it1++)
+            for(unsigned int i = 0; i < cycle.size() - 1; i++)
             {
-                string atom_str = (*it1);
-                map<string, Atom*>::iterator mit = IdAtom.find(atom_str);
-                atomvector.push_back((*mit).second);
-                if(it1 == splitted_cycle.end() - 2)
-                    ss << atom_str;
+                Atom* atom = atoms.at(cycle.at(i));
+                atomvector.push_back(atom);
+                if(i == cycle.size() - 2)
+                    ss << atom->GetId();
                 else
-                    ss << atom_str << "-";
+                    ss << atom->GetId() << "-";
             }
             cycles[ss.str()] = atomvector;
         }
     }
     return cycles;
+}
 
-    /*
-    CycleMap cycles = CycleMap();
-    AtomVector atoms = GetAllAtomsOfAssemblyExceptProteinWaterResiduesAtoms();
-    vector<string> path_graph_edges = vector<string> (); ///The list of edges in the molecular graph
-    vector<string> path_graph_labels = vector<string> (); ///The list of labels of edges in the molecular graph
-    vector<string> cycless = vector<string>();
-
-    ///Initializing the map
-    map<string, Atom*> IdAtom = map<string, Atom*>(); ///A map from atom ID to Assembly aTom object
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        IdAtom[atom->GetId()] = atom;
-    }
-
-    ///Pruning the graph (filter out atoms with less than 2 neighbors)
-    PruneGraph(atoms);
-
-    ///Converting the molecular graph into a path graph
-    ConvertIntoPathGraph(path_graph_edges, path_graph_labels, atoms);
-    vector<string> reduced_path_graph_edges = path_graph_edges;
-    vector<string> reduced_path_graph_labels = path_graph_labels;
+void Assembly::ReducePathGraph(PathGraph& path_graph, int common_atom, vector<vector<int> >& cycles)
+{
+    ///Edges of the common atom that are still in the graph, in the order they were created
+    vector<int>& incident_edges = path_graph.incident_edges.at(common_atom);
+    vector<int> common_atom_edges = vector<int>();
+    for(vector<int>::iterator it = incident_edges.begin(); it != incident_edges.end(); it++)
+        if(path_graph.alive.at(*it))
+            common_atom_edges.push_back(*it);
+    incident_edges = common_atom_edges;
+    if(common_atom_edges.size() < 2)
+        return;
 
-    ///Reducing the path graph
-    int neighbor_counter = 2;
-    ///Whenever a walk a-b-c is found it should be reduced to a-c and the lable should be changed from [a-b], [b-c] to [a-b-c]
-    /// the node with lowest number of connected edges should be examined first
-    while(atoms.size() > 1 && path_graph_edges.size() != 0)
+    for(unsigned int i = 0; i < common_atom_edges.size() - 1; i++)
     {
-        AtomVector::iterator common_atom_it;
-        bool neighbor_counter_update = true;
-        for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
+        pair<int, int> source_edge = path_graph.edges.at(common_atom_edges.at(i));
+        ///Copies, the labels may move when new edges are added
+        vector<int> source_label = path_graph.labels.at(common_atom_edges.at(i));
+        for(unsigned int j = i + 1; j < common_atom_edges.size(); j++)
         {
-            common_atom_it = it;
-            int counter = 0;
-            for(vector<string>::iterator it1 = path_graph_edges.begin(); it1 != path_graph_edges.end(); it1++)
+            pair<int, int> target_edge = path_graph.edges.at(common_atom_edges.at(j));
+            vector<int> target_label = path_graph.labels.at(common_atom_edges.at(j));
+            pair<int, int> new_edge;
+            vector<int> new_label = vector<int>();
+            if(source_edge.second == common_atom && target_edge.first == common_atom)///if there is a walk a_b_c in the graph (edges: a,b and b,c)
             {
-                string edge = (*it1);
-                if(edge.find((*common_atom_it)->GetId()) != string::npos) ///finding edges connected to the node
-                    counter++;
+                new_edge = make_pair(source_edge.first, target_edge.second);
+                new_label = source_label;
+                new_label.insert(new_label.end(), target_label.begin() + 1, target_label.end());
             }
-            if(counter <= neighbor_counter)///A node with lower number of edges has been found
+            else if(source_edge.second == common_atom && target_edge.second == common_atom)///if there is a walk a_b_c in the graph (edges: a,b and c,b)
             {
-                neighbor_counter_update = false;
-                break;
+                new_edge = make_pair(source_edge.first, target_edge.first);
+                new_label = source_label;
+                new_label.insert(new_label.end(), target_label.rbegin() + 1, target_label.rend());
+            }
+            else if(source_edge.first == common_atom && target_edge.first == common_atom)///if there is a walk a_b_c in the graph (edges: b,a and b,c)
+            {
+                new_edge = make_pair(source_edge.second, target_edge.second);
+                new_label.insert(new_label.end(), source_label.rbegin(), source_label.rend() - 1);
+                new_label.insert(new_label.end(), target_label.begin(), target_label.end());
+            }
+            else///if there is a walk a_b_c in the graph (edges: b,a and c,b)
+            {
+                new_edge = make_pair(source_edge.second, target_edge.first);
+                new_label.insert(new_label.end(), source_label.rbegin(), source_label.rend());
+                new_label.insert(new_label.end(), target_label.rbegin() + 1, target_label.rend());
             }
-        }
-        if(neighbor_counter_update)
-        {
-            neighbor_counter++;
-            continue;
-        }
-
-        ReducePathGraph(path_graph_edges, path_graph_labels, reduced_path_graph_edges, reduced_path_graph_labels, (*common_atom_it)->GetId(), cycless);
-
-        atoms.erase(common_atom_it);
-
-        path_graph_edges = reduced_path_graph_edges;
-    }
 
-    for(vector<string>::iterator it = cycless.begin(); it != cycless.end(); it++)
-    {
-        string cycle = (*it);
-        vector<string> splitted_cycle = Split(cycle, "-");
-        if(splitted_cycle.size() <= 7)
-        {
-            AtomVector atomvector = AtomVector();
-            stringstream ss;
-            for(vector<string>::iterator it1 = splitted_cycle.begin(); it1 != splitted_cycle.end() - 1; it1++)
+            ///in a bounded search only simple walks are kept, a walk that visits an atom twice can not be part of a ring
+            if(path_graph.maximum_ring_size != 0)
             {
-                string atom_str = (*it1);
-                map<string, Atom*>::iterator mit = IdAtom.find(atom_str);
-                atomvector.push_back((*mit).second);
-                if(it1 == splitted_cycle.end() - 2)
-                    ss << atom_str;
-                else
-                    ss << atom_str << "-";
+                bool simple_walk = true;
+                for(unsigned int k = 0; k < new_label.size() - 1 && simple_walk; k++)
+                    for(unsigned int l = k + 1; l < new_label.size() && simple_walk; l++)
+                        if(new_label.at(k) == new_label.at(l) && !(k == 0 && l == new_label.size() - 1))
+                            simple_walk = false;
+                if(!simple_walk)
+                    continue;
             }
-            cycles[ss.str()] = atomvector;
+            ///checking the new edge for cycle
+            if(new_edge.first == new_edge.second) ///edge is a,a
+            {
+                if(path_graph.maximum_ring_size == 0 || new_label.size() <= (unsigned int)path_graph.maximum_ring_size + 1)
+                    cycles.push_back(new_label);///label shows the atom involved in a cycle
+            }
+            ///a walk with more atoms than the largest ring can only be part of larger rings
+            else if(path_graph.maximum_ring_size != 0 && new_label.size() > (unsigned int)path_graph.maximum_ring_size)
+                continue;
+            ///adding the newly-formed edge (a,c) and label(a-b-c)
+            else if(path_graph.alive_labels.find(new_label) == path_graph.alive_labels.end())
+                path_graph.AddEdge(new_edge.first, new_edge.second, new_label);
         }
     }
-    return cycles; */
+
+    ///Every edge with the common atom b is part of a walk, so all of them are deleted
+    for(vector<int>::iterator it = common_atom_edges.begin(); it != common_atom_edges.end(); it++)
+        path_graph.RemoveEdge(*it);
+    path_graph.incident_edges.at(common_atom).clear();
 }
 
-void Assembly::ReducePathGraph(vector<string> path_graph_edges, vector<string> path_graph_labels, vector<string>& reduced_path_graph_edges,
-                               vector<string>& reduced_path_graph_labels, string common_atom, vector<string>& cycles)
+void Assembly::PruneGraph(AtomVector& all_atoms)
 {
-    vector<int> to_be_deleted_edges = vector<int>();
-    for(vector<string>::iterator it = path_graph_edges.begin(); it != path_graph_edges.end() - 1; it++)
+    BondGraph graph = BondGraph(all_atoms);
+    const vector<int>& offsets = graph.GetOffsets();
+    const vector<int>& neighbors = graph.GetNeighbors();
+
+    ///Number of neighbors of each atom among the atoms that are still in the graph
+    vector<int> counts = vector<int>(all_atoms.size(), 0);
+    vector<bool> removed = vector<bool>(all_atoms.size(), false);
+    vector<int> to_be_removed = vector<int>();
+    for(unsigned int i = 0; i < all_atoms.size(); i++)
     {
-        int source_index = distance(path_graph_edges.begin(), it);
-        string source_edge = (*it);
-        string source_label = path_graph_labels.at(source_index);
-        vector<string> source_edge_atoms = Split(source_edge, ",");
-
-        for(vector<string>::iterator it1 = it + 1; it1 != path_graph_edges.end(); it1++)
+        counts.at(i) = graph.GetDegree(i);
+        if(counts.at(i) <= 1)
         {
-            bool walk_found = false;
-            int target_index = distance(path_graph_edges.begin(), it1);
-            string target_edge = (*it1);
-            string target_label = path_graph_labels.at(target_index);
-            vector<string> target_edge_atoms = Split(target_edge, ",");
-            stringstream new_edge;
-            stringstream new_label;
-            if(source_edge_atoms.at(0).compare(source_edge_atoms.at(1)) != 0 && target_edge_atoms.at(0).compare(target_edge_atoms.at(1)) != 0)
-            {///if the edges a != b and b != c, so there might be a walk a_b_c
-
-                if(source_edge_atoms.at(1).compare(target_edge_atoms.at(0)) == 0 && source_edge_atoms.at(1).compare(common_atom) == 0)///if there is a walk a_b_c in the graph (edges: a,b and b,c)
-                {
-                    new_edge << source_edge_atoms.at(0) << "," << target_edge_atoms.at(1);
-                    new_label << source_label;
-                    vector<string> target_path_values = Split(target_label,"-");
-                    for(int i = 1; i < target_path_values.size(); i++)
-                        new_label << "-" << target_path_values.at(i);
-                    walk_found = true;
-                }
-                else if(source_edge_atoms.at(1).compare(target_edge_atoms.at(1)) == 0 && source_edge_atoms.at(1).compare(common_atom) == 0)///if there is a walk a_b_c in the graph (edges: a,b and c,b)
-                {
-                    new_edge << source_edge_atoms.at(0) << "," << target_edge_atoms.at(0);
-                    new_label << source_label;
-                    vector<string> target_path_values = Split(target_label,"-");
-                    for(int i = target_path_values.size() - 2 ; i >= 0; i--)
-                        new_label << "-" << target_path_values.at(i);
-                    walk_found = true;
-                }
-                else if(source_edge_atoms.at(0).compare(target_edge_atoms.at(0)) == 0 && source_edge_atoms.at(0).compare(common_atom) == 0)///if there is a walk a_b_c in the graph (edges: b,a and b,c)
-                {
-                    new_edge << source_edge_atoms.at(1) << "," << target_edge_atoms.at(1);
-                    vector<string> source_path_values = Split(source_label,"-");
-                    for(int i = source_path_values.size() - 1 ; i >= 1; i--)
-                        new_label << source_path_values.at(i) << "-";
-                    new_label << target_label;
-                    walk_found = true;
-                }
-                else if(source_edge_atoms.at(0).compare(target_edge_atoms.at(1)) == 0 && source_edge_atoms.at(0).compare(common_atom) == 0)///if there is a walk a_b_c in the graph (edges: b,a and c,b)
-                {
-                    new_edge << source_edge_atoms.at(1) << "," << target_edge_atoms.at(0);
-                    vector<string> source_path_values = Split(source_label,"-");
-                    for(int i = source_path_values.size() - 1 ; i >= 0; i--)
-                        new_label << source_path_values.at(i) << "-";
-                    vector<string> target_path_values = Split(target_label,"-");
-                    for(int i = target_path_values.size() - 2 ; i >= 0; i--)
-                    {
-                        if(i == 0)
-                            new_label << target_path_values.at(i);
-                        else
-                            new_label << target_path_values.at(i) << "-";
-                    }
-                    walk_found = true;
-                }
-            }
-            if(walk_found)
-            {
-                ///checking the new edge for cycle
-                vector<string> new_edge_atoms = Split(new_edge.str(), ",");
-                if(new_edge_atoms.at(0).compare(new_edge_atoms.at(1)) == 0) ///edge is a,a
-                {
-                    cycles.push_back(new_label.str());///label shows the atom involved in a cycle
-                }
-                ///adding the newly-formed edge (a,c) and label(a-b-c)
-                else if(find(reduced_path_graph_labels.begin(), reduced_path_graph_labels.end(), new_label.str()) == reduced_path_graph_labels.end())
-                {
-                    reduced_path_graph_edges.push_back(new_edge.str());
-                    reduced_path_graph_labels.push_back(new_label.str());
-                }
-
-                ///adding to be deleted edges with the common atom b
-                if(find(to_be_deleted_edges.begin(), to_be_deleted_edges.end(), source_index) == to_be_deleted_edges.end())
-                    to_be_deleted_edges.push_back(source_index);
-                if(find(to_be_deleted_edges.begin(), to_be_deleted_edges.end(), target_index) == to_be_deleted_edges.end())
-                    to_be_deleted_edges.push_back(target_index);
-            }
+            removed.at(i) = true;
+            to_be_removed.push_back(i);
         }
     }
-
-    vector<string> temp_reduced_path_graph_edges = vector<string>();
-    vector<string> temp_reduced_path_graph_labels = vector<string>();
-    for(int i = 0; i < reduced_path_graph_edges.size(); i++)
+    while(!to_be_removed.empty())
     {
-        if(find(to_be_deleted_edges.begin(), to_be_deleted_edges.end(), i) == to_be_deleted_edges.end())
+        int atom = to_be_removed.back();
+        to_be_removed.pop_back();
+        for(int i = offsets.at(atom); i < offsets.at(atom + 1); i++)
         {
-            temp_reduced_path_graph_edges.push_back(reduced_path_graph_edges.at(i));
-            temp_reduced_path_graph_labels.push_back(reduced_path_graph_labels.at(i));
+            int neighbor = neighbors.at(i);
+            counts.at(neighbor)--;
+            if(!removed.at(neighbor) && counts.at(neighbor) <= 1)
+            {
+                removed.at(neighbor) = true;
+                to_be_removed.push_back(neighbor);
+            }
         }
     }
-    reduced_path_graph_edges = temp_reduced_path_graph_edges;
-    reduced_path_graph_labels = temp_reduced_path_graph_labels;
+
+    AtomVector atoms_with_more_than_two_neighbors = AtomVector();
+    for(unsigned int i = 0; i < all_atoms.size(); i++)
+        if(!removed.at(i))
+            atoms_with_more_than_two_neighbors.push_back(all_atoms.at(i));
+    all_atoms = atoms_with_more_than_two_neighbors;
 }
 
-void Assembly::PruneGraph(AtomVector& all_atoms)
+void Assembly::PruneRingSystems(AtomVector& atoms, vector<string> required_elements)
 {
-    AtomVector atoms_with_more_than_two_neighbors = AtomVector();
-    vector<string> het_atom_ids = vector<string>();
-    for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
+    BondGraph graph = BondGraph(atoms);
+    const vector<int>& offsets = graph.GetOffsets();
+    const vector<int>& neighbors = graph.GetNeighbors();
+
+    ///Finding the ring systems and whether they have an atom of the required elements
+    vector<int> ring_systems = vector<int>(atoms.size(), -1);
+    vector<bool> has_required_element = vector<bool>();
+    for(unsigned int i = 0; i < atoms.size(); i++)
     {
-        Atom* atom = *it;
-        het_atom_ids.push_back(atom->GetId());
-    }
-    for(AtomVector::iterator it = all_atoms.begin(); it != all_atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        AtomNode* node = atom->GetNode();
-        int count = 0;
-        for(int i = 0; i < node->GetNodeNeighbors().size(); i++)
+        if(ring_systems.at(i) != -1)
+            continue;
+        int ring_system = has_required_element.size();
+        has_required_element.push_back(false);
+        ring_systems.at(i) = ring_system;
+        vector<int> to_visit = vector<int>(1, i);
+        while(!to_visit.empty())
         {
-            Atom* neighbor = node->GetNodeNeighbors().at(i);
-            if(find(het_atom_ids.begin(), het_atom_ids.end(), neighbor->GetId()) != het_atom_ids.end())
-                count++;
+            int atom_index = to_visit.back();
+            to_visit.pop_back();
+            Atom* atom = atoms.at(atom_index);
+            ///Element info is usually not set, in that case the first letter of the atom name is used
+            string element = atom->GetElementSymbol();
+            if(element.empty())
+                element = atom->GetName().substr(0, 1);
+            if(find(required_elements.begin(), required_elements.end(), element) != required_elements.end())
+                has_required_element.at(ring_system) = true;
+            for(int j = offsets.at(atom_index); j < offsets.at(atom_index + 1); j++)
+            {
+                int neighbor = neighbors.at(j);
+                if(ring_systems.at(neighbor) == -1)
+                {
+                    ring_systems.at(neighbor) = ring_system;
+                    to_visit.push_back(neighbor);
+                }
+            }
         }
-        if(count > 1)
-            atoms_with_more_than_two_neighbors.push_back(atom);
     }
-    if(atoms_with_more_than_two_neighbors.size() != all_atoms.size())
-    {
-        all_atoms = atoms_with_more_than_two_neighbors;
-        PruneGraph(all_atoms);
-    }
-    else
-        return;
+
+    AtomVector ring_system_atoms = AtomVector();
+    for(unsigned int i = 0; i < atoms.size(); i++)
+        if(has_required_element.at(ring_systems.at(i)))
+            ring_system_atoms.push_back(atoms.at(i));
+    atoms = ring_system_atoms;
 }
 
-void Assembly::ConvertIntoPathGraph(vector<string>& path_graph_edges, vector<string>& path_graph_labels, AtomVector atoms)
+void Assembly::ConvertIntoPathGraph(PathGraph& path_graph, AtomVector atoms)
 {
-    vector<string> atoms_id = vector<string>();
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = *it;
-        atoms_id.push_back(atom->GetId());
-    }
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
+    BondGraph graph = BondGraph(atoms);
+    const vector<int>& offsets = graph.GetOffsets();
+    const vector<int>& neighbors = graph.GetNeighbors();
+    path_graph = PathGraph(atoms.size(), path_graph.maximum_ring_size);
+    ///Bonds that already have an edge, with the lower index first
+    set<pair<int, int> > bonds = set<pair<int, int> >();
+    for(unsigned int i = 0; i < atoms.size(); i++)
     {
-        Atom* atom = (*it);
-        AtomNode* node = atom->GetNode();
-        AtomVector neighbors = node->GetNodeNeighbors();
-        for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
+        for(int j = offsets.at(i); j < offsets.at(i + 1); j++)
         {
-            Atom* neighbor = (*it1);
-            if(find(atoms_id.begin(), atoms_id.end(), neighbor->GetId()) != atoms_id.end())
+            int neighbor = neighbors.at(j);
+            if(bonds.insert(make_pair(min((int)i, neighbor), max((int)i, neighbor))).second) ///path not existed before
             {
-                stringstream ss;
-                ss << atom->GetId() << "," << neighbor->GetId();
-                stringstream reverse_ss;
-                reverse_ss << neighbor->GetId() << "," << atom->GetId();
-                if(find(path_graph_edges.begin(), path_graph_edges.end(), ss.str()) == path_graph_edges.end() &&
-                        find(path_graph_edges.begin(), path_graph_edges.end(), reverse_ss.str()) == path_graph_edges.end()) ///path not existed before
-                {
-                    stringstream path;
-                    path << atom->GetId() << "-" << neighbor->GetId();
-                    path_graph_edges.push_back(ss.str());
-                    path_graph_labels.push_back(path.str());
-                }
+                vector<int> path = vector<int>();
+                path.push_back(i);
+                path.push_back(neighbor);
+                path_graph.AddEdge(i, neighbor, path);
             }
         }
     }
@@ -428,77 +353,67 @@ void Assembly::ConvertIntoPathGraph(vector<string>& path_graph_edges, vector<str
 Assembly::CycleMap Assembly::DetectCyclesByDFS()
 {
     int counter = 0;
-
-    AtomStatusMap atom_status_map = AtomStatusMap();
-    AtomIdAtomMap atom_parent_map = AtomIdAtomMap();
-    AtomIdAtomMap src_dest_map = AtomIdAtomMap();
-    AtomVector cycle = AtomVector();
     CycleMap cycles = CycleMap();
 
     AtomVector atoms = GetAllAtomsOfAssemblyExceptProteinWaterResiduesAtoms();
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
+    BondGraph graph = BondGraph(atoms);
+    vector<gmml::GraphSearchNodeStatus> atom_statuses = vector<gmml::GraphSearchNodeStatus>(atoms.size(), gmml::UNVISITED);
+    vector<int> atom_parents = vector<int>(atoms.size(), -1);
+    vector<pair<int, int> > back_edges = vector<pair<int, int> >();
+    for(unsigned int i = 0; i < atoms.size(); i++)
     {
-        Atom* atom = (*it);
-        atom_status_map[atom->GetId()] = gmml::UNVISITED;
-        Atom* parent = new Atom();
-        parent->SetId("null");
-        atom_parent_map[atom->GetId()] = parent;
-    }
-    for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
-    {
-        Atom* atom = (*it);
-        if(atom_status_map[atom->GetId()] == gmml::UNVISITED)
-        {
-            DFSVisit(atoms, atom_status_map, atom_parent_map, atom, counter, src_dest_map);
-        }
+        if(atom_statuses.at(i) == gmml::UNVISITED)
+            DFSVisit(graph, atom_statuses, atom_parents, i, counter, back_edges);
     }
 
     stringstream n_of_cycle;
     n_of_cycle << "Number of cycles found: " << counter;
     cout << n_of_cycle.str() << endl;
     gmml::log(__LINE__, __FILE__,  gmml::INF, n_of_cycle.str());
-    for(AtomIdAtomMap::iterator it = src_dest_map.begin(); it != src_dest_map.end(); it++)
+    AtomVector cycle = AtomVector();
+    for(vector<pair<int, int> >::iterator it = back_edges.begin(); it != back_edges.end(); it++)
     {
-        string src_dest = (*it).first;
-        Atom* destination = (*it).second;
         cycle.clear();
         stringstream cycle_stream;
-        vector<string> key = Split(src_dest, "-");
-        ReturnCycleAtoms(key.at(0), destination, atom_parent_map, cycle, cycle_stream);
+        ReturnCycleAtoms((*it).first, (*it).second, atom_parents, atoms, cycle, cycle_stream);
         cycles[cycle_stream.str()] = cycle;
     }
     return cycles;
 }
 
-void Assembly::DFSVisit(AtomVector atoms, AtomStatusMap& atom_status_map, AtomIdAtomMap& atom_parent_map, Atom *atom, int& counter, AtomIdAtomMap& src_dest_map)
+void Assembly::DFSVisit(BondGraph& graph, vector<gmml::GraphSearchNodeStatus>& atom_statuses, vector<int>& atom_parents, int root, int& counter,
+                        vector<pair<int, int> >& back_edges)
 {
-    atom_status_map[atom->GetId()] = gmml::VISITED;
-    AtomNode* node = atom->GetNode();
-    AtomVector neighbors = node->GetNodeNeighbors();
-
-    for(AtomVector::iterator it = neighbors.begin(); it != neighbors.end(); it++)
+    const vector<int>& offsets = graph.GetOffsets();
+    const vector<int>& neighbors = graph.GetNeighbors();
+    ///Atoms on the current path, with the position of the next neighbor to look at
+    vector<pair<int, int> > stack = vector<pair<int, int> >();
+    atom_statuses.at(root) = gmml::VISITED;
+    stack.push_back(make_pair(root, offsets.at(root)));
+    while(!stack.empty())
     {
-        Atom* neighbor = (*it);
-        if(neighbor->GetDescription().find("Het;") != string::npos)
+        int atom = stack.back().first;
+        int& next = stack.back().second;
+        if(next == offsets.at(atom + 1))
         {
-            if(atom_status_map[neighbor->GetId()] == gmml::UNVISITED)
-            {
-                atom_parent_map[neighbor->GetId()] = atom;
-                DFSVisit(atoms, atom_status_map, atom_parent_map, neighbor, counter, src_dest_map);
-            }
-            if(atom_status_map[neighbor->GetId()] == gmml::VISITED)
-            {
-                Atom* parent = atom_parent_map[atom->GetId()];
-                if(neighbor->GetId().compare(parent->GetId()) != 0)///making sure we are not tracking back to the previous atom which is the parent of neigbor (current atom)
-                {
-                    counter++;
-                    stringstream key;
-                    key << neighbor->GetId() << "-" << atom->GetId();
-                    src_dest_map[key.str()] = atom;
-                }
-            }
+            atom_statuses.at(atom) = gmml::DONE;
+            stack.pop_back();
+            continue;
+        }
+        int neighbor = neighbors.at(next);
+        next++;
+        if(!graph.GetAtom(neighbor)->IsHeterogen())
+            continue;
+        if(atom_statuses.at(neighbor) == gmml::UNVISITED)
+        {
+            atom_parents.at(neighbor) = atom;
+            atom_statuses.at(neighbor) = gmml::VISITED;
+            stack.push_back(make_pair(neighbor, offsets.at(neighbor)));
+        }
+        else if(atom_statuses.at(neighbor) == gmml::VISITED && neighbor != atom_parents.at(atom))///making sure we are not tracking back to the parent of the current atom
+        {
+            counter++;
+            back_edges.push_back(make_pair(neighbor, atom));
         }
     }
-    atom_status_map[atom->GetId()] = gmml::DONE;
 }
-
@@ -5,6 +5,7 @@
 #include <set>
 #include <queue>
 #include <stack>
+#include <algorithm>
 
 #include "../../../includes/MolecularModeling/assembly.hpp"
 #include "../../../includes/MolecularModeling/residue.hpp"
@@ -63,6 +64,7 @@
 #include "../../../includes/common.hpp"
 #include "../../../includes/GeometryTopology/grid.hpp"
 #include "../../../includes/GeometryTopology/cell.hpp"
+#include "../../../includes/GeometryTopology/coordinateframe.hpp"
 
 #include <unistd.h>
 #include <errno.h>
@@ -86,7 +88,10 @@ using namespace CondensedSequenceSpace;
 //                       CONSTRUCTOR                    //
 //////////////////////////////////////////////////////////
 
-Assembly::Assembly() : description_(""), model_index_(0), sequence_number_(1), id_("1")
+Assembly::Assembly() : description_(""), model_index_(0), sequence_number_(1), id_("1"),
+    box_length_(dNotSet), box_width_(dNotSet), box_height_(dNotSet), box_angle_(dNotSet),
+    structure_revision_(AssemblyStorage::NextRevision()), views_revision_(0), coordinates_revision_(0), coordinates_model_index_(-1),
+    bond_graph_structure_revision_(0), bond_revision_(AssemblyStorage::NextRevision()), bond_graph_bond_revision_(0), storage_(new AssemblyStorage())
 {
     residues_ = ResidueVector();
     assemblies_ = AssemblyVector();
@@ -94,6 +99,18 @@ Assembly::Assembly() : description_(""), model_index_(0), sequence_number_(1), i
 
 Assembly::Assembly(vector<string> file_paths, gmml::InputFileType type)
 {
+    storage_ = new AssemblyStorage();
+    structure_revision_ = AssemblyStorage::NextRevision();
+    views_revision_ = 0;
+    coordinates_revision_ = 0;
+    coordinates_model_index_ = -1;
+    bond_graph_structure_revision_ = 0;
+    bond_revision_ = AssemblyStorage::NextRevision();
+    bond_graph_bond_revision_ = 0;
+    box_length_ = dNotSet;
+    box_width_ = dNotSet;
+    box_height_ = dNotSet;
+    box_angle_ = dNotSet;
     source_file_type_ = type;
     description_ = "";
     model_index_ = 0;
@@ -144,9 +161,13 @@ Assembly::Assembly(vector<string> file_paths, gmml::InputFileType type)
     }
 }
 
-Assembly::Assembly(Assembly *assembly) : description_(""), model_index_(0), sequence_number_(1), id_("1")
+Assembly::Assembly(Assembly *assembly) : description_(""), model_index_(0), sequence_number_(1), id_("1"),
+    box_length_(dNotSet), box_width_(dNotSet), box_height_(dNotSet), box_angle_(dNotSet),
+    structure_revision_(AssemblyStorage::NextRevision()), views_revision_(0), coordinates_revision_(0), coordinates_model_index_(-1),
+    bond_graph_structure_revision_(0), bond_revision_(AssemblyStorage::NextRevision()), bond_graph_bond_revision_(0), storage_(new AssemblyStorage())
 {
     source_file_ = assembly->GetSourceFile();
+    this->SetBoxDimensions(assembly->GetBoxLength(), assembly->GetBoxWidth(), assembly->GetBoxHeight(), assembly->GetBoxAngle());
     assemblies_ = AssemblyVector();
     AssemblyVector assemblies = assembly->GetAssemblies();
     for(AssemblyVector::iterator it = assemblies.begin(); it != assemblies.end(); it++)
@@ -160,6 +181,18 @@ Assembly::Assembly(Assembly *assembly) : description_(""), model_index_(0), sequ
 
 Assembly::Assembly(vector<vector<string> > file_paths, vector<gmml::InputFileType> types)
 {
+    storage_ = new AssemblyStorage();
+    structure_revision_ = AssemblyStorage::NextRevision();
+    views_revision_ = 0;
+    coordinates_revision_ = 0;
+    coordinates_model_index_ = -1;
+    bond_graph_structure_revision_ = 0;
+    bond_revision_ = AssemblyStorage::NextRevision();
+    bond_graph_bond_revision_ = 0;
+    box_length_ = dNotSet;
+    box_width_ = dNotSet;
+    box_height_ = dNotSet;
+    box_angle_ = dNotSet;
     stringstream name;
     stringstream source_file;
     sequence_number_ = 1;
@@ -190,6 +223,11 @@ Assembly::Assembly(vector<vector<string> > file_paths, vector<gmml::InputFileTyp
     model_index_ = 0;
 }
 
+Assembly::~Assembly()
+{
+    ReleaseStorages();
+}
+
 //////////////////////////////////////////////////////////
 //                         ACCESSOR                     //
 //////////////////////////////////////////////////////////
@@ -205,6 +243,7 @@ Assembly::AssemblyVector Assembly::GetAssemblies()
 
 Assembly::ResidueVector Assembly::GetResidues()
 {
+    this->ExpandSolventBlock();
     return residues_;
 }
 
@@ -243,32 +282,29 @@ int Assembly::GetModelIndex()
     return model_index_;
 }
 
+double Assembly::GetBoxLength()
+{
+    return box_length_;
+}
+
+double Assembly::GetBoxWidth()
+{
+    return box_width_;
+}
+
+double Assembly::GetBoxHeight()
+{
+    return box_height_;
+}
+
+double Assembly::GetBoxAngle()
+{
+    return box_angle_;
+}
+
 Assembly::AtomVector Assembly::GetAllAtomsOfAssembly()
 {
-    AtomVector all_atoms_of_assembly = AtomVector();
-    AssemblyVector assemblies = this->GetAssemblies();
-    for(AssemblyVector::iterator it = assemblies.begin(); it != assemblies.end(); it++)
-    {
-        Assembly* assembly = (*it);
-        AtomVector atoms_of_assembly = assembly->GetAllAtomsOfAssembly();
-        for(AtomVector::iterator it1 = atoms_of_assembly.begin(); it1 != atoms_of_assembly.end(); it1++)
-        {
-            Atom* atom = (*it1);
-            all_atoms_of_assembly.push_back(atom);
-        }
-    }
-    ResidueVector residues = this->GetResidues();
-    for(ResidueVector::iterator it = residues.begin(); it != residues.end(); it++)
-    {
-        Residue* residue = (*it);
-        AtomVector atoms = residue->GetAtoms();
-        for(AtomVector::iterator it1 = atoms.begin(); it1 != atoms.end(); it1++)
-        {
-            Atom* atom = (*it1);
-            all_atoms_of_assembly.push_back(atom);
-        }
-    }
-    return all_atoms_of_assembly;
+    return this->GetAllAtomsOfAssemblyView();
 }
 
 Assembly::AtomVector Assembly::GetAllAtomsOfAssemblyExceptProteinWaterResiduesAtoms()
@@ -286,16 +322,17 @@ Assembly::AtomVector Assembly::GetAllAtomsOfAssemblyExceptProteinWaterResiduesAt
         }
     }
     ResidueVector residues = this->GetResidues();
+    SymbolTable::Symbol water_name = SymbolTable::Intern("HOH");
     for(ResidueVector::iterator it = residues.begin(); it != residues.end(); it++)
     {
         Residue* residue = (*it);
-        if(residue->GetName().compare("HOH") != 0)
+        if(residue->GetNameSymbol() != water_name)
         {
             AtomVector atoms = residue->GetAtoms();
             for(AtomVector::iterator it1 = atoms.begin(); it1 != atoms.end(); it1++)
             {
                 Atom* atom = (*it1);
-                if(atom->GetDescription().find("Het;") != string::npos)
+                if(atom->IsHeterogen())
                     all_atoms_of_assembly.push_back(atom);
             }
         }
@@ -305,63 +342,50 @@ Assembly::AtomVector Assembly::GetAllAtomsOfAssemblyExceptProteinWaterResiduesAt
 
 Assembly::ResidueVector Assembly::GetAllResiduesOfAssembly()
 {
-    ResidueVector all_residues_of_assembly = ResidueVector();
-    AssemblyVector assemblies = this->GetAssemblies();
-    for(AssemblyVector::iterator it = assemblies.begin(); it != assemblies.end(); it++)
-    {
-        Assembly* assembly = (*it);
-        ResidueVector residues_of_assembly = assembly->GetAllResiduesOfAssembly();
-        for(ResidueVector::iterator it1 = residues_of_assembly.begin(); it1 != residues_of_assembly.end(); it1++)
-        {
-            all_residues_of_assembly.push_back(*it1);
-        }
-    }
-    ResidueVector residues = this->GetResidues();
-    for(ResidueVector::iterator it = residues.begin(); it != residues.end(); it++)
-    {
-        all_residues_of_assembly.push_back(*it);
-    }
-    return all_residues_of_assembly;
+    return this->GetAllResiduesOfAssemblyView();
 }
 
 Assembly::CoordinateVector Assembly::GetAllCoordinates()
 {
-    CoordinateVector coordinates = CoordinateVector();
-    for(AssemblyVector::iterator it = this->assemblies_.begin(); it != this->assemblies_.end(); it++)
-    {
-        Assembly* assembly = (*it);
-        CoordinateVector assembly_coordinate = assembly->GetAllCoordinates();
-        if(assembly_coordinate.size() == 0)
-        {
-            cout << "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)" << endl;
-            gmml::log(__LINE__, __FILE__, gmml::ERR, "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)");
-            return CoordinateVector();
-        }
-        for(CoordinateVector::iterator it1 = assembly_coordinate.begin(); it1 != assembly_coordinate.end(); it1++)
-        {
-            coordinates.push_back(*it1);
-        }
-    }
-    for(ResidueVector::iterator it = this->residues_.begin(); it != this->residues_.end(); it++)
-    {
-        Residue* residue = (*it);
-        AtomVector residue_atoms = residue->GetAtoms();
-        for(AtomVector::iterator it1 = residue_atoms.begin(); it1 != residue_atoms.end(); it1++)
-        {
-            Atom* atom = (*it1);
-            if(atom->GetCoordinates().size() == 0)
-            {
-                cout << "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)" << endl;
-                gmml::log(__LINE__, __FILE__, gmml::ERR, "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)");
-                return CoordinateVector();
-            }
-            else
-            {
-                coordinates.push_back(atom->GetCoordinates()[model_index_]);
-            }
-        }
-    }
-    return coordinates;
+    return this->GetAllCoordinatesView();
+}
+
+const Assembly::AtomVector& Assembly::GetAllAtomsOfAssemblyView()
+{
+    this->ExpandSolventBlock();
+    this->UpdateViews();
+    return all_atoms_;
+}
+
+const Assembly::ResidueVector& Assembly::GetAllResiduesOfAssemblyView()
+{
+    this->ExpandSolventBlock();
+    this->UpdateViews();
+    return all_residues_;
+}
+
+BondGraph* Assembly::GetBondGraph()
+{
+    this->ExpandSolventBlock();
+    this->UpdateBondGraph();
+    return &bond_graph_;
+}
+
+const Assembly::CoordinateVector& Assembly::GetAllCoordinatesView()
+{
+    this->ExpandSolventBlock();
+    this->UpdateCoordinatesView();
+    return all_coordinates_;
+}
+
+CoordinateFrame* Assembly::GetCoordinateFrame(int model_index)
+{
+    return storage_->GetCoordinateFrame(model_index);
+}
+
+int Assembly::GetNumberOfCoordinateFrames()
+{
+    return storage_->GetNumberOfCoordinateFrames();
 }
 
 Assembly::NoteVector Assembly::GetNotes()
@@ -369,6 +393,11 @@ Assembly::NoteVector Assembly::GetNotes()
     return notes_;
 }
 
+SolventBlock* Assembly::GetSolventBlock()
+{
+    return &solvent_block_;
+}
+
 //////////////////////////////////////////////////////////
 //                          MUTATOR                     //
 //////////////////////////////////////////////////////////
@@ -379,6 +408,7 @@ void Assembly::SetName(string name)
 
 void Assembly::SetAssemblies(AssemblyVector assemblies)
 {
+    NotifyStructureChanged();
     assemblies_.clear();
     for(AssemblyVector::iterator it = assemblies.begin(); it != assemblies.end(); it++)
     {
@@ -401,10 +431,13 @@ void Assembly::AddAssembly(Assembly *assembly)
     assembly->UpdateIds(ssss.str());
     assembly->SetId(ssss.str());
     this->assemblies_.push_back(assembly);
+    NotifyStructureChanged();
 }
 
 void Assembly::UpdateIds(string new_id)
 {
+    ///The ids of the solvent residues are rewritten below like the others, so the block is expanded first
+    this->ExpandSolventBlock();
     for(AssemblyVector::iterator  it = assemblies_.begin(); it != assemblies_.end(); it++)
     {
         Assembly* assembly = *it;
@@ -441,16 +474,22 @@ void Assembly::UpdateIds(string new_id)
 
 void Assembly::SetResidues(ResidueVector residues)
 {
+    NotifyStructureChanged();
     residues_.clear();
+    solvent_block_.Clear();
     for(ResidueVector::iterator it = residues.begin(); it != residues.end(); it++)
     {
+        this->RetainStorage((*it)->GetStorage());
         residues_.push_back(*it);
     }
 }
 
 void Assembly::AddResidue(Residue *residue)
 {
+    this->ExpandSolventBlock();
+    this->RetainStorage(residue->GetStorage());
     residues_.push_back(residue);
+    NotifyStructureChanged();
 }
 
 void Assembly::SetChemicalType(string chemical_type)
@@ -488,6 +527,14 @@ void Assembly::SetModelIndex(int model_index)
     model_index_ = model_index;
 }
 
+void Assembly::SetBoxDimensions(double box_length, double box_width, double box_height, double box_angle)
+{
+    box_length_ = box_length;
+    box_width_ = box_width;
+    box_height_ = box_height;
+    box_angle_ = box_angle;
+}
+
 void Assembly::SetNotes(NoteVector notes)
 {
     notes_.clear();
@@ -507,8 +554,13 @@ void Assembly::AddNote(Note *note)
 //////////////////////////////////////////////////////////
 void Assembly::ClearAssembly()
 {
+    NotifyStructureChanged();
     this->residues_.clear();
     this->assemblies_.clear();
+    this->solvent_block_.Clear();
+    this->ReleaseStorages();
+    this->storage_ = new AssemblyStorage();
+    this->SetBoxDimensions(dNotSet, dNotSet, dNotSet, dNotSet);
     //    this->source_file_ = "";
     //    this->source_file_type_ = UNKNOWN;
     //    this->chemical_type_ = "";
@@ -520,6 +572,190 @@ void Assembly::ClearAssembly()
     //    this->model_index_ = 0;
 }
 
+void Assembly::NotifyStructureChanged()
+{
+    structure_revision_ = AssemblyStorage::NextRevision();
+}
+
+void Assembly::NotifyBondsChanged()
+{
+    bond_revision_ = AssemblyStorage::NextRevision();
+}
+
+void Assembly::ShareStorage(Assembly* assembly)
+{
+    vector<AssemblyStorage*> storages = assembly->shared_storages_;
+    storages.push_back(assembly->storage_);
+    for(vector<AssemblyStorage*>::iterator it = storages.begin(); it != storages.end(); it++)
+        this->RetainStorage(*it);
+}
+
+void Assembly::RetainStorage(AssemblyStorage* storage)
+{
+    if(storage == NULL || storage == storage_ || find(shared_storages_.begin(), shared_storages_.end(), storage) != shared_storages_.end())
+        return;
+    storage->Retain();
+    shared_storages_.push_back(storage);
+}
+
+Coordinate* Assembly::CreateCoordinate(const Coordinate& coordinate, int model_index)
+{
+    return storage_->CreateCoordinate(coordinate, model_index);
+}
+
+Atom* Assembly::CreateAtom()
+{
+    return storage_->CreateAtom();
+}
+
+Residue* Assembly::CreateResidue()
+{
+    return storage_->CreateResidue();
+}
+
+AtomNode* Assembly::CreateAtomNode()
+{
+    return storage_->CreateAtomNode();
+}
+
+void Assembly::ExpandSolventBlock()
+{
+    if(solvent_block_.IsEmpty())
+        return;
+    //The block is emptied before its residues are added, so that AddResidue does not expand it again
+    SolventBlock solvent_block = solvent_block_;
+    solvent_block_.Clear();
+    for(int i = 0; i < solvent_block.GetNumberOfResidues(); i++)
+        this->AddResidue(solvent_block.ExpandResidue(i, this, id_));
+}
+
+void Assembly::ReleaseStorages()
+{
+    for(vector<AssemblyStorage*>::iterator it = shared_storages_.begin(); it != shared_storages_.end(); it++)
+        (*it)->Release();
+    shared_storages_.clear();
+    storage_->Release();
+    storage_ = NULL;
+}
+
+unsigned long Assembly::GetStructureRevision()
+{
+    unsigned long revision = structure_revision_;
+    ///Residue and Atom mutators bump the revision of the storage that owns the residue, which is one of the storages held here
+    if(storage_->GetStructureRevision() > revision)
+        revision = storage_->GetStructureRevision();
+    for(vector<AssemblyStorage*>::iterator it = shared_storages_.begin(); it != shared_storages_.end(); it++)
+    {
+        if((*it)->GetStructureRevision() > revision)
+            revision = (*it)->GetStructureRevision();
+    }
+    for(AssemblyVector::iterator it = this->assemblies_.begin(); it != this->assemblies_.end(); it++)
+    {
+        unsigned long assembly_revision = (*it)->GetStructureRevision();
+        if(assembly_revision > revision)
+            revision = assembly_revision;
+    }
+    return revision;
+}
+
+unsigned long Assembly::GetBondRevision()
+{
+    unsigned long revision = bond_revision_;
+    ///AtomNode mutators and Atom::SetNode bump the bond revision of the storage that owns the residue of the atom
+    if(storage_->GetBondRevision() > revision)
+        revision = storage_->GetBondRevision();
+    for(vector<AssemblyStorage*>::iterator it = shared_storages_.begin(); it != shared_storages_.end(); it++)
+    {
+        if((*it)->GetBondRevision() > revision)
+            revision = (*it)->GetBondRevision();
+    }
+    for(AssemblyVector::iterator it = this->assemblies_.begin(); it != this->assemblies_.end(); it++)
+    {
+        unsigned long assembly_revision = (*it)->GetBondRevision();
+        if(assembly_revision > revision)
+            revision = assembly_revision;
+    }
+    return revision;
+}
+
+void Assembly::UpdateViews()
+{
+    if(views_revision_ == this->GetStructureRevision())
+        return;
+    all_atoms_.clear();
+    all_residues_.clear();
+    for(AssemblyVector::iterator it = this->assemblies_.begin(); it != this->assemblies_.end(); it++)
+    {
+        Assembly* assembly = (*it);
+        const AtomVector& atoms_of_assembly = assembly->GetAllAtomsOfAssemblyView();
+        all_atoms_.insert(all_atoms_.end(), atoms_of_assembly.begin(), atoms_of_assembly.end());
+        const ResidueVector& residues_of_assembly = assembly->GetAllResiduesOfAssemblyView();
+        all_residues_.insert(all_residues_.end(), residues_of_assembly.begin(), residues_of_assembly.end());
+    }
+    for(ResidueVector::iterator it = this->residues_.begin(); it != this->residues_.end(); it++)
+    {
+        Residue* residue = (*it);
+        all_residues_.push_back(residue);
+        AtomVector atoms = residue->GetAtoms();
+        all_atoms_.insert(all_atoms_.end(), atoms.begin(), atoms.end());
+    }
+    ///Taken after the sub-assemblies have been read, since reading them may expand their solvent blocks
+    views_revision_ = this->GetStructureRevision();
+}
+
+void Assembly::UpdateBondGraph()
+{
+    this->UpdateViews();
+    if(bond_graph_structure_revision_ != views_revision_ || bond_graph_bond_revision_ != this->GetBondRevision())
+    {
+        bond_graph_.Build(all_atoms_);
+        bond_graph_structure_revision_ = views_revision_;
+        bond_graph_bond_revision_ = this->GetBondRevision();
+    }
+}
+
+void Assembly::UpdateCoordinatesView()
+{
+    if(coordinates_revision_ == this->GetStructureRevision() && coordinates_model_index_ == model_index_)
+        return;
+    all_coordinates_.clear();
+    for(AssemblyVector::iterator it = this->assemblies_.begin(); it != this->assemblies_.end(); it++)
+    {
+        Assembly* assembly = (*it);
+        const CoordinateVector& assembly_coordinate = assembly->GetAllCoordinatesView();
+        if(assembly_coordinate.size() == 0)
+        {
+            cout << "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)" << endl;
+            gmml::log(__LINE__, __FILE__, gmml::ERR, "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)");
+            all_coordinates_.clear();
+            return;
+        }
+        all_coordinates_.insert(all_coordinates_.end(), assembly_coordinate.begin(), assembly_coordinate.end());
+    }
+    for(ResidueVector::iterator it = this->residues_.begin(); it != this->residues_.end(); it++)
+    {
+        Residue* residue = (*it);
+        AtomVector residue_atoms = residue->GetAtoms();
+        for(AtomVector::iterator it1 = residue_atoms.begin(); it1 != residue_atoms.end(); it1++)
+        {
+            Atom* atom = (*it1);
+            if(atom->GetCoordinates().size() == 0)
+            {
+                cout << "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)" << endl;
+                gmml::log(__LINE__, __FILE__, gmml::ERR, "Central data structure is not complete in order for generating this type of file: Missing coordinate(s)");
+                all_coordinates_.clear();
+                return;
+            }
+            else
+            {
+                all_coordinates_.push_back(atom->GetCoordinates()[model_index_]);
+            }
+        }
+    }
+    coordinates_revision_ = this->GetStructureRevision();
+    coordinates_model_index_ = model_index_;
+}
+
 double Assembly::GetTotalCharge()
 {
     double charge = 0;
@@ -577,6 +813,7 @@ double Assembly::GetTotalMass()
 
 void Assembly::GetHierarchicalMapOfAssembly(HierarchicalContainmentMap &hierarchical_map, stringstream &index)
 {
+    this->ExpandSolventBlock();
     hierarchical_map[index.str()] = this->residues_;
     if(this->assemblies_.size() == 0)
         return;
@@ -647,6 +884,7 @@ void Assembly::Print(ostream &out)
 {
     out << "===================== " << name_ << " ============================" << endl;
     out << "Source file: " << source_file_ << endl;
+    this->ExpandSolventBlock();
     if(assemblies_.size() != 0)
     {
         for(AssemblyVector::iterator it = assemblies_.begin(); it != assemblies_.end(); it++)
@@ -679,11 +917,11 @@ void Assembly::PrettyPrintHet(ostream &out)
     }
     else
     {
+        SymbolTable::Symbol water_name = SymbolTable::Intern("HOH");
         for(ResidueVector::iterator it = residues_.begin(); it != residues_.end(); it++)
         {
             Residue* residue = (*it);
-            string name = residue->GetName();
-            if(name.compare("HOH") != 0)
+            if(residue->GetNameSymbol() != water_name)
                 residue->PrettyPrintHet(out);
         }
     }
@@ -701,11 +939,11 @@ void Assembly::PrintHetResidues(ostream &out)
     }
     else
     {
+        SymbolTable::Symbol water_name = SymbolTable::Intern("HOH");
         for(ResidueVector::iterator it = residues_.begin(); it != residues_.end(); it++)
         {
             Residue* residue = (*it);
-            string name = residue->GetName();
-            if(name.compare("HOH") != 0)
+            if(residue->GetNameSymbol() != water_name)
                 residue->PrintHetResidues(out);
         }
     }
@@ -723,11 +961,11 @@ void Assembly::PrintHetAtoms(ostream &out)
     }
     else
     {
+        SymbolTable::Symbol water_name = SymbolTable::Intern("HOH");
         for(ResidueVector::iterator it = residues_.begin(); it != residues_.end(); it++)
         {
             Residue* residue = (*it);
-            string name = residue->GetName();
-            if(name.compare("HOH") != 0)
+            if(residue->GetNameSymbol() != water_name)
                 residue->PrintHetAtoms(out);
         }
     }
@@ -738,11 +976,11 @@ void Assembly::WriteHetResidues(string file_name)
     ofstream out_file;
     out_file.open(file_name.c_str());
 
+    SymbolTable::Symbol water_name = SymbolTable::Intern("HOH");
     for(ResidueVector::iterator it = residues_.begin(); it != residues_.end(); it++)
     {
         Residue* residue = (*it);
-        string name = residue->GetName();
-        if(name.compare("HOH") != 0)
+        if(residue->GetNameSymbol() != water_name)
             residue->WriteHetResidues(out_file);
     }
     out_file.close();
@@ -753,11 +991,11 @@ void Assembly::WriteHetAtoms(string file_name)
     ofstream out_file;
     out_file.open(file_name.c_str());
 
+    SymbolTable::Symbol water_name = SymbolTable::Intern("HOH");
     for(ResidueVector::iterator it = residues_.begin(); it != residues_.end(); it++)
     {
         Residue* residue = (*it);
-        string name = residue->GetName();
-        if(name.compare("HOH") != 0)
+        if(residue->GetNameSymbol() != water_name)
             residue->WriteHetAtoms(out_file);
     }
 }
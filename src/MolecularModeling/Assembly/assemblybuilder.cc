@@ -63,6 +63,7 @@
 #include "../../../includes/common.hpp"
 #include "../../../includes/GeometryTopology/grid.hpp"
 #include "../../../includes/GeometryTopology/cell.hpp"
+#include "../../../includes/GeometryTopology/coordinateframe.hpp"
 
 #include <unistd.h>
 #include <errno.h>
@@ -128,6 +129,7 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
             parameter = new ParameterFile(parameter_file);
             atom_type_map = parameter->GetAtomTypes();
         }
+        SymbolTable::Symbol dummy_type = SymbolTable::Intern("DU");
         ResidueVector parent_residues = ResidueVector();
         ResidueVector branch_residues = ResidueVector();
         vector<bool> derivatives = vector<bool>();
@@ -148,14 +150,11 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
                 sequence_number++;
                 CoordinateVector cartesian_coordinate_list = CoordinateVector();
 
-                Residue* assembly_residue = new Residue();
+                Residue* assembly_residue = this->CreateResidue();
                 assembly_residue->SetAssembly(this);
                 string prep_residue_name = prep_residue->GetName();
                 assembly_residue->SetName(prep_residue_name);
-                stringstream id;
-                id << prep_residue_name << "_" << gmml::BLANK_SPACE << "_" << sequence_number << "_" << gmml::BLANK_SPACE << "_"
-                   << gmml::BLANK_SPACE << "_" << id_;
-                assembly_residue->SetId(id.str());
+                assembly_residue->SetIdentity(prep_residue_name, gmml::BLANK_SPACE, sequence_number, gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
                 if(distance(amber_prep_residues.begin(), it) == (int)amber_prep_residues.size()-1)
                     ss << prep_residue_name;
                 else
@@ -168,12 +167,10 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
                     string atom_name = prep_atom->GetName();
                     if(prep_atom->GetType() != "DU")
                         serial_number++;
-                    Atom* assembly_atom = new Atom();
+                    Atom* assembly_atom = this->CreateAtom();
                     assembly_atom->SetResidue(assembly_residue);
                     assembly_atom->SetName(atom_name);
-                    stringstream atom_id;
-                    atom_id << atom_name << "_" << serial_number << "_" << id.str();
-                    assembly_atom->SetId(atom_id.str());
+                    assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
 
                     assembly_atom->MolecularDynamicAtom::SetAtomType(prep_atom->GetType());
                     assembly_atom->MolecularDynamicAtom::SetCharge(prep_atom->GetCharge());
@@ -247,18 +244,19 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
                             coordinate_list.push_back(grandparent_coordinate);
                             coordinate_list.push_back(parent_coordinate);
                         }
-                        Coordinate* coordinate = new Coordinate();
-                        coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
-                                                                                         prep_atom->GetAngle(), prep_atom->GetDihedral());
+                        Coordinate* cartesian_coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
+                                                                                                                   prep_atom->GetAngle(), prep_atom->GetDihedral());
+                        Coordinate* coordinate = this->CreateCoordinate(*cartesian_coordinate);
+                        delete cartesian_coordinate;
                         cartesian_coordinate_list.push_back(coordinate);
 
                         assembly_atom->AddCoordinate(coordinate);
                     }
                     else if(prep_residue->GetCoordinateType() == PrepFileSpace::kXYZ)
                     {
-                        assembly_atom->AddCoordinate(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
+                        assembly_atom->AddCoordinate(this->CreateCoordinate(Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral())));
                     }
-                    if(assembly_atom->GetAtomType().compare("DU") != 0)
+                    if(assembly_atom->GetAtomTypeSymbol() != dummy_type)
                         assembly_residue->AddAtom(assembly_atom);
                     if(atom_name.compare(amber_prep_residue->GetAnomericCarbon()) == 0)
                         assembly_residue->AddHeadAtom(assembly_atom);
@@ -272,8 +270,11 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
                     temp_assembly->SetResidues(temp_assembly_residues);
                     temp_assembly->SetSourceFile(prep_file);
                     temp_assembly->BuildStructureByPrepFileInformation();
+                    //The atom nodes of the residue have been created by the temporary assembly
+                    this->ShareStorage(temp_assembly);
+                    delete temp_assembly;
                 }
-                residues_.push_back(assembly_residue);
+                this->AddResidue(assembly_residue);
                 if(amber_prep_residue->GetParentId() != -1)
                 {
                     Residue* parent_residue = residues_.at(amber_prep_residue->GetParentId());
@@ -353,6 +354,7 @@ void Assembly::BuildAssemblyFromCondensedSequence(string sequence, string prep_f
                 linkage_index++;
             }
         }
+        delete parameter;
     }
     catch(exception ex)
     {
@@ -382,6 +384,7 @@ Assembly::AssemblyVector Assembly::BuildAllRotamersFromCondensedSequence(string
             parameter = new ParameterFile(parameter_file);
             atom_type_map = parameter->GetAtomTypes();
         }
+        SymbolTable::Symbol dummy_type = SymbolTable::Intern("DU");
         for(unsigned int i = 0; i < structures.size(); i++)
         {
             ResidueVector parent_residues = ResidueVector();
@@ -405,14 +408,11 @@ Assembly::AssemblyVector Assembly::BuildAllRotamersFromCondensedSequence(string
                     sequence_number++;
                     CoordinateVector cartesian_coordinate_list = CoordinateVector();
 
-                    Residue* assembly_residue = new Residue();
+                    Residue* assembly_residue = structures.at(i)->CreateResidue();
                     assembly_residue->SetAssembly(structures.at(i));
                     string prep_residue_name = prep_residue->GetName();
                     assembly_residue->SetName(prep_residue_name);
-                    stringstream id;
-                    id << prep_residue_name << "_" << gmml::BLANK_SPACE << "_" << sequence_number << "_" << gmml::BLANK_SPACE << "_"
-                       << gmml::BLANK_SPACE << "_" << id_;
-                    assembly_residue->SetId(id.str());
+                    assembly_residue->SetIdentity(prep_residue_name, gmml::BLANK_SPACE, sequence_number, gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
                     if(distance(amber_prep_residues.begin(), it) == (int)amber_prep_residues.size()-1)
                         ss << prep_residue_name;
                     else
@@ -421,16 +421,14 @@ Assembly::AssemblyVector Assembly::BuildAllRotamersFromCondensedSequence(string
                     PrepFileResidue::PrepFileAtomVector prep_atoms = prep_residue->GetAtoms();
                     for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
                     {
-                        Atom* assembly_atom = new Atom();
+                        Atom* assembly_atom = structures.at(i)->CreateAtom();
                         PrepFileAtom* prep_atom = (*it1);
                         if(prep_atom->GetType() != "DU")
                             serial_number++;
                         assembly_atom->SetResidue(assembly_residue);
                         string atom_name = prep_atom->GetName();
                         assembly_atom->SetName(atom_name);
-                        stringstream atom_id;
-                        atom_id << atom_name << "_" << serial_number << "_" << id.str();
-                        assembly_atom->SetId(atom_id.str());                        
+                        assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
 
                         assembly_atom->MolecularDynamicAtom::SetAtomType(prep_atom->GetType());
                         assembly_atom->MolecularDynamicAtom::SetCharge(prep_atom->GetCharge());
@@ -504,18 +502,19 @@ Assembly::AssemblyVector Assembly::BuildAllRotamersFromCondensedSequence(string
                                 coordinate_list.push_back(grandparent_coordinate);
                                 coordinate_list.push_back(parent_coordinate);
                             }
-                            Coordinate* coordinate = new Coordinate();
-                            coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
-                                                                                             prep_atom->GetAngle(), prep_atom->GetDihedral());
+                            Coordinate* cartesian_coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
+                                                                                                                       prep_atom->GetAngle(), prep_atom->GetDihedral());
+                            Coordinate* coordinate = structures.at(i)->CreateCoordinate(*cartesian_coordinate);
+                            delete cartesian_coordinate;
                             cartesian_coordinate_list.push_back(coordinate);
 
                             assembly_atom->AddCoordinate(coordinate);
                         }
                         else if(prep_residue->GetCoordinateType() == PrepFileSpace::kXYZ)
                         {
-                            assembly_atom->AddCoordinate(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
+                            assembly_atom->AddCoordinate(structures.at(i)->CreateCoordinate(Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral())));
                         }
-                        if(assembly_atom->GetAtomType().compare("DU") != 0)
+                        if(assembly_atom->GetAtomTypeSymbol() != dummy_type)
                             assembly_residue->AddAtom(assembly_atom);
                         if(atom_name.compare(amber_prep_residue->GetAnomericCarbon()) == 0)
                             assembly_residue->AddHeadAtom(assembly_atom);
@@ -529,8 +528,11 @@ Assembly::AssemblyVector Assembly::BuildAllRotamersFromCondensedSequence(string
                         temp_assembly->SetResidues(temp_assembly_residues);
                         temp_assembly->SetSourceFile(prep_file);
                         temp_assembly->BuildStructureByPrepFileInformation();
+                        //The atom nodes of the residue have been created by the temporary assembly
+                        structures.at(i)->ShareStorage(temp_assembly);
+                        delete temp_assembly;
                     }
-                    structures.at(i)->residues_.push_back(assembly_residue);
+                    structures.at(i)->AddResidue(assembly_residue);
                     if(amber_prep_residue->GetParentId() != -1)
                     {
                         Residue* parent_residue = structures.at(i)->residues_.at(amber_prep_residue->GetParentId());
@@ -631,6 +633,7 @@ Assembly::AssemblyVector Assembly::BuildAllRotamersFromCondensedSequence(string
                 }
             }
         }
+        delete parameter;
         return structures;
     }
     catch(exception ex)
@@ -681,7 +684,7 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
         {
             string residue_key = *it;
             PdbFile::PdbAtomVector* atoms = residue_atoms_map[residue_key];
-            Residue* residue = new Residue();
+            Residue* residue = this->CreateResidue();
             residue->SetAssembly(this);
 
             for(PdbFile::PdbAtomVector::iterator it1 = atoms->begin(); it1 != atoms->end(); it1++)
@@ -692,13 +695,9 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
                 int sequence_number = atom->GetAtomResidueSequenceNumber();
                 char insertion_code = atom->GetAtomInsertionCode();
                 char alternate_location = atom->GetAtomAlternateLocation();
-                stringstream ss;
-                ss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code << "_"
-                   << alternate_location << "_" << id_;
-                string key = ss.str();
-                residue->SetId(key);
+                residue->SetIdentity(residue_name, chain_id, sequence_number, insertion_code, alternate_location, id_);
 
-                Atom* new_atom = new Atom();
+                Atom* new_atom = this->CreateAtom();
                 residue->SetName(residue_name);
                 string atom_name = atom->GetAtomName();
                 new_atom->SetName(atom_name);
@@ -780,14 +779,12 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
                     }
                 }
                 new_atom->SetResidue(residue);
-                stringstream atom_key;
-                atom_key << atom_name << "_" << atom->GetAtomSerialNumber() << "_" << key;
-                new_atom->SetId(atom_key.str());
+                new_atom->SetIdentity(atom_name, atom->GetAtomSerialNumber(), residue->GetIdentity());
                 PdbModelCard* models = pdb_file->GetModels();
                 PdbModelCard::PdbModelMap model_maps = models->GetModels();
                 if(model_maps.size() == 1)
                 {
-                    new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
+                    new_atom->AddCoordinate(this->CreateCoordinate(atom->GetAtomOrthogonalCoordinate()));
                     vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
                     if(card_index.at(0).compare("ATOM") == 0)
                     {
@@ -802,6 +799,7 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
                 {
                     for(PdbModelCard::PdbModelMap::iterator it2 = model_maps.begin(); it2 != model_maps.end(); it2++)
                     {
+                        int model_index = distance(model_maps.begin(), it2);
                         PdbModel* model = (*it2).second;
                         PdbModelResidueSet* residue_set = model->GetModelResidueSet();
                         PdbModelResidueSet::AtomCardVector atom_cards = residue_set->GetAtoms();
@@ -818,14 +816,10 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
                                 int matching_sequence_number = matching_atom->GetAtomResidueSequenceNumber();
                                 char matching_insertion_code = matching_atom->GetAtomInsertionCode();
                                 char matching_alternate_location = matching_atom->GetAtomAlternateLocation();
-                                stringstream sss;
-                                sss << matching_residue_name << "_" << matching_chain_id << "_" << matching_sequence_number << "_"
-                                    << matching_insertion_code << "_" << matching_alternate_location << "_" << id_;
-                                string matching_key = sss.str();
-
-                                if(key.compare(matching_key) == 0)
+                                if(matching_residue_name.compare(residue_name) == 0 && matching_chain_id == chain_id && matching_sequence_number == sequence_number &&
+                                        matching_insertion_code == insertion_code && matching_alternate_location == alternate_location)
                                 {
-                                    GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_atom->GetAtomOrthogonalCoordinate());
+                                    GeometryTopology::Coordinate* coordinate = this->CreateCoordinate(matching_atom->GetAtomOrthogonalCoordinate(), model_index);
                                     new_atom->AddCoordinate(coordinate);
                                     new_atom->SetDescription("Atom;");
                                 }
@@ -844,14 +838,10 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
                                 int matching_heterogen_sequence_number = matching_heterogen_atom->GetAtomResidueSequenceNumber();
                                 char matching_heterogen_insertion_code = matching_heterogen_atom->GetAtomInsertionCode();
                                 char matching_heterogen_alternate_location = matching_heterogen_atom->GetAtomAlternateLocation();
-                                stringstream ssss;
-                                ssss << matching_heterogen_residue_name << "_" << matching_heterogen_chain_id << "_" << matching_heterogen_sequence_number << "_"
-                                     << matching_heterogen_insertion_code << "_" << matching_heterogen_alternate_location << "_" << id_;
-                                string matching_heterogen_key = ssss.str();
-
-                                if(key.compare(matching_heterogen_key) == 0)
+                                if(matching_heterogen_residue_name.compare(residue_name) == 0 && matching_heterogen_chain_id == chain_id && matching_heterogen_sequence_number == sequence_number &&
+                                        matching_heterogen_insertion_code == insertion_code && matching_heterogen_alternate_location == alternate_location)
                                 {
-                                    GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_heterogen_atom->GetAtomOrthogonalCoordinate());
+                                    GeometryTopology::Coordinate* coordinate = this->CreateCoordinate(matching_heterogen_atom->GetAtomOrthogonalCoordinate(), model_index);
                                     new_atom->AddCoordinate(coordinate);
                                     new_atom->SetDescription("Het;");
                                 }
@@ -863,6 +853,7 @@ void Assembly::BuildAssemblyFromPdbFile(string pdb_file_path, vector<string> ami
             }
             this->AddResidue(residue);
         }
+        delete parameter;
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
@@ -909,7 +900,7 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
         {
             string residue_key = *it;
             PdbFile::PdbAtomVector* atoms = residue_atoms_map[residue_key];
-            Residue* residue = new Residue();
+            Residue* residue = this->CreateResidue();
             residue->SetAssembly(this);
 
             for(PdbFile::PdbAtomVector::iterator it1 = atoms->begin(); it1 != atoms->end(); it1++)
@@ -920,13 +911,9 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
                 int sequence_number = atom->GetAtomResidueSequenceNumber();
                 char insertion_code = atom->GetAtomInsertionCode();
                 char alternate_location = atom->GetAtomAlternateLocation();
-                stringstream ss;
-                ss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code << "_"
-                   << alternate_location << "_" << id_;
-                string key = ss.str();
-                residue->SetId(key);
+                residue->SetIdentity(residue_name, chain_id, sequence_number, insertion_code, alternate_location, id_);
 
-                Atom* new_atom = new Atom();
+                Atom* new_atom = this->CreateAtom();
                 residue->SetName(residue_name);
                 string atom_name = atom->GetAtomName();
                 new_atom->SetName(atom_name);
@@ -1008,14 +995,12 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
                     }
                 }
                 new_atom->SetResidue(residue);
-                stringstream atom_key;
-                atom_key << atom_name << "_" << atom->GetAtomSerialNumber() << "_" << key;
-                new_atom->SetId(atom_key.str());
+                new_atom->SetIdentity(atom_name, atom->GetAtomSerialNumber(), residue->GetIdentity());
                 PdbModelCard* models = pdb_file->GetModels();
                 PdbModelCard::PdbModelMap model_maps = models->GetModels();
                 if(model_maps.size() == 1)
                 {
-                    new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
+                    new_atom->AddCoordinate(this->CreateCoordinate(atom->GetAtomOrthogonalCoordinate()));
                     vector<string> card_index = gmml::Split(atom->GetAtomCardIndexInResidueSet(), "_");
                     if(card_index.at(0).compare("ATOM") == 0)
                     {
@@ -1030,6 +1015,7 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
                 {
                     for(PdbModelCard::PdbModelMap::iterator it2 = model_maps.begin(); it2 != model_maps.end(); it2++)
                     {
+                        int model_index = distance(model_maps.begin(), it2);
                         PdbModel* model = (*it2).second;
                         PdbModelResidueSet* residue_set = model->GetModelResidueSet();
                         PdbModelResidueSet::AtomCardVector atom_cards = residue_set->GetAtoms();
@@ -1046,14 +1032,10 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
                                 int matching_sequence_number = matching_atom->GetAtomResidueSequenceNumber();
                                 char matching_insertion_code = matching_atom->GetAtomInsertionCode();
                                 char matching_alternate_location = matching_atom->GetAtomAlternateLocation();
-                                stringstream sss;
-                                sss << matching_residue_name << "_" << matching_chain_id << "_" << matching_sequence_number << "_"
-                                    << matching_insertion_code << "_" << matching_alternate_location << "_" << id_;
-                                string matching_key = sss.str();
-
-                                if(key.compare(matching_key) == 0)
+                                if(matching_residue_name.compare(residue_name) == 0 && matching_chain_id == chain_id && matching_sequence_number == sequence_number &&
+                                        matching_insertion_code == insertion_code && matching_alternate_location == alternate_location)
                                 {
-                                    GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_atom->GetAtomOrthogonalCoordinate());
+                                    GeometryTopology::Coordinate* coordinate = this->CreateCoordinate(matching_atom->GetAtomOrthogonalCoordinate(), model_index);
                                     new_atom->AddCoordinate(coordinate);
                                     new_atom->SetDescription("Atom;");
                                 }
@@ -1072,14 +1054,10 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
                                 int matching_heterogen_sequence_number = matching_heterogen_atom->GetAtomResidueSequenceNumber();
                                 char matching_heterogen_insertion_code = matching_heterogen_atom->GetAtomInsertionCode();
                                 char matching_heterogen_alternate_location = matching_heterogen_atom->GetAtomAlternateLocation();
-                                stringstream ssss;
-                                ssss << matching_heterogen_residue_name << "_" << matching_heterogen_chain_id << "_" << matching_heterogen_sequence_number << "_"
-                                     << matching_heterogen_insertion_code << "_" << matching_heterogen_alternate_location << "_" << id_;
-                                string matching_heterogen_key = ssss.str();
-
-                                if(key.compare(matching_heterogen_key) == 0)
+                                if(matching_heterogen_residue_name.compare(residue_name) == 0 && matching_heterogen_chain_id == chain_id && matching_heterogen_sequence_number == sequence_number &&
+                                        matching_heterogen_insertion_code == insertion_code && matching_heterogen_alternate_location == alternate_location)
                                 {
-                                    GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_heterogen_atom->GetAtomOrthogonalCoordinate());
+                                    GeometryTopology::Coordinate* coordinate = this->CreateCoordinate(matching_heterogen_atom->GetAtomOrthogonalCoordinate(), model_index);
                                     new_atom->AddCoordinate(coordinate);
                                     new_atom->SetDescription("Het;");
                                 }
@@ -1091,6 +1069,7 @@ void Assembly::BuildAssemblyFromPdbFile(PdbFile *pdb_file, vector<string> amino_
             }
             this->AddResidue(residue);
         }
+        delete parameter;
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
@@ -1117,7 +1096,7 @@ void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string paramet
         {
             string residue_key = *it;
             PdbqtFile::PdbqtAtomVector* atoms = residue_atoms_map[residue_key];
-            Residue* residue = new Residue();
+            Residue* residue = this->CreateResidue();
             residue->SetAssembly(this);
 
             for(PdbqtFile::PdbqtAtomVector::iterator it1 = atoms->begin(); it1 != atoms->end(); it1++)
@@ -1128,13 +1107,9 @@ void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string paramet
                 int sequence_number = atom->GetAtomResidueSequenceNumber();
                 char insertion_code = atom->GetAtomInsertionCode();
                 char alternate_location = atom->GetAtomAlternateLocation();
-                stringstream ss;
-                ss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code << "_"
-                   << alternate_location << "_" << id_;
-                string key = ss.str();
-                residue->SetId(key);
+                residue->SetIdentity(residue_name, chain_id, sequence_number, insertion_code, alternate_location, id_);
 
-                Atom* new_atom = new Atom();
+                Atom* new_atom = this->CreateAtom();
                 residue->SetName(residue_name);
                 string atom_name = atom->GetAtomName();
                 new_atom->SetName(atom_name);
@@ -1160,14 +1135,12 @@ void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string paramet
                     new_atom->MolecularDynamicAtom::SetRadius(dNotSet);
                 }
                 new_atom->SetResidue(residue);
-                stringstream atom_key;
-                atom_key << atom_name << "_" << atom->GetAtomSerialNumber() << "_" << key;
-                new_atom->SetId(atom_key.str());
+                new_atom->SetIdentity(atom_name, atom->GetAtomSerialNumber(), residue->GetIdentity());
                 PdbqtModelCard* models = pdbqt_file->GetModels();
                 PdbqtModelCard::PdbqtModelMap model_maps = models->GetModels();
                 if(model_maps.size() == 1)
                 {
-                    new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
+                    new_atom->AddCoordinate(this->CreateCoordinate(atom->GetAtomOrthogonalCoordinate()));
                     if(atom->GetType().compare("ATOM") == 0)
                     {
                         new_atom->SetDescription("Atom;");
@@ -1181,6 +1154,7 @@ void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string paramet
                 {
                     for(PdbqtModelCard::PdbqtModelMap::iterator it2 = model_maps.begin(); it2 != model_maps.end(); it2++)
                     {
+                        int model_index = distance(model_maps.begin(), it2);
                         PdbqtModel* model = (*it2).second;
                         PdbqtModelResidueSet* residue_set = model->GetModelResidueSet();
                         PdbqtAtomCard* atom_card = residue_set->GetAtoms();
@@ -1191,14 +1165,10 @@ void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string paramet
                         int matching_sequence_number = matching_atom->GetAtomResidueSequenceNumber();
                         char matching_insertion_code = matching_atom->GetAtomInsertionCode();
                         char matching_alternate_location = matching_atom->GetAtomAlternateLocation();
-                        stringstream sss;
-                        sss << matching_residue_name << "_" << matching_chain_id << "_" << matching_sequence_number << "_"
-                            << matching_insertion_code << "_" << matching_alternate_location << "_" << id_;
-                        string matching_key = sss.str();
-
-                        if(key.compare(matching_key) == 0)
+                        if(matching_residue_name.compare(residue_name) == 0 && matching_chain_id == chain_id && matching_sequence_number == sequence_number &&
+                                matching_insertion_code == insertion_code && matching_alternate_location == alternate_location)
                         {
-                            GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_atom->GetAtomOrthogonalCoordinate());
+                            GeometryTopology::Coordinate* coordinate = this->CreateCoordinate(matching_atom->GetAtomOrthogonalCoordinate(), model_index);
                             new_atom->AddCoordinate(coordinate);
                             if(atom->GetType().compare("ATOM") == 0)
                             {
@@ -1215,6 +1185,7 @@ void Assembly::BuildAssemblyFromPdbqtFile(string pdbqt_file_path, string paramet
             }
             this->AddResidue(residue);
         }
+        delete parameter;
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
@@ -1240,7 +1211,7 @@ void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string paramete
         {
             string residue_key = *it;
             PdbqtFile::PdbqtAtomVector* atoms = residue_atoms_map[residue_key];
-            Residue* residue = new Residue();
+            Residue* residue = this->CreateResidue();
             residue->SetAssembly(this);
 
             for(PdbqtFile::PdbqtAtomVector::iterator it1 = atoms->begin(); it1 != atoms->end(); it1++)
@@ -1251,13 +1222,9 @@ void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string paramete
                 int sequence_number = atom->GetAtomResidueSequenceNumber();
                 char insertion_code = atom->GetAtomInsertionCode();
                 char alternate_location = atom->GetAtomAlternateLocation();
-                stringstream ss;
-                ss << residue_name << "_" << chain_id << "_" << sequence_number << "_" << insertion_code << "_"
-                   << alternate_location << "_" << id_;
-                string key = ss.str();
-                residue->SetId(key);
+                residue->SetIdentity(residue_name, chain_id, sequence_number, insertion_code, alternate_location, id_);
 
-                Atom* new_atom = new Atom();
+                Atom* new_atom = this->CreateAtom();
                 residue->SetName(residue_name);
                 string atom_name = atom->GetAtomName();
                 new_atom->SetName(atom_name);
@@ -1283,14 +1250,12 @@ void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string paramete
                     new_atom->MolecularDynamicAtom::SetRadius(dNotSet);
                 }
                 new_atom->SetResidue(residue);
-                stringstream atom_key;
-                atom_key << atom_name << "_" << atom->GetAtomSerialNumber() << "_" << key;
-                new_atom->SetId(atom_key.str());
+                new_atom->SetIdentity(atom_name, atom->GetAtomSerialNumber(), residue->GetIdentity());
                 PdbqtModelCard* models = pdbqt_file->GetModels();
                 PdbqtModelCard::PdbqtModelMap model_maps = models->GetModels();
                 if(model_maps.size() == 1)
                 {
-                    new_atom->AddCoordinate(new GeometryTopology::Coordinate(atom->GetAtomOrthogonalCoordinate()));
+                    new_atom->AddCoordinate(this->CreateCoordinate(atom->GetAtomOrthogonalCoordinate()));
                     if(atom->GetType().compare("ATOM") == 0)
                     {
                         new_atom->SetDescription("Atom;");
@@ -1304,6 +1269,7 @@ void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string paramete
                 {
                     for(PdbqtModelCard::PdbqtModelMap::iterator it2 = model_maps.begin(); it2 != model_maps.end(); it2++)
                     {
+                        int model_index = distance(model_maps.begin(), it2);
                         PdbqtModel* model = (*it2).second;
                         PdbqtModelResidueSet* residue_set = model->GetModelResidueSet();
                         PdbqtAtomCard* atom_card = residue_set->GetAtoms();
@@ -1314,14 +1280,10 @@ void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string paramete
                         int matching_sequence_number = matching_atom->GetAtomResidueSequenceNumber();
                         char matching_insertion_code = matching_atom->GetAtomInsertionCode();
                         char matching_alternate_location = matching_atom->GetAtomAlternateLocation();
-                        stringstream sss;
-                        sss << matching_residue_name << "_" << matching_chain_id << "_" << matching_sequence_number << "_"
-                            << matching_insertion_code << "_" << matching_alternate_location << "_" << id_;
-                        string matching_key = sss.str();
-
-                        if(key.compare(matching_key) == 0)
+                        if(matching_residue_name.compare(residue_name) == 0 && matching_chain_id == chain_id && matching_sequence_number == sequence_number &&
+                                matching_insertion_code == insertion_code && matching_alternate_location == alternate_location)
                         {
-                            GeometryTopology::Coordinate* coordinate = new GeometryTopology::Coordinate(matching_atom->GetAtomOrthogonalCoordinate());
+                            GeometryTopology::Coordinate* coordinate = this->CreateCoordinate(matching_atom->GetAtomOrthogonalCoordinate(), model_index);
                             new_atom->AddCoordinate(coordinate);
                             if(atom->GetType().compare("ATOM") == 0)
                             {
@@ -1338,6 +1300,7 @@ void Assembly::BuildAssemblyFromPdbqtFile(PdbqtFile *pdbqt_file, string paramete
             }
             this->AddResidue(residue);
         }
+        delete parameter;
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
@@ -1362,27 +1325,22 @@ void Assembly::BuildAssemblyFromTopologyFile(string topology_file_path, string p
     TopologyAssembly::TopologyResidueVector topology_residues = topology_file->GetAssembly()->GetResidues();
     for(TopologyAssembly::TopologyResidueVector::iterator it = topology_residues.begin(); it != topology_residues.end(); it++)
     {
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         TopologyResidue* topology_residue = (*it);
         string residue_name = topology_residue->GetResidueName();
         assembly_residue->SetName(residue_name);
-        stringstream id;
-        id << residue_name << "_" << gmml::BLANK_SPACE << "_" << topology_residue->GetIndex() << "_" << gmml::BLANK_SPACE << "_"
-           << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(residue_name, gmml::BLANK_SPACE, topology_residue->GetIndex(), gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
 
         TopologyResidue::TopologyAtomVector topology_atoms = topology_residue->GetAtoms();
 
         for(TopologyResidue::TopologyAtomVector::iterator it1 = topology_atoms.begin(); it1 != topology_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             string atom_name = (*it1)->GetAtomName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << serial_number << "_" << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
             TopologyAtom* topology_atom = (*it1);
             assembly_atom->MolecularDynamicAtom::SetCharge(topology_atom->GetAtomCharge() / CHARGE_DIVIDER);
             assembly_atom->MolecularDynamicAtom::SetMass(topology_atom->GetAtomMass());
@@ -1411,6 +1369,7 @@ void Assembly::BuildAssemblyFromTopologyFile(string topology_file_path, string p
         this->AddResidue(assembly_residue);
 
     }
+    delete parameter;
 }
 
 void Assembly::BuildAssemblyFromTopologyFile(TopologyFile *topology_file, string parameter_file)
@@ -1431,27 +1390,22 @@ void Assembly::BuildAssemblyFromTopologyFile(TopologyFile *topology_file, string
     TopologyAssembly::TopologyResidueVector topology_residues = topology_file->GetAssembly()->GetResidues();
     for(TopologyAssembly::TopologyResidueVector::iterator it = topology_residues.begin(); it != topology_residues.end(); it++)
     {
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         TopologyResidue* topology_residue = (*it);
         string residue_name = topology_residue->GetResidueName();
         assembly_residue->SetName(residue_name);
-        stringstream id;
-        id << residue_name << "_" << gmml::BLANK_SPACE << "_" << topology_residue->GetIndex()
-           << "_" << gmml::BLANK_SPACE << "_" << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(residue_name, gmml::BLANK_SPACE, topology_residue->GetIndex(), gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
 
         TopologyResidue::TopologyAtomVector topology_atoms = topology_residue->GetAtoms();
 
         for(TopologyResidue::TopologyAtomVector::iterator it1 = topology_atoms.begin(); it1 != topology_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             string atom_name = (*it1)->GetAtomName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << serial_number << "_" << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
             TopologyAtom* topology_atom = (*it1);
             assembly_atom->MolecularDynamicAtom::SetCharge(topology_atom->GetAtomCharge() / CHARGE_DIVIDER);
             assembly_atom->MolecularDynamicAtom::SetMass(topology_atom->GetAtomMass());
@@ -1480,6 +1434,7 @@ void Assembly::BuildAssemblyFromTopologyFile(TopologyFile *topology_file, string
         this->AddResidue(assembly_residue);
 
     }
+    delete parameter;
 }
 
 void Assembly::BuildAssemblyFromLibraryFile(string library_file_path, string parameter_file)
@@ -1504,14 +1459,11 @@ void Assembly::BuildAssemblyFromLibraryFile(string library_file_path, string par
     for(LibraryFile::ResidueMap::iterator it = library_residues.begin(); it != library_residues.end(); it++)
     {
         sequence_number++;
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         string residue_name = (*it).first;
         assembly_residue->SetName(residue_name);
-        stringstream id;
-        id << residue_name << "_" << gmml::BLANK_SPACE << "_" << sequence_number << "_" << gmml::BLANK_SPACE << "_"
-           << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(residue_name, gmml::BLANK_SPACE, sequence_number, gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
         LibraryFileResidue* library_residue = (*it).second;
         int lib_res_tail_atom_index = library_residue->GetTailAtomIndex();
         int lib_res_head_atom_index = library_residue->GetHeadAtomIndex();
@@ -1526,13 +1478,11 @@ void Assembly::BuildAssemblyFromLibraryFile(string library_file_path, string par
         for(LibraryFileResidue::AtomMap::iterator it1 = library_atoms.begin(); it1 != library_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             LibraryFileAtom* library_atom = (*it1).second;
             string atom_name = library_atom->GetName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << library_atom->GetAtomOrder() << "_" << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, library_atom->GetAtomOrder(), assembly_residue->GetIdentity());
 
             assembly_atom->SetResidue(assembly_residue);
             assembly_atom->SetName(library_atom->GetName());
@@ -1559,7 +1509,7 @@ void Assembly::BuildAssemblyFromLibraryFile(string library_file_path, string par
                 assembly_atom->MolecularDynamicAtom::SetRadius(dNotSet);
             }
 
-            Coordinate* coordinate = new Coordinate(library_atom->GetCoordinate());
+            Coordinate* coordinate = this->CreateCoordinate(library_atom->GetCoordinate());
             assembly_atom->AddCoordinate(coordinate);
             assembly_residue->AddAtom(assembly_atom);
 
@@ -1568,9 +1518,11 @@ void Assembly::BuildAssemblyFromLibraryFile(string library_file_path, string par
             if(library_atom->GetAtomIndex() == lib_res_tail_atom_index)
                 assembly_residue->AddTailAtom(assembly_atom);
         }
-        residues_.push_back(assembly_residue);
+        this->AddResidue(assembly_residue);
     }
     name_ = ss.str();
+    delete parameter;
+    delete library_file;
 }
 
 void Assembly::BuildAssemblyFromLibraryFile(LibraryFile *library_file, string parameter_file)
@@ -1594,14 +1546,11 @@ void Assembly::BuildAssemblyFromLibraryFile(LibraryFile *library_file, string pa
     for(LibraryFile::ResidueMap::iterator it = library_residues.begin(); it != library_residues.end(); it++)
     {
         sequence_number++;
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         string residue_name = (*it).first;
         assembly_residue->SetName(residue_name);
-        stringstream id;
-        id << residue_name << "_" << gmml::BLANK_SPACE << "_" << sequence_number << "_" << gmml::BLANK_SPACE << "_"
-           << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(residue_name, gmml::BLANK_SPACE, sequence_number, gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
         LibraryFileResidue* library_residue = (*it).second;
         int lib_res_tail_atom_index = library_residue->GetTailAtomIndex();
         int lib_res_head_atom_index = library_residue->GetHeadAtomIndex();
@@ -1616,13 +1565,11 @@ void Assembly::BuildAssemblyFromLibraryFile(LibraryFile *library_file, string pa
         for(LibraryFileResidue::AtomMap::iterator it1 = library_atoms.begin(); it1 != library_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             LibraryFileAtom* library_atom = (*it1).second;
             string atom_name = library_atom->GetName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << library_atom->GetAtomOrder() << "_" << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, library_atom->GetAtomOrder(), assembly_residue->GetIdentity());
 
             assembly_atom->SetResidue(assembly_residue);
             assembly_atom->SetName(library_atom->GetName());
@@ -1649,7 +1596,7 @@ void Assembly::BuildAssemblyFromLibraryFile(LibraryFile *library_file, string pa
                 assembly_atom->MolecularDynamicAtom::SetRadius(dNotSet);
             }
 
-            Coordinate* coordinate = new Coordinate(library_atom->GetCoordinate());
+            Coordinate* coordinate = this->CreateCoordinate(library_atom->GetCoordinate());
             assembly_atom->AddCoordinate(coordinate);
             assembly_residue->AddAtom(assembly_atom);
 
@@ -1658,9 +1605,10 @@ void Assembly::BuildAssemblyFromLibraryFile(LibraryFile *library_file, string pa
             if(library_atom->GetAtomIndex() == lib_res_tail_atom_index)
                 assembly_residue->AddTailAtom(assembly_atom);
         }
-        residues_.push_back(assembly_residue);
+        this->AddResidue(assembly_residue);
     }
     name_ = ss.str();
+    delete parameter;
 }
 
 void Assembly::BuildAssemblyFromTopologyCoordinateFile(string topology_file_path, string coordinate_file_path, string parameter_file)
@@ -1669,6 +1617,8 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(string topology_file_path
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building assembly from topology and coordinate files ...");
     this->ClearAssembly();
     TopologyFile* topology_file = new TopologyFile(topology_file_path);
+    CoordinateFile* coordinate_file = new CoordinateFile(coordinate_file_path);
+    vector<GeometryTopology::Coordinate*> coord_file_coordinates = coordinate_file->GetCoordinates();
     ParameterFile* parameter = NULL;
     ParameterFile::AtomTypeMap atom_type_map = ParameterFile::AtomTypeMap();
     if(parameter_file.compare("") != 0)
@@ -1682,27 +1632,22 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(string topology_file_path
     TopologyAssembly::TopologyResidueVector topology_residues = topology_file->GetAssembly()->GetResidues();
     for(TopologyAssembly::TopologyResidueVector::iterator it = topology_residues.begin(); it != topology_residues.end(); it++)
     {
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         TopologyResidue* topology_residue = (*it);
         string residue_name = topology_residue->GetResidueName();
         assembly_residue->SetName(residue_name);
-        stringstream id;
-        id << residue_name << "_" << gmml::BLANK_SPACE << "_" << topology_residue->GetIndex() << "_" << gmml::BLANK_SPACE << "_"
-           << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(residue_name, gmml::BLANK_SPACE, topology_residue->GetIndex(), gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
 
         TopologyResidue::TopologyAtomVector topology_atoms = topology_residue->GetAtoms();
 
         for(TopologyResidue::TopologyAtomVector::iterator it1 = topology_atoms.begin(); it1 != topology_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             string atom_name = (*it1)->GetAtomName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << serial_number << "_" << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
             TopologyAtom* topology_atom = (*it1);
 
             assembly_atom->MolecularDynamicAtom::SetCharge(topology_atom->GetAtomCharge() / CHARGE_DIVIDER);
@@ -1730,13 +1675,19 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(string topology_file_path
             assembly_atom->SetResidue(assembly_residue);
             assembly_atom->SetName(topology_atom->GetAtomName());
 
-            CoordinateFile* coordinate_file = new CoordinateFile(coordinate_file_path);
-            vector<GeometryTopology::Coordinate*> coord_file_coordinates = coordinate_file->GetCoordinates();
-            assembly_atom->AddCoordinate(coord_file_coordinates.at(topology_atom_index-1));
+            assembly_atom->AddCoordinate(this->CreateCoordinate(*(coord_file_coordinates.at(topology_atom_index-1))));
             assembly_residue->AddAtom(assembly_atom);
         }
-        residues_.push_back(assembly_residue);
+        this->AddResidue(assembly_residue);
     }
+    /// The periodic box of the restart file is preferred; the topology file only records a single angle
+    vector<double> box_dimensions = coordinate_file->GetBoxDimensions();
+    vector<double> topology_box_dimensions = topology_file->GetBoxDimensions();
+    if(box_dimensions.size() == 6)
+        this->SetBoxDimensions(box_dimensions.at(0), box_dimensions.at(1), box_dimensions.at(2), box_dimensions.at(3));
+    else if(topology_box_dimensions.size() == 4)
+        this->SetBoxDimensions(topology_box_dimensions.at(1), topology_box_dimensions.at(2), topology_box_dimensions.at(3), topology_box_dimensions.at(0));
+    delete parameter;
 }
 
 void Assembly::BuildAssemblyFromTopologyCoordinateFile(TopologyFile *topology_file, CoordinateFile *coordinate_file, string parameter_file)
@@ -1758,27 +1709,22 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(TopologyFile *topology_fi
     TopologyAssembly::TopologyResidueVector topology_residues = topology_file->GetAssembly()->GetResidues();
     for(TopologyAssembly::TopologyResidueVector::iterator it = topology_residues.begin(); it != topology_residues.end(); it++)
     {
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         TopologyResidue* topology_residue = (*it);
         string residue_name = topology_residue->GetResidueName();
         assembly_residue->SetName(residue_name);
-        stringstream id;
-        id << residue_name << "_" << gmml::BLANK_SPACE << "_" << topology_residue->GetIndex() << "_" << gmml::BLANK_SPACE << "_"
-           << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(residue_name, gmml::BLANK_SPACE, topology_residue->GetIndex(), gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
 
         TopologyResidue::TopologyAtomVector topology_atoms = topology_residue->GetAtoms();
 
         for(TopologyResidue::TopologyAtomVector::iterator it1 = topology_atoms.begin(); it1 != topology_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             string atom_name = (*it1)->GetAtomName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << serial_number << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
             TopologyAtom* topology_atom = (*it1);
 
             assembly_atom->MolecularDynamicAtom::SetCharge(topology_atom->GetAtomCharge() / CHARGE_DIVIDER);
@@ -1807,11 +1753,19 @@ void Assembly::BuildAssemblyFromTopologyCoordinateFile(TopologyFile *topology_fi
             assembly_atom->SetName(topology_atom->GetAtomName());
 
             vector<GeometryTopology::Coordinate*> coord_file_coordinates = coordinate_file->GetCoordinates();
-            assembly_atom->AddCoordinate(coord_file_coordinates.at(topology_atom_index-1));
+            assembly_atom->AddCoordinate(this->CreateCoordinate(*(coord_file_coordinates.at(topology_atom_index-1))));
             assembly_residue->AddAtom(assembly_atom);
         }
-        residues_.push_back(assembly_residue);
+        this->AddResidue(assembly_residue);
     }
+    /// The periodic box of the restart file is preferred; the topology file only records a single angle
+    vector<double> box_dimensions = coordinate_file->GetBoxDimensions();
+    vector<double> topology_box_dimensions = topology_file->GetBoxDimensions();
+    if(box_dimensions.size() == 6)
+        this->SetBoxDimensions(box_dimensions.at(0), box_dimensions.at(1), box_dimensions.at(2), box_dimensions.at(3));
+    else if(topology_box_dimensions.size() == 4)
+        this->SetBoxDimensions(topology_box_dimensions.at(1), topology_box_dimensions.at(2), topology_box_dimensions.at(3), topology_box_dimensions.at(0));
+    delete parameter;
 }
 
 void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter_file)
@@ -1827,6 +1781,7 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
         parameter = new ParameterFile(parameter_file);
         atom_type_map = parameter->GetAtomTypes();
     }
+    SymbolTable::Symbol dummy_type = SymbolTable::Intern("DU");
     sequence_number_ = 1;
     PrepFile::ResidueMap prep_residues = prep_file->GetResidues();
     stringstream ss;
@@ -1839,18 +1794,15 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
         CoordinateVector cartesian_coordinate_list = CoordinateVector();
         int head_atom_index = INFINITY;
         int tail_atom_index = -INFINITY;
-        Atom* head_atom = new Atom();
-        Atom* tail_atom = new Atom();
+        Atom* head_atom = this->CreateAtom();
+        Atom* tail_atom = this->CreateAtom();
 
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         PrepFileResidue* prep_residue = (*it).second;
         string prep_residue_name = prep_residue->GetName();
         assembly_residue->SetName(prep_residue_name);
-        stringstream id;
-        id << prep_residue_name << "_" << gmml::BLANK_SPACE << "_" << sequence_number << "_" << gmml::BLANK_SPACE << "_"
-           << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(prep_residue_name, gmml::BLANK_SPACE, sequence_number, gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
         if(distance(prep_residues.begin(), it) == (int)prep_residues.size()-1)
             ss << prep_residue_name;
         else
@@ -1860,14 +1812,12 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
         for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             PrepFileAtom* prep_atom = (*it1);
             assembly_atom->SetResidue(assembly_residue);
             string atom_name = prep_atom->GetName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << serial_number << "_" << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
 
             assembly_atom->MolecularDynamicAtom::SetAtomType(prep_atom->GetType());
             assembly_atom->MolecularDynamicAtom::SetCharge(prep_atom->GetCharge());
@@ -1926,16 +1876,17 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
                     coordinate_list.push_back(grandparent_coordinate);
                     coordinate_list.push_back(parent_coordinate);
                 }
-                Coordinate* coordinate = new Coordinate();
-                coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
-                                                                                 prep_atom->GetAngle(), prep_atom->GetDihedral());
+                Coordinate* cartesian_coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
+                                                                                                           prep_atom->GetAngle(), prep_atom->GetDihedral());
+                Coordinate* coordinate = this->CreateCoordinate(*cartesian_coordinate);
+                delete cartesian_coordinate;
                 cartesian_coordinate_list.push_back(coordinate);
 
                 assembly_atom->AddCoordinate(coordinate);
             }
             else if(prep_residue->GetCoordinateType() == PrepFileSpace::kXYZ)
             {
-                assembly_atom->AddCoordinate(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
+                assembly_atom->AddCoordinate(this->CreateCoordinate(Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral())));
             }
             if(prep_atom->GetTopologicalType() == kTopTypeM && prep_atom->GetType().compare(prep_residue->GetDummyAtomType()) != 0)
             {
@@ -1950,14 +1901,15 @@ void Assembly::BuildAssemblyFromPrepFile(string prep_file_path, string parameter
                     tail_atom = assembly_atom;
                 }
             }
-            if(assembly_atom->GetAtomType().compare("DU") != 0)
+            if(assembly_atom->GetAtomTypeSymbol() != dummy_type)
                 assembly_residue->AddAtom(assembly_atom);
         }
         assembly_residue->AddHeadAtom(head_atom);
         assembly_residue->AddTailAtom(tail_atom);
-        residues_.push_back(assembly_residue);
+        this->AddResidue(assembly_residue);
     }
     name_ = ss.str();
+    delete parameter;
 }
 
 void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_file)
@@ -1972,6 +1924,7 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
         parameter = new ParameterFile(parameter_file);
         atom_type_map = parameter->GetAtomTypes();
     }
+    SymbolTable::Symbol dummy_type = SymbolTable::Intern("DU");
     sequence_number_ = 1;
     PrepFile::ResidueMap prep_residues = prep_file->GetResidues();
     stringstream ss;
@@ -1984,17 +1937,14 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
         CoordinateVector cartesian_coordinate_list = CoordinateVector();
         int head_atom_index = INFINITY;
         int tail_atom_index = -INFINITY;
-        Atom* head_atom = new Atom();
-        Atom* tail_atom = new Atom();
+        Atom* head_atom = this->CreateAtom();
+        Atom* tail_atom = this->CreateAtom();
 
-        Residue* assembly_residue = new Residue();
+        Residue* assembly_residue = this->CreateResidue();
         assembly_residue->SetAssembly(this);
         string residue_name = (*it).first;
         assembly_residue->SetName(residue_name);
-        stringstream id;
-        id << residue_name << "_" << gmml::BLANK_SPACE << "_" << sequence_number << "_" << gmml::BLANK_SPACE << "_"
-           << gmml::BLANK_SPACE << "_" << id_;
-        assembly_residue->SetId(id.str());
+        assembly_residue->SetIdentity(residue_name, gmml::BLANK_SPACE, sequence_number, gmml::BLANK_SPACE, gmml::BLANK_SPACE, id_);
         PrepFileResidue* prep_residue = (*it).second;
         string prep_residue_name = prep_residue->GetName();
         if(distance(prep_residues.begin(), it) == (int)prep_residues.size()-1)
@@ -2007,15 +1957,13 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
         for(PrepFileResidue::PrepFileAtomVector::iterator it1 = prep_atoms.begin(); it1 != prep_atoms.end(); it1++)
         {
             serial_number++;
-            Atom* assembly_atom = new Atom();
+            Atom* assembly_atom = this->CreateAtom();
             PrepFileAtom* prep_atom = (*it1);
 
             assembly_atom->SetResidue(assembly_residue);
             string atom_name = prep_atom->GetName();
             assembly_atom->SetName(atom_name);
-            stringstream atom_id;
-            atom_id << atom_name << "_" << serial_number << "_" << id.str();
-            assembly_atom->SetId(atom_id.str());
+            assembly_atom->SetIdentity(atom_name, serial_number, assembly_residue->GetIdentity());
 
             assembly_atom->MolecularDynamicAtom::SetAtomType(prep_atom->GetType());
             assembly_atom->MolecularDynamicAtom::SetCharge(prep_atom->GetCharge());
@@ -2074,15 +2022,17 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
                     coordinate_list.push_back(grandparent_coordinate);
                     coordinate_list.push_back(parent_coordinate);
                 }
-                Coordinate* coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
-                                                                                             prep_atom->GetAngle(), prep_atom->GetDihedral());
+                Coordinate* cartesian_coordinate = gmml::ConvertInternalCoordinate2CartesianCoordinate(coordinate_list, prep_atom->GetBondLength(),
+                                                                                                           prep_atom->GetAngle(), prep_atom->GetDihedral());
+                Coordinate* coordinate = this->CreateCoordinate(*cartesian_coordinate);
+                delete cartesian_coordinate;
                 cartesian_coordinate_list.push_back(coordinate);
 
                 assembly_atom->AddCoordinate(coordinate);
             }
             else if(prep_residue->GetCoordinateType() == PrepFileSpace::kXYZ)
             {
-                assembly_atom->AddCoordinate(new Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral()));
+                assembly_atom->AddCoordinate(this->CreateCoordinate(Coordinate(prep_atom->GetBondLength(), prep_atom->GetAngle(), prep_atom->GetDihedral())));
             }
             if(prep_atom->GetTopologicalType() == kTopTypeM && prep_atom->GetType().compare(prep_residue->GetDummyAtomType()) != 0)
             {
@@ -2097,13 +2047,14 @@ void Assembly::BuildAssemblyFromPrepFile(PrepFile *prep_file, string parameter_f
                     tail_atom = assembly_atom;
                 }
             }
-            if(assembly_atom->GetAtomType().compare("DU") != 0)
+            if(assembly_atom->GetAtomTypeSymbol() != dummy_type)
                 assembly_residue->AddAtom(assembly_atom);
         }
         assembly_residue->AddHeadAtom(head_atom);
         assembly_residue->AddTailAtom(tail_atom);
-        residues_.push_back(assembly_residue);
+        this->AddResidue(assembly_residue);
     }
     name_ = ss.str();
+    delete parameter;
 }
 
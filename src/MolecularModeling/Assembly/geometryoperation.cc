@@ -2,6 +2,7 @@
 #include <fstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <ctype.h>
 #include <set>
 #include <queue>
 #include <stack>
@@ -63,6 +64,7 @@
 #include "../../../includes/common.hpp"
 #include "../../../includes/GeometryTopology/grid.hpp"
 #include "../../../includes/GeometryTopology/cell.hpp"
+#include "../../../includes/GeometryTopology/neighborgrid.hpp"
 
 #include <unistd.h>
 #include <errno.h>
@@ -136,42 +138,41 @@ void Assembly::SetAttachedResidueBond(Residue *residue, Residue *parent_residue,
         bond_length = parameter_bonds[bond]->GetLength();
     else if(parameter_bonds.find(reverse_bond) != parameter_bonds.end())
         bond_length = parameter_bonds[reverse_bond]->GetLength();
+    delete parameter;
+    ///Both directions of the new bond are added before the bond graph is invalidated once
     residue->GetHeadAtoms().at(0)->GetNode()->AddNodeNeighbor(parent_target_atom);
     parent_residue->GetTailAtoms().at(branch_index)->GetNode()->AddNodeNeighbor(residue_head_atom);
+    this->NotifyBondsChanged();
     residue_head_atom_adjacent_atoms = residue_head_atom->GetNode()->GetNodeNeighbors();
     parent_target_atom_adjacent_atoms = parent_target_atom->GetNode()->GetNodeNeighbors();
 
-    Coordinate* residue_direction = new Coordinate();
+    Coordinate residue_direction;
     for(AtomVector::iterator it = residue_head_atom_adjacent_atoms.begin(); it != residue_head_atom_adjacent_atoms.end(); it++)
     {
         Atom* atom = *it;
         if(atom->GetId().compare(parent_target_atom->GetId()) != 0)
         {
-            Coordinate* dist = new Coordinate(*residue_head_atom->GetCoordinates().at(model_index_));
-            dist->operator -(*atom->GetCoordinates().at(model_index_));
-            dist->Normalize();
-            residue_direction->operator +(*dist);
-            residue_direction->Normalize();
+            Coordinate dist = Coordinate(*residue_head_atom->GetCoordinates().at(model_index_));
+            dist.operator -(*atom->GetCoordinates().at(model_index_));
+            dist.Normalize();
+            residue_direction.operator +(dist);
+            residue_direction.Normalize();
         }
     }
 
-    residue_direction->Normalize();
-    residue_direction->operator *(bond_length);
+    residue_direction.Normalize();
+    residue_direction.operator *(bond_length);
 
-    residue_direction->operator +(*residue_head_atom->GetCoordinates().at(model_index_));
+    residue_direction.operator +(*residue_head_atom->GetCoordinates().at(model_index_));
 
-    Coordinate* oxygen_position = new Coordinate(residue_direction->GetX(), residue_direction->GetY(), residue_direction->GetZ());
-    Coordinate* offset = new Coordinate(*parent_target_atom->GetCoordinates().at(model_index_));
-    offset->operator -(*oxygen_position);
+    Coordinate oxygen_position = Coordinate(residue_direction.GetX(), residue_direction.GetY(), residue_direction.GetZ());
+    Coordinate offset = Coordinate(*parent_target_atom->GetCoordinates().at(model_index_));
+    offset.operator -(oxygen_position);
 
-    AtomVector atomsToTranslate = AtomVector();
-    atomsToTranslate.push_back(parent_target_atom);
-    residue_head_atom->FindConnectedAtoms(atomsToTranslate);
-
-    for(AtomVector::iterator it = atomsToTranslate.begin() + 1; it != atomsToTranslate.end(); it++)
-    {
-        (*it)->GetCoordinates().at(model_index_)->Translate(offset->GetX(), offset->GetY(), offset->GetZ());
-    }
+    double translation_matrix[3][4] = {{1.0, 0.0, 0.0, offset.GetX()},
+                                       {0.0, 1.0, 0.0, offset.GetY()},
+                                       {0.0, 0.0, 1.0, offset.GetZ()}};
+    this->TransformMovingAtoms(parent_target_atom, residue_head_atom, translation_matrix);
 }
 
 void Assembly::SetAttachedResidueAngle(Residue *residue, Residue *parent_residue, int branch_index, string parameter_file)
@@ -194,62 +195,46 @@ void Assembly::SetAttachedResidueAngle(Residue *residue, Residue *parent_residue
         bond_length = parameter_bonds[bond]->GetLength();
     else if(parameter_bonds.find(reverse_bond) != parameter_bonds.end())
         bond_length = parameter_bonds[reverse_bond]->GetLength();
+    delete parameter;
     residue_head_atom_adjacent_atoms = residue_head_atom->GetNode()->GetNodeNeighbors();
     parent_target_atom_adjacent_atoms = parent_target_atom->GetNode()->GetNodeNeighbors();
 
-    Coordinate* carbon_direction = new Coordinate();
+    Coordinate carbon_direction;
     for(AtomVector::iterator it = parent_target_atom_adjacent_atoms.begin(); it != parent_target_atom_adjacent_atoms.end(); it++)
     {
         Atom* atom = *it;
         if(atom->GetId().compare(residue_head_atom->GetId()) != 0)
         {
-            Coordinate* dist = new Coordinate(*parent_target_atom->GetCoordinates().at(model_index_));
-            dist->operator -(*atom->GetCoordinates().at(model_index_));
-            dist->Normalize();
-            carbon_direction->operator +(*dist);
-            carbon_direction->Normalize();
+            Coordinate dist = Coordinate(*parent_target_atom->GetCoordinates().at(model_index_));
+            dist.operator -(*atom->GetCoordinates().at(model_index_));
+            dist.Normalize();
+            carbon_direction.operator +(dist);
+            carbon_direction.Normalize();
         }
     }
 
-    carbon_direction->Normalize();
-    carbon_direction->operator *(bond_length);
-    carbon_direction->operator +(*parent_target_atom->GetCoordinates().at(model_index_));
+    carbon_direction.Normalize();
+    carbon_direction.operator *(bond_length);
+    carbon_direction.operator +(*parent_target_atom->GetCoordinates().at(model_index_));
 
-    Coordinate* carbon_position = new Coordinate(*carbon_direction);
+    Coordinate carbon_position = Coordinate(carbon_direction);
 
-    Coordinate* carbon_target = new Coordinate(*carbon_position);
-    carbon_target->operator -(*parent_target_atom->GetCoordinates().at(model_index_));
+    Coordinate carbon_target = Coordinate(carbon_position);
+    carbon_target.operator -(*parent_target_atom->GetCoordinates().at(model_index_));
 
-    Coordinate* head_target = new Coordinate(*residue_head_atom->GetCoordinates().at(model_index_));
-    head_target->operator -(*parent_target_atom->GetCoordinates().at(model_index_));
+    Coordinate head_target = Coordinate(*residue_head_atom->GetCoordinates().at(model_index_));
+    head_target.operator -(*parent_target_atom->GetCoordinates().at(model_index_));
 
-    double angle = acos((carbon_target->DotProduct(*head_target)) / (carbon_target->length() * head_target->length() + DIST_EPSILON));
+    double angle = acos((carbon_target.DotProduct(head_target)) / (carbon_target.length() * head_target.length() + DIST_EPSILON));
     double rotation_angle = ConvertDegree2Radian(PI_DEGREE - ROTATION_ANGLE) - angle;
 
-    Coordinate* direction = new Coordinate(*carbon_target);
-    direction->CrossProduct(*head_target);
-    direction->Normalize();
-    double** rotation_matrix = GenerateRotationMatrix(direction, parent_target_atom->GetCoordinates().at(model_index_), rotation_angle);
-
-    AtomVector atomsToRotate = AtomVector();
-    atomsToRotate.push_back(parent_target_atom);
-    residue_head_atom->FindConnectedAtoms(atomsToRotate);
+    Coordinate direction = Coordinate(carbon_target);
+    direction.CrossProduct(head_target);
+    direction.Normalize();
+    double rotation_matrix[3][4];
+    GenerateRotationMatrix(&direction, parent_target_atom->GetCoordinate(model_index_), rotation_angle, rotation_matrix);
 
-    for(AtomVector::iterator it = atomsToRotate.begin() + 1; it != atomsToRotate.end(); it++)
-    {
-        Coordinate* atom_coordinate = (*it)->GetCoordinates().at(model_index_);
-        Coordinate* result = new Coordinate();
-        result->SetX(rotation_matrix[0][0] * atom_coordinate->GetX() + rotation_matrix[0][1] * atom_coordinate->GetY() +
-                rotation_matrix[0][2] * atom_coordinate->GetZ() + rotation_matrix[0][3]);
-        result->SetY(rotation_matrix[1][0] * atom_coordinate->GetX() + rotation_matrix[1][1] * atom_coordinate->GetY() +
-                rotation_matrix[1][2] * atom_coordinate->GetZ() + rotation_matrix[1][3]);
-        result->SetZ(rotation_matrix[2][0] * atom_coordinate->GetX() + rotation_matrix[2][1] * atom_coordinate->GetY() +
-                rotation_matrix[2][2] * atom_coordinate->GetZ() + rotation_matrix[2][3]);
-
-        (*it)->GetCoordinates().at(model_index_)->SetX(result->GetX());
-        (*it)->GetCoordinates().at(model_index_)->SetY(result->GetY());
-        (*it)->GetCoordinates().at(model_index_)->SetZ(result->GetZ());
-    }
+    this->TransformMovingAtoms(parent_target_atom, residue_head_atom, rotation_matrix);
 }
 
 void Assembly::SetAttachedResidueTorsion(Residue *residue, Residue *parent_residue, int branch_index)
@@ -1044,103 +1029,107 @@ void Assembly::SetOmegaDerivativeTorsion(Residue *residue, Residue *parent_resid
 void Assembly::SetDihedral(Atom *atom1, Atom *atom2, Atom *atom3, Atom *atom4, double torsion)
 {
     double current_dihedral = 0.0;
-    Coordinate* a1 = atom1->GetCoordinates().at(model_index_);
-    Coordinate* a2 = atom2->GetCoordinates().at(model_index_);
-    Coordinate* a3 = atom3->GetCoordinates().at(model_index_);
-    Coordinate* a4 = atom4->GetCoordinates().at(model_index_);
-
-    Coordinate* b1 = new Coordinate(*a2);
-    b1->operator -(*a1);
-    Coordinate* b2 = new Coordinate(*a3);
-    b2->operator -(*a2);
-    Coordinate* b3 = new Coordinate(*a4);
-    b3->operator -(*a3);
-    Coordinate* b4 = new Coordinate(*b2);
-    b4->operator *(-1);
+    Coordinate* a1 = atom1->GetCoordinate(model_index_);
+    Coordinate* a2 = atom2->GetCoordinate(model_index_);
+    Coordinate* a3 = atom3->GetCoordinate(model_index_);
+    Coordinate* a4 = atom4->GetCoordinate(model_index_);
 
-    Coordinate* b2xb3 = new Coordinate(*b2);
-    b2xb3->CrossProduct(*b3);
+    Coordinate b1 = Coordinate(*a2);
+    b1.operator -(*a1);
+    Coordinate b2 = Coordinate(*a3);
+    b2.operator -(*a2);
+    Coordinate b3 = Coordinate(*a4);
+    b3.operator -(*a3);
+    Coordinate b4 = Coordinate(b2);
+    b4.operator *(-1);
 
-    Coordinate* b1_m_b2n = new Coordinate(*b1);
-    b1_m_b2n->operator *(b2->length());
+    Coordinate b2xb3 = Coordinate(b2);
+    b2xb3.CrossProduct(b3);
 
-    Coordinate* b1xb2 = new Coordinate(*b1);
-    b1xb2->CrossProduct(*b2);
+    Coordinate b1_m_b2n = Coordinate(b1);
+    b1_m_b2n.operator *(b2.length());
 
-    current_dihedral = atan2(b1_m_b2n->DotProduct(*b2xb3), b1xb2->DotProduct(*b2xb3));
+    Coordinate b1xb2 = Coordinate(b1);
+    b1xb2.CrossProduct(b2);
 
-    double** torsion_matrix = GenerateRotationMatrix(b4, a2, current_dihedral - ConvertDegree2Radian(torsion));
+    current_dihedral = atan2(b1_m_b2n.DotProduct(b2xb3), b1xb2.DotProduct(b2xb3));
 
-    AtomVector atomsToRotate = AtomVector();
-    atomsToRotate.push_back(atom2);
-    atom3->FindConnectedAtoms(atomsToRotate);
+    double torsion_matrix[3][4];
+    GenerateRotationMatrix(&b4, a2, current_dihedral - ConvertDegree2Radian(torsion), torsion_matrix);
 
-    for(AtomVector::iterator it = atomsToRotate.begin(); it != atomsToRotate.end(); it++)
-    {
-        Coordinate* atom_coordinate = (*it)->GetCoordinates().at(model_index_);
-        Coordinate* result = new Coordinate();
-        result->SetX(torsion_matrix[0][0] * atom_coordinate->GetX() + torsion_matrix[0][1] * atom_coordinate->GetY() +
-                torsion_matrix[0][2] * atom_coordinate->GetZ() + torsion_matrix[0][3]);
-        result->SetY(torsion_matrix[1][0] * atom_coordinate->GetX() + torsion_matrix[1][1] * atom_coordinate->GetY() +
-                torsion_matrix[1][2] * atom_coordinate->GetZ() + torsion_matrix[1][3]);
-        result->SetZ(torsion_matrix[2][0] * atom_coordinate->GetX() + torsion_matrix[2][1] * atom_coordinate->GetY() +
-                torsion_matrix[2][2] * atom_coordinate->GetZ() + torsion_matrix[2][3]);
-
-        (*it)->GetCoordinates().at(model_index_)->SetX(result->GetX());
-        (*it)->GetCoordinates().at(model_index_)->SetY(result->GetY());
-        (*it)->GetCoordinates().at(model_index_)->SetZ(result->GetZ());
-    }
+    this->TransformMovingAtoms(atom2, atom3, torsion_matrix);
 }
 
 void Assembly::SetAngle(Atom* atom1, Atom* atom2, Atom* atom3, double angle)
 {
     double current_angle = 0.0;
-    Coordinate* a1 = atom1->GetCoordinates().at(model_index_);
-    Coordinate* a2 = atom2->GetCoordinates().at(model_index_);
-    Coordinate* a3 = atom3->GetCoordinates().at(model_index_);
+    Coordinate* a1 = atom1->GetCoordinate(model_index_);
+    Coordinate* a2 = atom2->GetCoordinate(model_index_);
+    Coordinate* a3 = atom3->GetCoordinate(model_index_);
 
-    Coordinate* b1 = new Coordinate(*a1);
-    b1->operator -(*a2);
-    Coordinate* b2 = new Coordinate(*a3);
-    b2->operator -(*a2);
+    Coordinate b1 = Coordinate(*a1);
+    b1.operator -(*a2);
+    Coordinate b2 = Coordinate(*a3);
+    b2.operator -(*a2);
 
-    current_angle = acos((b1->DotProduct(*b2)) / (b1->length() * b2->length() + DIST_EPSILON));
+    current_angle = acos((b1.DotProduct(b2)) / (b1.length() * b2.length() + DIST_EPSILON));
     double rotation_angle = ConvertDegree2Radian(angle) - current_angle;
 
-    Coordinate* direction = new Coordinate(*b1);
-    direction->CrossProduct(*b2);
-    direction->Normalize();
-    double** rotation_matrix = GenerateRotationMatrix(direction, a2, rotation_angle);
+    Coordinate direction = Coordinate(b1);
+    direction.CrossProduct(b2);
+    direction.Normalize();
+    double rotation_matrix[3][4];
+    GenerateRotationMatrix(&direction, a2, rotation_angle, rotation_matrix);
 
-    AtomVector atomsToRotate = AtomVector();
-    atomsToRotate.push_back(atom2);
-    atom3->FindConnectedAtoms(atomsToRotate);
+    this->TransformMovingAtoms(atom2, atom3, rotation_matrix);
+}
 
-    for(AtomVector::iterator it = atomsToRotate.begin() + 1; it != atomsToRotate.end(); it++)
+Assembly::AtomVector Assembly::GetMovingAtoms(Atom* fixed_atom, Atom* moving_atom)
+{
+    AtomVector moving_atoms = AtomVector();
+    BondGraph* bond_graph = this->GetBondGraph();
+    int fixed_index = bond_graph->GetIndex(fixed_atom);
+    int moving_index = bond_graph->GetIndex(moving_atom);
+    if(fixed_index < 0 || moving_index < 0)
     {
-        Coordinate* atom_coordinate = (*it)->GetCoordinates().at(model_index_);
-        Coordinate* result = new Coordinate();
-        result->SetX(rotation_matrix[0][0] * atom_coordinate->GetX() + rotation_matrix[0][1] * atom_coordinate->GetY() +
-                rotation_matrix[0][2] * atom_coordinate->GetZ() + rotation_matrix[0][3]);
-        result->SetY(rotation_matrix[1][0] * atom_coordinate->GetX() + rotation_matrix[1][1] * atom_coordinate->GetY() +
-                rotation_matrix[1][2] * atom_coordinate->GetZ() + rotation_matrix[1][3]);
-        result->SetZ(rotation_matrix[2][0] * atom_coordinate->GetX() + rotation_matrix[2][1] * atom_coordinate->GetY() +
-                rotation_matrix[2][2] * atom_coordinate->GetZ() + rotation_matrix[2][3]);
-
-        (*it)->GetCoordinates().at(model_index_)->SetX(result->GetX());
-        (*it)->GetCoordinates().at(model_index_)->SetY(result->GetY());
-        (*it)->GetCoordinates().at(model_index_)->SetZ(result->GetZ());
+        moving_atoms.push_back(fixed_atom);
+        moving_atom->FindConnectedAtoms(moving_atoms);
+        moving_atoms.erase(moving_atoms.begin());
+        return moving_atoms;
     }
+    const BondGraph::IndexVector& moving_indices = bond_graph->GetMovingAtoms(fixed_index, moving_index);
+    moving_atoms.reserve(moving_indices.size());
+    for(BondGraph::IndexVector::const_iterator it = moving_indices.begin(); it != moving_indices.end(); it++)
+        moving_atoms.push_back(bond_graph->GetAtom(*it));
+    return moving_atoms;
+}
+
+void Assembly::TransformMovingAtoms(Atom* fixed_atom, Atom* moving_atom, const double matrix[3][4])
+{
+    BondGraph* bond_graph = this->GetBondGraph();
+    int fixed_index = bond_graph->GetIndex(fixed_atom);
+    int moving_index = bond_graph->GetIndex(moving_atom);
+    if(fixed_index < 0 || moving_index < 0)
+    {
+        AtomVector moving_atoms = this->GetMovingAtoms(fixed_atom, moving_atom);
+        for(AtomVector::iterator it = moving_atoms.begin(); it != moving_atoms.end(); it++)
+            (*it)->GetCoordinate(model_index_)->Transform(matrix);
+        return;
+    }
+    const BondGraph::IndexVector& moving_indices = bond_graph->GetMovingAtoms(fixed_index, moving_index);
+    const BondGraph::AtomVector& atoms = bond_graph->GetAtoms();
+    for(BondGraph::IndexVector::const_iterator it = moving_indices.begin(); it != moving_indices.end(); it++)
+        atoms[*it]->GetCoordinate(model_index_)->Transform(matrix);
 }
 
 double Assembly::CalculateBondAngleByCoordinates(Coordinate* atom1_crd, Coordinate* atom2_crd, Coordinate* atom3_crd)
 {
-    Coordinate* b1 = new Coordinate(*atom1_crd);
-    b1->operator -(*atom2_crd);
-    Coordinate* b2 = new Coordinate(*atom3_crd);
-    b2->operator -(*atom2_crd);
+    Coordinate b1 = Coordinate(*atom1_crd);
+    b1.operator -(*atom2_crd);
+    Coordinate b2 = Coordinate(*atom3_crd);
+    b2.operator -(*atom2_crd);
 
-    return acos(b1->DotProduct((*b2)) / b1->length() / b2->length());
+    return acos(b1.DotProduct(b2) / b1.length() / b2.length());
 
 }
 
@@ -1150,37 +1139,37 @@ double Assembly::CalculateBondAngleByAtoms(Atom *atom1, Atom *atom2, Atom *atom3
     Coordinate* a2 = atom2->GetCoordinates().at(model_index_);
     Coordinate* a3 = atom3->GetCoordinates().at(model_index_);
 
-    Coordinate* b1 = new Coordinate(*a1);
-    b1->operator -(*a2);
-    Coordinate* b2 = new Coordinate(*a3);
-    b2->operator -(*a2);
+    Coordinate b1 = Coordinate(*a1);
+    b1.operator -(*a2);
+    Coordinate b2 = Coordinate(*a3);
+    b2.operator -(*a2);
 
-    return acos(b1->DotProduct((*b2)) / b1->length() / b2->length());
+    return acos(b1.DotProduct(b2) / b1.length() / b2.length());
 }
 
 double Assembly::CalculateTorsionAngleByCoordinates(Coordinate* atom1_crd, Coordinate* atom2_crd, Coordinate* atom3_crd, Coordinate* atom4_crd)
 {
     double current_dihedral = 0.0;
 
-    Coordinate* b1 = new Coordinate(*atom2_crd);
-    b1->operator -(*atom1_crd);
-    Coordinate* b2 = new Coordinate(*atom3_crd);
-    b2->operator -(*atom2_crd);
-    Coordinate* b3 = new Coordinate(*atom4_crd);
-    b3->operator -(*atom3_crd);
-    Coordinate* b4 = new Coordinate(*b2);
-    b4->operator *(-1);
+    Coordinate b1 = Coordinate(*atom2_crd);
+    b1.operator -(*atom1_crd);
+    Coordinate b2 = Coordinate(*atom3_crd);
+    b2.operator -(*atom2_crd);
+    Coordinate b3 = Coordinate(*atom4_crd);
+    b3.operator -(*atom3_crd);
+    Coordinate b4 = Coordinate(b2);
+    b4.operator *(-1);
 
-    Coordinate* b2xb3 = new Coordinate(*b2);
-    b2xb3->CrossProduct(*b3);
+    Coordinate b2xb3 = Coordinate(b2);
+    b2xb3.CrossProduct(b3);
 
-    Coordinate* b1_m_b2n = new Coordinate(*b1);
-    b1_m_b2n->operator *(b2->length());
+    Coordinate b1_m_b2n = Coordinate(b1);
+    b1_m_b2n.operator *(b2.length());
 
-    Coordinate* b1xb2 = new Coordinate(*b1);
-    b1xb2->CrossProduct(*b2);
+    Coordinate b1xb2 = Coordinate(b1);
+    b1xb2.CrossProduct(b2);
 
-    current_dihedral = atan2(b1_m_b2n->DotProduct(*b2xb3), b1xb2->DotProduct(*b2xb3));
+    current_dihedral = atan2(b1_m_b2n.DotProduct(b2xb3), b1xb2.DotProduct(b2xb3));
     return current_dihedral;
 }
 
@@ -1192,38 +1181,38 @@ double Assembly::CalculateTorsionAngleByAtoms(Atom *atom1, Atom *atom2, Atom *at
     Coordinate* a3 = atom3->GetCoordinates().at(model_index_);
     Coordinate* a4 = atom4->GetCoordinates().at(model_index_);
 
-    Coordinate* b1 = new Coordinate(*a2);
-    b1->operator -(*a1);
-    Coordinate* b2 = new Coordinate(*a3);
-    b2->operator -(*a2);
-    Coordinate* b3 = new Coordinate(*a4);
-    b3->operator -(*a3);
-    Coordinate* b4 = new Coordinate(*b2);
-    b4->operator *(-1);
+    Coordinate b1 = Coordinate(*a2);
+    b1.operator -(*a1);
+    Coordinate b2 = Coordinate(*a3);
+    b2.operator -(*a2);
+    Coordinate b3 = Coordinate(*a4);
+    b3.operator -(*a3);
+    Coordinate b4 = Coordinate(b2);
+    b4.operator *(-1);
 
-    Coordinate* b2xb3 = new Coordinate(*b2);
-    b2xb3->CrossProduct(*b3);
+    Coordinate b2xb3 = Coordinate(b2);
+    b2xb3.CrossProduct(b3);
 
-    Coordinate* b1_m_b2n = new Coordinate(*b1);
-    b1_m_b2n->operator *(b2->length());
+    Coordinate b1_m_b2n = Coordinate(b1);
+    b1_m_b2n.operator *(b2.length());
 
-    Coordinate* b1xb2 = new Coordinate(*b1);
-    b1xb2->CrossProduct(*b2);
+    Coordinate b1xb2 = Coordinate(b1);
+    b1xb2.CrossProduct(b2);
 
-    current_dihedral = atan2(b1_m_b2n->DotProduct(*b2xb3), b1xb2->DotProduct(*b2xb3));
+    current_dihedral = atan2(b1_m_b2n.DotProduct(b2xb3), b1xb2.DotProduct(b2xb3));
     return current_dihedral;
 }
 
 void Assembly::GetCenterOfMass(Coordinate *center_of_mass)
 {
     //    center_of_mass = new Coordinate();
-    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
-    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    const AtomVector& all_atoms_of_assembly = this->GetAllAtomsOfAssemblyView();
+    for(AtomVector::const_iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
         Atom* atom = *it;
-        center_of_mass->Translate(atom->MolecularDynamicAtom::GetMass() * atom->GetCoordinates().at(model_index_)->GetX(),
-                                  atom->MolecularDynamicAtom::GetMass() * atom->GetCoordinates().at(model_index_)->GetY(),
-                                  atom->MolecularDynamicAtom::GetMass() * atom->GetCoordinates().at(model_index_)->GetZ());
+        Coordinate* atom_coordinate = atom->GetCoordinates().at(model_index_);
+        double mass = atom->MolecularDynamicAtom::GetMass();
+        center_of_mass->Translate(mass * atom_coordinate->GetX(), mass * atom_coordinate->GetY(), mass * atom_coordinate->GetZ());
     }
     double total_mass = this->GetTotalMass();
     center_of_mass->operator /(Coordinate(center_of_mass->GetX() / total_mass,
@@ -1236,13 +1225,13 @@ void Assembly::GetCenterOfGeometry(Coordinate *center_of_geometry)
     double sumX = 0.0;
     double sumY = 0.0;
     double sumZ = 0.0;
-    CoordinateVector all_coords = this->GetAllCoordinates();
-    for(CoordinateVector::iterator it = all_coords.begin(); it != all_coords.end(); it++)
+    const CoordinateVector& all_coords = this->GetAllCoordinatesView();
+    for(CoordinateVector::const_iterator it = all_coords.begin(); it != all_coords.end(); it++)
     {
-        GeometryTopology::Coordinate coord = *it;
-        sumX += coord.GetX();
-        sumY += coord.GetY();
-        sumZ += coord.GetZ();
+        Coordinate* coord = *it;
+        sumX += coord->GetX();
+        sumY += coord->GetY();
+        sumZ += coord->GetZ();
     }
     center_of_geometry->SetX( (sumX / all_coords.size()) );
     center_of_geometry->SetY( (sumY / all_coords.size()) );
@@ -1259,8 +1248,10 @@ void Assembly::GetBoundary(Coordinate* lower_left_back_corner, Coordinate* upper
     upper_right_front_corner->SetX(-INFINITY);
     upper_right_front_corner->SetY(-INFINITY);
     upper_right_front_corner->SetZ(-INFINITY);
-    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
-    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    ///The solvent block is not expanded, its molecules are taken from their sites below
+    this->UpdateViews();
+    const AtomVector& all_atoms_of_assembly = all_atoms_;
+    for(AtomVector::const_iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
         Atom* atom = *it;
         if(atom->MolecularDynamicAtom::GetRadius() == dNotSet)
@@ -1274,28 +1265,49 @@ void Assembly::GetBoundary(Coordinate* lower_left_back_corner, Coordinate* upper
             //            cout << ss.str() << endl;
             //            return;
         }
-        double upper_right_front_x = atom->GetCoordinates().at(model_index_)->GetX() + atom->MolecularDynamicAtom::GetRadius();
-        double lower_left_back_x = atom->GetCoordinates().at(model_index_)->GetX() - atom->MolecularDynamicAtom::GetRadius();
+        Coordinate* atom_coordinate = atom->GetCoordinates().at(model_index_);
+        double upper_right_front_x = atom_coordinate->GetX() + atom->MolecularDynamicAtom::GetRadius();
+        double lower_left_back_x = atom_coordinate->GetX() - atom->MolecularDynamicAtom::GetRadius();
         if(upper_right_front_x > upper_right_front_corner->GetX())
             upper_right_front_corner->SetX(upper_right_front_x);
         if(lower_left_back_x < lower_left_back_corner->GetX())
             lower_left_back_corner->SetX(lower_left_back_x);
 
-        double upper_right_front_y = atom->GetCoordinates().at(model_index_)->GetY() + atom->MolecularDynamicAtom::GetRadius();
-        double lower_left_back_y = atom->GetCoordinates().at(model_index_)->GetY() - atom->MolecularDynamicAtom::GetRadius();
+        double upper_right_front_y = atom_coordinate->GetY() + atom->MolecularDynamicAtom::GetRadius();
+        double lower_left_back_y = atom_coordinate->GetY() - atom->MolecularDynamicAtom::GetRadius();
         if(upper_right_front_y > upper_right_front_corner->GetY())
             upper_right_front_corner->SetY(upper_right_front_y);
         if(lower_left_back_y < lower_left_back_corner->GetY())
             lower_left_back_corner->SetY(lower_left_back_y);
 
-        double upper_right_front_z = atom->GetCoordinates().at(model_index_)->GetZ() + atom->MolecularDynamicAtom::GetRadius();
-        double lower_left_back_z = atom->GetCoordinates().at(model_index_)->GetZ() - atom->MolecularDynamicAtom::GetRadius();
+        double upper_right_front_z = atom_coordinate->GetZ() + atom->MolecularDynamicAtom::GetRadius();
+        double lower_left_back_z = atom_coordinate->GetZ() - atom->MolecularDynamicAtom::GetRadius();
         if(upper_right_front_z > upper_right_front_corner->GetZ())
             upper_right_front_corner->SetZ(upper_right_front_z);
         if(lower_left_back_z < lower_left_back_corner->GetZ())
             lower_left_back_corner->SetZ(lower_left_back_z);
     }
-    if(all_atoms_of_assembly.size() == 0)
+    for(int i = 0; i < solvent_block_.GetNumberOfMolecules(); i++)
+    {
+        for(int j = 0; j < solvent_block_.GetNumberOfSites(); j++)
+        {
+            Coordinate& site_coordinate = solvent_block_.GetSiteCoordinate(i, j);
+            double radius = (solvent_block_.GetSiteRadius(j) != dNotSet) ? solvent_block_.GetSiteRadius(j) : DEFAULT_RADIUS;
+            if(site_coordinate.GetX() + radius > upper_right_front_corner->GetX())
+                upper_right_front_corner->SetX(site_coordinate.GetX() + radius);
+            if(site_coordinate.GetX() - radius < lower_left_back_corner->GetX())
+                lower_left_back_corner->SetX(site_coordinate.GetX() - radius);
+            if(site_coordinate.GetY() + radius > upper_right_front_corner->GetY())
+                upper_right_front_corner->SetY(site_coordinate.GetY() + radius);
+            if(site_coordinate.GetY() - radius < lower_left_back_corner->GetY())
+                lower_left_back_corner->SetY(site_coordinate.GetY() - radius);
+            if(site_coordinate.GetZ() + radius > upper_right_front_corner->GetZ())
+                upper_right_front_corner->SetZ(site_coordinate.GetZ() + radius);
+            if(site_coordinate.GetZ() - radius < lower_left_back_corner->GetZ())
+                lower_left_back_corner->SetZ(site_coordinate.GetZ() - radius);
+        }
+    }
+    if(all_atoms_of_assembly.size() == 0 && solvent_block_.GetNumberOfMolecules() == 0)
     {
         lower_left_back_corner->SetX(0.0);
         lower_left_back_corner->SetY(0.0);
@@ -1344,45 +1356,159 @@ string Assembly::CalculateRSOrientations(Atom *prev_atom, Atom *target, Atom *ne
     return orientation;
 }
 
-double Assembly::CalculateAtomicOverlaps(Assembly *assemblyB)
+namespace
 {
-    AtomVector assemblyAAtoms = this->GetAllAtomsOfAssembly();
-    AtomVector assemblyBAtoms = assemblyB->GetAllAtomsOfAssembly();
+    /// Radii of the elements that are considered in overlap calculations: Rowland and Taylor modification for the first six,
+    /// van der Waals radii of Bondi for the others (Mantina et al. for calcium)
+    const int NUMBER_OF_OVERLAP_ELEMENTS = 17;
+    const char* OVERLAP_ELEMENTS[NUMBER_OF_OVERLAP_ELEMENTS] = {"C", "O", "N", "S", "P", "H", "F", "Cl", "Br", "I", "Se", "Si",
+                                                                 "Na", "K", "Mg", "Ca", "Zn"};
+    const double OVERLAP_RADII[NUMBER_OF_OVERLAP_ELEMENTS] = {1.70, 1.52, 1.55, 1.80, 1.80, 1.09, 1.47, 1.75, 1.85, 1.98, 1.90, 2.10,
+                                                              2.27, 2.75, 1.73, 2.31, 1.39};
+
+    /// Elements without a radius of their own that have already been reported
+    pthread_mutex_t unknown_overlap_elements_mutex = PTHREAD_MUTEX_INITIALIZER;
+    set<string> unknown_overlap_elements;
+
+    double FindOverlapRadius(const string& element)
+    {
+        for(int i = 0; i < NUMBER_OF_OVERLAP_ELEMENTS; i++)
+        {
+            if(element.compare(OVERLAP_ELEMENTS[i]) == 0)
+                return OVERLAP_RADII[i];
+        }
+        return 0.0;
+    }
 
-    double rA = 0.0, rB = 0.0, distance = 0.0, totalOverlap = 0.0;
+    double GetOverlapRadius(Atom* atom)
+    {
+        /// Element info is usually not set, in that case the first letter of the atom name is used (after a leading digit, as in 1H1)
+        string element = atom->GetElementSymbol();
+        if(element.empty())
+        {
+            string name = atom->GetName();
+            unsigned int first_letter = (name.size() > 1 && isdigit(name[0])) ? 1 : 0;
+            if(name.size() > first_letter)
+                element = name.substr(first_letter, 1);
+        }
+        /// Element symbols are written in capitals in some files (e.g. CL)
+        for(unsigned int i = 0; i < element.size(); i++)
+            element[i] = (i == 0) ? toupper(element[i]) : tolower(element[i]);
+        double radius = FindOverlapRadius(element);
+        if(radius > 0.0)
+            return radius;
+        /// An element out of the table falls back to its first letter, as the atom names did before the element was looked at;
+        /// if that has no radius either the atom does not take part in the overlaps. Either case is reported once for each element
+        string fallback = element.substr(0, 1);
+        if(element.size() > 1)
+            radius = FindOverlapRadius(fallback);
+        pthread_mutex_lock(&unknown_overlap_elements_mutex);
+        if(unknown_overlap_elements.insert(element).second)
+        {
+            stringstream ss;
+            ss << "No overlap radius for element \"" << element << "\" (atom " << atom->GetId() << "), ";
+            if(radius > 0.0)
+                ss << "the radius of \"" << fallback << "\" is used for its atoms.";
+            else
+                ss << "its atoms are left out of the overlaps.";
+            gmml::log(__LINE__, __FILE__, gmml::WAR, ss.str());
+            cout << ss.str() << endl;
+        }
+        pthread_mutex_unlock(&unknown_overlap_elements_mutex);
+        return radius;
+    }
 
-    for(AtomVector::iterator atomA = assemblyAAtoms.begin(); atomA != assemblyAAtoms.end(); atomA++)
+    void* CalculateAtomicOverlapsThread(void* args)
     {
-        for(AtomVector::iterator atomB = assemblyBAtoms.begin(); atomB != assemblyBAtoms.end(); atomB++)
+        OverlapCalculationThreadArgument* arg = (OverlapCalculationThreadArgument*)args;
+        vector<Coordinate*>& query_coordinates = *(arg->query_coordinates);
+        vector<double>& query_radii = *(arg->query_radii);
+        vector<Coordinate*>& grid_coordinates = *(arg->grid_coordinates);
+        vector<double>& grid_radii = *(arg->grid_radii);
+        int size = query_coordinates.size();
+        int begin_index = (int)(((long long)arg->thread_index * size) / arg->number_of_threads);
+        int end_index = (int)(((long long)(arg->thread_index + 1) * size) / arg->number_of_threads);
+
+        double total_overlap = 0.0;
+        vector<int> candidates = vector<int>();
+        for(int index = begin_index; index < end_index; index++)
         {
-            distance = (*atomA)->GetDistanceToAtom( (*atomB));
-            if ( ( distance < 3.6 ) && ( distance > 0.0 ) ) //Close enough to overlap, but not the same atom
+            Coordinate* query_coordinate = query_coordinates[index];
+            candidates.clear();
+            arg->grid->GetCandidateIndices(query_coordinate->GetX(), query_coordinate->GetY(), query_coordinate->GetZ(), candidates);
+            for(vector<int>::iterator it = candidates.begin(); it != candidates.end(); it++)
             {
-                // element info not set, so I look at first letter of atom name.
-                if ((*atomA)->GetName().at(0) == 'C') rA = 1.70; // Rowland and Taylor modification
-                if ((*atomA)->GetName().at(0) == 'O') rA = 1.52;
-                if ((*atomA)->GetName().at(0) == 'N') rA = 1.55;
-                if ((*atomA)->GetName().at(0) == 'S') rA = 1.80;
-                if ((*atomA)->GetName().at(0) == 'P') rA = 1.80;
-                if ((*atomA)->GetName().at(0) == 'H') rA = 1.09;
-
-                if ((*atomB)->GetName().at(0) == 'C') rB = 1.70;
-                if ((*atomB)->GetName().at(0) == 'O') rB = 1.52;
-                if ((*atomB)->GetName().at(0) == 'N') rB = 1.55;
-                if ((*atomB)->GetName().at(0) == 'S') rB = 1.80;
-                if ((*atomA)->GetName().at(0) == 'P') rA = 1.80;
-                if ((*atomA)->GetName().at(0) == 'H') rA = 1.09;
-
-       //         std::cout << "Distance=" << distance << " rA=" << rA << " rB=" << rB << std::endl;
-                if (rA + rB > distance + 0.6){ // 0.6 overlap is deemed acceptable. (Copying chimera:)
-                    // Eqn 1, Rychkov and Petukhov, J. Comput. Chem., 2006, Joint Neighbours...
-                    // Each atom against each atom, so overlap can be "double" counted. See paper.
-                    totalOverlap += ( 2 * (PI_RADIAN) * rA* ( rA - distance / 2 - ( ( (rA*rA) - (rB*rB) ) / (2 * distance) ) ) );
-                    //std::cout << "Overlap=" << totalOverlap << std::endl;
+                double distance = query_coordinate->Distance(*(grid_coordinates[*it]));
+                if((distance < OVERLAP_CUTOFF) && (distance > 0.0)) //Close enough to overlap, but not the same atom
+                {
+                    /// The overlap is computed from the radius of the atom of the first assembly, whichever side was binned
+                    double rA = (arg->query_is_first) ? query_radii[index] : grid_radii[*it];
+                    double rB = (arg->query_is_first) ? grid_radii[*it] : query_radii[index];
+                    if(rA + rB > distance + OVERLAP_TOLERANCE) // 0.6 overlap is deemed acceptable. (Copying chimera:)
+                    {
+                        // Eqn 1, Rychkov and Petukhov, J. Comput. Chem., 2006, Joint Neighbours...
+                        // Each atom against each atom, so overlap can be "double" counted. See paper.
+                        total_overlap += (2 * (PI_RADIAN) * rA * (rA - distance / 2 - (((rA * rA) - (rB * rB)) / (2 * distance))));
+                    }
                 }
             }
         }
+        arg->overlap = total_overlap;
+        pthread_exit(NULL);
     }
+}
+
+double Assembly::CalculateAtomicOverlaps(Assembly *assemblyB, int number_of_threads, int model_index)
+{
+    const AtomVector& assemblyAAtoms = this->GetAllAtomsOfAssemblyView();
+    if(number_of_threads < 1)
+        number_of_threads = 1;
+
+    ///Coordinates and radii are looked up once per atom instead of once per pair
+    vector<Coordinate*> coordinatesA = vector<Coordinate*>();
+    vector<double> radiiA = vector<double>();
+    coordinatesA.reserve(assemblyAAtoms.size());
+    radiiA.reserve(assemblyAAtoms.size());
+    for(AtomVector::const_iterator it = assemblyAAtoms.begin(); it != assemblyAAtoms.end(); it++)
+    {
+        coordinatesA.push_back((*it)->GetCoordinate(model_index));
+        radiiA.push_back(GetOverlapRadius(*it));
+    }
+    ///Taken after the first one is read, since reading a view may expand a solvent block
+    const AtomVector& assemblyBAtoms = assemblyB->GetAllAtomsOfAssemblyView();
+    vector<Coordinate*> coordinatesB = vector<Coordinate*>();
+    vector<double> radiiB = vector<double>();
+    coordinatesB.reserve(assemblyBAtoms.size());
+    radiiB.reserve(assemblyBAtoms.size());
+    for(AtomVector::const_iterator it = assemblyBAtoms.begin(); it != assemblyBAtoms.end(); it++)
+    {
+        coordinatesB.push_back((*it)->GetCoordinate(model_index));
+        radiiB.push_back(GetOverlapRadius(*it));
+    }
+
+    ///The larger assembly is binned into a grid with cells as large as the cutoff, and the atoms of the smaller one are divided between the threads
+    bool query_is_first = (coordinatesA.size() <= coordinatesB.size());
+    vector<Coordinate*>* query_coordinates = (query_is_first) ? &coordinatesA : &coordinatesB;
+    vector<double>* query_radii = (query_is_first) ? &radiiA : &radiiB;
+    vector<Coordinate*>* grid_coordinates = (query_is_first) ? &coordinatesB : &coordinatesA;
+    vector<double>* grid_radii = (query_is_first) ? &radiiB : &radiiA;
+    NeighborGrid grid = NeighborGrid(*grid_coordinates, OVERLAP_CUTOFF);
+
+    pthread_t threads[number_of_threads];
+    OverlapCalculationThreadArgument arg[number_of_threads];
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        arg[i] = OverlapCalculationThreadArgument(i, number_of_threads, query_is_first, query_coordinates, query_radii, grid_coordinates, grid_radii, &grid);
+        pthread_create(&threads[i], NULL, &CalculateAtomicOverlapsThread, &arg[i]);
+    }
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    double totalOverlap = 0.0;
+    for(int i = 0; i < number_of_threads; i++)
+        totalOverlap += arg[i].overlap;
     return (totalOverlap / CARBON_SURFACE_AREA); //Normalise to area of a buried carbon
 }
 
@@ -287,7 +287,9 @@ void Assembly::UpdateResidueName2GlycamName(GlycamResidueNamingMap residue_glyca
         string residue_id = residue->GetId();
         if(residue_glycam_map.find(residue_id) != residue_glycam_map.end())
         {
-            terminal_residues.push_back(new Residue(this, ""));
+            ///The new residues are created in the storage of the assembly, so that their atom changes reach the views of the assembly
+            terminal_residues.push_back(this->CreateResidue());
+            terminal_residues.back()->SetAssembly(this);
             residue_sequence_number--;
             bool terminal = false;
             int residue_name_size = residue_name.size();
@@ -368,7 +370,9 @@ void Assembly::UpdateResidueName2GlycamName(GlycamResidueNamingMap residue_glyca
                     glycam_name = Split(prep_atom_id,"_")[2];
                     if(residue_set.find(glycam_name) == residue_set.end())
                     {
-                        residue_set[glycam_name] = (new Residue(this, glycam_name));
+                        residue_set[glycam_name] = this->CreateResidue();
+                        residue_set[glycam_name]->SetAssembly(this);
+                        residue_set[glycam_name]->SetName(glycam_name);
                         residue_sequence_number--;
                         vector<string> res_id_tokens = Split(residue_id, "_");
                         string res_id = glycam_name + "_" + res_id_tokens.at(1) + "_" + ConvertT<int>(residue_sequence_number) + "_"
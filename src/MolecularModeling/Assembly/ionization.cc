@@ -63,6 +63,7 @@
 #include "../../../includes/common.hpp"
 #include "../../../includes/GeometryTopology/grid.hpp"
 #include "../../../includes/GeometryTopology/cell.hpp"
+#include "../../../includes/GeometryTopology/neighborgrid.hpp"
 
 #include <unistd.h>
 #include <errno.h>
@@ -85,266 +86,393 @@ using namespace CondensedSequenceSpace;
 //////////////////////////////////////////////////////////
 //                       FUNCTIONS                      //
 //////////////////////////////////////////////////////////
-void Assembly::AddIon(string ion_name, string lib_file, string parameter_file, int ion_count)
+void Assembly::AddIon(string ion_name, string lib_file, string parameter_file, int ion_count, int number_of_threads, double cutoff, double screening_length,
+                      double minimum_solute_distance, double minimum_ion_distance, int seed)
 {
-    if(ion_count == 0)
+    if(ion_count < 0)
     {
-        gmml::log(__LINE__, __FILE__,  gmml::INF, "Neutralizing .......");
-        cout << "Neutralizing ......." << endl;
-        LibraryFile* lib = new LibraryFile(lib_file);
-        ParameterFile* param = new ParameterFile(parameter_file, gmml::IONICMOD);
-        double charge = this->GetTotalCharge();
-        if(fabs(charge) < CHARGE_TOLERANCE)
+        gmml::log(__LINE__, __FILE__,  gmml::ERR, "Please have a non-negative number as the number of ion(s) want to add");
+        cout << "Please have a non-negative number as the number of ion(s) want to add" << endl;
+        return;
+    }
+    /// A non-negative seed gives the ties between equally good positions their own random sequence, independent of rand()
+    unsigned int random_state = (seed >= 0) ? (unsigned int)seed : 0;
+    bool neutralize = (ion_count == 0);
+    gmml::log(__LINE__, __FILE__,  gmml::INF, (neutralize) ? "Neutralizing ......." : "Ionizing .......");
+    cout << ((neutralize) ? "Neutralizing ......." : "Ionizing .......") << endl;
+    LibraryFile lib = LibraryFile(lib_file);
+    ParameterFile param = ParameterFile(parameter_file, gmml::IONICMOD);
+    double charge = this->GetTotalCharge();
+    if(neutralize && fabs(charge) < CHARGE_TOLERANCE)
+    {
+        gmml::log(__LINE__, __FILE__,  gmml::INF, "The assembly has 0 charge and is neutral.");
+        cout << "The assembly has 0 charge and is neutral." << endl;
+        return;
+    }
+    stringstream ss;
+    ss << "Total charge of the assembly is " << charge;
+    gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
+    cout << ss.str() << endl;
+
+    vector<string> ion_list = lib.GetAllResidueNames();
+    if(find(ion_list.begin(), ion_list.end(), ion_name) == ion_list.end())
+    {
+        gmml::log(__LINE__, __FILE__,  (neutralize) ? gmml::WAR : gmml::ERR, "The ion has not been found in the library file.");
+        cout << "The ion has not been found in the library file." << endl;
+        return;
+    }
+    LibraryFileResidue* lib_ion_residue = lib.GetLibraryResidueByResidueName(ion_name);
+    double ion_charge = lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetCharge();
+    if(ion_charge == 0)
+    {
+        gmml::log(__LINE__, __FILE__,  gmml::INF, "The ion has 0 charge");
+        cout << "The ion has 0 charge" << endl;
+        return;
+    }
+    int number_of_ions = ion_count;
+    if(neutralize)
+    {
+        if(ion_charge > 0 && charge > 0)
         {
-            gmml::log(__LINE__, __FILE__,  gmml::INF, "The assembly has 0 charge and is neutral.");
-            cout << "The assembly has 0 charge and is neutral." << endl;
+            gmml::log(__LINE__, __FILE__,  gmml::ERR, "The assembly and the given ion have positive charges, neutralizing process is aborted.");
+            cout << "The assembly and the given ion have positive charges, neutralizing process is aborted." << endl;
             return;
         }
-        else
+        else if(ion_charge < 0 && charge < 0)
         {
-            stringstream ss;
-            ss << "Total charge of the assembly is " << charge;
-            gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
-            cout << ss.str() << endl;
+            gmml::log(__LINE__, __FILE__,  gmml::ERR, "The assembly and the given ion have positive charges, neutralizing process is aborted.");
+            cout << "The assembly and the given ion have negative charges, neutralizing process is aborted." << endl;
+            return;
         }
-        double ion_charge = 0;
-        string ion_residue_name = "";
-        vector<string> ion_list = lib->GetAllResidueNames();
-        if(find(ion_list.begin(), ion_list.end(), ion_name) != ion_list.end())
+        number_of_ions = (int)(fabs(charge) + gmml::CHARGE_TOLERANCE) / (int)(fabs(ion_charge) + gmml::CHARGE_TOLERANCE);
+        stringstream ss;
+        ss << "The assembly will be neutralized by " << number_of_ions << " ion(s)";
+        gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
+    }
+    else
+    {
+        stringstream ss;
+        ss << "The assembly will be charged by " << number_of_ions << " ion(s)" ;
+        gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
+        cout << ss.str() << endl;
+    }
+
+    ParameterFile::AtomTypeMap atom_type_map = param.GetAtomTypes();
+    double ion_radius = MINIMUM_RADIUS;
+    double ion_mass = dNotSet;
+    if(atom_type_map.find(ion_name) != atom_type_map.end())
+    {
+        ion_radius = atom_type_map[ion_name]->GetRadius();
+        ion_mass = atom_type_map[ion_name]->GetMass();
+    }
+    Coordinate minimum_boundary = Coordinate();
+    Coordinate maximum_boundary = Coordinate();
+    this->GetBoundary(&minimum_boundary, &maximum_boundary);
+    if(minimum_boundary.GetX() == INFINITY || minimum_boundary.GetY() == INFINITY || minimum_boundary.GetZ() == INFINITY ||
+            maximum_boundary.GetX() == -INFINITY || maximum_boundary.GetY() == -INFINITY || maximum_boundary.GetZ() == -INFINITY)
+        return;
+    minimum_boundary.operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
+    maximum_boundary.operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
+
+    /// The grid is built and ranked once; every placed ion only adds its own contribution to the potential energy of the cells
+    Grid grid(this, &minimum_boundary, &maximum_boundary, ion_radius, ion_charge);
+    grid.CalculateCellsPotentialEnergy(ion_radius, number_of_threads, cutoff, screening_length, minimum_solute_distance);
+    grid.RankCells(ion_charge);
+    for(int i = 0; i < number_of_ions; i++)
+    {
+        Grid::CellVector best_cells = grid.GetBestRankedCells();
+        if(best_cells.empty())
         {
-            LibraryFileResidue* lib_ion_residue = lib->GetLibraryResidueByResidueName(ion_name);
-            ion_charge = lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetCharge();
-            ion_residue_name = lib_ion_residue->GetName();
+            gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no optimum position to place the ion");
+            cout << "There is no optimum position to place the ion" << endl;
+            return;
+        }
+        Coordinate position = *(best_cells.at(((seed >= 0) ? rand_r(&random_state) : rand()) % best_cells.size())->GetCellCenter());
+        Atom* ion_atom = this->AddIonResidue(lib_ion_residue, ion_name, ion_mass, ion_radius, position, i);
+        grid.UpdateCellsPotentialEnergy(ion_atom, ion_radius, minimum_ion_distance);
+        grid.RemoveCellsInsideAssembly(ion_atom);
+    }
+}
+
+void Assembly::AddSalt(string cation_name, string anion_name, string lib_file, string parameter_file, double concentration, double net_charge,
+                       bool replace_solvent, int number_of_threads, double cutoff, double screening_length, double minimum_solute_distance,
+                       double minimum_ion_distance, int seed)
+{
+    gmml::log(__LINE__, __FILE__,  gmml::INF, "Adding salt .......");
+    cout << "Adding salt ......." << endl;
+    LibraryFile lib = LibraryFile(lib_file);
+    ParameterFile param = ParameterFile(parameter_file, gmml::IONICMOD);
+    vector<string> ion_list = lib.GetAllResidueNames();
+    if(find(ion_list.begin(), ion_list.end(), cation_name) == ion_list.end() || find(ion_list.begin(), ion_list.end(), anion_name) == ion_list.end())
+    {
+        gmml::log(__LINE__, __FILE__,  gmml::ERR, "The ion has not been found in the library file.");
+        cout << "The ion has not been found in the library file." << endl;
+        return;
+    }
+    LibraryFileResidue* lib_cation_residue = lib.GetLibraryResidueByResidueName(cation_name);
+    LibraryFileResidue* lib_anion_residue = lib.GetLibraryResidueByResidueName(anion_name);
+    double cation_charge = lib_cation_residue->GetLibraryAtomByAtomName(cation_name)->GetCharge();
+    double anion_charge = lib_anion_residue->GetLibraryAtomByAtomName(anion_name)->GetCharge();
+    if(cation_charge <= 0 || anion_charge >= 0)
+    {
+        gmml::log(__LINE__, __FILE__,  gmml::ERR, "The cation has to be positive and the anion negative, adding salt is aborted.");
+        cout << "The cation has to be positive and the anion negative, adding salt is aborted." << endl;
+        return;
+    }
+    ParameterFile::AtomTypeMap atom_type_map = param.GetAtomTypes();
+    double cation_radius = MINIMUM_RADIUS;
+    double cation_mass = dNotSet;
+    if(atom_type_map.find(cation_name) != atom_type_map.end())
+    {
+        cation_radius = atom_type_map[cation_name]->GetRadius();
+        cation_mass = atom_type_map[cation_name]->GetMass();
+    }
+    double anion_radius = MINIMUM_RADIUS;
+    double anion_mass = dNotSet;
+    if(atom_type_map.find(anion_name) != atom_type_map.end())
+    {
+        anion_radius = atom_type_map[anion_name]->GetRadius();
+        anion_mass = atom_type_map[anion_name]->GetMass();
+    }
+
+    /// The charge and the amount of solvent are taken without expanding the solvent block
+    this->UpdateViews();
+    double charge = 0.0;
+    for(AtomVector::iterator it = all_atoms_.begin(); it != all_atoms_.end(); it++)
+        if((*it)->MolecularDynamicAtom::GetCharge() != dNotSet)
+            charge += (*it)->MolecularDynamicAtom::GetCharge();
+    for(int site = 0; site < solvent_block_.GetNumberOfSites(); site++)
+        charge += solvent_block_.GetSiteCharge(site) * solvent_block_.GetNumberOfMolecules();
+
+    /// The salt is counted in formula units, e.g. one Na+ and one Cl- or one Mg2+ and two Cl-, from the number of water molecules
+    /// (WATER_MOLARITY of them make a liter) or else from the volume of the periodic box
+    double number_of_formula_units = 0.0;
+    if(solvent_block_.GetNumberOfMolecules() > 0)
+        number_of_formula_units = concentration * solvent_block_.GetNumberOfMolecules() / WATER_MOLARITY;
+    else if(box_length_ != dNotSet)
+    {
+        double cos_angle = cos(box_angle_ * PI_RADIAN / PI_DEGREE);
+        double volume = box_length_ * box_width_ * box_height_ * sqrt(1 - 3 * cos_angle * cos_angle + 2 * cos_angle * cos_angle * cos_angle);
+        number_of_formula_units = concentration * volume * MOLAR_TO_PER_CUBIC_ANGSTROM;
+    }
+    else if(concentration > 0)
+    {
+        gmml::log(__LINE__, __FILE__,  gmml::WAR, "The assembly has neither solvent nor a periodic box, only the net charge is set.");
+        cout << "The assembly has neither solvent nor a periodic box, only the net charge is set." << endl;
+    }
+    int cation_valence = (int)(cation_charge + CHARGE_TOLERANCE);
+    int anion_valence = (int)(-anion_charge + CHARGE_TOLERANCE);
+    int common_divisor = cation_valence;
+    for(int remainder = anion_valence; remainder != 0; )
+    {
+        int next = common_divisor % remainder;
+        common_divisor = remainder;
+        remainder = next;
+    }
+    if(common_divisor < 1)
+        common_divisor = 1;
+    int formula_units = (int)(number_of_formula_units + 0.5);
+    int number_of_cations = formula_units * anion_valence / common_divisor;
+    int number_of_anions = formula_units * cation_valence / common_divisor;
+    double charge_to_add = net_charge - charge;
+    if(charge_to_add > CHARGE_TOLERANCE)
+        number_of_cations += (int)(charge_to_add / cation_charge + 0.5);
+    else if(charge_to_add < -CHARGE_TOLERANCE)
+        number_of_anions += (int)(charge_to_add / anion_charge + 0.5);
+    stringstream ss;
+    ss << "Total charge of the assembly is " << charge << ", " << number_of_cations << " " << cation_name << " and " << number_of_anions << " "
+       << anion_name << " will be added";
+    gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
+    cout << ss.str() << endl;
+    if(number_of_cations + number_of_anions == 0)
+        return;
+
+    unsigned int random_state = (seed >= 0) ? (unsigned int)seed : 0;
+    int placed_cations = 0;
+    int placed_anions = 0;
+    vector<Coordinate> positions = vector<Coordinate>();
+    vector<bool> position_is_cation = vector<bool>();
+    if(replace_solvent && solvent_block_.GetNumberOfMolecules() > 0)
+    {
+        /// Every solvent molecule is a candidate site at its first site (the oxygen of a water). Its potential energy comes from the solute
+        /// and the ions that have been placed, and the molecules at the chosen sites are removed from the solvent block.
+        /// The potential energy of the sites is calculated by the threads of Grid::CalculatePotentialEnergies and the sites are ranked
+        /// in an ordered set like the cells of a grid, so the best sites are found without scanning all molecules for every ion.
+        int number_of_molecules = solvent_block_.GetNumberOfMolecules();
+        vector<Coordinate*> sites = vector<Coordinate*>();
+        sites.reserve(number_of_molecules);
+        for(int molecule = 0; molecule < number_of_molecules; molecule++)
+            sites.push_back(&solvent_block_.GetSiteCoordinate(molecule, 0));
+        vector<Coordinate*> solute_coordinates = vector<Coordinate*>();
+        vector<double> solute_charges = vector<double>();
+        for(AtomVector::iterator it = all_atoms_.begin(); it != all_atoms_.end(); it++)
+        {
+            solute_coordinates.push_back((*it)->GetCoordinates().at(model_index_));
+            solute_charges.push_back(((*it)->MolecularDynamicAtom::GetCharge() != dNotSet) ? (*it)->MolecularDynamicAtom::GetCharge() : 0.0);
+        }
+        vector<double> overlap_distances = vector<double>(solute_coordinates.size(), minimum_solute_distance);
+        vector<double> potential_energies = vector<double>();
+        Grid::CalculatePotentialEnergies(sites, solute_coordinates, solute_charges, overlap_distances, number_of_threads, cutoff, screening_length,
+                                         potential_energies);
+        vector<pair<double, int> > entries = vector<pair<double, int> >();
+        for(int molecule = 0; molecule < number_of_molecules; molecule++)
+            if(potential_energies.at(molecule) != INFINITY)
+                entries.push_back(make_pair(potential_energies.at(molecule), molecule));
+        sort(entries.begin(), entries.end());
+        Grid::CellRanking ranking = Grid::CellRanking(entries.begin(), entries.end());
 
-            if(ion_charge == 0)
+        /// With a cutoff only the sites within reach of a placed ion change, and they are looked up in a neighbor grid of the sites
+        double reach = (cutoff > minimum_ion_distance) ? cutoff : minimum_ion_distance;
+        NeighborGrid* site_grid = (cutoff > 0.0) ? new NeighborGrid(sites, reach) : NULL;
+        vector<int> neighbors = vector<int>();
+        vector<int> grid_candidates = vector<int>();
+        vector<int> replaced_molecules = vector<int>();
+        while(placed_cations < number_of_cations || placed_anions < number_of_anions)
+        {
+            bool cation = (placed_anions >= number_of_anions) ||
+                    (placed_cations < number_of_cations && (long long)placed_cations * number_of_anions <= (long long)placed_anions * number_of_cations);
+            double ion_charge = (cation) ? cation_charge : anion_charge;
+            if(ranking.empty())
             {
-                gmml::log(__LINE__, __FILE__,  gmml::INF, "The ion has 0 charge");
-                cout << "The ion has 0 charge" << endl;
-                return;
+                gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no solvent molecule left to replace with an ion");
+                cout << "There is no solvent molecule left to replace with an ion" << endl;
+                break;
             }
-            else if(ion_charge > 0 && charge > 0)
+            /// The lowest potential energy is the best for a cation and the highest for an anion; ties are taken in the order of the molecules
+            vector<int> best_molecules = vector<int>();
+            if(cation)
             {
-                gmml::log(__LINE__, __FILE__,  gmml::ERR, "The assembly and the given ion have positive charges, neutralizing process is aborted.");
-                cout << "The assembly and the given ion have positive charges, neutralizing process is aborted." << endl;
-                return;
+                double best_value = ranking.begin()->first;
+                for(Grid::CellRanking::iterator it = ranking.begin(); it != ranking.end() && it->first - best_value < THRESHOLD; it++)
+                    best_molecules.push_back(it->second);
             }
-            else if(ion_charge < 0 && charge < 0)
+            else
             {
-                gmml::log(__LINE__, __FILE__,  gmml::ERR, "The assembly and the given ion have positive charges, neutralizing process is aborted.");
-                cout << "The assembly and the given ion have negative charges, neutralizing process is aborted." << endl;
-                return;
+                double best_value = ranking.rbegin()->first;
+                for(Grid::CellRanking::reverse_iterator it = ranking.rbegin(); it != ranking.rend() && best_value - it->first < THRESHOLD; it++)
+                    best_molecules.push_back(it->second);
             }
+            sort(best_molecules.begin(), best_molecules.end());
+            int best_molecule = best_molecules.at(((seed >= 0) ? rand_r(&random_state) : rand()) % best_molecules.size());
+            Coordinate position = *(sites.at(best_molecule));
+            replaced_molecules.push_back(best_molecule);
+            positions.push_back(position);
+            position_is_cation.push_back(cation);
+            if(cation)
+                placed_cations++;
             else
+                placed_anions++;
+            ranking.erase(make_pair(potential_energies.at(best_molecule), best_molecule));
+            potential_energies.at(best_molecule) = INFINITY;
+            neighbors.clear();
+            if(site_grid != NULL)
+                site_grid->GetIndicesWithinDistance(&position, reach, neighbors, grid_candidates);
+            int number_of_neighbors = (site_grid != NULL) ? neighbors.size() : number_of_molecules;
+            for(int n = 0; n < number_of_neighbors; n++)
             {
-                int number_of_neutralizing_ion = (int)(fabs(charge) + gmml::CHARGE_TOLERANCE) / (int)(fabs(ion_charge) + gmml::CHARGE_TOLERANCE);
-                stringstream ss;
-                ss << "The assembly will be neutralized by " << number_of_neutralizing_ion << " ion(s)";
-                gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
-
-                ParameterFile::AtomTypeMap atom_type_map = param->GetAtomTypes();
-                double ion_radius = MINIMUM_RADIUS;
-                double ion_mass = dNotSet;
-                if(atom_type_map.find(ion_name) != atom_type_map.end())
+                int molecule = (site_grid != NULL) ? neighbors.at(n) : n;
+                if(potential_energies.at(molecule) == INFINITY)
+                    continue;
+                double dist = sites.at(molecule)->Distance(position);
+                if(dist >= minimum_ion_distance && cutoff > 0.0 && dist >= cutoff)
+                    continue;
+                ranking.erase(make_pair(potential_energies.at(molecule), molecule));
+                if(dist < minimum_ion_distance)
+                    potential_energies.at(molecule) = INFINITY;
+                else
                 {
-                    ion_radius = atom_type_map[ion_name]->GetRadius();
-                    ion_mass = atom_type_map[ion_name]->GetMass();
-                }
-                Coordinate* minimum_boundary = new Coordinate();
-                Coordinate* maximum_boundary = new Coordinate();
-                this->GetBoundary(minimum_boundary, maximum_boundary);
-                if(minimum_boundary->GetX() == INFINITY || minimum_boundary->GetY() == INFINITY || minimum_boundary->GetZ() == INFINITY ||
-                        maximum_boundary->GetX() == -INFINITY || maximum_boundary->GetY() == -INFINITY || maximum_boundary->GetZ() == -INFINITY)
-                    return;
-
-                minimum_boundary->operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
-                maximum_boundary->operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
-
-                for(int i = 0; i < number_of_neutralizing_ion; i++)
-                {
-                    Grid* grid = new Grid(this, minimum_boundary, maximum_boundary, ion_radius, ion_charge);
-                    grid->CalculateCellsCharge();
-                    grid->CalculateCellsPotentialEnergy(ion_radius);
-                    CoordinateVector best_positions = grid->GetBestPositions(ion_charge);
-
-                    if(best_positions.size() == 0)
-                    {
-                        gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no optimum position to place the ion");
-                        cout << "There is no optimum position to place the ion" << endl;
-                        return;
-                    }
-                    else
-                    {
-                        int index = rand() % best_positions.size();
-                        Coordinate* best_position = new Coordinate(best_positions.at(index)->GetX(),
-                                                                   best_positions.at(index)->GetY(), best_positions.at(index)->GetZ());
-                        Grid::CellVector cells = grid->GetCells();
-                        for(Grid::CellVector::iterator it = cells.begin(); it != cells.end(); it++)
-                        {
-                            if(best_position->GetX() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetZ() &&
-                                    best_position->GetX() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetZ())
-                            {
-                                (*it)->SetCellPotentialEnergy(INFINITY);
-                            }
-                        }
-
-                        Residue* ion = new Residue(this, ion_residue_name);
-                        AtomVector atoms = AtomVector();
-                        stringstream residue_id;
-                        residue_id << ion->GetName() << "_" << BLANK_SPACE << "_" << (i+1) << "_" << BLANK_SPACE << "_" << BLANK_SPACE << "_" << id_;
-                        ion->SetId(residue_id.str());
-
-                        CoordinateVector atom_coordinates = CoordinateVector();
-                        atom_coordinates.push_back(best_position);
-                        Atom* ion_atom = new Atom(ion, lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetName(), atom_coordinates);
-                        ion_atom->MolecularDynamicAtom::SetAtomType(lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetType());
-                        ion_atom->MolecularDynamicAtom::SetCharge(lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetCharge());
-                        ion_atom->MolecularDynamicAtom::SetMass(ion_mass);
-                        ion_atom->MolecularDynamicAtom::SetRadius(ion_radius);
-                        stringstream atom_id;
-                        atom_id << ion_atom->GetName() << "_" << MAX_PDB_ATOM - i << "_" << residue_id.str();
-                        ion_atom->SetId(atom_id.str());
-
-                        atoms.push_back(ion_atom);
-                        ion->SetAtoms(atoms);
-
-                        this->AddResidue(ion);
-                    }
+                    potential_energies.at(molecule) += (screening_length > 0.0) ? ion_charge * exp(-dist / screening_length) / dist : ion_charge / dist;
+                    ranking.insert(make_pair(potential_energies.at(molecule), molecule));
                 }
             }
         }
-        else
-        {
-            gmml::log(__LINE__, __FILE__,  gmml::WAR, "The ion has not been found in the library file.");
-            cout << "The ion has not been found in the library file." << endl;
-        }
+        delete site_grid;
+        solvent_block_.RemoveMolecules(replaced_molecules);
     }
-    else if (ion_count > 0)
+    else
     {
-        gmml::log(__LINE__, __FILE__,  gmml::INF, "Ionizing .......");
-        cout << "Ionizing ......." << endl;
-        LibraryFile* lib = new LibraryFile(lib_file);
-        ParameterFile* param = new ParameterFile(parameter_file, gmml::IONICMOD);
-        double charge = this->GetTotalCharge();
-        stringstream ss;
-        ss << "Total charge of the assembly is " << charge;
-        gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
-        cout << ss.str() << endl;
-        double ion_charge = 0;
-        string ion_residue_name = "";
-        vector<string> ion_list = lib->GetAllResidueNames();
-        if(find(ion_list.begin(), ion_list.end(), ion_name) != ion_list.end())
+        if(replace_solvent)
         {
-            LibraryFileResidue* lib_ion_residue = lib->GetLibraryResidueByResidueName(ion_name);
-            ion_charge = lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetCharge();
-            ion_residue_name = lib_ion_residue->GetName();
-
-            if(ion_charge == 0)
+            gmml::log(__LINE__, __FILE__,  gmml::WAR, "There is no solvent to replace, the ions are placed around the assembly.");
+            cout << "There is no solvent to replace, the ions are placed around the assembly." << endl;
+        }
+        /// Both kinds of ions are placed from one grid; it is built for the larger ion so that neither of them overlaps with an atom
+        double ion_radius = (cation_radius > anion_radius) ? cation_radius : anion_radius;
+        Coordinate minimum_boundary = Coordinate();
+        Coordinate maximum_boundary = Coordinate();
+        this->GetBoundary(&minimum_boundary, &maximum_boundary);
+        if(minimum_boundary.GetX() == INFINITY || minimum_boundary.GetY() == INFINITY || minimum_boundary.GetZ() == INFINITY ||
+                maximum_boundary.GetX() == -INFINITY || maximum_boundary.GetY() == -INFINITY || maximum_boundary.GetZ() == -INFINITY)
+            return;
+        minimum_boundary.operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
+        maximum_boundary.operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
+        Grid grid(this, &minimum_boundary, &maximum_boundary, ion_radius, cation_charge);
+        grid.CalculateCellsPotentialEnergy(ion_radius, number_of_threads, cutoff, screening_length, minimum_solute_distance);
+        grid.RankCells(cation_charge);
+        while(placed_cations < number_of_cations || placed_anions < number_of_anions)
+        {
+            bool cation = (placed_anions >= number_of_anions) ||
+                    (placed_cations < number_of_cations && (long long)placed_cations * number_of_anions <= (long long)placed_anions * number_of_cations);
+            Grid::CellVector best_cells = grid.GetBestRankedCells((cation) ? cation_charge : anion_charge);
+            if(best_cells.empty())
             {
-                gmml::log(__LINE__, __FILE__,  gmml::INF, "The ion has 0 charge");
-                cout << "The ion has 0 charge" << endl;
+                gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no optimum position to place the ion");
+                cout << "There is no optimum position to place the ion" << endl;
                 return;
             }
-            else
-            {
-                stringstream ss;
-                ss << "The assembly will be charged by " << ion_count << " ion(s)" ;
-                gmml::log(__LINE__, __FILE__,  gmml::INF, ss.str());
-                cout << ss.str() << endl;
-
-                ParameterFile::AtomTypeMap atom_type_map = param->GetAtomTypes();
-                double ion_radius = MINIMUM_RADIUS;
-                double ion_mass = dNotSet;
-                if(atom_type_map.find(ion_name) != atom_type_map.end())
-                {
-                    ion_radius = atom_type_map[ion_name]->GetRadius();
-                    ion_mass = atom_type_map[ion_name]->GetMass();
-                }
-                Coordinate* minimum_boundary = new Coordinate();
-                Coordinate* maximum_boundary = new Coordinate();
-                this->GetBoundary(minimum_boundary, maximum_boundary);
-
-                if(minimum_boundary->GetX() == INFINITY || minimum_boundary->GetY() == INFINITY || minimum_boundary->GetZ() == INFINITY ||
-                        maximum_boundary->GetX() == -INFINITY || maximum_boundary->GetY() == -INFINITY || maximum_boundary->GetZ() == -INFINITY)
-                    return;
-                minimum_boundary->operator +(-GRID_OFFSET - 2 * ion_radius - MARGIN);
-                maximum_boundary->operator +(GRID_OFFSET + 2 * ion_radius + MARGIN);
-
-                for(int i = 0; i < ion_count; i++)
-                {
-                    Grid* grid = new Grid(this, minimum_boundary, maximum_boundary, ion_radius, ion_charge);
-                    grid->CalculateCellsCharge();
-                    grid->CalculateCellsPotentialEnergy(ion_radius);
-                    CoordinateVector best_positions = grid->GetBestPositions(ion_charge);
+            Coordinate position = *(best_cells.at(((seed >= 0) ? rand_r(&random_state) : rand()) % best_cells.size())->GetCellCenter());
+            Atom* ion_atom = (cation) ? this->AddIonResidue(lib_cation_residue, cation_name, cation_mass, cation_radius, position, placed_cations++) :
+                                        this->AddIonResidue(lib_anion_residue, anion_name, anion_mass, anion_radius, position, placed_anions++);
+            grid.UpdateCellsPotentialEnergy(ion_atom, ion_radius, minimum_ion_distance);
+            grid.RemoveCellsInsideAssembly(ion_atom);
+        }
+        return;
+    }
 
-                    if(best_positions.size() == 0)
-                    {
-                        gmml::log(__LINE__, __FILE__,  gmml::ERR, "There is no optimum position to place the ion");
-                        cout << "There is no optimum position to place the ion" << endl;
-                        return;
-                    }
-                    else
-                    {
-                        int index = rand() % best_positions.size();
-                        Coordinate* best_position = new Coordinate(best_positions.at(index)->GetX(),
-                                                                   best_positions.at(index)->GetY(), best_positions.at(index)->GetZ());
-                        Grid::CellVector cells = grid->GetCells();
-                        for(Grid::CellVector::iterator it = cells.begin(); it != cells.end(); it++)
-                        {
-                            if(best_position->GetX() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() + CRITICAL_RADIOUS * ion_radius + GRID_OFFSET > (*it)->GetCellCenter()->GetZ() &&
-                                    best_position->GetX() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetX() &&
-                                    best_position->GetY() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetY() &&
-                                    best_position->GetZ() - CRITICAL_RADIOUS * ion_radius - GRID_OFFSET < (*it)->GetCellCenter()->GetZ())
-                            {
-                                (*it)->SetCellPotentialEnergy(INFINITY);
-                            }
-                        }
+    placed_cations = 0;
+    placed_anions = 0;
+    for(unsigned int i = 0; i < positions.size(); i++)
+    {
+        if(position_is_cation.at(i))
+            this->AddIonResidue(lib_cation_residue, cation_name, cation_mass, cation_radius, positions.at(i), placed_cations++);
+        else
+            this->AddIonResidue(lib_anion_residue, anion_name, anion_mass, anion_radius, positions.at(i), placed_anions++);
+    }
+}
 
-                        Residue* ion = new Residue(this, ion_residue_name);
-                        AtomVector atoms = AtomVector();
-                        stringstream residue_id;
-                        residue_id << ion->GetName() << "_" << BLANK_SPACE << "_" << (i+1) << "_" << BLANK_SPACE << "_" << BLANK_SPACE << "_" << id_;
-                        ion->SetId(residue_id.str());
+Atom* Assembly::AddIonResidue(LibraryFileResidue* lib_ion_residue, string ion_name, double ion_mass, double ion_radius, Coordinate position, int ion_index)
+{
+    Residue* ion = this->CreateResidue();
+    ion->SetAssembly(this);
+    ion->SetName(lib_ion_residue->GetName());
+    AtomVector atoms = AtomVector();
+    stringstream residue_id;
+    residue_id << ion->GetName() << "_" << BLANK_SPACE << "_" << (ion_index + 1) << "_" << BLANK_SPACE << "_" << BLANK_SPACE << "_" << id_;
+    ion->SetId(residue_id.str());
 
-                        CoordinateVector atom_coordinates = CoordinateVector();
-                        atom_coordinates.push_back(best_position);
-                        Atom* ion_atom = new Atom(ion, lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetName(), atom_coordinates);
-                        ion_atom->MolecularDynamicAtom::SetAtomType(lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetType());
-                        ion_atom->MolecularDynamicAtom::SetCharge(lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetCharge());
-                        ion_atom->MolecularDynamicAtom::SetMass(ion_mass);
-                        ion_atom->MolecularDynamicAtom::SetRadius(ion_radius);
-                        stringstream atom_id;
-                        atom_id << ion_atom->GetName() << "_" << MAX_PDB_ATOM - i << "_" << residue_id.str();
-                        ion_atom->SetId(atom_id.str());
+    Atom* ion_atom = this->CreateAtom();
+    ion_atom->SetResidue(ion);
+    ion_atom->SetName(lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetName());
+    ion_atom->AddCoordinate(this->CreateCoordinate(position));
+    ion_atom->MolecularDynamicAtom::SetAtomType(lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetType());
+    ion_atom->MolecularDynamicAtom::SetCharge(lib_ion_residue->GetLibraryAtomByAtomName(ion_name)->GetCharge());
+    ion_atom->MolecularDynamicAtom::SetMass(ion_mass);
+    ion_atom->MolecularDynamicAtom::SetRadius(ion_radius);
+    stringstream atom_id;
+    atom_id << ion_atom->GetName() << "_" << MAX_PDB_ATOM - ion_index << "_" << residue_id.str();
+    ion_atom->SetId(atom_id.str());
 
-                        atoms.push_back(ion_atom);
-                        ion->SetAtoms(atoms);
+    atoms.push_back(ion_atom);
+    ion->SetAtoms(atoms);
 
-                        this->AddResidue(ion);
-                    }
-                }
-            }
-        }
-        else
-        {
-            gmml::log(__LINE__, __FILE__,  gmml::ERR, "The ion has not been found in the library file.");
-            cout << "The ion has not been found in the library file." << endl;
-        }
-    }
-    else
-    {
-        gmml::log(__LINE__, __FILE__,  gmml::ERR, "Please have a non-negative number as the number of ion(s) want to add");
-        cout << "Please have a non-negative number as the number of ion(s) want to add" << endl;
-    }
+    ///AddResidue expands the solvent block first, so the ions come after the water residues whether or not the solvent is kept in a block
+    this->AddResidue(ion);
+    return ion_atom;
 }
 
 void Assembly::SplitIons(Assembly *assembly, ResidueVector ions)
 {
+    this->ExpandSolventBlock();
     for(AssemblyVector::iterator it = this->assemblies_.begin(); it != this->assemblies_.end(); it++)
         (*it)->SplitIons(assembly, ions);
     for(ResidueVector::iterator it = this->residues_.begin(); it != this->residues_.end(); it++)
@@ -122,17 +122,21 @@ void Assembly::RemoveHydrogenAtAttachedPosition(Residue *residue, int branch_ind
 
         }
         residue->RemoveAtom(hydrogen);
+        this->NotifyStructureChanged();
     }
 }
 
 void Assembly::AdjustCharge(Residue *residue, Residue *parent_residue, int branch_index)
 {
-    if(residue->GetName().compare("SO3") == 0)
+    SymbolTable::Symbol residue_name = residue->GetNameSymbol();
+    SymbolTable::Symbol methyl_name = SymbolTable::Intern("MEX");
+    SymbolTable::Symbol acetyl_name = SymbolTable::Intern("ACX");
+    if(residue_name == SymbolTable::Intern("SO3"))
     {
       parent_residue->GetTailAtoms().at(branch_index)->MolecularDynamicAtom::SetCharge(
                   parent_residue->GetTailAtoms().at(branch_index)->MolecularDynamicAtom::GetCharge() + 0.031);
     }
-    else if(residue->GetName().compare("MEX") == 0 || residue->GetName().compare("ACX") == 0)
+    else if(residue_name == methyl_name || residue_name == acetyl_name)
     {
         Atom* oxygen = parent_residue->GetTailAtoms().at(branch_index);
         Atom* carbon = NULL;
@@ -154,9 +158,9 @@ void Assembly::AdjustCharge(Residue *residue, Residue *parent_residue, int branc
         }
         if(carbon != NULL)
         {
-            if(residue->GetName().compare("MEX") == 0)
+            if(residue_name == methyl_name)
                 carbon->MolecularDynamicAtom::SetCharge(carbon->MolecularDynamicAtom::GetCharge() - 0.039);
-            if(residue->GetName().compare("ACX") == 0)
+            if(residue_name == acetyl_name)
                 carbon->MolecularDynamicAtom::SetCharge(carbon->MolecularDynamicAtom::GetCharge() + 0.008);
         }
     }
@@ -142,6 +142,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                 }
                 else
                     residue_name_search_type = 0;
+                SymbolTable::Symbol residue_name_symbol = SymbolTable::Intern(residue_name);
                 if(residue_name.find("*") == string::npos)
                 {
                     for(ResidueVector::iterator it2 = residues_of_assembly.begin(); it2 != residues_of_assembly.end(); it2++)
@@ -151,7 +152,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                         {
                             case 0:  /// Search in residue set by matching the whole name of the residue
                             {
-                                if(residue->GetName().compare(residue_name) == 0)
+                                if(residue->GetNameSymbol() == residue_name_symbol)
                                 {
                                     vector<string> atom_names = (*it1).second;
                                     if(find(atom_names.begin(), atom_names.end(), "*") == atom_names.end())
@@ -178,6 +179,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                             }
                                             else
                                                 atom_name_search_type = 0;
+                                            SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                             for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                             {
                                                 Atom* atom = *it4;
@@ -185,7 +187,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                 {
                                                     case 0:
                                                     {
-                                                        if(atom->GetName().compare(atom_name) == 0)
+                                                        if(atom->GetNameSymbol() == atom_name_symbol)
                                                             selection.push_back(atom);
                                                         break;
                                                     }
@@ -205,7 +207,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     case -2:
                                                     {
-                                                        string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                        string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                         int range_selection = 0;
                                                         if(atom_name.find("-") != string::npos)
                                                         {
@@ -284,6 +286,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                             }
                                             else
                                                 atom_name_search_type = 0;
+                                            SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                             for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                             {
                                                 Atom* atom = *it4;
@@ -291,7 +294,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                 {
                                                     case 0:
                                                     {
-                                                        if(atom->GetName().compare(atom_name) == 0)
+                                                        if(atom->GetNameSymbol() == atom_name_symbol)
                                                             selection.push_back(atom);
                                                         break;
                                                     }
@@ -311,7 +314,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     case -2:
                                                     {
-                                                        string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                        string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                         int range_selection = 0;
                                                         if(atom_name.find("-") != string::npos)
                                                         {
@@ -390,6 +393,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                             }
                                             else
                                                 atom_name_search_type = 0;
+                                            SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                             for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                             {
                                                 Atom* atom = *it4;
@@ -397,7 +401,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                 {
                                                     case 0:
                                                     {
-                                                        if(atom->GetName().compare(atom_name) == 0)
+                                                        if(atom->GetNameSymbol() == atom_name_symbol)
                                                             selection.push_back(atom);
                                                         break;
                                                     }
@@ -417,7 +421,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     case -2:
                                                     {
-                                                        string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                        string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                         int range_selection = 0;
                                                         if(atom_name.find("-") != string::npos)
                                                         {
@@ -468,7 +472,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                             }
                             case -2:  /// Searching the residue set by matching the residue sequence number
                             {
-                                string residue_sequence_number = Split(residue->GetId(), "_").at(2);
+                                string residue_sequence_number = ConvertT<int>(residue->GetSequenceNumber());
                                 int range_residue_selection = 0;
                                 if(residue_sequence_number.find("-") != string::npos)
                                 {
@@ -508,6 +512,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     else
                                                         atom_name_search_type = 0;
+                                                    SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                     for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                     {
                                                         Atom* atom = *it4;
@@ -515,7 +520,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         {
                                                             case 0:
                                                             {
-                                                                if(atom->GetName().compare(atom_name) == 0)
+                                                                if(atom->GetNameSymbol() == atom_name_symbol)
                                                                     selection.push_back(atom);
                                                                 break;
                                                             }
@@ -535,7 +540,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             }
                                                             case -2:
                                                             {
-                                                                string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                 int range_selection = 0;
                                                                 if(atom_name.find("-") != string::npos)
                                                                 {
@@ -618,6 +623,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     else
                                                         atom_name_search_type = 0;
+                                                    SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                     for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                     {
                                                         Atom* atom = *it4;
@@ -625,7 +631,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         {
                                                             case 0:
                                                             {
-                                                                if(atom->GetName().compare(atom_name) == 0)
+                                                                if(atom->GetNameSymbol() == atom_name_symbol)
                                                                     selection.push_back(atom);
                                                                 break;
                                                             }
@@ -645,7 +651,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             }
                                                             case -2:
                                                             {
-                                                                string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                 int range_selection = 0;
                                                                 if(atom_name.find("-") != string::npos)
                                                                 {
@@ -730,6 +736,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                 }
                                 else
                                     atom_name_search_type = 0;
+                                SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                 for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                 {
                                     Atom* atom = *it4;
@@ -737,7 +744,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                     {
                                         case 0:
                                         {
-                                            if(atom->GetName().compare(atom_name) == 0)
+                                            if(atom->GetNameSymbol() == atom_name_symbol)
                                                 selection.push_back(atom);
                                             break;
                                         }
@@ -757,7 +764,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                         }
                                         case -2:
                                         {
-                                            string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                            string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                             int range_selection = 0;
                                             if(atom_name.find("-") != string::npos)
                                             {
@@ -839,6 +846,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                         }
                         else
                             residue_name_search_type = 0;
+                        SymbolTable::Symbol residue_name_symbol = SymbolTable::Intern(residue_name);
                         if(residue_name.find("*") == string::npos)
                         {
                             for(ResidueVector::iterator it2 = residues_of_assembly.begin(); it2 != residues_of_assembly.end(); it2++)
@@ -848,7 +856,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                 {
                                     case 0:  /// Search in residue set by matching the whole name of the residue
                                     {
-                                        if(residue->GetName().compare(residue_name) == 0)
+                                        if(residue->GetNameSymbol() == residue_name_symbol)
                                         {
                                             vector<string> atom_names = (*it1).second;
                                             if(find(atom_names.begin(), atom_names.end(), "*") == atom_names.end())
@@ -875,6 +883,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     else
                                                         atom_name_search_type = 0;
+                                                    SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                     for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                     {
                                                         Atom* atom = *it4;
@@ -882,7 +891,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         {
                                                             case 0:
                                                             {
-                                                                if(atom->GetName().compare(atom_name) == 0)
+                                                                if(atom->GetNameSymbol() == atom_name_symbol)
                                                                     selection.push_back(atom);
                                                                 break;
                                                             }
@@ -902,7 +911,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             }
                                                             case -2:
                                                             {
-                                                                string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                 int range_selection = 0;
                                                                 if(atom_name.find("-") != string::npos)
                                                                 {
@@ -981,6 +990,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     else
                                                         atom_name_search_type = 0;
+                                                    SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                     for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                     {
                                                         Atom* atom = *it4;
@@ -988,7 +998,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         {
                                                             case 0:
                                                             {
-                                                                if(atom->GetName().compare(atom_name) == 0)
+                                                                if(atom->GetNameSymbol() == atom_name_symbol)
                                                                     selection.push_back(atom);
                                                                 break;
                                                             }
@@ -1008,7 +1018,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             }
                                                             case -2:
                                                             {
-                                                                string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                 int range_selection = 0;
                                                                 if(atom_name.find("-") != string::npos)
                                                                 {
@@ -1087,6 +1097,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     else
                                                         atom_name_search_type = 0;
+                                                    SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                     for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                     {
                                                         Atom* atom = *it4;
@@ -1094,7 +1105,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         {
                                                             case 0:
                                                             {
-                                                                if(atom->GetName().compare(atom_name) == 0)
+                                                                if(atom->GetNameSymbol() == atom_name_symbol)
                                                                     selection.push_back(atom);
                                                                 break;
                                                             }
@@ -1114,7 +1125,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             }
                                                             case -2:
                                                             {
-                                                                string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                 int range_selection = 0;
                                                                 if(atom_name.find("-") != string::npos)
                                                                 {
@@ -1165,7 +1176,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                     }
                                     case -2:  /// Searching the residue set by matching the residue sequence number
                                     {
-                                        string residue_sequence_number = Split(residue->GetId(), "_").at(2);
+                                        string residue_sequence_number = ConvertT<int>(residue->GetSequenceNumber());
                                         int range_residue_selection = 0;
                                         if(residue_sequence_number.find("-") != string::npos)
                                         {
@@ -1205,6 +1216,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             }
                                                             else
                                                                 atom_name_search_type = 0;
+                                                            SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                             for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                             {
                                                                 Atom* atom = *it4;
@@ -1212,7 +1224,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                 {
                                                                     case 0:
                                                                     {
-                                                                        if(atom->GetName().compare(atom_name) == 0)
+                                                                        if(atom->GetNameSymbol() == atom_name_symbol)
                                                                             selection.push_back(atom);
                                                                         break;
                                                                     }
@@ -1232,7 +1244,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                     }
                                                                     case -2:
                                                                     {
-                                                                        string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                        string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                         int range_selection = 0;
                                                                         if(atom_name.find("-") != string::npos)
                                                                         {
@@ -1315,6 +1327,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             }
                                                             else
                                                                 atom_name_search_type = 0;
+                                                            SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                             for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                             {
                                                                 Atom* atom = *it4;
@@ -1322,7 +1335,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                 {
                                                                     case 0:
                                                                     {
-                                                                        if(atom->GetName().compare(atom_name) == 0)
+                                                                        if(atom->GetNameSymbol() == atom_name_symbol)
                                                                             selection.push_back(atom);
                                                                         break;
                                                                     }
@@ -1342,7 +1355,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                     }
                                                                     case -2:
                                                                     {
-                                                                        string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                        string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                         int range_selection = 0;
                                                                         if(atom_name.find("-") != string::npos)
                                                                         {
@@ -1427,6 +1440,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                         }
                                         else
                                             atom_name_search_type = 0;
+                                        SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                         for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                         {
                                             Atom* atom = *it4;
@@ -1434,7 +1448,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                             {
                                                 case 0:
                                                 {
-                                                    if(atom->GetName().compare(atom_name) == 0)
+                                                    if(atom->GetNameSymbol() == atom_name_symbol)
                                                         selection.push_back(atom);
                                                     break;
                                                 }
@@ -1454,7 +1468,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                 }
                                                 case -2:
                                                 {
-                                                    string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                    string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                     int range_selection = 0;
                                                     if(atom_name.find("-") != string::npos)
                                                     {
@@ -1537,6 +1551,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                             }
                             else
                                 residue_name_search_type = 0;
+                            SymbolTable::Symbol residue_name_symbol = SymbolTable::Intern(residue_name);
                             if(residue_name.find("*") == string::npos)
                             {
                                 for(ResidueVector::iterator it2 = residues_of_assembly.begin(); it2 != residues_of_assembly.end(); it2++)
@@ -1546,7 +1561,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                     {
                                         case 0:  /// Search in residue set by matching the whole name of the residue
                                         {
-                                            if(residue->GetName().compare(residue_name) == 0)
+                                            if(residue->GetNameSymbol() == residue_name_symbol)
                                             {
                                                 vector<string> atom_names = (*it1).second;
                                                 if(find(atom_names.begin(), atom_names.end(), "*") == atom_names.end())
@@ -1573,6 +1588,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         }
                                                         else
                                                             atom_name_search_type = 0;
+                                                        SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                         for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                         {
                                                             Atom* atom = *it4;
@@ -1580,7 +1596,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             {
                                                                 case 0:
                                                                 {
-                                                                    if(atom->GetName().compare(atom_name) == 0)
+                                                                    if(atom->GetNameSymbol() == atom_name_symbol)
                                                                         selection.push_back(atom);
                                                                     break;
                                                                 }
@@ -1600,7 +1616,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                 }
                                                                 case -2:
                                                                 {
-                                                                    string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                    string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                     int range_selection = 0;
                                                                     if(atom_name.find("-") != string::npos)
                                                                     {
@@ -1679,6 +1695,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         }
                                                         else
                                                             atom_name_search_type = 0;
+                                                        SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                         for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                         {
                                                             Atom* atom = *it4;
@@ -1686,7 +1703,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             {
                                                                 case 0:
                                                                 {
-                                                                    if(atom->GetName().compare(atom_name) == 0)
+                                                                    if(atom->GetNameSymbol() == atom_name_symbol)
                                                                         selection.push_back(atom);
                                                                     break;
                                                                 }
@@ -1706,7 +1723,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                 }
                                                                 case -2:
                                                                 {
-                                                                    string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                    string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                     int range_selection = 0;
                                                                     if(atom_name.find("-") != string::npos)
                                                                     {
@@ -1785,6 +1802,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                         }
                                                         else
                                                             atom_name_search_type = 0;
+                                                        SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                         for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                         {
                                                             Atom* atom = *it4;
@@ -1792,7 +1810,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                             {
                                                                 case 0:
                                                                 {
-                                                                    if(atom->GetName().compare(atom_name) == 0)
+                                                                    if(atom->GetNameSymbol() == atom_name_symbol)
                                                                         selection.push_back(atom);
                                                                     break;
                                                                 }
@@ -1812,7 +1830,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                 }
                                                                 case -2:
                                                                 {
-                                                                    string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                    string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                     int range_selection = 0;
                                                                     if(atom_name.find("-") != string::npos)
                                                                     {
@@ -1863,7 +1881,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                         }
                                         case -2:  /// Searching the residue set by matching the residue sequence number
                                         {
-                                            string residue_sequence_number = Split(residue->GetId(), "_").at(2);
+                                            string residue_sequence_number = ConvertT<int>(residue->GetSequenceNumber());
                                             int range_residue_selection = 0;
                                             if(residue_sequence_number.find("-") != string::npos)
                                             {
@@ -1903,6 +1921,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                 }
                                                                 else
                                                                     atom_name_search_type = 0;
+                                                                SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                                 for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                                 {
                                                                     Atom* atom = *it4;
@@ -1910,7 +1929,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                     {
                                                                         case 0:
                                                                         {
-                                                                            if(atom->GetName().compare(atom_name) == 0)
+                                                                            if(atom->GetNameSymbol() == atom_name_symbol)
                                                                                 selection.push_back(atom);
                                                                             break;
                                                                         }
@@ -1930,7 +1949,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                         }
                                                                         case -2:
                                                                         {
-                                                                            string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                            string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                             int range_selection = 0;
                                                                             if(atom_name.find("-") != string::npos)
                                                                             {
@@ -2013,6 +2032,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                 }
                                                                 else
                                                                     atom_name_search_type = 0;
+                                                                SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                                                 for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                                                 {
                                                                     Atom* atom = *it4;
@@ -2020,7 +2040,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                     {
                                                                         case 0:
                                                                         {
-                                                                            if(atom->GetName().compare(atom_name) == 0)
+                                                                            if(atom->GetNameSymbol() == atom_name_symbol)
                                                                                 selection.push_back(atom);
                                                                             break;
                                                                         }
@@ -2040,7 +2060,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                                         }
                                                                         case -2:
                                                                         {
-                                                                            string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                                            string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                                             int range_selection = 0;
                                                                             if(atom_name.find("-") != string::npos)
                                                                             {
@@ -2125,6 +2145,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                             }
                                             else
                                                 atom_name_search_type = 0;
+                                            SymbolTable::Symbol atom_name_symbol = SymbolTable::Intern(atom_name);
                                             for(AtomVector::iterator it4 = atoms.begin(); it4 != atoms.end(); it4++)
                                             {
                                                 Atom* atom = *it4;
@@ -2132,7 +2153,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                 {
                                                     case 0:
                                                     {
-                                                        if(atom->GetName().compare(atom_name) == 0)
+                                                        if(atom->GetNameSymbol() == atom_name_symbol)
                                                             selection.push_back(atom);
                                                         break;
                                                     }
@@ -2152,7 +2173,7 @@ Assembly::AtomVector Assembly::Select(string pattern)
                                                     }
                                                     case -2:
                                                     {
-                                                        string atom_serial_number = Split(atom->GetId(), "_").at(1);
+                                                        string atom_serial_number = ConvertT<int>(atom->GetSerialNumber());
                                                         int range_selection = 0;
                                                         if(atom_name.find("-") != string::npos)
                                                         {
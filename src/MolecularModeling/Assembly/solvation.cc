@@ -5,6 +5,7 @@
 #include <set>
 #include <queue>
 #include <stack>
+#include <algorithm>
 
 #include "../../../includes/MolecularModeling/assembly.hpp"
 #include "../../../includes/MolecularModeling/residue.hpp"
@@ -63,6 +64,7 @@
 #include "../../../includes/common.hpp"
 #include "../../../includes/GeometryTopology/grid.hpp"
 #include "../../../includes/GeometryTopology/cell.hpp"
+#include "../../../includes/GeometryTopology/neighborgrid.hpp"
 
 #include <unistd.h>
 #include <errno.h>
@@ -85,20 +87,87 @@ using namespace CondensedSequenceSpace;
 //////////////////////////////////////////////////////////
 //                       FUNCTIONS                      //
 //////////////////////////////////////////////////////////
-void Assembly::AddSolvent(double extension, double closeness, string lib_file)
+void* AddSolventBoxThread(void* args)
 {
-    Coordinate* solvent_component_min_boundary = new Coordinate();
-    Coordinate* solvent_component_max_boundary = new Coordinate();
-    Assembly* solvent_component = new Assembly();                   //Box of water (TIP3p | TIP5p)
-    solvent_component->BuildAssemblyFromLibraryFile(lib_file);      //Reading the box of water from library file
+    SolventBoxThreadArgument* arg = (SolventBoxThreadArgument*)args;
+    vector<vector<int> >& solvent_molecules = *(arg->solvent_molecules);
+    vector<Coordinate>& solvent_coordinates = *(arg->solvent_coordinates);
+    NeighborGrid* solute_grid = arg->solute_grid;
+    Coordinate* solvent_box_max_boundary = arg->solvent_box_max_boundary;
+    Coordinate* center = arg->center;
+    int number_of_boxes = arg->box_shifts->size();
+    vector<int> close_solute_atoms = vector<int>();
+    vector<int> grid_candidates = vector<int>();
+
+    ///Each thread owns a contiguous chunk of the box copies and only writes the removal flags of its own boxes
+    int begin_index = (int)(((long long)arg->thread_index * number_of_boxes) / arg->number_of_threads);
+    int end_index = (int)(((long long)(arg->thread_index + 1) * number_of_boxes) / arg->number_of_threads);
+    for(int box = begin_index; box < end_index; box++)
+    {
+        Coordinate& shift = arg->box_shifts->at(box);
+        vector<bool>& removed = arg->removed_molecules->at(box);
+        removed.assign(solvent_molecules.size(), false);
+        for(unsigned int molecule = 0; molecule < solvent_molecules.size(); molecule++)
+        {
+            //A molecule is removed as a whole as soon as one of its atoms is outside the solvent cube or too close to the solute
+            vector<int>& molecule_atoms = solvent_molecules.at(molecule);
+            bool in_shell = false;
+            for(vector<int>::iterator it = molecule_atoms.begin(); it != molecule_atoms.end() && !removed.at(molecule); it++)
+            {
+                Coordinate tip_atom_coords = solvent_coordinates.at(*it);
+                tip_atom_coords.Translate(shift.GetX(), shift.GetY(), shift.GetZ());
+                if(tip_atom_coords.GetX() >= solvent_box_max_boundary->GetX() || tip_atom_coords.GetY() >= solvent_box_max_boundary->GetY() ||
+                        tip_atom_coords.GetZ() >= solvent_box_max_boundary->GetZ())
+                {
+                    removed.at(molecule) = true;
+                    break;
+                }
+                //The truncated octahedron is the part of the cube that is cut off by the (hexagonal) faces |x| + |y| + |z| = limit around the center
+                if(arg->shape == SOLVENT_TRUNCATED_OCTAHEDRON &&
+                        fabs(tip_atom_coords.GetX() - center->GetX()) + fabs(tip_atom_coords.GetY() - center->GetY()) +
+                        fabs(tip_atom_coords.GetZ() - center->GetZ()) >= arg->octahedron_limit)
+                {
+                    removed.at(molecule) = true;
+                    break;
+                }
+                //Only the solute atoms of the surrounding grid cells can be within closeness
+                close_solute_atoms.clear();
+                solute_grid->GetIndicesWithinDistance(&tip_atom_coords, arg->closeness, close_solute_atoms, grid_candidates);
+                if(!close_solute_atoms.empty())
+                    removed.at(molecule) = true;
+                //A molecule belongs to the shell if any of its atoms is within the shell distance of the solute
+                if(arg->shape == SOLVENT_SHELL && !in_shell)
+                {
+                    close_solute_atoms.clear();
+                    arg->shell_grid->GetIndicesWithinDistance(&tip_atom_coords, arg->shell_distance, close_solute_atoms, grid_candidates);
+                    in_shell = !close_solute_atoms.empty();
+                }
+            }
+            if(arg->shape == SOLVENT_SHELL && !in_shell)
+                removed.at(molecule) = true;
+        }
+    }
+    pthread_exit(NULL);
+}
+
+void Assembly::AddSolvent(double extension, double closeness, string lib_file, int number_of_threads, SolventShape shape)
+{
+    if(number_of_threads < 1)
+        number_of_threads = 1;
+
+    //Reading the box of water (TIP3p | TIP5p) from library file once; it is the template of all copies
+    LibraryFile* lib = new LibraryFile(lib_file);
+    Assembly* solvent_component = new Assembly();
+    solvent_component->BuildAssemblyFromLibraryFile(lib);
     solvent_component->SetSourceFile(lib_file);
-    solvent_component->BuildStructureByLIBFileInformation();        //Building the structure of the box of water
+    solvent_component->BuildStructureByLIBFileInformation(lib);    //Building the structure of the box of water
 
     //Bounding box calculation of the water box (TIP3p | TIP5p)
-    solvent_component->GetBoundary(solvent_component_min_boundary, solvent_component_max_boundary);
+    Coordinate solvent_component_min_boundary = Coordinate();
+    Coordinate solvent_component_max_boundary = Coordinate();
+    solvent_component->GetBoundary(&solvent_component_min_boundary, &solvent_component_max_boundary);
 
     //Reading the exact dimension of the water box from library file
-    LibraryFile* lib = new LibraryFile(lib_file);
     LibraryFile::ResidueMap lib_residues = lib->GetResidues();
     LibraryFileResidue* lib_residue  = lib_residues.begin()->second;
 
@@ -107,12 +176,18 @@ void Assembly::AddSolvent(double extension, double closeness, string lib_file)
     double solvent_height = lib_residue->GetBoxHeight();
 
     //Bounding box calculation of the solute
-    Coordinate* solute_min_boundary = new Coordinate();
-    Coordinate* solute_max_boundary = new Coordinate();
-    this->GetBoundary(solute_min_boundary, solute_max_boundary);
-    double solute_length = solute_max_boundary->GetX() - solute_min_boundary->GetX();
-    double solute_width = solute_max_boundary->GetY() - solute_min_boundary->GetY();
-    double solute_height = solute_max_boundary->GetZ() - solute_min_boundary->GetZ();
+    Coordinate solute_min_boundary = Coordinate();
+    Coordinate solute_max_boundary = Coordinate();
+    this->GetBoundary(&solute_min_boundary, &solute_max_boundary);
+    double solute_length = solute_max_boundary.GetX() - solute_min_boundary.GetX();
+    double solute_width = solute_max_boundary.GetY() - solute_min_boundary.GetY();
+    double solute_height = solute_max_boundary.GetZ() - solute_min_boundary.GetZ();
+
+    //Only the solute atoms (and not the water that is being added) are checked for overlaps
+    const AtomVector& all_atoms_of_solute = this->GetAllAtomsOfAssemblyView();
+    CoordinateVector solute_coordinates = CoordinateVector();
+    for(AtomVector::const_iterator it = all_atoms_of_solute.begin(); it != all_atoms_of_solute.end(); it++)
+        solute_coordinates.push_back((*it)->GetCoordinate(model_index_));
 
     //Solvent cube dimension calculation
     double solvent_box_dimension = 0;
@@ -125,16 +200,35 @@ void Assembly::AddSolvent(double extension, double closeness, string lib_file)
     solvent_box_dimension += extension;
 
     //Center of solute calculation
-    Coordinate* center_of_box = new Coordinate(solute_min_boundary->GetX() + solute_length/2, solute_min_boundary->GetY() + solute_width/2,
-                                               solute_min_boundary->GetZ() + solute_height/2);
+    Coordinate center_of_box = Coordinate(solute_min_boundary.GetX() + solute_length/2, solute_min_boundary.GetY() + solute_width/2,
+                                          solute_min_boundary.GetZ() + solute_height/2);
+
+    //The hexagonal faces of a truncated octahedron cut into a cube of half size h at |x| + |y| + |z| = 3h/2 (relative to the center),
+    //so the cube is enlarged until every solute atom is at least extension away from these faces as well
+    double octahedron_limit = 0.0;
+    if(shape == SOLVENT_TRUNCATED_OCTAHEDRON)
+    {
+        double max_octahedral_distance = 0.0;
+        for(CoordinateVector::iterator it = solute_coordinates.begin(); it != solute_coordinates.end(); it++)
+        {
+            double octahedral_distance = fabs((*it)->GetX() - center_of_box.GetX()) + fabs((*it)->GetY() - center_of_box.GetY()) +
+                    fabs((*it)->GetZ() - center_of_box.GetZ());
+            if(octahedral_distance > max_octahedral_distance)
+                max_octahedral_distance = octahedral_distance;
+        }
+        double octahedron_dimension = (max_octahedral_distance + sqrt(3.0) * extension) * 2.0 / 3.0;
+        if(octahedron_dimension > solvent_box_dimension)
+            solvent_box_dimension = octahedron_dimension;
+        octahedron_limit = solvent_box_dimension * 3.0 / 2.0;
+    }
     //Creating the solvent cube around the center of solute
-    Coordinate* solvent_box_min_boundary = new Coordinate(center_of_box->GetX(), center_of_box->GetY(), center_of_box->GetZ());
-    solvent_box_min_boundary->operator +(-solvent_box_dimension);
-    Coordinate* solvent_box_max_boundary = new Coordinate(center_of_box->GetX(), center_of_box->GetY(), center_of_box->GetZ());
-    solvent_box_max_boundary->operator +(solvent_box_dimension);
-    double solvent_box_length = solvent_box_max_boundary->GetX() - solvent_box_min_boundary->GetX();
-    double solvent_box_width = solvent_box_max_boundary->GetY() - solvent_box_min_boundary->GetY();
-    double solvent_box_height = solvent_box_max_boundary->GetZ() - solvent_box_min_boundary->GetZ();
+    Coordinate solvent_box_min_boundary = Coordinate(center_of_box.GetX(), center_of_box.GetY(), center_of_box.GetZ());
+    solvent_box_min_boundary.operator +(-solvent_box_dimension);
+    Coordinate solvent_box_max_boundary = Coordinate(center_of_box.GetX(), center_of_box.GetY(), center_of_box.GetZ());
+    solvent_box_max_boundary.operator +(solvent_box_dimension);
+    double solvent_box_length = solvent_box_max_boundary.GetX() - solvent_box_min_boundary.GetX();
+    double solvent_box_width = solvent_box_max_boundary.GetY() - solvent_box_min_boundary.GetY();
+    double solvent_box_height = solvent_box_max_boundary.GetZ() - solvent_box_min_boundary.GetZ();
 
     //Number of copies of water box along x, y and z axis inside solvent cube
     int x_copy = solvent_box_length/solvent_length + 1;
@@ -142,147 +236,157 @@ void Assembly::AddSolvent(double extension, double closeness, string lib_file)
     int z_copy = solvent_box_height/solvent_height + 1;
 
     //Amount of shifting of the default water box along x, y and z axis to be placed in the min corner of the solvent cube
-    double shift_x = solvent_box_min_boundary->GetX() - solvent_component_min_boundary->GetX();// - solvent_length/2;
-    double shift_y = solvent_box_min_boundary->GetY() - solvent_component_min_boundary->GetY();// - solvent_width/2;
-    double shift_z = solvent_box_min_boundary->GetZ() - solvent_component_min_boundary->GetZ();// - solvent_height/2;
-
-    int sequence_number = this->GetResidues().size() + 1;
-    int serial_number = this->GetAllAtomsOfAssembly().size() + 1;
+    double shift_x = solvent_box_min_boundary.GetX() - solvent_component_min_boundary.GetX();// - solvent_length/2;
+    double shift_y = solvent_box_min_boundary.GetY() - solvent_component_min_boundary.GetY();// - solvent_width/2;
+    double shift_z = solvent_box_min_boundary.GetZ() - solvent_component_min_boundary.GetZ();// - solvent_height/2;
 
-    //Filling the solvent cube with water boxes
-    for(int i = 0; i < x_copy; i ++)
+    //Template of the water box: coordinates of its atoms and its molecules (connected sets of atoms) by their index
+    AtomVector all_atoms_of_tip = solvent_component->GetAllAtomsOfAssembly();
+    BondGraph solvent_graph = BondGraph(all_atoms_of_tip);
+    vector<Coordinate> solvent_coordinates = vector<Coordinate>();
+    for(AtomVector::iterator it = all_atoms_of_tip.begin(); it != all_atoms_of_tip.end(); it++)
+        solvent_coordinates.push_back(Coordinate((*it)->GetCoordinate(0)));
+    const BondGraph::IndexVector& offsets = solvent_graph.GetOffsets();
+    const BondGraph::IndexVector& neighbors = solvent_graph.GetNeighbors();
+    vector<int> molecule_of_atom = vector<int>(all_atoms_of_tip.size(), -1);
+    vector<vector<int> > solvent_molecules = vector<vector<int> >();
+    for(unsigned int index = 0; index < all_atoms_of_tip.size(); index++)
     {
-        for(int j = 0; j < y_copy; j ++)
+        if(molecule_of_atom.at(index) != -1)
+            continue;
+        int molecule = solvent_molecules.size();
+        solvent_molecules.push_back(vector<int>(1, index));
+        molecule_of_atom.at(index) = molecule;
+        for(unsigned int i = 0; i < solvent_molecules.at(molecule).size(); i++)
         {
-            for(int k = 0; k < z_copy; k++)
+            int atom_index = solvent_molecules.at(molecule).at(i);
+            for(int j = offsets.at(atom_index); j < offsets.at(atom_index + 1); j++)
             {
-                //solute_min/max_with_extension = solute_min/max_boundary + closeness
-                //check coordinate of each atom to see if it's between solute_min/max_with_extension
-                //if so, check distance with all solutes atoms (this)
-                //if < closeness remove else add to to_be_added_atoms vector
-                Coordinate* solute_min_boundary_with_extension = new Coordinate();
-                Coordinate* solute_max_boundary_with_extension = new Coordinate();
-                solute_min_boundary_with_extension->SetX(solute_min_boundary->GetX() - closeness);
-                solute_min_boundary_with_extension->SetY(solute_min_boundary->GetY() - closeness);
-                solute_min_boundary_with_extension->SetZ(solute_min_boundary->GetZ() - closeness);
-                solute_max_boundary_with_extension->SetX(solute_max_boundary->GetX() + closeness);
-                solute_max_boundary_with_extension->SetY(solute_max_boundary->GetY() + closeness);
-                solute_max_boundary_with_extension->SetZ(solute_max_boundary->GetZ() + closeness);
-                Assembly* tip_box = new Assembly();
-                tip_box->BuildAssemblyFromLibraryFile(lib_file);
-                tip_box->SetSourceFile(lib_file);
-                tip_box->BuildStructureByLIBFileInformation();
-                //                    tip_box->BuildStructureByDistance();
-                AtomVector all_atoms_of_tip = tip_box->GetAllAtomsOfAssembly();
-                Residue* tip_residue = new Residue();
-                vector<string> removed_atom_id_list = vector<string>();
-                for(AtomVector::iterator it = all_atoms_of_tip.begin(); it != all_atoms_of_tip.end(); it++)
+                if(molecule_of_atom.at(neighbors.at(j)) == -1)
                 {
-                    (*it)->GetCoordinates().at(model_index_)->Translate(shift_x + i * solvent_length,
-                                                                        shift_y + j * solvent_width, shift_z + k * solvent_height);
-                    (*it)->SetDescription("Het;");
+                    molecule_of_atom.at(neighbors.at(j)) = molecule;
+                    solvent_molecules.at(molecule).push_back(neighbors.at(j));
+                }
+            }
+        }
+    }
 
-                    //Check if the atom of the water box residue is outside the solvent cube and mark it as to be removed
-                    if(((*it)->GetCoordinates().at(model_index_)->GetX()) >= solvent_box_max_boundary->GetX())
-                        removed_atom_id_list.push_back((*it)->GetId());
-                    if(((*it)->GetCoordinates().at(model_index_)->GetY()) >= solvent_box_max_boundary->GetY())
-                        removed_atom_id_list.push_back((*it)->GetId());
-                    if(((*it)->GetCoordinates().at(model_index_)->GetZ()) >= solvent_box_max_boundary->GetZ())
-                        removed_atom_id_list.push_back((*it)->GetId());
-                    GeometryTopology::Coordinate* tip_atom_coords = (*it)->GetCoordinates().at(model_index_);
+    //All molecules of the box are stored as copies of its first one, so a box whose molecules differ from the first one is not added
+    vector<vector<int> > molecule_sites = solvent_molecules;
+    for(vector<vector<int> >::iterator it = molecule_sites.begin(); it != molecule_sites.end(); it++)
+        sort(it->begin(), it->end());
+    AtomVector template_atoms = AtomVector();
+    for(vector<int>::iterator it = molecule_sites.at(0).begin(); it != molecule_sites.at(0).end(); it++)
+        template_atoms.push_back(all_atoms_of_tip.at(*it));
+    for(unsigned int molecule = 0; molecule < molecule_sites.size(); molecule++)
+    {
+        vector<int>& sites = molecule_sites.at(molecule);
+        bool matches_template = (sites.size() == template_atoms.size());
+        for(unsigned int site = 0; site < sites.size() && matches_template; site++)
+            matches_template = (all_atoms_of_tip.at(sites.at(site))->GetName().compare(template_atoms.at(site)->GetName()) == 0);
+        if(!matches_template)
+        {
+            stringstream ss;
+            ss << "Molecule " << molecule + 1 << " of the solvent box in " << lib_file << " does not match its first molecule, solvating process is aborted.";
+            gmml::log(__LINE__, __FILE__, gmml::ERR, ss.str());
+            cout << ss.str() << endl;
+            delete solvent_component;
+            delete lib;
+            return;
+        }
+    }
 
-                    //Check if the atom of water box residue is overlaping the solute or is not far enough from the boundary of the solute
-                    //and mark it as to be removed
-                    if(solute_min_boundary_with_extension->GetX() <= tip_atom_coords->GetX() &&
-                            tip_atom_coords->GetX() <= solute_max_boundary_with_extension->GetX() &&
-                            solute_min_boundary_with_extension->GetY() <= tip_atom_coords->GetY() &&
-                            tip_atom_coords->GetY() <= solute_max_boundary_with_extension->GetY() &&
-                            solute_min_boundary_with_extension->GetZ() <= tip_atom_coords->GetZ() &&
-                            tip_atom_coords->GetZ() <= solute_max_boundary_with_extension->GetZ() )
-                    {
-                        AtomVector all_atoms_of_solute = this->GetAllAtomsOfAssembly();
-                        bool flag = false;
-                        for(AtomVector::iterator it1 = all_atoms_of_solute.begin(); it1 != all_atoms_of_solute.end(); it1++)
-                        {
-                            Atom* solute_atom = (*it1);
-                            if(((*it)->GetCoordinates().at(model_index_)->Distance(*(solute_atom->GetCoordinates().at(model_index_)))) <= closeness)
-                            {
-                                removed_atom_id_list.push_back((*it)->GetId());
-                                flag = true;
-                                break;
-                            }
-                        }
-                        if(flag)
-                            continue;
-                    }
-                }
-                //Check if one atom of HOH is in to-be-removed list and add the other two atoms belonging to the same HOH
-                for(AtomVector::iterator it = all_atoms_of_tip.begin(); it != all_atoms_of_tip.end(); it++)
-                {
-                    Atom* tip_atom = *it;
-                    if(find(removed_atom_id_list.begin(), removed_atom_id_list.end(), tip_atom->GetId()) != removed_atom_id_list.end())
-                    {
-                        AtomNode* node = tip_atom->GetNode();
-                        if(node != NULL)
-                        {
-                            AtomVector neighbors = node->GetNodeNeighbors();
-                            for(AtomVector::iterator it1 = neighbors.begin(); it1 != neighbors.end(); it1++)
-                            {
-                                Atom* neighbor = *it1;
-                                removed_atom_id_list.push_back(neighbor->GetId());
+    //Without a positive distance no solute atom is close enough, the empty grids find none
+    NeighborGrid solute_grid = NeighborGrid();
+    if(closeness > 0.0)
+        solute_grid.Build(solute_coordinates, closeness);
+    NeighborGrid shell_grid = NeighborGrid();
+    if(shape == SOLVENT_SHELL && extension > 0.0)
+        shell_grid.Build(solute_coordinates, extension);
 
-                                AtomNode* neighbor_node = neighbor->GetNode();
-                                if(neighbor_node != NULL)
-                                {
-                                    AtomVector neighbors_of_neighbor = neighbor_node->GetNodeNeighbors();
-                                    for(AtomVector::iterator it2 = neighbors_of_neighbor.begin(); it2 != neighbors_of_neighbor.end(); it2++)
-                                    {
-                                        Atom* neighbor_of_neighbor = *it2;
-                                        removed_atom_id_list.push_back(neighbor_of_neighbor->GetId());
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                //Add all water molecules of a water box which are not in the to-be-removed list to one residue
-                for(AtomVector::iterator it = all_atoms_of_tip.begin(); it != all_atoms_of_tip.end(); it++)
-                {
-                    Atom* tip_atom = *it;
-                    if(find(removed_atom_id_list.begin(), removed_atom_id_list.end(), tip_atom->GetId()) == removed_atom_id_list.end())
-                    {
-                        tip_residue->AddAtom(tip_atom);
-                        string residue_name = tip_atom->GetResidue()->GetName().substr(0,4);
-                        tip_residue->SetName("HOH");
-                        tip_atom->SetResidue(tip_residue);
-                        string id = residue_name + "_" + BLANK_SPACE + "_" + ConvertT<int>(sequence_number) + "_" +
-                                BLANK_SPACE + "_" + BLANK_SPACE + "_" + this->GetId();
-                        tip_residue->SetId(id);
-                        string atom_id = tip_atom->GetName() + "_" + ConvertT<int>(serial_number) + "_" + id;
-                        serial_number++;
-                        tip_atom->SetId(atom_id);
-                    }
-                }
-                //Add the residue to the assembly
-                this->AddResidue(tip_residue);
-                sequence_number++;
-                //                }
+    //Filling the solvent cube with water boxes: the threads decide which water molecules of each copy are kept
+    vector<Coordinate> box_shifts = vector<Coordinate>();
+    for(int i = 0; i < x_copy; i ++)
+        for(int j = 0; j < y_copy; j ++)
+            for(int k = 0; k < z_copy; k++)
+                box_shifts.push_back(Coordinate(shift_x + i * solvent_length, shift_y + j * solvent_width, shift_z + k * solvent_height));
+    vector<vector<bool> > removed_molecules = vector<vector<bool> >(box_shifts.size());
+
+    pthread_t threads[number_of_threads];
+    SolventBoxThreadArgument arg[number_of_threads];
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        arg[i] = SolventBoxThreadArgument(i, number_of_threads, closeness, &solvent_molecules, &solvent_coordinates, &box_shifts, &solute_grid,
+                                          &solvent_box_max_boundary, &removed_molecules, shape, &center_of_box, octahedron_limit, &shell_grid, extension);
+        pthread_create(&threads[i], NULL, &AddSolventBoxThread, &arg[i]);
+    }
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    //The kept water molecules are stored in the solvent block in the order of the copies, as packed coordinates of the sites of one
+    //template molecule; atoms are only built for them when a caller asks for the atoms or residues of the assembly
+    solvent_block_.SetTemplate(template_atoms, "HOH", template_atoms.at(0)->GetResidue()->GetName().substr(0,4));
+    solvent_block_.SetFirstNumbers(this->GetResidues().size() + 1, all_atoms_of_solute.size() + 1);
+    vector<Coordinate> molecule_coordinates = vector<Coordinate>();
+    for(unsigned int box = 0; box < box_shifts.size(); box++)
+    {
+        Coordinate& shift = box_shifts.at(box);
+        vector<bool>& removed = removed_molecules.at(box);
+        //Add all water molecules of a water box which are not removed to one residue
+        solvent_block_.AddResidue();
+        for(unsigned int molecule = 0; molecule < molecule_sites.size(); molecule++)
+        {
+            if(removed.at(molecule))
+                continue;
+            molecule_coordinates.clear();
+            for(vector<int>::iterator it = molecule_sites.at(molecule).begin(); it != molecule_sites.at(molecule).end(); it++)
+            {
+                Coordinate coordinate = solvent_coordinates.at(*it);
+                coordinate.Translate(shift.GetX(), shift.GetY(), shift.GetZ());
+                molecule_coordinates.push_back(coordinate);
             }
+            solvent_block_.AddMolecule(&molecule_coordinates.at(0));
         }
     }
+
+    //Recording the dimensions of the periodic box; the lattice vectors of a truncated octahedron made from a cube of edge 2h are sqrt(3)h long
+    switch(shape)
+    {
+        case SOLVENT_BOX:
+            this->SetBoxDimensions(2 * solvent_box_dimension, 2 * solvent_box_dimension, 2 * solvent_box_dimension, 90.0);
+            break;
+        case SOLVENT_TRUNCATED_OCTAHEDRON:
+            this->SetBoxDimensions(sqrt(3.0) * solvent_box_dimension, sqrt(3.0) * solvent_box_dimension, sqrt(3.0) * solvent_box_dimension,
+                                   TRUNCATED_OCTAHEDRON_ANGLE);
+            break;
+        case SOLVENT_SHELL:
+            this->SetBoxDimensions(dNotSet, dNotSet, dNotSet, dNotSet);
+            break;
+    }
+    delete solvent_component;
+    delete lib;
 }
 
 void Assembly::SplitSolvent(Assembly* solvent, Assembly* solute)
 {
+    this->ExpandSolventBlock();
+    //The residues stay in the current assembly as well, so the solvent and solute keep its objects alive
+    solvent->ShareStorage(this);
+    solute->ShareStorage(this);
     for(AssemblyVector::iterator it = this->assemblies_.begin(); it != this->assemblies_.end(); it++)
     {
         (*it)->SplitSolvent(solvent, solute);
     }
+    SymbolTable::Symbol water_name = SymbolTable::Intern("HOH");
+    SymbolTable::Symbol tip3p_name = SymbolTable::Intern("TP3");
+    SymbolTable::Symbol tip5p_name = SymbolTable::Intern("TP5");
     for(ResidueVector::iterator it = this->residues_.begin(); it != this->residues_.end(); it++)
     {
         Residue* residue = *it;
-        if(residue->GetName().compare("HOH") == 0 || residue->GetName().compare("TP3") == 0 ||
-                residue->GetName().compare("TP5") == 0)
+        SymbolTable::Symbol residue_name = residue->GetNameSymbol();
+        if(residue_name == water_name || residue_name == tip3p_name || residue_name == tip5p_name)
             solvent->AddResidue(residue);
         else
             solute->AddResidue(residue);
@@ -63,6 +63,7 @@
 #include "../../../includes/common.hpp"
 #include "../../../includes/GeometryTopology/grid.hpp"
 #include "../../../includes/GeometryTopology/cell.hpp"
+#include "../../../includes/GeometryTopology/neighborgrid.hpp"
 
 #include <unistd.h>
 #include <errno.h>
@@ -267,92 +268,36 @@ void* BuildStructureByDistanceByOptimizedThread(void* args){
     int model_index = arg->model_index;
     int ti = arg->thread_index;
     int t = arg->number_of_threads;
-
-
-    //    cout << "Thread" << ti << " start" << endl;
-    Assembly::AtomVector all_atoms_of_assembly = arg->a->GetAllAtomsOfAssembly();
-    int atoms_size = all_atoms_of_assembly.size();
-
-    int increase_factor = 0;
-    increase_factor = atoms_size / ((t * t+1) / 2);
-    int end_index = 0;
-    int begin_index = 0;
-    int i = 1;
-    for(i = 1; i < ti+1; i++)
-    {
-        begin_index = begin_index + (i*increase_factor);
-    }
-    end_index = begin_index + (i*increase_factor);
-
-    for(Assembly::AtomVector::iterator it = all_atoms_of_assembly.begin() + begin_index; ; it++)
+    Assembly::AtomVector* all_atoms_of_assembly = arg->atoms;
+    NeighborGrid* grid = arg->grid;
+    int atoms_size = all_atoms_of_assembly->size();
+
+    ///Each atom only visits the atoms of its own and the surrounding grid cells, so the workload per atom is roughly constant
+    ///and the atoms can be equally divided between the threads
+    int begin_index = (int)(((long long)ti * atoms_size) / t);
+    int end_index = (int)(((long long)(ti + 1) * atoms_size) / t);
+    vector<int> candidates = vector<int>();
+    ///Nodes are created before the threads start; each thread owns the nodes of its own chunk of atoms and collects the bonds it finds into its own buffer, so no lock is needed.
+    ///The buffers are merged into the neighbor lists after all threads are joined
+    std::vector<std::pair<int, int> >* edges = arg->edges;
+    for(int index = begin_index; index < end_index; index++)
     {
-        if(ti + 1 < t)///if it's not the last thread
+        Atom* atom = all_atoms_of_assembly->at(index);
+        Coordinate* atom_coordinate = atom->GetCoordinates().at(model_index);
+        atom->GetNode()->SetId(index);
+
+        candidates.clear();
+        grid->GetCandidateIndices(atom_coordinate->GetX(), atom_coordinate->GetY(), atom_coordinate->GetZ(), candidates);
+        ///Visiting the neighbors in the order of the atoms of the assembly keeps the neighbor lists identical to the all-pairs scan
+        sort(candidates.begin(), candidates.end());
+        for(vector<int>::iterator it = candidates.begin(); it != candidates.end(); it++)
         {
-            if(it == all_atoms_of_assembly.begin() + end_index)
-                break;
-        }
-        else
-        {
-            if(it == all_atoms_of_assembly.end() - 1)
-            {
-                if((*it)->GetNode() == NULL)
-                {
-                    Atom* atom = (*it);
-                    AtomNode* atom_node = new AtomNode();
-                    atom_node->SetAtom(atom);
-                    atom->SetNode(atom_node);
-                }
-                break;
-            }
-        }
-        int index = distance(all_atoms_of_assembly.begin(), it);
-        Atom* atom = (*it);
-        AtomNode* atom_node;
-        pthread_mutex_lock(&mutex1);
-        if(atom->GetNode() == NULL)
-        {
-            atom_node = new AtomNode();
-            atom_node->SetAtom(atom);
-            atom->SetNode(atom_node);
-        }
-        else
-            atom_node = atom->GetNode();
-        atom_node->SetId(index);
-        //        cout << "Thread" << ti << " atom id " << i << endl;
-        pthread_mutex_unlock(&mutex1);
-        for(Assembly::AtomVector::iterator it1 = it + 1; it1 != all_atoms_of_assembly.end(); it1++)
-        {
-            Atom* neighbor_atom = (*it1);
-            // X distance
-            if(atom->GetCoordinates().at(model_index)->GetX() - neighbor_atom->GetCoordinates().at(model_index)->GetX() < cutoff)
-            {
-                // Y distance
-                if(atom->GetCoordinates().at(model_index)->GetY() - neighbor_atom->GetCoordinates().at(model_index)->GetY() < cutoff)
-                {
-                    // Z distance
-                    if(atom->GetCoordinates().at(model_index)->GetZ() - neighbor_atom->GetCoordinates().at(model_index)->GetZ() < cutoff)
-                    {
-                        if((atom->GetCoordinates().at(model_index)->Distance(*(neighbor_atom->GetCoordinates().at(model_index)))) < cutoff)
-                        {
-                            AtomNode* neighbor_node;
-                            pthread_mutex_lock(&mutex1);
-                            if (neighbor_atom->GetNode() == NULL)
-                            {
-                                neighbor_node = new AtomNode();
-                                neighbor_node->SetAtom(neighbor_atom);
-                            }
-                            else
-                                neighbor_node = neighbor_atom->GetNode();
-                            atom_node->AddNodeNeighbor(neighbor_atom);
-                            neighbor_node->AddNodeNeighbor(atom);
-                            neighbor_atom->SetNode(neighbor_node);
-                            pthread_mutex_unlock(&mutex1);
-                        }
-                    }
-                }
-            }
+            if(*it <= index)
+                continue;
+            Atom* neighbor_atom = all_atoms_of_assembly->at(*it);
+            if((atom_coordinate->Distance(*(neighbor_atom->GetCoordinates().at(model_index)))) < cutoff)
+                edges->push_back(std::make_pair(index, *it));
         }
-        atom->SetNode(atom_node);
     }
 
     //    cout << "Thread" << ti << " END" << endl;
@@ -620,11 +565,31 @@ void Assembly::BuildStructureByDistance(int number_of_threads, double cutoff, in
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by distance ...");
     model_index_ = model_index;
 
+    ///Bin all atoms into a cell list with cells as large as the cutoff, so each atom is only compared to the atoms of the 27 surrounding cells
+    AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+    CoordinateVector coordinates = CoordinateVector();
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+        coordinates.push_back((*it)->GetCoordinates().at(model_index));
+    NeighborGrid grid = NeighborGrid(coordinates, cutoff);
+
+    ///The node pool of the assembly is not thread safe, so the missing nodes are created here
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    {
+        Atom* atom = (*it);
+        if(atom->GetNode() == NULL)
+        {
+            AtomNode* atom_node = this->CreateAtomNode();
+            atom_node->SetAtom(atom);
+            atom->SetNode(atom_node);
+        }
+    }
+
     pthread_t threads[number_of_threads];
     DistanceCalculationThreadArgument arg[number_of_threads];
+    std::vector<std::vector<std::pair<int, int> > > edges_of_threads = std::vector<std::vector<std::pair<int, int> > >(number_of_threads);
     for(int i = 0; i < number_of_threads; i++)
     {
-        arg[i] = DistanceCalculationThreadArgument(i, number_of_threads, model_index, cutoff, this);
+        arg[i] = DistanceCalculationThreadArgument(i, number_of_threads, model_index, cutoff, this, &all_atoms_of_assembly, &grid, &edges_of_threads.at(i));
         //        pthread_create(&threads[i], NULL, &BuildStructureByDistanceThread, &arg[i]); ///First version. Workload of threads are not equal
         pthread_create(&threads[i], NULL, &BuildStructureByDistanceByOptimizedThread, &arg[i]); ///Second version. Workload of threads are roughly equal.
     }
@@ -632,6 +597,20 @@ void Assembly::BuildStructureByDistance(int number_of_threads, double cutoff, in
     {
         pthread_join(threads[i], NULL);
     }
+
+    ///Threads own contiguous ascending chunks of atoms, so merging the buffers in thread order adds the neighbors in the same order as a single thread does
+    for(int i = 0; i < number_of_threads; i++)
+    {
+        std::vector<std::pair<int, int> >& edges = edges_of_threads.at(i);
+        for(std::vector<std::pair<int, int> >::iterator it = edges.begin(); it != edges.end(); it++)
+        {
+            Atom* atom = all_atoms_of_assembly.at(it->first);
+            Atom* neighbor_atom = all_atoms_of_assembly.at(it->second);
+            atom->GetNode()->AddNodeNeighbor(neighbor_atom);
+            neighbor_atom->GetNode()->AddNodeNeighbor(atom);
+        }
+    }
+    this->NotifyBondsChanged();
 }
 
 void Assembly::BuildStructureByOriginalFileBondingInformation()
@@ -673,7 +652,7 @@ void Assembly::BuildStructureByPDBFileInformation()
         for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
         {
             Atom* atom = (*it);
-            AtomNode* atom_node = new AtomNode();
+            AtomNode* atom_node = this->CreateAtomNode();
             atom_node->SetAtom(atom);
             atom_node->SetId(i);
             i++;
@@ -713,6 +692,16 @@ void Assembly::BuildStructureByPDBFileInformation()
     }
     catch(PdbFileSpace::PdbFileProcessingException &ex)
     {}
+    this->NotifyBondsChanged();
+}
+
+/// Splits a "NAME(number)" reference of a topology file into the symbol of the name and the number
+pair<SymbolTable::Symbol, int> ParseTopologyReference(const string& reference)
+{
+    size_t open = reference.rfind('(');
+    if(open == string::npos)
+        return make_pair(SymbolTable::Intern(reference), gmml::iNotSet);
+    return make_pair(SymbolTable::Intern(reference.substr(0, open)), atoi(reference.c_str() + open + 1));
 }
 
 void Assembly::BuildStructureByTOPFileInformation()
@@ -721,72 +710,94 @@ void Assembly::BuildStructureByTOPFileInformation()
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by topology file information ...");
     TopologyFile* topology_file = new TopologyFile(gmml::Split(this->GetSourceFile(), ";")[0]);
     AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
-    int i = 0;
-    for (AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+
+    /// Index the atoms by the residue name and sequence number and the atom name and serial number that the topology bonds refer to
+    AtomIndexHashMap atom_indices_by_key = AtomIndexHashMap();
+    for(unsigned int i = 0; i < all_atoms_of_assembly.size(); i++)
     {
-        Atom* atom_1 = (*it);
-        AtomNode* atom_node = new AtomNode();
-        atom_node->SetAtom(atom_1);
-        atom_node->SetId(i);
-        i++;
-        for(AtomVector::iterator it1 = all_atoms_of_assembly.begin(); it1 != all_atoms_of_assembly.end(); it1++)
+        AtomIdentity identity = all_atoms_of_assembly.at(i)->GetIdentity();
+        AtomIdentityKey key = make_pair(make_pair(identity.residue_.name_, identity.residue_.sequence_number_), make_pair(identity.name_, identity.serial_number_));
+        atom_indices_by_key[key].push_back(i);
+    }
+
+    /// Every bond connects all atoms matching one end to all atoms matching the other end
+    vector<vector<int> > neighbor_indices = vector<vector<int> >(all_atoms_of_assembly.size(), vector<int>());
+    TopologyFile::TopologyBondMap topology_bonds = topology_file->GetBonds();
+    for(TopologyFile::TopologyBondMap::iterator it = topology_bonds.begin(); it != topology_bonds.end(); it++)
+    {
+        TopologyBond* bond = (*it).second;
+        AtomIdentityKey first_key = make_pair(ParseTopologyReference(bond->GetResidueNames().at(0)), ParseTopologyReference(bond->GetBonds().at(0)));
+        AtomIdentityKey second_key = make_pair(ParseTopologyReference(bond->GetResidueNames().at(1)), ParseTopologyReference(bond->GetBonds().at(1)));
+        AtomIndexHashMap::iterator first_atoms = atom_indices_by_key.find(first_key);
+        AtomIndexHashMap::iterator second_atoms = atom_indices_by_key.find(second_key);
+        if(first_atoms == atom_indices_by_key.end() || second_atoms == atom_indices_by_key.end())
+            continue;
+        for(vector<int>::iterator it1 = (*first_atoms).second.begin(); it1 != (*first_atoms).second.end(); it1++)
         {
-            if(it != it1)
+            for(vector<int>::iterator it2 = (*second_atoms).second.begin(); it2 != (*second_atoms).second.end(); it2++)
             {
-                Atom* atom_2 = (*it1);
-                stringstream ss;
-                ss << gmml::Split(atom_1->GetId(), "_").at(2) << "(" << gmml::Split(atom_1->GetId(), "_").at(4) << ")"
-                   << ":" << gmml::Split(atom_1->GetId(), "_").at(0) << "(" <<  gmml::Split(atom_1->GetId(), "_").at(1) << ")" << "-"
-                   << gmml::Split(atom_2->GetId(), "_").at(2) << "(" << gmml::Split(atom_2->GetId(), "_").at(4) << ")"
-                   << ":" << gmml::Split(atom_2->GetId(), "_").at(0) << "(" << gmml::Split(atom_2->GetId(), "_").at(1) << ")";
-                string key = ss.str();
-                TopologyFile::TopologyBondMap topology_bond = topology_file->GetBonds();
-                for(TopologyFile::TopologyBondMap::iterator it2 = topology_bond.begin(); it2 != topology_bond.end(); it2++)
+                if(*it1 != *it2)
                 {
-                    TopologyBond* bond = (*it2).second;
-                    stringstream sss;
-                    sss << bond->GetResidueNames().at(0) << ":" << bond->GetBonds().at(0) << "-" << bond->GetResidueNames().at(1) << ":" << bond->GetBonds().at(1);
-                    string topology_bond_key = sss.str();
-                    if(key.compare(topology_bond_key) == 0)
-                    {
-                        atom_node->AddNodeNeighbor(atom_2);
-                        break;
-                    }
-                    stringstream ssss;
-                    ssss << bond->GetResidueNames().at(1) << ":" << bond->GetBonds().at(1) << "-" << bond->GetResidueNames().at(0) << ":" << bond->GetBonds().at(0);
-                    topology_bond_key = ssss.str();
-                    if(key.compare(topology_bond_key) == 0)
-                    {
-                        atom_node->AddNodeNeighbor(atom_2);
-                        break;
-                    }
+                    neighbor_indices.at(*it1).push_back(*it2);
+                    neighbor_indices.at(*it2).push_back(*it1);
                 }
             }
         }
-        atom_1->SetNode(atom_node);
     }
+
+    for(unsigned int i = 0; i < all_atoms_of_assembly.size(); i++)
+    {
+        Atom* atom = all_atoms_of_assembly.at(i);
+        AtomNode* atom_node = this->CreateAtomNode();
+        atom_node->SetAtom(atom);
+        atom_node->SetId(i);
+        /// Keep the neighbors in the order of the atoms of the assembly and add each of them once
+        vector<int>& neighbors = neighbor_indices.at(i);
+        sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        for(vector<int>::iterator it = neighbors.begin(); it != neighbors.end(); it++)
+            atom_node->AddNodeNeighbor(all_atoms_of_assembly.at(*it));
+        atom->SetNode(atom_node);
+    }
+    this->NotifyBondsChanged();
 }
 
 void Assembly::BuildStructureByLIBFileInformation()
+{
+    LibraryFile* library_file = new LibraryFile(this->GetSourceFile());
+    this->BuildStructureByLIBFileInformation(library_file);
+    delete library_file;
+}
+
+void Assembly::BuildStructureByLIBFileInformation(LibraryFile* library_file)
 {
     cout << "Building structure by library file information..." << endl;
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by library file information ...");
-    LibraryFile* library_file = new LibraryFile(this->GetSourceFile());
     AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+
+    /// Index the atoms by residue name, atom name and atom order; the first atom of the assembly wins if a key occurs more than once
+    AtomHashMap atoms_by_key = AtomHashMap();
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    {
+        AtomIdentity identity = (*it)->GetIdentity();
+        AtomIdentityKey key = make_pair(make_pair(identity.residue_.name_, gmml::iNotSet), make_pair(identity.name_, identity.serial_number_));
+        if(atoms_by_key.find(key) == atoms_by_key.end())
+            atoms_by_key[key] = *it;
+    }
+
     int i = 0;
     for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
         Atom* atom = (*it);
-        AtomNode* atom_node = new AtomNode();
+        AtomNode* atom_node = this->CreateAtomNode();
         atom_node->SetAtom(atom);
         atom_node->SetId(i);
         i++;
         Residue* assembly_residue = atom->GetResidue();
-        vector<string> atom_id_tokens = Split(atom->GetId(), "_");
         LibraryFileResidue* library_residue = library_file->GetLibraryResidueByResidueName(assembly_residue->GetName());
         if(library_residue != NULL)
         {
-            LibraryFileAtom* library_atom = library_residue->GetAtomByOrder(ConvertString<int>(atom_id_tokens.at(1)));
+            LibraryFileAtom* library_atom = library_residue->GetAtomByOrder(atom->GetSerialNumber());
             if(library_atom != NULL)
             {
                 vector<int> library_bonded_atom_indices = library_atom->GetBondedAtomsIndices();
@@ -794,27 +805,17 @@ void Assembly::BuildStructureByLIBFileInformation()
                 {
                     int library_bonded_atom_index = (*it1);
                     LibraryFileAtom* library_atom = library_residue->GetAtomByOrder(library_bonded_atom_index);
-                    for(AtomVector::iterator it2 = all_atoms_of_assembly.begin(); it2 != all_atoms_of_assembly.end(); it2++)
-                    {
-                        Atom* assembly_atom = (*it2);
-                        string assembly_atom_id = assembly_atom->GetId();
-                        stringstream ss;
-                        ss << library_residue->GetName() << ":" << library_atom->GetName() << "(" << library_atom->GetAtomOrder() << ")";
-                        string library_atom_id = ss.str();
-                        vector<string> assembly_atom_id_tokens = gmml::Split(assembly_atom_id, "_");
-                        stringstream sss;
-                        sss << assembly_atom_id_tokens.at(2) << ":" << assembly_atom_id_tokens.at(0) << "(" << assembly_atom_id_tokens.at(1) << ")";
-                        if(sss.str().compare(library_atom_id) == 0)
-                        {
-                            atom_node->AddNodeNeighbor(assembly_atom);
-                            break;
-                        }
-                    }
+                    AtomIdentityKey key = make_pair(make_pair(SymbolTable::Intern(library_residue->GetName()), gmml::iNotSet),
+                                                    make_pair(SymbolTable::Intern(library_atom->GetName()), library_atom->GetAtomOrder()));
+                    AtomHashMap::iterator bonded_atom = atoms_by_key.find(key);
+                    if(bonded_atom != atoms_by_key.end())
+                        atom_node->AddNodeNeighbor((*bonded_atom).second);
                 }
             }
         }
         atom->SetNode(atom_node);
     }
+    this->NotifyBondsChanged();
 }
 
 void Assembly::BuildStructureByPrepFileInformation()
@@ -823,11 +824,22 @@ void Assembly::BuildStructureByPrepFileInformation()
     gmml::log(__LINE__, __FILE__, gmml::INF, "Building structure by prep file information ...");
     PrepFile* prep_file = new PrepFile(this->GetSourceFile());
     AtomVector all_atoms_of_assembly = this->GetAllAtomsOfAssembly();
+
+    /// Index the atoms by residue name and atom name; the first atom of the assembly wins if a key occurs more than once
+    AtomHashMap atoms_by_key = AtomHashMap();
+    for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
+    {
+        AtomIdentity identity = (*it)->GetIdentity();
+        AtomIdentityKey key = make_pair(make_pair(identity.residue_.name_, gmml::iNotSet), make_pair(identity.name_, gmml::iNotSet));
+        if(atoms_by_key.find(key) == atoms_by_key.end())
+            atoms_by_key[key] = *it;
+    }
+
     int i = 0;
     for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
         Atom* atom = (*it);
-        AtomNode* atom_node = new AtomNode();
+        AtomNode* atom_node = this->CreateAtomNode();
         atom_node->SetAtom(atom);
         atom_node->SetId(i);
         i++;
@@ -844,25 +856,17 @@ void Assembly::BuildStructureByPrepFileInformation()
                 {
                     int bonded_atom_index = (*it1);
                     PrepFileAtom* bonded_atom = prep_residue->GetPrepAtomByName(prep_residue->GetAtomNameByIndex(bonded_atom_index));
-                    stringstream ss;
-                    ss << prep_residue->GetName() << ":" << bonded_atom->GetName();
-                    for(AtomVector::iterator it2 = all_atoms_of_assembly.begin(); it2 != all_atoms_of_assembly.end(); it2++)
-                    {
-                        Atom* assembly_atom = (*it2);
-                        vector<string> atom_id_tokens = gmml::Split(assembly_atom->GetId(), "_");
-                        stringstream sss;
-                        sss << atom_id_tokens.at(2) << ":" << atom_id_tokens.at(0);
-                        if(sss.str().compare(ss.str()) == 0)
-                        {
-                            atom_node->AddNodeNeighbor(assembly_atom);
-                            break;
-                        }
-                    }
+                    AtomIdentityKey key = make_pair(make_pair(SymbolTable::Intern(prep_residue->GetName()), gmml::iNotSet),
+                                                    make_pair(SymbolTable::Intern(bonded_atom->GetName()), gmml::iNotSet));
+                    AtomHashMap::iterator assembly_atom = atoms_by_key.find(key);
+                    if(assembly_atom != atoms_by_key.end())
+                        atom_node->AddNodeNeighbor((*assembly_atom).second);
                 }
             }
         }
         atom->SetNode(atom_node);
     }
+    this->NotifyBondsChanged();
 }
 
 void Assembly::BuildStructureByDatabaseFilesBondingInformation(vector<gmml::InputFileType> types, vector<string> file_paths)
@@ -874,7 +878,7 @@ void Assembly::BuildStructureByDatabaseFilesBondingInformation(vector<gmml::Inpu
     for(AtomVector::iterator it = all_atoms_of_assembly.begin(); it != all_atoms_of_assembly.end(); it++)
     {
         Atom* atom = (*it);
-        AtomNode* atom_node = new AtomNode();
+        AtomNode* atom_node = this->CreateAtomNode();
         atom_node->SetAtom(atom);
         atom_node->SetId(i);
         i++;
@@ -912,6 +916,7 @@ void Assembly::BuildStructureByDatabaseFilesBondingInformation(vector<gmml::Inpu
                         }
                     }
                 }
+                delete library_file;
             }
             if(types.at(i) == gmml::PREP)
             {
@@ -947,4 +952,5 @@ void Assembly::BuildStructureByDatabaseFilesBondingInformation(vector<gmml::Inpu
             atom->SetNode(atom_node);
         }
     }
+    this->NotifyBondsChanged();
 }
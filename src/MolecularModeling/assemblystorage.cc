@@ -0,0 +1,122 @@
+#include "../../includes/MolecularModeling/assemblystorage.hpp"
+#include "../../includes/MolecularModeling/atom.hpp"
+#include "../../includes/MolecularModeling/atomnode.hpp"
+#include "../../includes/MolecularModeling/residue.hpp"
+#include "../../includes/GeometryTopology/coordinate.hpp"
+#include "../../includes/GeometryTopology/coordinateframe.hpp"
+#include <pthread.h>
+
+using namespace std;
+using namespace MolecularModeling;
+using namespace GeometryTopology;
+
+namespace
+{
+    // Revisions of all assemblies and storages come from one counter, so a later change always gets a larger revision than any earlier one
+    pthread_mutex_t revision_mutex = PTHREAD_MUTEX_INITIALIZER;
+    unsigned long last_revision = 0;
+}
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+AssemblyStorage::AssemblyStorage() : reference_count_(1), structure_revision_(0), bond_revision_(0)
+{
+    coordinate_frames_ = CoordinateFrameVector();
+}
+
+AssemblyStorage::~AssemblyStorage()
+{
+    atom_node_pool_.Clear();
+    atom_pool_.Clear();
+    residue_pool_.Clear();
+    for(CoordinateFrameVector::iterator it = coordinate_frames_.begin(); it != coordinate_frames_.end(); it++)
+        delete *it;
+    coordinate_frames_.clear();
+}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+CoordinateFrame* AssemblyStorage::GetCoordinateFrame(int model_index)
+{
+    if(model_index < 0 || model_index >= (int)coordinate_frames_.size())
+        return NULL;
+    return coordinate_frames_.at(model_index);
+}
+
+int AssemblyStorage::GetNumberOfCoordinateFrames()
+{
+    return coordinate_frames_.size();
+}
+
+unsigned long AssemblyStorage::GetStructureRevision()
+{
+    return structure_revision_;
+}
+
+unsigned long AssemblyStorage::GetBondRevision()
+{
+    return bond_revision_;
+}
+
+//////////////////////////////////////////////////////////
+//                       FUNCTIONS                      //
+//////////////////////////////////////////////////////////
+void AssemblyStorage::Retain()
+{
+    reference_count_++;
+}
+
+void AssemblyStorage::Release()
+{
+    reference_count_--;
+    if(reference_count_ == 0)
+        delete this;
+}
+
+unsigned long AssemblyStorage::NextRevision()
+{
+    pthread_mutex_lock(&revision_mutex);
+    unsigned long revision = ++last_revision;
+    pthread_mutex_unlock(&revision_mutex);
+    return revision;
+}
+
+void AssemblyStorage::NotifyStructureChanged()
+{
+    pthread_mutex_lock(&revision_mutex);
+    structure_revision_ = ++last_revision;
+    pthread_mutex_unlock(&revision_mutex);
+}
+
+void AssemblyStorage::NotifyBondsChanged()
+{
+    pthread_mutex_lock(&revision_mutex);
+    bond_revision_ = ++last_revision;
+    pthread_mutex_unlock(&revision_mutex);
+}
+
+Coordinate* AssemblyStorage::CreateCoordinate(const Coordinate& coordinate, int model_index)
+{
+    while((int)coordinate_frames_.size() <= model_index)
+        coordinate_frames_.push_back(new CoordinateFrame());
+    return coordinate_frames_.at(model_index)->AddCoordinate(coordinate);
+}
+
+Atom* AssemblyStorage::CreateAtom()
+{
+    return atom_pool_.Create();
+}
+
+Residue* AssemblyStorage::CreateResidue()
+{
+    Residue* residue = residue_pool_.Create();
+    residue->SetStorage(this);
+    return residue;
+}
+
+AtomNode* AssemblyStorage::CreateAtomNode()
+{
+    return atom_node_pool_.Create();
+}
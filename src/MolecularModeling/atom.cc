@@ -4,7 +4,13 @@
 #include "../../includes/MolecularModeling/dockingatom.hpp"
 #include "../../includes/MolecularModeling/atomnode.hpp"
 #include "../../includes/MolecularModeling/residue.hpp"
+#include "../../includes/MolecularModeling/assemblystorage.hpp"
+#include "../../includes/common.hpp"
+#include "../../includes/utils.hpp"
 #include "cmath"
+#include <sstream>
+#include <cstdlib>
+#include <boost/unordered_set.hpp>
 
 using namespace std;
 using namespace MolecularModeling;
@@ -12,30 +18,32 @@ using namespace MolecularModeling;
 //////////////////////////////////////////////////////////
 //                       CONSTRUCTOR                    //
 //////////////////////////////////////////////////////////
-Atom::Atom() : name_(""), chemical_type_(""), element_symbol_(""), description_(""), id_("")
+Atom::Atom() : name_(0), chemical_type_(0), description_(0), is_heterogen_(false), element_symbol_(0), id_("")
 {
     coordinates_ = CoordinateVector();
     residue_ = NULL;
     node_ = NULL;
     index_ = this->generateAtomIndex();
+    this->SetIdentity("", gmml::iNotSet, Residue::ParseIdentity(vector<string>(), 0));
 }
 
 Atom::Atom(Residue *residue, string name, CoordinateVector coordinates) :
-    chemical_type_(""), element_symbol_(""), description_("")
+    chemical_type_(0), description_(0), is_heterogen_(false), element_symbol_(0)
 {
     residue_ = residue;
-    name_ = name;
+    name_ = SymbolTable::Intern(name);
     coordinates_ = CoordinateVector();
     for(CoordinateVector::iterator it = coordinates.begin(); it != coordinates.end(); it++)
         coordinates_.push_back(*it);
     node_ = NULL;
     index_ = this->generateAtomIndex();
+    this->SetIdentity("", gmml::iNotSet, Residue::ParseIdentity(vector<string>(), 0));
 }
 
-Atom::Atom(Atom *atom)
+Atom::Atom(Atom *atom) : chemical_type_(0), description_(0), is_heterogen_(false), element_symbol_(0)
 {
     residue_ = new Residue(atom->GetResidue());
-    name_ = atom->GetName();
+    name_ = atom->GetNameSymbol();
     coordinates_ = CoordinateVector();
     CoordinateVector coordinates = atom->GetCoordinates();
     for(CoordinateVector::iterator it = coordinates.begin(); it != coordinates.end(); it++)
@@ -44,6 +52,7 @@ Atom::Atom(Atom *atom)
     AtomNode node = atom->GetNode();
     node_ = new AtomNode(node);
     index_ = atom->GetIndex();
+    this->SetIdentity("", gmml::iNotSet, Residue::ParseIdentity(vector<string>(), 0));
 }
 
 //////////////////////////////////////////////////////////
@@ -54,6 +63,10 @@ Residue* Atom::GetResidue()
     return residue_;
 }
 string Atom::GetName()
+{
+    return SymbolTable::GetString(name_);
+}
+SymbolTable::Symbol Atom::GetNameSymbol()
 {
     return name_;
 }
@@ -61,15 +74,32 @@ Atom::CoordinateVector Atom::GetCoordinates()
 {
     return coordinates_;
 }
+
+GeometryTopology::Coordinate* Atom::GetCoordinate(int model_index)
+{
+    return coordinates_.at(model_index);
+}
 string Atom::GetChemicalType()
+{
+    return SymbolTable::GetString(chemical_type_);
+}
+SymbolTable::Symbol Atom::GetChemicalTypeSymbol()
 {
     return chemical_type_;
 }
 string Atom::GetDescription()
+{
+    return SymbolTable::GetString(description_);
+}
+SymbolTable::Symbol Atom::GetDescriptionSymbol()
 {
     return description_;
 }
 string Atom::GetElementSymbol()
+{
+    return SymbolTable::GetString(element_symbol_);
+}
+SymbolTable::Symbol Atom::GetElementSymbolSymbol()
 {
     return element_symbol_;
 }
@@ -81,6 +111,14 @@ string Atom::GetId()
 {
     return id_;
 }
+AtomIdentity Atom::GetIdentity()
+{
+    return identity_;
+}
+int Atom::GetSerialNumber()
+{
+    return identity_.serial_number_;
+}
 bool Atom::GetIsRing()
 {
     return is_ring_;
@@ -99,7 +137,7 @@ void Atom::SetResidue(Residue *residue)
 }
 void Atom::SetName(string name)
 {
-    name_ = name;
+    name_ = SymbolTable::Intern(name);
 }
 void Atom::SetCoordinates(CoordinateVector coordinates)
 {
@@ -108,30 +146,60 @@ void Atom::SetCoordinates(CoordinateVector coordinates)
     {
         coordinates_.push_back(*it);
     }
+    this->NotifyStructureChanged();
 }
 void Atom::AddCoordinate(GeometryTopology::Coordinate *coordinate)
 {
     coordinates_.push_back(coordinate);
+    this->NotifyStructureChanged();
 }
 void Atom::SetChemicalType(string chemical_type)
 {
-    chemical_type_ = chemical_type;
+    chemical_type_ = SymbolTable::Intern(chemical_type);
 }
 void Atom::SetDescription(string description)
 {
-    description_ = description;
+    description_ = SymbolTable::Intern(description);
+    is_heterogen_ = (description.find("Het;") != string::npos);
 }
 void Atom::SetElementSymbol(string element_symbol)
 {
-    element_symbol_ = element_symbol;
+    element_symbol_ = SymbolTable::Intern(element_symbol);
 }
 void Atom::SetNode(AtomNode *node)
 {
     node_ = node;
+    if(residue_ != NULL && residue_->GetStorage() != NULL)
+        residue_->GetStorage()->NotifyBondsChanged();
 }
 void Atom::SetId(string id)
 {
     id_ = id;
+    vector<string> tokens = gmml::Split(id, "_");
+    identity_.name_ = (tokens.size() > 0) ? SymbolTable::Intern(tokens.at(0)) : 0;
+    identity_.serial_number_ = gmml::iNotSet;
+    if(tokens.size() > 1)
+    {
+        char* end = NULL;
+        long serial_number = strtol(tokens.at(1).c_str(), &end, 10);
+        if(*end == '\0')
+            identity_.serial_number_ = serial_number;
+    }
+    identity_.residue_ = Residue::ParseIdentity(tokens, 2);
+}
+void Atom::SetIdentity(string name, int serial_number, ResidueIdentity residue_identity)
+{
+    identity_.name_ = SymbolTable::Intern(name);
+    identity_.serial_number_ = serial_number;
+    identity_.residue_ = residue_identity;
+    /// The id is formatted here rather than on first use, so reading it never writes to an atom that is shared between threads
+    id_ = "";
+    if(serial_number != gmml::iNotSet)
+    {
+        stringstream ss;
+        ss << name << "_" << serial_number << "_" << Residue::FormatIdentity(residue_identity);
+        id_ = ss.str();
+    }
 }
 void Atom::SetIsRing(bool is_ring)
 {
@@ -143,23 +211,39 @@ void Atom::SetIsRing(bool is_ring)
 //////////////////////////////////////////////////////////
 void Atom::FindConnectedAtoms(AtomVector &visitedAtoms)
 {
-    visitedAtoms.push_back(this);
-    AtomVector neighbors = this->GetNode()->GetNodeNeighbors();
-    bool alreadyVisited = false;
-
-    for(AtomVector::iterator neighbor = neighbors.begin(); neighbor != neighbors.end(); neighbor++){
-        alreadyVisited = false; // reset for each neighbor
-        for(AtomVector::iterator visitedAtom = visitedAtoms.begin(); visitedAtom != visitedAtoms.end(); visitedAtom++){
-            if ( (*neighbor)->GetIndex() == (*visitedAtom)->GetIndex() )
-                alreadyVisited = true;
-        }
-        if (!alreadyVisited) {
-            //std::cout << "Found unvisited neighbor, Going to " << (*neighbor)->GetId() << " from " << this->GetId() << std::endl;
-            (*neighbor)->FindConnectedAtoms(visitedAtoms); // recursive function call
+    /// Iterative depth first search; atoms are identified by their index, and the atoms already in the list count as visited
+    boost::unordered_set<unsigned long long> visited_indices = boost::unordered_set<unsigned long long>();
+    for(AtomVector::iterator visitedAtom = visitedAtoms.begin(); visitedAtom != visitedAtoms.end(); visitedAtom++)
+        visited_indices.insert((*visitedAtom)->GetIndex());
+    visited_indices.insert(this->GetIndex());
+    AtomVector stack = AtomVector(1, this);
+    while(!stack.empty())
+    {
+        Atom* atom = stack.back();
+        stack.pop_back();
+        if(atom != this && !visited_indices.insert(atom->GetIndex()).second)
+            continue;
+        visitedAtoms.push_back(atom);
+        AtomVector neighbors = atom->GetNode()->GetNodeNeighbors();
+        for(AtomVector::reverse_iterator neighbor = neighbors.rbegin(); neighbor != neighbors.rend(); neighbor++)
+        {
+            if(visited_indices.find((*neighbor)->GetIndex()) == visited_indices.end())
+                stack.push_back(*neighbor);
         }
     }
 }
 
+void Atom::NotifyStructureChanged()
+{
+    if(residue_ != NULL && residue_->GetStorage() != NULL)
+        residue_->GetStorage()->NotifyStructureChanged();
+}
+
+bool Atom::IsHeterogen()
+{
+    return is_heterogen_;
+}
+
 double Atom::GetDistanceToAtom(Atom *otherAtom)
 {
     double x = ( this->GetCoordinates().at(0)->GetX() - otherAtom->GetCoordinates().at(0)->GetX() );
@@ -179,8 +263,8 @@ unsigned long long Atom::generateAtomIndex()
 //////////////////////////////////////////////////////////
 void Atom::Print(ostream &out)
 {
-    out << "Atom name: " << name_ << endl;
-    out << "Element: " << element_symbol_ << endl;
+    out << "Atom name: " << SymbolTable::GetString(name_) << endl;
+    out << "Element: " << SymbolTable::GetString(element_symbol_) << endl;
     out << "Atom Type: " << this->MolecularDynamicAtom::GetAtomType() << endl;
     out << "Coordinates: " << endl;
     if(coordinates_.size() != 0)
@@ -1,6 +1,7 @@
 #include "../../includes/MolecularModeling/atomnode.hpp"
 #include "../../includes/MolecularModeling/atom.hpp"
 #include "../../includes/MolecularModeling/residue.hpp"
+#include "../../includes/MolecularModeling/assemblystorage.hpp"
 #include "../../includes/utils.hpp"
 
 using namespace std;
@@ -9,7 +10,7 @@ using namespace MolecularModeling;
 //////////////////////////////////////////////////////////
 //                       CONSTRUCTOR                    //
 //////////////////////////////////////////////////////////
-AtomNode::AtomNode() {}
+AtomNode::AtomNode() : atom_(NULL) {}
 AtomNode::AtomNode(AtomNode *node)
 {
     atom_ = new Atom(new Atom(node->GetAtom()));
@@ -67,10 +68,12 @@ void AtomNode::SetNodeNeighbors(AtomVector node_neighbors)
     {
         node_neighbors_.push_back(*it);
     }
+    this->NotifyBondsChanged();
 }
 void AtomNode::AddNodeNeighbor(Atom *node_neighbor)
 {
     node_neighbors_.push_back(node_neighbor);
+    this->NotifyBondsChanged();
 }
 
 void AtomNode::SetId(int id)
@@ -89,6 +92,12 @@ void AtomNode::RemoveNodeNeighbor(Atom *node_neighbor)
     this->SetNodeNeighbors(new_node_neighbors);
 }
 
+void AtomNode::NotifyBondsChanged()
+{
+    if(atom_ != NULL && atom_->GetResidue() != NULL && atom_->GetResidue()->GetStorage() != NULL)
+        atom_->GetResidue()->GetStorage()->NotifyBondsChanged();
+}
+
 void AtomNode::SetElementLabel(string element_label)
 {
     element_label_ = element_label;
@@ -0,0 +1,129 @@
+#include "../../includes/MolecularModeling/bondgraph.hpp"
+#include "../../includes/MolecularModeling/atom.hpp"
+#include "../../includes/MolecularModeling/atomnode.hpp"
+
+using namespace std;
+using namespace MolecularModeling;
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+BondGraph::BondGraph()
+{
+    offsets_.push_back(0);
+}
+
+BondGraph::BondGraph(AtomVector atoms)
+{
+    this->Build(atoms);
+}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+int BondGraph::GetNumberOfAtoms()
+{
+    return atoms_.size();
+}
+
+int BondGraph::GetNumberOfNeighborEntries()
+{
+    return neighbors_.size();
+}
+
+Atom* BondGraph::GetAtom(int index)
+{
+    return atoms_.at(index);
+}
+
+int BondGraph::GetIndex(Atom* atom)
+{
+    AtomIndexMap::iterator it = indices_.find(atom);
+    if(it == indices_.end())
+        return -1;
+    return it->second;
+}
+
+int BondGraph::GetDegree(int index)
+{
+    return offsets_.at(index + 1) - offsets_.at(index);
+}
+
+const BondGraph::AtomVector& BondGraph::GetAtoms()
+{
+    return atoms_;
+}
+
+const BondGraph::IndexVector& BondGraph::GetOffsets()
+{
+    return offsets_;
+}
+
+const BondGraph::IndexVector& BondGraph::GetNeighbors()
+{
+    return neighbors_;
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+void BondGraph::Build(AtomVector atoms)
+{
+    atoms_ = atoms;
+    moving_atoms_.clear();
+    visited_.assign(atoms_.size(), false);
+    indices_.clear();
+    indices_.rehash(atoms_.size());
+    for(unsigned int i = 0; i < atoms_.size(); i++)
+        indices_.insert(AtomIndexMap::value_type(atoms_.at(i), i));
+
+    offsets_.assign(atoms_.size() + 1, 0);
+    neighbors_.clear();
+    for(unsigned int i = 0; i < atoms_.size(); i++)
+    {
+        AtomNode* node = atoms_.at(i)->GetNode();
+        if(node != NULL)
+        {
+            AtomVector node_neighbors = node->GetNodeNeighbors();
+            for(AtomVector::iterator it = node_neighbors.begin(); it != node_neighbors.end(); it++)
+            {
+                AtomIndexMap::iterator neighbor = indices_.find(*it);
+                if(neighbor != indices_.end())
+                    neighbors_.push_back(neighbor->second);
+            }
+        }
+        offsets_.at(i + 1) = neighbors_.size();
+    }
+}
+
+const BondGraph::IndexVector& BondGraph::GetMovingAtoms(int fixed_index, int moving_index)
+{
+    pair<int, int> key = make_pair(fixed_index, moving_index);
+    MovingAtomsMap::iterator cached = moving_atoms_.find(key);
+    if(cached != moving_atoms_.end())
+        return cached->second;
+
+    IndexVector& moving_atoms = moving_atoms_[key];
+    visited_.at(fixed_index) = true;
+    stack_.assign(1, moving_index);
+    while(!stack_.empty())
+    {
+        int index = stack_.back();
+        stack_.pop_back();
+        if(visited_.at(index))
+            continue;
+        visited_.at(index) = true;
+        moving_atoms.push_back(index);
+        /// Neighbors are pushed in reverse so that they are visited in the order of the atom node
+        for(int i = offsets_.at(index + 1) - 1; i >= offsets_.at(index); i--)
+        {
+            if(!visited_.at(neighbors_.at(i)))
+                stack_.push_back(neighbors_.at(i));
+        }
+    }
+    /// Only the atoms that have been visited are reset, so a query costs the size of its result and not the size of the graph
+    visited_.at(fixed_index) = false;
+    for(IndexVector::iterator it = moving_atoms.begin(); it != moving_atoms.end(); it++)
+        visited_.at(*it) = false;
+    return moving_atoms;
+}
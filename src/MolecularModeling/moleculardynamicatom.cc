@@ -7,12 +7,16 @@ using namespace MolecularModeling;
 //////////////////////////////////////////////////////////
 //                       CONSTRUCTOR                    //
 //////////////////////////////////////////////////////////
-MolecularDynamicAtom::MolecularDynamicAtom() : atom_type_(""), charge_(gmml::dNotSet), mass_(gmml::dNotSet), radius_(gmml::dNotSet) {}
+MolecularDynamicAtom::MolecularDynamicAtom() : atom_type_(0), charge_(gmml::dNotSet), mass_(gmml::dNotSet), radius_(gmml::dNotSet) {}
 
 //////////////////////////////////////////////////////////
 //                         ACCESSOR                     //
 //////////////////////////////////////////////////////////
 string MolecularDynamicAtom::GetAtomType()
+{
+    return SymbolTable::GetString(atom_type_);
+}
+SymbolTable::Symbol MolecularDynamicAtom::GetAtomTypeSymbol()
 {
     return atom_type_;
 }
@@ -34,7 +38,7 @@ double MolecularDynamicAtom::GetRadius()
 //////////////////////////////////////////////////////////
 void MolecularDynamicAtom::SetAtomType(string atom_type)
 {
-    atom_type_ = atom_type;
+    atom_type_ = SymbolTable::Intern(atom_type);
 }
 void MolecularDynamicAtom::SetCharge(double charge)
 {
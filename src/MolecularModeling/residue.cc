@@ -1,31 +1,42 @@
 #include "../../includes/MolecularModeling/residue.hpp"
 #include "../../includes/MolecularModeling/assembly.hpp"
+#include "../../includes/MolecularModeling/assemblystorage.hpp"
 #include "../../includes/MolecularModeling/atom.hpp"
 #include "../../includes/MolecularModeling/atomnode.hpp"
+#include "../../includes/common.hpp"
+#include "../../includes/utils.hpp"
+#include <sstream>
+#include <cstdlib>
 
 using namespace std;
 using namespace MolecularModeling;
 //////////////////////////////////////////////////////////
 //                       CONSTRUCTOR                    //
 //////////////////////////////////////////////////////////
-Residue::Residue() {}
+Residue::Residue() : storage_(NULL), name_(0), chemical_type_(0), description_(0)
+{
+    identity_ = ParseIdentity(vector<string>(), 0);
+}
 
 Residue::Residue(Assembly *assembly, string name)
 {
     assembly_ = assembly;
-    name_ = name;
+    storage_ = NULL;
+    name_ = SymbolTable::Intern(name);
     atoms_ = AtomVector();
     head_atoms_ = AtomVector();
     tail_atoms_ = AtomVector();
-    chemical_type_ = "";
-    description_ = "";
+    chemical_type_ = 0;
+    description_ = 0;
     id_ = "";
+    identity_ = ParseIdentity(vector<string>(), 0);
 }
 
 Residue::Residue(Residue *residue)
 {
     assembly_ = new Assembly(residue->GetAssembly());
-    name_ = residue->GetName();
+    storage_ = NULL;
+    name_ = residue->GetNameSymbol();
     atoms_ = AtomVector();
     AtomVector atoms = residue->GetAtoms();
     for(AtomVector::iterator it = atoms.begin(); it != atoms.end(); it++)
@@ -38,9 +49,10 @@ Residue::Residue(Residue *residue)
     AtomVector tail_atoms = residue->GetTailAtoms();
     for(AtomVector::iterator it = tail_atoms.begin(); it != tail_atoms.end(); it++)
         tail_atoms_.push_back(new Atom(*it));
-    chemical_type_ = residue->GetChemicalType();
-    description_ = residue->GetDescription();
+    chemical_type_ = residue->GetChemicalTypeSymbol();
+    description_ = residue->GetDescriptionSymbol();
     id_ = residue->GetId();
+    identity_ = residue->GetIdentity();
 }
 
 //////////////////////////////////////////////////////////
@@ -50,7 +62,15 @@ Assembly* Residue::GetAssembly()
 {
     return assembly_;
 }
+AssemblyStorage* Residue::GetStorage()
+{
+    return storage_;
+}
 string Residue::GetName()
+{
+    return SymbolTable::GetString(name_);
+}
+SymbolTable::Symbol Residue::GetNameSymbol()
 {
     return name_;
 }
@@ -67,10 +87,18 @@ Residue::AtomVector Residue::GetTailAtoms()
     return tail_atoms_;
 }
 string Residue::GetChemicalType()
+{
+    return SymbolTable::GetString(chemical_type_);
+}
+SymbolTable::Symbol Residue::GetChemicalTypeSymbol()
 {
     return chemical_type_;
 }
 string Residue::GetDescription()
+{
+    return SymbolTable::GetString(description_);
+}
+SymbolTable::Symbol Residue::GetDescriptionSymbol()
 {
     return description_;
 }
@@ -78,6 +106,14 @@ string Residue::GetId()
 {
     return id_;
 }
+ResidueIdentity Residue::GetIdentity()
+{
+    return identity_;
+}
+int Residue::GetSequenceNumber()
+{
+    return identity_.sequence_number_;
+}
 
 //////////////////////////////////////////////////////////
 //                          MUTATOR                     //
@@ -86,9 +122,13 @@ void Residue::SetAssembly(Assembly *assembly)
 {
     assembly_ = assembly;
 }
+void Residue::SetStorage(AssemblyStorage *storage)
+{
+    storage_ = storage;
+}
 void Residue::SetName(string name)
 {
-    name_ = name;
+    name_ = SymbolTable::Intern(name);
 }
 void Residue::SetAtoms(AtomVector atoms)
 {
@@ -97,10 +137,14 @@ void Residue::SetAtoms(AtomVector atoms)
     {
         atoms_.push_back(*it);
     }
+    if(storage_ != NULL)
+        storage_->NotifyStructureChanged();
 }
 void Residue::AddAtom(Atom *atom)
 {
     atoms_.push_back(atom);
+    if(storage_ != NULL)
+        storage_->NotifyStructureChanged();
 }
 void Residue::RemoveAtom(Atom *atom)
 {
@@ -144,26 +188,75 @@ void Residue::AddTailAtom(Atom *tail_atom)
 }
 void Residue::SetChemicalType(string chemical_type)
 {
-    chemical_type_ = chemical_type;
+    chemical_type_ = SymbolTable::Intern(chemical_type);
 }
 void Residue::SetDescription(string description)
 {
-    description_ = description;
+    description_ = SymbolTable::Intern(description);
 }
 void Residue::SetId(string id)
 {
     id_ = id;
+    identity_ = ParseIdentity(gmml::Split(id, "_"), 0);
+}
+void Residue::SetIdentity(string name, char chain_id, int sequence_number, char insertion_code, char alternate_location, string model)
+{
+    identity_.name_ = SymbolTable::Intern(name);
+    identity_.chain_id_ = chain_id;
+    identity_.sequence_number_ = sequence_number;
+    identity_.insertion_code_ = insertion_code;
+    identity_.alternate_location_ = alternate_location;
+    identity_.model_ = SymbolTable::Intern(model);
+    /// The id is formatted here rather than on first use, so reading it never writes to a residue that is shared between threads
+    id_ = (sequence_number != gmml::iNotSet) ? FormatIdentity(identity_) : "";
 }
 
 //////////////////////////////////////////////////////////
 //                       FUNCTIONS                      //
 //////////////////////////////////////////////////////////
+string Residue::FormatIdentity(ResidueIdentity identity)
+{
+    stringstream ss;
+    ss << SymbolTable::GetString(identity.name_) << "_" << identity.chain_id_ << "_" << identity.sequence_number_ << "_"
+       << identity.insertion_code_ << "_" << identity.alternate_location_ << "_" << SymbolTable::GetString(identity.model_);
+    return ss.str();
+}
+
+ResidueIdentity Residue::ParseIdentity(vector<string> tokens, int first_token)
+{
+    ResidueIdentity identity;
+    identity.name_ = 0;
+    identity.chain_id_ = gmml::BLANK_SPACE;
+    identity.sequence_number_ = gmml::iNotSet;
+    identity.insertion_code_ = gmml::BLANK_SPACE;
+    identity.alternate_location_ = gmml::BLANK_SPACE;
+    identity.model_ = 0;
+    int size = tokens.size();
+    if(size > first_token)
+        identity.name_ = SymbolTable::Intern(tokens.at(first_token));
+    if(size > first_token + 1)
+        identity.chain_id_ = tokens.at(first_token + 1).at(0);
+    if(size > first_token + 2)
+    {
+        char* end = NULL;
+        long sequence_number = strtol(tokens.at(first_token + 2).c_str(), &end, 10);
+        if(*end == '\0')
+            identity.sequence_number_ = sequence_number;
+    }
+    if(size > first_token + 3)
+        identity.insertion_code_ = tokens.at(first_token + 3).at(0);
+    if(size > first_token + 4)
+        identity.alternate_location_ = tokens.at(first_token + 4).at(0);
+    if(size > first_token + 5)
+        identity.model_ = SymbolTable::Intern(tokens.at(first_token + 5));
+    return identity;
+}
 bool Residue::CheckSymbolBasedElementLabeling()
 {
     for(AtomVector::iterator it = atoms_.begin(); it != atoms_.end(); it++)
     {
         Atom* atom = *it;
-        if(atom->GetElementSymbol().compare("") == 0)
+        if(atom->GetElementSymbolSymbol() == 0)
             return false;
     }
     return true;
@@ -171,10 +264,12 @@ bool Residue::CheckSymbolBasedElementLabeling()
 
 bool Residue::CheckParameterBasedElementLabeling()
 {
+    SymbolTable::Symbol unknown_type = SymbolTable::Intern("UNK");
     for(AtomVector::iterator it = atoms_.begin(); it != atoms_.end(); it++)
     {
         Atom* atom = *it;
-        if(atom->GetAtomType().compare("UNK") == 0 || atom->GetAtomType().compare("") == 0)
+        SymbolTable::Symbol atom_type = atom->GetAtomTypeSymbol();
+        if(atom_type == unknown_type || atom_type == 0)
             return false;
     }
     return true;
@@ -282,7 +377,7 @@ Residue::AtomVector Residue::GetAtomsWithLowestIntraDegree()
 //////////////////////////////////////////////////////////
 void Residue::Print(ostream &out)
 {
-    out << "------------------------ " << name_ << " --------------------------" << endl;
+    out << "------------------------ " << SymbolTable::GetString(name_) << " --------------------------" << endl;
     out << "Head atoms: ";
     for(AtomVector::iterator it = head_atoms_.begin(); it != head_atoms_.end(); it++)
     {
@@ -310,7 +405,7 @@ void Residue::PrettyPrintHet(ostream &out)
 {
     out << "------------------------ " << "Residue " << " --------------------------" << endl;
     out << " ID: " << id_ << endl;
-    out << " Name: " << name_ << endl;
+    out << " Name: " << SymbolTable::GetString(name_) << endl;
 //    out << " Chemical type: " << chemical_type_ << endl;
 //    out << " Description: " << description_ << endl;
     out << " ATOMS: ";
@@ -350,7 +445,7 @@ void Residue::PrettyPrintHet(ostream &out)
 
 void Residue::PrintHetResidues(ostream &out)
 {
-    out << id_ << ";" << name_ << ";";
+    out << id_ << ";" << SymbolTable::GetString(name_) << ";";
     for(AtomVector::iterator it = atoms_.begin(); it != atoms_.end(); it++)
     {
         Atom* atom = *it;
@@ -381,7 +476,7 @@ void Residue::PrintHetAtoms(ostream &out)
 
 void Residue::WriteHetResidues(ofstream& out)
 {
-    out << id_ << ";" << name_ << ";";
+    out << id_ << ";" << SymbolTable::GetString(name_) << ";";
     for(AtomVector::iterator it = atoms_.begin(); it != atoms_.end(); it++)
     {
         Atom* atom = *it;
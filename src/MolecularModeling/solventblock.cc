@@ -0,0 +1,285 @@
+#include <algorithm>
+
+#include "../../includes/MolecularModeling/solventblock.hpp"
+#include "../../includes/MolecularModeling/assembly.hpp"
+#include "../../includes/MolecularModeling/residue.hpp"
+#include "../../includes/MolecularModeling/atom.hpp"
+#include "../../includes/MolecularModeling/atomnode.hpp"
+#include "../../includes/MolecularModeling/bondgraph.hpp"
+#include "../../includes/utils.hpp"
+#include "../../includes/common.hpp"
+
+using namespace std;
+using namespace MolecularModeling;
+using namespace GeometryTopology;
+using namespace gmml;
+
+//////////////////////////////////////////////////////////
+//                       CONSTRUCTOR                    //
+//////////////////////////////////////////////////////////
+SolventBlock::SolventBlock() : residue_name_(""), id_prefix_(""), first_sequence_number_(1), first_serial_number_(1)
+{
+    site_offsets_.push_back(0);
+    residue_offsets_.push_back(0);
+}
+
+//////////////////////////////////////////////////////////
+//                         ACCESSOR                     //
+//////////////////////////////////////////////////////////
+bool SolventBlock::IsEmpty()
+{
+    return residue_offsets_.size() == 1;
+}
+
+int SolventBlock::GetNumberOfSites()
+{
+    return site_names_.size();
+}
+
+int SolventBlock::GetNumberOfMolecules()
+{
+    return residue_offsets_.back();
+}
+
+int SolventBlock::GetNumberOfAtoms()
+{
+    return coordinates_.size();
+}
+
+int SolventBlock::GetNumberOfResidues()
+{
+    return residue_offsets_.size() - 1;
+}
+
+int SolventBlock::GetFirstMoleculeOfResidue(int residue_index)
+{
+    return residue_offsets_.at(residue_index);
+}
+
+int SolventBlock::GetNumberOfMoleculesOfResidue(int residue_index)
+{
+    return residue_offsets_.at(residue_index + 1) - residue_offsets_.at(residue_index);
+}
+
+int SolventBlock::GetResidueOfMolecule(int molecule_index)
+{
+    /// The last residue whose first molecule is not after the molecule; empty residues in between are skipped by upper_bound
+    return distance(residue_offsets_.begin(), upper_bound(residue_offsets_.begin(), residue_offsets_.end() - 1, molecule_index)) - 1;
+}
+
+Coordinate& SolventBlock::GetSiteCoordinate(int molecule_index, int site_index)
+{
+    return coordinates_.at(molecule_index * site_names_.size() + site_index);
+}
+
+int SolventBlock::GetSequenceNumber(int residue_index)
+{
+    return first_sequence_number_ + residue_index;
+}
+
+int SolventBlock::GetSerialNumber(int molecule_index, int site_index)
+{
+    return first_serial_number_ + molecule_index * site_names_.size() + site_index;
+}
+
+string SolventBlock::GetResidueName()
+{
+    return residue_name_;
+}
+
+string SolventBlock::GetIdPrefix()
+{
+    return id_prefix_;
+}
+
+string SolventBlock::GetSiteName(int site_index)
+{
+    return site_names_.at(site_index);
+}
+
+string SolventBlock::GetSiteAtomType(int site_index)
+{
+    return site_atom_types_.at(site_index);
+}
+
+double SolventBlock::GetSiteCharge(int site_index)
+{
+    return site_charges_.at(site_index);
+}
+
+double SolventBlock::GetSiteRadius(int site_index)
+{
+    return site_radii_.at(site_index);
+}
+
+const SolventBlock::IndexVector& SolventBlock::GetSiteOffsets()
+{
+    return site_offsets_;
+}
+
+const SolventBlock::IndexVector& SolventBlock::GetSiteNeighbors()
+{
+    return site_neighbors_;
+}
+
+//////////////////////////////////////////////////////////
+//                          MUTATOR                     //
+//////////////////////////////////////////////////////////
+void SolventBlock::SetTemplate(AtomVector molecule_atoms, string residue_name, string id_prefix)
+{
+    this->Clear();
+    residue_name_ = residue_name;
+    id_prefix_ = id_prefix;
+    site_names_.clear();
+    site_atom_types_.clear();
+    site_charges_.clear();
+    site_masses_.clear();
+    site_radii_.clear();
+    site_node_ids_.clear();
+    for(AtomVector::iterator it = molecule_atoms.begin(); it != molecule_atoms.end(); it++)
+    {
+        Atom* atom = *it;
+        site_names_.push_back(atom->GetName());
+        site_atom_types_.push_back(atom->MolecularDynamicAtom::GetAtomType());
+        site_charges_.push_back(atom->MolecularDynamicAtom::GetCharge());
+        site_masses_.push_back(atom->MolecularDynamicAtom::GetMass());
+        site_radii_.push_back(atom->MolecularDynamicAtom::GetRadius());
+        site_node_ids_.push_back((atom->GetNode() != NULL) ? atom->GetNode()->GetId() : iNotSet);
+    }
+    BondGraph molecule_graph = BondGraph(molecule_atoms);
+    site_offsets_ = molecule_graph.GetOffsets();
+    site_neighbors_ = molecule_graph.GetNeighbors();
+}
+
+void SolventBlock::SetFirstNumbers(int first_sequence_number, int first_serial_number)
+{
+    first_sequence_number_ = first_sequence_number;
+    first_serial_number_ = first_serial_number;
+}
+
+//////////////////////////////////////////////////////////
+//                       FUNCTIONS                      //
+//////////////////////////////////////////////////////////
+void SolventBlock::AddResidue()
+{
+    residue_offsets_.push_back(residue_offsets_.back());
+}
+
+void SolventBlock::AddMolecule(const Coordinate* site_coordinates)
+{
+    if(residue_offsets_.size() == 1)
+        this->AddResidue();
+    coordinates_.insert(coordinates_.end(), site_coordinates, site_coordinates + site_names_.size());
+    residue_offsets_.back()++;
+}
+
+void SolventBlock::Clear()
+{
+    coordinates_.clear();
+    residue_offsets_.assign(1, 0);
+}
+
+void SolventBlock::RemoveMolecules(IndexVector molecule_indices)
+{
+    int number_of_molecules = this->GetNumberOfMolecules();
+    int number_of_sites = site_names_.size();
+    vector<bool> removed = vector<bool>(number_of_molecules, false);
+    for(IndexVector::iterator it = molecule_indices.begin(); it != molecule_indices.end(); it++)
+        if(*it >= 0 && *it < number_of_molecules)
+            removed.at(*it) = true;
+    CoordinateVector coordinates = CoordinateVector();
+    coordinates.reserve(coordinates_.size());
+    IndexVector residue_offsets = IndexVector(1, 0);
+    for(int residue = 0; residue < this->GetNumberOfResidues(); residue++)
+    {
+        int kept = residue_offsets.back();
+        for(int molecule = residue_offsets_.at(residue); molecule < residue_offsets_.at(residue + 1); molecule++)
+        {
+            if(removed.at(molecule))
+                continue;
+            coordinates.insert(coordinates.end(), coordinates_.begin() + molecule * number_of_sites, coordinates_.begin() + (molecule + 1) * number_of_sites);
+            kept++;
+        }
+        residue_offsets.push_back(kept);
+    }
+    coordinates_.swap(coordinates);
+    residue_offsets_.swap(residue_offsets);
+}
+
+Residue* SolventBlock::ExpandResidue(int residue_index, Assembly* assembly, string assembly_id)
+{
+    return this->ExpandMolecules(residue_index, residue_offsets_.at(residue_index), residue_offsets_.at(residue_index + 1), assembly, assembly_id);
+}
+
+Residue* SolventBlock::ExpandMolecule(int molecule_index, Assembly* assembly, string assembly_id)
+{
+    return this->ExpandMolecules(this->GetResidueOfMolecule(molecule_index), molecule_index, molecule_index + 1, assembly, assembly_id);
+}
+
+void SolventBlock::RenumberResidue(int residue_index, Residue* residue, string assembly_id)
+{
+    int first_molecule = residue_offsets_.at(residue_index);
+    int last_molecule = residue_offsets_.at(residue_index + 1);
+    if(first_molecule == last_molecule)
+        return;
+    string id = this->FormatResidueId(residue_index, assembly_id);
+    residue->SetId(id);
+    /// The atoms of an expanded residue are in the order of the molecules and their sites
+    AtomVector atoms = residue->GetAtoms();
+    int number_of_sites = site_names_.size();
+    for(int molecule = first_molecule; molecule < last_molecule; molecule++)
+    {
+        for(int site = 0; site < number_of_sites; site++)
+        {
+            Atom* atom = atoms.at((molecule - first_molecule) * number_of_sites + site);
+            atom->SetId(site_names_.at(site) + "_" + ConvertT<int>(this->GetSerialNumber(molecule, site)) + "_" + id);
+        }
+    }
+}
+
+string SolventBlock::FormatResidueId(int residue_index, string assembly_id)
+{
+    return id_prefix_ + "_" + BLANK_SPACE + "_" + ConvertT<int>(this->GetSequenceNumber(residue_index)) + "_" +
+            BLANK_SPACE + "_" + BLANK_SPACE + "_" + assembly_id;
+}
+
+Residue* SolventBlock::ExpandMolecules(int residue_index, int first_molecule, int last_molecule, Assembly* assembly, string assembly_id)
+{
+    /// An empty residue is left without name and id, like a copy of the solvent box whose molecules have all been removed
+    Residue* residue = assembly->CreateResidue();
+    if(first_molecule == last_molecule)
+        return residue;
+    string id = this->FormatResidueId(residue_index, assembly_id);
+    residue->SetName(residue_name_);
+    residue->SetId(id);
+    int number_of_sites = site_names_.size();
+    AtomVector molecule_atoms = AtomVector(number_of_sites, NULL);
+    for(int molecule = first_molecule; molecule < last_molecule; molecule++)
+    {
+        for(int site = 0; site < number_of_sites; site++)
+        {
+            Atom* atom = assembly->CreateAtom();
+            atom->SetName(site_names_.at(site));
+            atom->MolecularDynamicAtom::SetCharge(site_charges_.at(site));
+            atom->MolecularDynamicAtom::SetAtomType(site_atom_types_.at(site));
+            atom->MolecularDynamicAtom::SetMass(site_masses_.at(site));
+            atom->MolecularDynamicAtom::SetRadius(site_radii_.at(site));
+            atom->SetDescription("Het;");
+            atom->AddCoordinate(assembly->CreateCoordinate(this->GetSiteCoordinate(molecule, site)));
+            atom->SetResidue(residue);
+            atom->SetId(site_names_.at(site) + "_" + ConvertT<int>(this->GetSerialNumber(molecule, site)) + "_" + id);
+            residue->AddAtom(atom);
+            molecule_atoms.at(site) = atom;
+        }
+        for(int site = 0; site < number_of_sites; site++)
+        {
+            AtomNode* node = assembly->CreateAtomNode();
+            node->SetAtom(molecule_atoms.at(site));
+            node->SetId(site_node_ids_.at(site));
+            for(int i = site_offsets_.at(site); i < site_offsets_.at(site + 1); i++)
+                node->AddNodeNeighbor(molecule_atoms.at(site_neighbors_.at(i)));
+            molecule_atoms.at(site)->SetNode(node);
+        }
+    }
+    return residue;
+}
@@ -0,0 +1,79 @@
+#include <map>
+#include <stdexcept>
+#include <pthread.h>
+
+#include "../../includes/MolecularModeling/symboltable.hpp"
+
+using namespace std;
+using namespace MolecularModeling;
+
+namespace
+{
+    // Strings live in fixed size chunks that are never reallocated, so a string stays at the same address once it is interned
+    const unsigned int SYMBOL_CHUNK_SIZE = 4096;
+    const unsigned int MAX_SYMBOL_CHUNKS = 16384;
+
+    typedef map<string, SymbolTable::Symbol> SymbolMap;
+
+    // Plain pointers and counters are constant initialized, so interning is safe during static initialization of other units
+    pthread_mutex_t symbol_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+    SymbolMap* symbol_lookup = NULL;
+    string* symbol_chunks[MAX_SYMBOL_CHUNKS];
+    unsigned int number_of_symbols = 1;
+
+    const string& EmptySymbolString()
+    {
+        static const string empty_string = "";
+        return empty_string;
+    }
+}
+
+//////////////////////////////////////////////////////////
+//                         FUNCTIONS                    //
+//////////////////////////////////////////////////////////
+SymbolTable::Symbol SymbolTable::Intern(const string& text)
+{
+    if(text.empty())
+        return 0;
+    pthread_mutex_lock(&symbol_table_mutex);
+    if(symbol_lookup == NULL)
+        symbol_lookup = new SymbolMap();
+    Symbol symbol = 0;
+    SymbolMap::iterator it = symbol_lookup->find(text);
+    if(it != symbol_lookup->end())
+        symbol = it->second;
+    else
+    {
+        // Handing out symbol 0 for a new string would make it equal to the empty string
+        if(number_of_symbols >= SYMBOL_CHUNK_SIZE * MAX_SYMBOL_CHUNKS)
+        {
+            pthread_mutex_unlock(&symbol_table_mutex);
+            throw length_error("SymbolTable::Intern: the symbol table is full");
+        }
+        symbol = number_of_symbols;
+        unsigned int chunk = symbol / SYMBOL_CHUNK_SIZE;
+        if(symbol_chunks[chunk] == NULL)
+            symbol_chunks[chunk] = new string[SYMBOL_CHUNK_SIZE];
+        symbol_chunks[chunk][symbol % SYMBOL_CHUNK_SIZE] = text;
+        (*symbol_lookup)[text] = symbol;
+        // The release store publishes the chunk and the string before readers can see the new count
+        __atomic_store_n(&number_of_symbols, symbol + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&symbol_table_mutex);
+    return symbol;
+}
+
+const string& SymbolTable::GetString(Symbol symbol)
+{
+    if(symbol == 0)
+        return EmptySymbolString();
+    // Reads take no lock: the acquire load pairs with the release store in Intern, and interned strings are never moved or changed
+    if(symbol >= __atomic_load_n(&number_of_symbols, __ATOMIC_ACQUIRE))
+        return EmptySymbolString();
+    return symbol_chunks[symbol / SYMBOL_CHUNK_SIZE][symbol % SYMBOL_CHUNK_SIZE];
+}
+
+unsigned int SymbolTable::GetNumberOfSymbols()
+{
+    return __atomic_load_n(&number_of_symbols, __ATOMIC_ACQUIRE);
+}
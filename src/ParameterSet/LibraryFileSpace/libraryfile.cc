@@ -33,7 +33,11 @@ LibraryFile::LibraryFile(const std::string &lib_file)
     in_file.close();            /// Close the parameter files
 }
 
-LibraryFile::~LibraryFile(){}
+LibraryFile::~LibraryFile()
+{
+    for(ResidueMap::iterator it = residues_.begin(); it != residues_.end(); it++)
+        delete it->second;
+}
 //////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////
@@ -32,6 +32,12 @@ LibraryFileResidue::LibraryFileResidue(string &name, int listing_index, vector<L
     }
 }
 
+LibraryFileResidue::~LibraryFileResidue()
+{
+    for(AtomMap::iterator it = atoms_.begin(); it != atoms_.end(); it++)
+        delete it->second;
+}
+
 ///////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////
@@ -46,6 +46,18 @@ ParameterFile::ParameterFile(std::string param_file, int file_type)
 
 }
 
+ParameterFile::~ParameterFile()
+{
+    for(AtomTypeMap::iterator it = atom_types_.begin(); it != atom_types_.end(); it++)
+        delete it->second;
+    for(BondMap::iterator it = bonds_.begin(); it != bonds_.end(); it++)
+        delete it->second;
+    for(AngleMap::iterator it = angles_.begin(); it != angles_.end(); it++)
+        delete it->second;
+    for(DihedralMap::iterator it = dihedrals_.begin(); it != dihedrals_.end(); it++)
+        delete it->second;
+}
+
 //////////////////////////////////////////////////////////
 //                           ACCESSOR                   //
 //////////////////////////////////////////////////////////